@@ -0,0 +1,88 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "../../test/src/Catch2.h"
+#include "Assets/ModelDefinition.h"
+#include "BenchmarkUtils.h"
+#include "EL/EvaluationContext.h"
+#include "EL/Value.h"
+#include "EL/VariableStore.h"
+#include "IO/ELParser.h"
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace TrenchBroom
+{
+namespace Assets
+{
+static constexpr size_t NumEntities = 50'000;
+
+TEST_CASE("ModelDefinitionBenchmark.benchModelSpecification")
+{
+  const auto expression = IO::ELParser::parseStrict(R"({{
+    spawnflags & 1 -> { path: "progs/armor.mdl", skin: 1 },
+    spawnflags & 2 -> { path: "progs/armor.mdl", skin: 2 },
+    model -> { path: model, skin: skin, frame: frame },
+                      "progs/armor.mdl"
+  }})");
+
+  const auto definition = ModelDefinition{expression};
+
+  auto variableStores = std::vector<EL::VariableTable>{};
+  variableStores.reserve(NumEntities);
+  for (size_t i = 0; i < NumEntities; ++i)
+  {
+    variableStores.emplace_back(std::map<std::string, EL::Value>{
+      {"spawnflags", EL::Value{std::to_string(i % 4)}},
+      {"model", EL::Value{i % 3 == 0 ? "progs/player.mdl" : ""}},
+      {"skin", EL::Value{std::to_string(i % 2)}},
+      {"frame", EL::Value{std::to_string(i % 5)}},
+    });
+  }
+
+  auto specs = std::vector<ModelSpecification>{};
+  specs.reserve(NumEntities);
+
+  timeLambda(
+    [&]() {
+      for (const auto& variableStore : variableStores)
+      {
+        specs.push_back(definition.modelSpecification(variableStore));
+      }
+    },
+    "evaluate " + std::to_string(NumEntities) + " model specifications");
+
+  auto values = std::vector<EL::Value>{};
+  values.reserve(NumEntities);
+
+  timeLambda(
+    [&]() {
+      for (const auto& variableStore : variableStores)
+      {
+        values.push_back(expression.evaluate(EL::EvaluationContext{variableStore}));
+      }
+    },
+    "evaluate " + std::to_string(NumEntities) + " model expressions without caching");
+
+  CHECK(specs.size() == values.size());
+}
+} // namespace Assets
+} // namespace TrenchBroom
@@ -0,0 +1,205 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "../../test/src/Catch2.h"
+#include "BenchmarkUtils.h"
+#include "Error.h"
+#include "Model/Brush.h"
+#include "Model/BrushBuilder.h"
+#include "Model/BrushNode.h"
+#include "Model/MapFormat.h"
+#include "Renderer/BrushRendererBrushCache.h"
+
+#include "kdl/result.h"
+
+#include "vm/bbox.h"
+#include "vm/mat.h"
+#include "vm/mat_ext.h"
+#include "vm/scalar.h"
+#include "vm/vec.h"
+
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace TrenchBroom::Model
+{
+namespace
+{
+constexpr size_t NumBrushes = 20'000;
+constexpr size_t NumCopies = 200;
+constexpr auto worldBounds = vm::bbox3{8192.0};
+
+std::vector<Brush> makeBrushes(const size_t count)
+{
+  const auto builder = BrushBuilder{MapFormat::Quake3, worldBounds};
+
+  auto result = std::vector<Brush>{};
+  result.reserve(count);
+  for (size_t i = 0; i < count; ++i)
+  {
+    const auto x = double(i % 128) * 32.0 - 2048.0;
+    const auto y = double(i / 128) * 32.0 - 2048.0;
+    const auto bounds = vm::bbox3{{x, y, 0.0}, {x + 16.0, y + 16.0, 16.0}};
+    result.push_back(builder.createCuboid(bounds, "material") | kdl::value());
+  }
+  return result;
+}
+
+size_t memoryUsage(const std::vector<std::vector<Brush>>& brushes)
+{
+  auto result = size_t(0);
+  for (const auto& copy : brushes)
+  {
+    for (const auto& brush : copy)
+    {
+      result += brush.memoryUsage();
+    }
+  }
+  return result;
+}
+
+} // namespace
+
+TEST_CASE("BrushCopyBenchmark.copyAndTransform")
+{
+  const auto brushes = makeBrushes(NumBrushes);
+
+  auto copies = std::vector<Brush>{};
+  timeLambda(
+    [&]() { copies = brushes; }, "copy " + std::to_string(NumBrushes) + " brushes");
+
+  const auto translation = vm::translation_matrix(vm::vec3{16.0, 16.0, 16.0});
+  timeLambda(
+    [&]() {
+      for (auto& brush : copies)
+      {
+        REQUIRE(brush.transform(worldBounds, translation, false).is_success());
+      }
+    },
+    "translate " + std::to_string(NumBrushes) + " copied brushes");
+
+  timeLambda(
+    [&]() {
+      for (auto& brush : copies)
+      {
+        REQUIRE(brush.transform(worldBounds, translation, false).is_success());
+      }
+    },
+    "translate " + std::to_string(NumBrushes) + " unshared brushes");
+
+  const auto rotation = vm::rotation_matrix(vm::vec3::pos_z(), vm::to_radians(90.0));
+  timeLambda(
+    [&]() {
+      for (auto& brush : copies)
+      {
+        REQUIRE(brush.transform(worldBounds, rotation, false).is_success());
+      }
+    },
+    "rotate " + std::to_string(NumBrushes) + " brushes");
+
+  CHECK(copies.front().bounds().min == vm::vec3{2000.0, -2016.0, 32.0});
+}
+
+TEST_CASE("BrushCopyBenchmark.memoryUsage")
+{
+  constexpr auto count = NumBrushes / NumCopies;
+
+  auto shared = std::vector<std::vector<Brush>>{};
+  shared.push_back(makeBrushes(count));
+  for (size_t i = 1; i < NumCopies; ++i)
+  {
+    shared.push_back(shared.front());
+  }
+
+  auto unshared = std::vector<std::vector<Brush>>{};
+  for (size_t i = 0; i < NumCopies; ++i)
+  {
+    unshared.push_back(makeBrushes(count));
+  }
+
+  const auto sharedUsage = memoryUsage(shared);
+  const auto unsharedUsage = memoryUsage(unshared);
+  printf(
+    "Memory used by %zu copies of %zu brushes: %zu bytes, without sharing %zu bytes\n",
+    NumCopies,
+    count,
+    sharedUsage,
+    unsharedUsage);
+
+  CHECK(sharedUsage < unsharedUsage);
+}
+
+TEST_CASE("BrushCopyBenchmark.linkedGroup")
+{
+  constexpr auto count = NumBrushes / NumCopies;
+
+  const auto source = makeBrushes(count);
+
+  // updating a linked group copies the brushes of the changed instance into every other
+  // instance and transforms them with the instance's transformation
+  auto instances = std::vector<std::vector<Brush>>{};
+  instances.reserve(NumCopies);
+  timeLambda(
+    [&]() {
+      for (size_t i = 0; i < NumCopies; ++i)
+      {
+        const auto offset = double(i + 1) * 16.0;
+        const auto transformation = vm::translation_matrix(vm::vec3{0.0, 0.0, offset});
+
+        auto& instance = instances.emplace_back(source);
+        for (auto& brush : instance)
+        {
+          REQUIRE(brush.transform(worldBounds, transformation, false).is_success());
+        }
+      }
+    },
+    "update " + std::to_string(NumCopies) + " linked instances of "
+      + std::to_string(count) + " brushes");
+
+  auto brushNodes = std::vector<std::unique_ptr<BrushNode>>{};
+  brushNodes.reserve(NumCopies * count);
+  for (const auto& instance : instances)
+  {
+    for (const auto& brush : instance)
+    {
+      brushNodes.push_back(std::make_unique<BrushNode>(brush));
+    }
+  }
+
+  timeLambda(
+    [&]() {
+      for (const auto& brushNode : brushNodes)
+      {
+        brushNode->brushRendererBrushCache().validateVertexCache(*brushNode);
+      }
+    },
+    "validate renderer caches of " + std::to_string(NumCopies) + " linked instances");
+
+  printf(
+    "Memory used by %zu linked instances of %zu brushes: %zu bytes\n",
+    NumCopies,
+    count,
+    memoryUsage(instances));
+
+  CHECK(instances.back().front().bounds().min.z() == double(NumCopies) * 16.0);
+}
+
+} // namespace TrenchBroom::Model
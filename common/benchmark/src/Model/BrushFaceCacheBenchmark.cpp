@@ -0,0 +1,223 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "../../test/src/Catch2.h"
+#include "BenchmarkUtils.h"
+#include "Error.h"
+#include "Model/Brush.h"
+#include "Model/BrushBuilder.h"
+#include "Model/BrushFace.h"
+#include "Model/MapFormat.h"
+#include "Model/PackedBrushFaces.h"
+
+#include "kdl/result.h"
+
+#include "vm/bbox.h"
+#include "vm/plane.h"
+#include "vm/ray.h"
+#include "vm/vec.h"
+
+#include <cstdio>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace TrenchBroom::Model
+{
+namespace
+{
+constexpr size_t NumBrushes = 20'000;
+constexpr size_t NumQueries = 64;
+
+std::vector<Brush> makeBrushes()
+{
+  constexpr auto worldBounds = vm::bbox3{8192.0};
+  const auto builder = BrushBuilder{MapFormat::Quake3, worldBounds};
+
+  auto result = std::vector<Brush>{};
+  result.reserve(NumBrushes);
+  for (size_t i = 0; i < NumBrushes; ++i)
+  {
+    const auto x = double(i % 128) * 32.0 - 2048.0;
+    const auto y = double(i / 128) * 32.0 - 2048.0;
+    const auto z = double(i % 7) * 4.0;
+    // octagonal prisms have more faces than cuboids, like many real world brushes
+    const auto points = std::vector<vm::vec3>{
+      {x + 8.0, y, z},
+      {x + 16.0, y, z},
+      {x + 24.0, y + 8.0, z},
+      {x + 24.0, y + 16.0, z},
+      {x + 16.0, y + 24.0, z},
+      {x + 8.0, y + 24.0, z},
+      {x, y + 16.0, z},
+      {x, y + 8.0, z},
+    };
+    auto prismPoints = points;
+    for (const auto& point : points)
+    {
+      prismPoints.push_back(point + vm::vec3{0.0, 0.0, 24.0});
+    }
+    result.push_back(builder.createBrush(prismPoints, "material") | kdl::value());
+  }
+  return result;
+}
+
+bool containsPointUsingFaces(const Brush& brush, const vm::vec3& point)
+{
+  for (const auto& face : brush.faces())
+  {
+    if (face.boundary().point_status(point) == vm::plane_status::above)
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool containsPointUsingPackedFaces(const Brush& brush, const vm::vec3& point)
+{
+  return brush.packedFaces().containsPoint(point);
+}
+
+std::optional<FloatType> findFaceHitUsingFaces(const Brush& brush, const vm::ray3& ray)
+{
+  for (const auto& face : brush.faces())
+  {
+    if (const auto distance = face.intersectWithRay(ray))
+    {
+      return distance;
+    }
+  }
+  return std::nullopt;
+}
+
+std::optional<FloatType> findFaceHitUsingPackedFaces(
+  const Brush& brush, const vm::ray3& ray)
+{
+  const auto& packedFaces = brush.packedFaces();
+  for (size_t i = 0; i < packedFaces.faceCount(); ++i)
+  {
+    if (const auto distance = packedFaces.intersectWithRay(i, ray))
+    {
+      return distance;
+    }
+  }
+  return std::nullopt;
+}
+
+std::vector<vm::vec3> makeQueryPoints()
+{
+  auto result = std::vector<vm::vec3>{};
+  for (size_t i = 0; i < NumQueries; ++i)
+  {
+    result.emplace_back(double(i) * 0.5, double(i % 5) * 4.0 + 2.0, double(i % 3) * 8.0);
+  }
+  return result;
+}
+
+} // namespace
+
+TEST_CASE("BrushFaceCacheBenchmark.containsPoint")
+{
+  const auto brushes = makeBrushes();
+  const auto points = makeQueryPoints();
+
+  // the bounds check is skipped so that every face plane is visited
+  const auto run = [&](const auto& containsPoint) {
+    size_t count = 0;
+    for (const auto& point : points)
+    {
+      for (const auto& brush : brushes)
+      {
+        if (containsPoint(brush, point + brush.bounds().min))
+        {
+          ++count;
+        }
+      }
+    }
+    return count;
+  };
+
+  auto faceCount = size_t(0);
+  auto packedCount = size_t(0);
+  timeLambda(
+    [&]() { faceCount = run(containsPointUsingFaces); },
+    "contains point using " + std::to_string(NumBrushes) + " brushes' faces");
+  timeLambda(
+    [&]() { packedCount = run(containsPointUsingPackedFaces); },
+    "contains point using " + std::to_string(NumBrushes) + " brushes' packed faces");
+
+  CHECK(faceCount == packedCount);
+}
+
+TEST_CASE("BrushFaceCacheBenchmark.findFaceHit")
+{
+  const auto brushes = makeBrushes();
+  const auto points = makeQueryPoints();
+
+  const auto run = [&](const auto& findFaceHit) {
+    auto sum = FloatType(0);
+    for (const auto& point : points)
+    {
+      for (const auto& brush : brushes)
+      {
+        const auto origin = brush.bounds().min + vm::vec3{point.x(), point.y(), 64.0};
+        const auto ray = vm::ray3{origin, vm::normalize(vm::vec3{0.1, 0.2, -1.0})};
+        sum += findFaceHit(brush, ray).value_or(FloatType(0));
+      }
+    }
+    return sum;
+  };
+
+  auto faceSum = FloatType(0);
+  auto packedSum = FloatType(0);
+  timeLambda(
+    [&]() { faceSum = run(findFaceHitUsingFaces); },
+    "pick " + std::to_string(NumBrushes) + " brushes using faces");
+  timeLambda(
+    [&]() { packedSum = run(findFaceHitUsingPackedFaces); },
+    "pick " + std::to_string(NumBrushes) + " brushes using packed faces");
+
+  CHECK(faceSum == packedSum);
+}
+
+TEST_CASE("BrushFaceCacheBenchmark.memoryUsage")
+{
+  const auto brushes = makeBrushes();
+
+  auto brushUsage = size_t(0);
+  auto packedUsage = size_t(0);
+  for (const auto& brush : brushes)
+  {
+    brushUsage += brush.memoryUsage();
+    packedUsage += brush.packedFaces().memoryUsage();
+  }
+
+  printf(
+    "Memory used by %zu brushes: %zu bytes, of which %zu bytes (%.1f%%) are packed "
+    "faces\n",
+    NumBrushes,
+    brushUsage,
+    packedUsage,
+    100.0 * double(packedUsage) / double(brushUsage));
+
+  CHECK(packedUsage < brushUsage);
+}
+
+} // namespace TrenchBroom::Model
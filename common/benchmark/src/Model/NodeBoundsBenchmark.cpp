@@ -0,0 +1,89 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "../../test/src/Catch2.h"
+#include "BenchmarkUtils.h"
+#include "Error.h"
+#include "Model/Brush.h"
+#include "Model/BrushBuilder.h"
+#include "Model/BrushNode.h"
+#include "Model/Entity.h"
+#include "Model/EntityNode.h"
+#include "Model/Group.h"
+#include "Model/GroupNode.h"
+#include "Model/LayerNode.h"
+#include "Model/MapFormat.h"
+#include "Model/WorldNode.h"
+#include "octree.h"
+
+#include "kdl/result.h"
+
+#include "vm/bbox.h"
+#include "vm/mat.h"
+#include "vm/mat_ext.h"
+
+#include <string>
+
+namespace TrenchBroom::Model
+{
+namespace
+{
+constexpr size_t NumBrushes = 20'000;
+} // namespace
+
+TEST_CASE("NodeBoundsBenchmark.transformGroupedBrushes")
+{
+  constexpr auto worldBounds = vm::bbox3{8192.0};
+  constexpr auto mapFormat = MapFormat::Quake3;
+
+  auto worldNode = WorldNode{{}, {}, mapFormat};
+  auto* groupNode = new GroupNode{Group{"group"}};
+  auto* entityNode = new EntityNode{Entity{{{"classname", "func_detail"}}}};
+  groupNode->addChild(entityNode);
+  worldNode.defaultLayer()->addChild(groupNode);
+
+  const auto builder = BrushBuilder{mapFormat, worldBounds};
+  for (size_t i = 0; i < NumBrushes; ++i)
+  {
+    const auto x = double(i % 128) * 32.0 - 2048.0;
+    const auto y = double(i / 128) * 32.0 - 2048.0;
+    const auto bounds = vm::bbox3{{x, y, 0.0}, {x + 16.0, y + 16.0, 16.0}};
+    entityNode->addChild(
+      new BrushNode{builder.createCuboid(bounds, "material") | kdl::value()});
+  }
+
+  const auto transformation = vm::translation_matrix(vm::vec3{16.0, 16.0, 16.0});
+  timeLambda(
+    [&]() {
+      for (auto* child : entityNode->children())
+      {
+        auto* brushNode = static_cast<BrushNode*>(child);
+        auto brush = brushNode->brush();
+        REQUIRE(brush.transform(worldBounds, transformation, false).is_success());
+        brushNode->setBrush(std::move(brush));
+      }
+      worldNode.applyPendingNodeTreeUpdates();
+    },
+    "transform " + std::to_string(NumBrushes) + " brushes in a grouped brush entity");
+
+  CHECK(worldNode.nodeTree().contains(entityNode));
+  CHECK(entityNode->physicalBounds().min == vm::vec3{-2032.0, -2032.0, 16.0});
+}
+
+} // namespace TrenchBroom::Model
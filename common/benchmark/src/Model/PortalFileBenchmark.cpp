@@ -0,0 +1,92 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "../../test/src/Catch2.h"
+#include "BenchmarkUtils.h"
+#include "Error.h"
+#include "Model/PortalFile.h"
+
+#include "kdl/result.h"
+
+#include "vm/polygon.h"
+
+#include <cstdio>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace TrenchBroom::Model
+{
+namespace
+{
+constexpr size_t NumPortals = 250'000;
+
+std::string makePortalFile()
+{
+  auto str = "PRT1\n" + std::to_string(NumPortals) + "\n" + std::to_string(NumPortals)
+             + "\n";
+
+  for (size_t i = 0; i < NumPortals; ++i)
+  {
+    const auto x = std::to_string(float(i % 512) * 16.0f);
+    const auto y = std::to_string(float(i / 512) * 16.0f);
+    str += "4 " + std::to_string(i) + " " + std::to_string(i + 1) + " ";
+    str += "(" + x + " " + y + " 0 ) ";
+    str += "(" + x + " " + y + " 16.5 ) ";
+    str += "(" + x + " -8.25 16.5 ) ";
+    str += "(" + x + " -8.25 0 )\n";
+  }
+
+  return str;
+}
+} // namespace
+
+TEST_CASE("PortalFileBenchmark.loadPortalFile")
+{
+  const auto str = makePortalFile();
+
+  auto portalFile = std::optional<PortalFile>{};
+  timeLambda(
+    [&]() { portalFile = loadPortalFile(std::string_view{str}) | kdl::value(); },
+    "load " + std::to_string(NumPortals) + " portals");
+
+  REQUIRE(portalFile);
+  CHECK(portalFile->portalCount() == NumPortals);
+
+  const auto flatSize = portalFile->vertices().capacity() * sizeof(vm::vec3f)
+                        + portalFile->offsets().capacity() * sizeof(size_t);
+
+  auto polygons = std::vector<vm::polygon3f>{};
+  timeLambda(
+    [&]() { polygons = portalFile->portals(); }, "convert portals to polygons");
+
+  auto polygonSize = polygons.capacity() * sizeof(vm::polygon3f);
+  for (const auto& polygon : polygons)
+  {
+    polygonSize += polygon.vertexCount() * sizeof(vm::vec3f);
+  }
+
+  printf(
+    "Memory used by %zu portals: %zu KiB flat, %zu KiB as polygons\n",
+    NumPortals,
+    flatSize / 1024,
+    polygonSize / 1024);
+}
+
+} // namespace TrenchBroom::Model
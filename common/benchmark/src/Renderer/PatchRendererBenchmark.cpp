@@ -0,0 +1,129 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "../../test/src/Catch2.h"
+#include "Assets/Material.h"
+#include "Assets/Texture.h"
+#include "BenchmarkUtils.h"
+#include "Model/BezierPatch.h"
+#include "Model/EditorContext.h"
+#include "Model/PatchNode.h"
+#include "Renderer/PatchRenderer.h"
+
+#include "kdl/vector_utils.h"
+
+#include <string>
+#include <vector>
+
+namespace TrenchBroom::Renderer
+{
+namespace
+{
+constexpr size_t NumPatches = 8'000;
+constexpr size_t NumMaterials = 64;
+
+/**
+ * Both returned vectors need to be freed with kdl::vec_clear_and_delete
+ */
+std::pair<std::vector<Model::PatchNode*>, std::vector<Assets::Material*>> makePatches()
+{
+  auto materials = std::vector<Assets::Material*>{};
+  for (size_t i = 0; i < NumMaterials; ++i)
+  {
+    auto materialName = "material " + std::to_string(i);
+    auto textureResource = createTextureResource(Assets::Texture{64, 64});
+    materials.push_back(
+      new Assets::Material{std::move(materialName), std::move(textureResource)});
+  }
+
+  auto result = std::vector<Model::PatchNode*>{};
+  for (size_t i = 0; i < NumPatches; ++i)
+  {
+    const auto x = double(i % 100) * 64.0;
+    const auto y = double(i / 100) * 64.0;
+
+    auto points = std::vector<Model::BezierPatch::Point>{};
+    for (size_t row = 0; row < 5; ++row)
+    {
+      for (size_t col = 0; col < 5; ++col)
+      {
+        const auto z = double((row + col) % 2) * 8.0;
+        points.emplace_back(
+          x + double(col) * 16.0, y + double(row) * 16.0, z, double(col), double(row));
+      }
+    }
+
+    auto patch = Model::BezierPatch{5, 5, std::move(points), ""};
+    patch.setMaterial(materials[i % NumMaterials]);
+
+    result.push_back(new Model::PatchNode{std::move(patch)});
+  }
+
+  return {result, materials};
+}
+} // namespace
+
+TEST_CASE("PatchRendererBenchmark.benchPatchRenderer")
+{
+  auto [patches, materials] = makePatches();
+
+  const auto editorContext = Model::EditorContext{};
+  auto r = PatchRenderer{editorContext};
+
+  timeLambda(
+    [&]() {
+      for (auto* patch : patches)
+      {
+        r.addPatch(patch);
+      }
+    },
+    "add " + std::to_string(patches.size()) + " patches to PatchRenderer");
+  timeLambda(
+    [&]() {
+      if (!r.valid())
+      {
+        r.validate();
+      }
+    },
+    "validate after adding " + std::to_string(patches.size())
+      + " patches to PatchRenderer");
+
+  // Tiny change: edit a single patch
+  timeLambda(
+    [&]() {
+      r.invalidatePatch(patches.front());
+      r.validate();
+    },
+    "invalidate and validate one patch");
+
+  // Full rebuild
+  timeLambda(
+    [&]() {
+      r.invalidate();
+      r.validate();
+    },
+    "invalidate and validate all patches");
+
+  r.clear();
+
+  kdl::vec_clear_and_delete(patches);
+  kdl::vec_clear_and_delete(materials);
+}
+
+} // namespace TrenchBroom::Renderer
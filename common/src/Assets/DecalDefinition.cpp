@@ -19,7 +19,6 @@
 
 #include "DecalDefinition.h"
 
-#include "EL/EvaluationContext.h"
 #include "EL/Expressions.h"
 #include "EL/Types.h"
 #include "EL/Value.h"
@@ -89,12 +88,13 @@ void DecalDefinition::append(const DecalDefinition& other)
 
   auto cases = std::vector<EL::Expression>{std::move(m_expression), other.m_expression};
   m_expression = EL::Expression{EL::SwitchExpression{std::move(cases)}, line, column};
+  m_evaluationCache.clear();
 }
 
 DecalSpecification DecalDefinition::decalSpecification(
   const EL::VariableStore& variableStore) const
 {
-  return convertToDecal(m_expression.evaluate(EL::EvaluationContext{variableStore}));
+  return convertToDecal(m_evaluationCache.evaluate(m_expression, variableStore));
 }
 
 DecalSpecification DecalDefinition::defaultDecalSpecification() const
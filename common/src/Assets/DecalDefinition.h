@@ -19,6 +19,7 @@
 
 #pragma once
 
+#include "EL/EvaluationCache.h"
 #include "EL/Expression.h"
 
 #include "kdl/reflection_decl.h"
@@ -46,6 +47,7 @@ class DecalDefinition
 {
 private:
   EL::Expression m_expression;
+  EL::EvaluationCache m_evaluationCache;
 
 public:
   DecalDefinition();
@@ -97,6 +97,12 @@ std::vector<EntityDefinition*> EntityDefinitionManager::definitions() const
     m_definitions, [](const auto& definition) { return definition.get(); });
 }
 
+std::vector<EntityDefinition*> EntityDefinitionManager::findDefinitions(
+  const std::vector<std::string>& patterns) const
+{
+  return m_nameIndex.find_all(patterns);
+}
+
 const std::vector<EntityDefinitionGroup>& EntityDefinitionManager::groups() const
 {
   return m_groups;
@@ -135,12 +141,14 @@ void EntityDefinitionManager::updateCache()
   for (auto& definition : m_definitions)
   {
     m_cache[definition->name()] = definition.get();
+    m_nameIndex.insert(definition->name(), definition.get());
   }
 }
 
 void EntityDefinitionManager::clearCache()
 {
   m_cache.clear();
+  m_nameIndex.clear();
 }
 
 void EntityDefinitionManager::clearGroups()
@@ -21,6 +21,8 @@
 
 #include "Result.h"
 
+#include "kdl/ngram_index.h"
+
 #include <filesystem>
 #include <map>
 #include <string>
@@ -52,6 +54,7 @@ private:
   std::vector<std::unique_ptr<EntityDefinition>> m_definitions;
   std::vector<EntityDefinitionGroup> m_groups;
   Cache m_cache;
+  kdl::ngram_index<EntityDefinition*> m_nameIndex;
 
 public:
   ~EntityDefinitionManager();
@@ -69,6 +72,13 @@ public:
     EntityDefinitionType type, EntityDefinitionSortOrder order) const;
   std::vector<EntityDefinition*> definitions() const;
 
+  /**
+   * Returns the definitions whose names contain each of the given patterns, ignoring
+   * case. The definitions are returned in the order in which they were loaded.
+   */
+  std::vector<EntityDefinition*> findDefinitions(
+    const std::vector<std::string>& patterns) const;
+
   const std::vector<EntityDefinitionGroup>& groups() const;
 
 private:
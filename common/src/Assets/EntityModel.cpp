@@ -25,11 +25,14 @@
 #include "Renderer/MaterialIndexRangeMap.h"
 #include "Renderer/MaterialIndexRangeRenderer.h"
 #include "Renderer/PrimType.h"
+#include "bvh.h"
 
 #include "kdl/reflection_impl.h"
+#include "kdl/string_utils.h"
 #include "kdl/vector_utils.h"
 
 #include "vm/bbox.h"
+#include "vm/bbox_io.h" // IWYU pragma: keep
 #include "vm/forward.h"
 #include "vm/intersection.h"
 
@@ -88,10 +91,15 @@ EntityModelFrame::EntityModelFrame(
   : m_index{index}
   , m_name{std::move(name)}
   , m_bounds{bounds}
-  , m_spacialTree{16.0f}
 {
 }
 
+EntityModelFrame::EntityModelFrame(EntityModelFrame&& other) noexcept = default;
+EntityModelFrame& EntityModelFrame::operator=(EntityModelFrame&& other) noexcept =
+  default;
+
+EntityModelFrame::~EntityModelFrame() = default;
+
 size_t EntityModelFrame::index() const
 {
   return m_index;
@@ -119,19 +127,29 @@ const vm::bbox3f& EntityModelFrame::bounds() const
 
 std::optional<float> EntityModelFrame::intersect(const vm::ray3f& ray) const
 {
-  auto closestDistance = std::optional<float>{};
-
-  const auto candidates = m_spacialTree.find_intersectors(ray);
-  for (const auto triNum : candidates)
+  if (!m_spacialTree)
   {
+    auto triangles = std::vector<std::pair<vm::bbox3f, TriNum>>{};
+    triangles.reserve(m_tris.size() / 3u);
+
+    for (size_t i = 0; i < m_tris.size(); i += 3)
+    {
+      auto bounds = vm::bbox3f::builder{};
+      bounds.add(m_tris[i + 0]);
+      bounds.add(m_tris[i + 1]);
+      bounds.add(m_tris[i + 2]);
+      triangles.emplace_back(bounds.bounds(), i / 3u);
+    }
+
+    m_spacialTree = std::make_unique<SpacialTree>(std::move(triangles));
+  }
+
+  return m_spacialTree->intersect(ray, [&](const auto triNum) {
     const auto& p1 = m_tris[triNum * 3 + 0];
     const auto& p2 = m_tris[triNum * 3 + 1];
     const auto& p3 = m_tris[triNum * 3 + 2];
-    closestDistance =
-      vm::safe_min(closestDistance, vm::intersect_ray_triangle(ray, p1, p2, p3));
-  }
-
-  return closestDistance;
+    return vm::intersect_ray_triangle(ray, p1, p2, p3);
+  });
 }
 
 void EntityModelFrame::addToSpacialTree(
@@ -140,6 +158,8 @@ void EntityModelFrame::addToSpacialTree(
   const size_t index,
   const size_t count)
 {
+  m_spacialTree.reset();
+
   switch (primType)
   {
   case Renderer::PrimType::Points:
@@ -152,19 +172,12 @@ void EntityModelFrame::addToSpacialTree(
     m_tris.reserve(m_tris.size() + count);
     for (size_t i = 0; i < count; i += 3)
     {
-      auto bounds = vm::bbox3f::builder{};
       const auto& p1 = Renderer::getVertexComponent<0>(vertices[index + i + 0]);
       const auto& p2 = Renderer::getVertexComponent<0>(vertices[index + i + 1]);
       const auto& p3 = Renderer::getVertexComponent<0>(vertices[index + i + 2]);
-      bounds.add(p1);
-      bounds.add(p2);
-      bounds.add(p3);
-
-      const auto triIndex = m_tris.size() / 3u;
       m_tris.push_back(p1);
       m_tris.push_back(p2);
       m_tris.push_back(p3);
-      m_spacialTree.insert(bounds.bounds(), triIndex);
     }
     break;
   }
@@ -176,18 +189,11 @@ void EntityModelFrame::addToSpacialTree(
     const auto& p1 = Renderer::getVertexComponent<0>(vertices[index]);
     for (size_t i = 1; i < count - 1; ++i)
     {
-      auto bounds = vm::bbox3f::builder{};
       const auto& p2 = Renderer::getVertexComponent<0>(vertices[index + i]);
       const auto& p3 = Renderer::getVertexComponent<0>(vertices[index + i + 1]);
-      bounds.add(p1);
-      bounds.add(p2);
-      bounds.add(p3);
-
-      const auto triIndex = m_tris.size() / 3u;
       m_tris.push_back(p1);
       m_tris.push_back(p2);
       m_tris.push_back(p3);
-      m_spacialTree.insert(bounds.bounds(), triIndex);
     }
     break;
   }
@@ -198,15 +204,9 @@ void EntityModelFrame::addToSpacialTree(
     m_tris.reserve(m_tris.size() + (count - 2) * 3);
     for (size_t i = 0; i < count - 2; ++i)
     {
-      auto bounds = vm::bbox3f::builder{};
       const auto& p1 = Renderer::getVertexComponent<0>(vertices[index + i + 0]);
       const auto& p2 = Renderer::getVertexComponent<0>(vertices[index + i + 1]);
       const auto& p3 = Renderer::getVertexComponent<0>(vertices[index + i + 2]);
-      bounds.add(p1);
-      bounds.add(p2);
-      bounds.add(p3);
-
-      const auto triIndex = m_tris.size() / 3u;
       if (i % 2 == 0)
       {
         m_tris.push_back(p1);
@@ -219,7 +219,6 @@ void EntityModelFrame::addToSpacialTree(
         m_tris.push_back(p3);
         m_tris.push_back(p2);
       }
-      m_spacialTree.insert(bounds.bounds(), triIndex);
     }
     break;
   }
@@ -227,6 +226,13 @@ void EntityModelFrame::addToSpacialTree(
   }
 }
 
+size_t EntityModelFrame::memoryUsage() const
+{
+  return sizeof(EntityModelFrame) + kdl::str_allocated_size(m_name)
+         + m_tris.capacity() * sizeof(vm::vec3f)
+         + (m_spacialTree ? m_spacialTree->memory_usage() : 0u);
+}
+
 // EntityModelData::Mesh
 
 /**
@@ -266,6 +272,14 @@ public:
     return doBuildRenderer(skin, vertexArray);
   }
 
+  /**
+   * Returns an estimate of the number of bytes used by this mesh.
+   */
+  size_t memoryUsage() const
+  {
+    return m_vertices.capacity() * sizeof(EntityModelVertex) + doGetMemoryUsage();
+  }
+
 private:
   /**
    * Creates and returns the actual mesh renderer
@@ -276,6 +290,11 @@ private:
    */
   virtual std::unique_ptr<Renderer::MaterialIndexRangeRenderer> doBuildRenderer(
     const Material* skin, const Renderer::VertexArray& vertices) const = 0;
+
+  /**
+   * Returns the number of bytes used by this mesh object and its indices.
+   */
+  virtual size_t doGetMemoryUsage() const = 0;
 };
 
 // EntityModelData::IndexedMesh
@@ -321,6 +340,11 @@ private:
     const Renderer::MaterialIndexRangeMap indices(skin, m_indices);
     return std::make_unique<Renderer::MaterialIndexRangeRenderer>(vertices, indices);
   }
+
+  size_t doGetMemoryUsage() const override
+  {
+    return sizeof(EntityModelIndexedMesh) - sizeof(m_indices) + m_indices.memoryUsage();
+  }
 };
 
 // EntityModelMaterialMesh
@@ -366,6 +390,11 @@ private:
   {
     return std::make_unique<Renderer::MaterialIndexRangeRenderer>(vertices, m_indices);
   }
+
+  size_t doGetMemoryUsage() const override
+  {
+    return sizeof(EntityModelMaterialMesh) - sizeof(m_indices) + m_indices.memoryUsage();
+  }
 };
 
 } // namespace
@@ -465,6 +494,26 @@ std::unique_ptr<Renderer::MaterialIndexRangeRenderer> EntityModelSurface::buildR
                               : nullptr;
 }
 
+size_t EntityModelSurface::memoryUsage() const
+{
+  auto result = sizeof(EntityModelSurface) + kdl::str_allocated_size(m_name)
+                + m_meshes.capacity() * sizeof(std::unique_ptr<EntityModelMesh>)
+                + m_skins->memoryUsage();
+  for (const auto& mesh : m_meshes)
+  {
+    if (mesh)
+    {
+      result += mesh->memoryUsage();
+    }
+  }
+  return result;
+}
+
+size_t EntityModelSurface::uploadedTextureSize() const
+{
+  return m_skins->uploadedTextureSize();
+}
+
 // EntityModelData
 
 kdl_reflect_impl(EntityModelData);
@@ -601,6 +650,34 @@ const EntityModelSurface* EntityModelData::surface(const std::string& name) cons
   return it != m_surfaces.end() ? &*it : nullptr;
 }
 
+size_t EntityModelData::memoryUsage() const
+{
+  const auto unusedFrames = m_frames.capacity() - m_frames.size();
+  const auto unusedSurfaces = m_surfaces.capacity() - m_surfaces.size();
+
+  auto result = sizeof(EntityModelData) + unusedFrames * sizeof(EntityModelFrame)
+                + unusedSurfaces * sizeof(EntityModelSurface);
+  for (const auto& frame : m_frames)
+  {
+    result += frame.memoryUsage();
+  }
+  for (const auto& surface : m_surfaces)
+  {
+    result += surface.memoryUsage();
+  }
+  return result;
+}
+
+size_t EntityModelData::uploadedTextureSize() const
+{
+  auto result = size_t(0);
+  for (const auto& surface : m_surfaces)
+  {
+    result += surface.uploadedTextureSize();
+  }
+  return result;
+}
+
 kdl_reflect_impl(EntityModel);
 
 EntityModel::EntityModel(
@@ -630,4 +707,17 @@ const EntityModelDataResource& EntityModel::dataResource() const
   return *m_dataResource;
 }
 
+size_t EntityModel::memoryUsage() const
+{
+  const auto* modelData = data();
+  return sizeof(EntityModel) + kdl::str_allocated_size(m_name)
+         + (modelData ? modelData->memoryUsage() : 0u);
+}
+
+size_t EntityModel::uploadedTextureSize() const
+{
+  const auto* modelData = data();
+  return modelData ? modelData->uploadedTextureSize() : 0u;
+}
+
 } // namespace TrenchBroom::Assets
@@ -21,7 +21,6 @@ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
 
 #include "Assets/EntityModelDataResource.h"
 #include "Assets/EntityModel_Forward.h"
-#include "octree.h"
 
 #include "kdl/reflection_decl.h"
 
@@ -36,7 +35,7 @@ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
 namespace TrenchBroom
 {
 template <typename T, typename U>
-class octree;
+class bvh;
 }
 
 namespace TrenchBroom::Renderer
@@ -95,11 +94,11 @@ private:
   vm::bbox3f m_bounds;
   size_t m_skinOffset = 0;
 
-  // For hit testing
+  // For hit testing, the spacial tree is built when the frame is first picked
   std::vector<vm::vec3f> m_tris;
   using TriNum = size_t;
-  using SpacialTree = octree<float, TriNum>;
-  SpacialTree m_spacialTree;
+  using SpacialTree = bvh<float, TriNum>;
+  mutable std::unique_ptr<SpacialTree> m_spacialTree;
 
   kdl_reflect_decl(EntityModelFrame, m_index, m_name, m_bounds, m_skinOffset);
 
@@ -111,6 +110,11 @@ public:
    */
   explicit EntityModelFrame(size_t index, std::string name, const vm::bbox3f& bounds);
 
+  EntityModelFrame(EntityModelFrame&& other) noexcept;
+  EntityModelFrame& operator=(EntityModelFrame&& other) noexcept;
+
+  ~EntityModelFrame();
+
   /**
    * Returns the index of this frame.
    *
@@ -145,6 +149,9 @@ public:
   /**
    * Intersects this frame with the given ray and returns the point of intersection.
    *
+   * The spacial tree for this frame is built on the first call. This function is not
+   * thread safe.
+   *
    * @param ray the ray to intersect
    * @return the distance to the point of intersection or nullopt if the given ray does
    * not intersect this frame
@@ -152,7 +159,7 @@ public:
   std::optional<float> intersect(const vm::ray3f& ray) const;
 
   /**
-   * Adds the given primitives to the spacial tree for this frame.
+   * Adds the given primitives to the triangles used for hit testing this frame.
    *
    * @param vertices the vertices
    * @param primType the primitive type
@@ -165,6 +172,12 @@ public:
     Renderer::PrimType primType,
     size_t index,
     size_t count);
+
+  /**
+   * Returns an estimate of the number of bytes used by this frame, including its hit
+   * testing data. The estimate does not account for allocator overhead.
+   */
+  size_t memoryUsage() const;
 };
 
 class EntityModelMesh;
@@ -280,6 +293,17 @@ public:
 
   std::unique_ptr<Renderer::MaterialIndexRangeRenderer> buildRenderer(
     size_t skinIndex, size_t frameIndex) const;
+
+  /**
+   * Returns an estimate of the number of bytes of main memory used by this surface,
+   * including its meshes and skins. The estimate does not account for allocator overhead.
+   */
+  size_t memoryUsage() const;
+
+  /**
+   * Returns the number of bytes of skin texture data that were uploaded to the GPU.
+   */
+  size_t uploadedTextureSize() const;
 };
 
 /**
@@ -436,6 +460,18 @@ public:
    * @return the surface with the given name or null if no such surface was found
    */
   const EntityModelSurface* surface(const std::string& name) const;
+
+  /**
+   * Returns an estimate of the number of bytes of main memory used by this model data,
+   * including its frames and surfaces. The estimate does not account for allocator
+   * overhead.
+   */
+  size_t memoryUsage() const;
+
+  /**
+   * Returns the number of bytes of skin texture data that were uploaded to the GPU.
+   */
+  size_t uploadedTextureSize() const;
 };
 
 class EntityModel
@@ -458,6 +494,18 @@ public:
   EntityModelData* data();
 
   const EntityModelDataResource& dataResource() const;
+
+  /**
+   * Returns an estimate of the number of bytes of main memory used by this model, or only
+   * the size of this object if the model data is not loaded.
+   */
+  size_t memoryUsage() const;
+
+  /**
+   * Returns the number of bytes of skin texture data that were uploaded to the GPU, or 0
+   * if the model data is not loaded.
+   */
+  size_t uploadedTextureSize() const;
 };
 
 } // namespace TrenchBroom::Assets
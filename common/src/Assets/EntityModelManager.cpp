@@ -41,8 +41,11 @@
 namespace TrenchBroom::Assets
 {
 EntityModelManager::EntityModelManager(
-  Assets::CreateEntityModelDataResource createResource, Logger& logger)
+  Assets::CreateEntityModelDataResource createResource,
+  std::function<void(const ResourceId&)> prioritizeResource,
+  Logger& logger)
   : m_createResource{std::move(createResource)}
+  , m_prioritizeResource{std::move(prioritizeResource)}
   , m_logger{logger}
 {
 }
@@ -116,6 +119,12 @@ Renderer::MaterialRenderer* EntityModelManager::renderer(
         m_logger.error() << "Failed to construct entity model renderer for " << spec
                          << ", check the skin and frame indices";
       }
+      else if (entityModel->dataResource().needsProcessing())
+      {
+        // A renderer is only requested for entities that are about to be rendered, so
+        // the model data should be loaded before that of any model that is not visible
+        m_prioritizeResource(entityModel->dataResource().id());
+      }
     }
   }
 
@@ -183,6 +192,27 @@ const std::vector<const EntityModel*> EntityModelManager::
          | views::transform(toPointer) | kdl::to_vector();
 }
 
+size_t EntityModelManager::memoryUsage() const
+{
+  auto result = size_t(0);
+  for (const auto& [path, model] : m_models)
+  {
+    result += path.native().capacity() * sizeof(std::filesystem::path::value_type)
+              + model.memoryUsage();
+  }
+  return result;
+}
+
+size_t EntityModelManager::uploadedTextureSize() const
+{
+  auto result = size_t(0);
+  for (const auto& [path, model] : m_models)
+  {
+    result += model.uploadedTextureSize();
+  }
+  return result;
+}
+
 const EntityModel* EntityModelManager::safeGetModel(
   const std::filesystem::path& path) const
 {
@@ -26,6 +26,7 @@
 #include "kdl/path_hash.h"
 
 #include <filesystem>
+#include <functional>
 #include <memory>
 #include <unordered_map>
 #include <unordered_set>
@@ -57,6 +58,7 @@ class EntityModelManager
 {
 private:
   Assets::CreateEntityModelDataResource m_createResource;
+  std::function<void(const ResourceId&)> m_prioritizeResource;
   Logger& m_logger;
 
   const Model::Game* m_game = nullptr;
@@ -74,7 +76,9 @@ private:
 
 public:
   EntityModelManager(
-    Assets::CreateEntityModelDataResource createResource, Logger& logger);
+    Assets::CreateEntityModelDataResource createResource,
+    std::function<void(const ResourceId&)> prioritizeResource,
+    Logger& logger);
   ~EntityModelManager();
 
   void clear();
@@ -90,6 +94,16 @@ public:
   const std::vector<const EntityModel*> findEntityModelsByTextureResourceId(
     const std::vector<ResourceId>& resourceIds) const;
 
+  /**
+   * Returns an estimate of the number of bytes of main memory used by the loaded models.
+   */
+  size_t memoryUsage() const;
+
+  /**
+   * Returns the number of bytes of model skin texture data that were uploaded to the GPU.
+   */
+  size_t uploadedTextureSize() const;
+
 private:
   const EntityModel* safeGetModel(const std::filesystem::path& path) const;
   Result<EntityModel> loadModel(const std::filesystem::path& path) const;
@@ -23,6 +23,7 @@
 #include "Ensure.h"
 
 #include "kdl/reflection_impl.h"
+#include "kdl/string_utils.h"
 #include "kdl/vector_utils.h"
 
 #include <string>
@@ -98,4 +99,31 @@ Material* MaterialCollection::materialByName(const std::string& name)
     const_cast<const MaterialCollection*>(this)->materialByName(name));
 }
 
+size_t MaterialCollection::memoryUsage() const
+{
+  auto result = sizeof(MaterialCollection) + m_materials.capacity() * sizeof(Material);
+  for (const auto& material : m_materials)
+  {
+    result += kdl::str_allocated_size(material.name());
+    if (const auto* texture = material.texture())
+    {
+      result += texture->memoryUsage();
+    }
+  }
+  return result;
+}
+
+size_t MaterialCollection::uploadedTextureSize() const
+{
+  auto result = size_t(0);
+  for (const auto& material : m_materials)
+  {
+    if (const auto* texture = material.texture())
+    {
+      result += texture->uploadedSize();
+    }
+  }
+  return result;
+}
+
 } // namespace TrenchBroom::Assets
@@ -63,6 +63,18 @@ public:
 
   const Material* materialByName(const std::string& name) const;
   Material* materialByName(const std::string& name);
+
+  /**
+   * Returns an estimate of the number of bytes of main memory used by this collection,
+   * including its materials and their textures.
+   */
+  size_t memoryUsage() const;
+
+  /**
+   * Returns the number of bytes of texture data of this collection's materials that were
+   * uploaded to the GPU.
+   */
+  size_t uploadedTextureSize() const;
 };
 
 } // namespace TrenchBroom::Assets
@@ -31,6 +31,7 @@
 #include "kdl/map_utils.h"
 #include "kdl/result.h"
 #include "kdl/string_format.h"
+#include "kdl/string_utils.h"
 #include "kdl/vector_utils.h"
 
 #include <algorithm>
@@ -91,6 +92,7 @@ void MaterialManager::clear()
   m_collections.clear();
   m_materialsByName.clear();
   m_materials.clear();
+  m_materialNameIndex.clear();
 
   // Remove logging because it might fail when the document is already destroyed.
 }
@@ -121,20 +123,65 @@ const std::vector<const Material*>& MaterialManager::materials() const
   return m_materials;
 }
 
+std::vector<const Material*> MaterialManager::findMaterials(
+  const std::vector<std::string>& patterns) const
+{
+  return m_materialNameIndex.find_all(patterns);
+}
+
 const std::vector<MaterialCollection>& MaterialManager::collections() const
 {
   return m_collections;
 }
 
+size_t MaterialManager::memoryUsage() const
+{
+  // every element of an std::unordered_map is stored in a separately allocated node
+  // along with a pointer to the next node and its hash
+  constexpr auto mapNodeOverhead = sizeof(void*) + sizeof(size_t);
+
+  auto result = sizeof(MaterialManager)
+                + m_collections.capacity() * sizeof(MaterialCollection)
+                + m_materialsByName.bucket_count() * sizeof(void*)
+                + m_materialsByName.size()
+                    * (mapNodeOverhead + sizeof(decltype(m_materialsByName)::value_type))
+                + m_materials.capacity() * sizeof(const Material*)
+                + m_materialNameIndex.memory_usage()
+                - sizeof(kdl::ngram_index<const Material*>);
+
+  for (const auto& [name, material] : m_materialsByName)
+  {
+    result += kdl::str_allocated_size(name);
+  }
+  for (const auto& collection : m_collections)
+  {
+    result += collection.memoryUsage() - sizeof(MaterialCollection);
+  }
+  return result;
+}
+
+size_t MaterialManager::uploadedTextureSize() const
+{
+  auto result = size_t(0);
+  for (const auto& collection : m_collections)
+  {
+    result += collection.uploadedTextureSize();
+  }
+  return result;
+}
+
 void MaterialManager::updateMaterials()
 {
   m_materialsByName.clear();
   m_materials.clear();
+  m_materialNameIndex.clear();
 
   for (auto& collection : m_collections)
   {
     for (auto& material : collection.materials())
     {
+      m_materialNameIndex.insert(material.name(), &material);
+
       const auto key = kdl::str_to_lower(material.name());
 
       auto mIt = m_materialsByName.find(key);
@@ -22,6 +22,8 @@
 #include "Assets/MaterialCollection.h"
 #include "Assets/TextureResource.h"
 
+#include "kdl/ngram_index.h"
+
 #include <filesystem>
 #include <string>
 #include <unordered_map>
@@ -56,6 +58,7 @@ private:
 
   std::unordered_map<std::string, Material*> m_materialsByName;
   std::vector<const Material*> m_materials;
+  kdl::ngram_index<const Material*> m_materialNameIndex;
 
 public:
   explicit MaterialManager(Logger& logger);
@@ -82,8 +85,27 @@ public:
     const std::vector<ResourceId>& textureResourceIds) const;
 
   const std::vector<const Material*>& materials() const;
+
+  /**
+   * Returns the materials of all collections whose names contain each of the given
+   * patterns, ignoring case. The materials are returned in collection order.
+   */
+  std::vector<const Material*> findMaterials(
+    const std::vector<std::string>& patterns) const;
+
   const std::vector<MaterialCollection>& collections() const;
 
+  /**
+   * Returns an estimate of the number of bytes of main memory used by this manager,
+   * including all material collections and their textures.
+   */
+  size_t memoryUsage() const;
+
+  /**
+   * Returns the number of bytes of texture data that were uploaded to the GPU.
+   */
+  size_t uploadedTextureSize() const;
+
 private:
   void updateMaterials();
 };
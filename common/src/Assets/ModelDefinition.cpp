@@ -60,6 +60,7 @@ void ModelDefinition::append(ModelDefinition other)
 
   auto cases = std::vector{std::move(m_expression), std::move(other.m_expression)};
   m_expression = EL::Expression{EL::SwitchExpression{std::move(cases)}, line, column};
+  m_evaluationCache.clear();
 }
 
 static std::filesystem::path path(const EL::Value& value)
@@ -108,8 +109,7 @@ static ModelSpecification convertToModel(const EL::Value& value)
 ModelSpecification ModelDefinition::modelSpecification(
   const EL::VariableStore& variableStore) const
 {
-  const auto context = EL::EvaluationContext{variableStore};
-  return convertToModel(m_expression.evaluate(context));
+  return convertToModel(m_evaluationCache.evaluate(m_expression, variableStore));
 }
 
 ModelSpecification ModelDefinition::defaultModelSpecification() const
@@ -172,8 +172,7 @@ vm::vec3 ModelDefinition::scale(
   const EL::VariableStore& variableStore,
   const std::optional<EL::Expression>& defaultScaleExpression) const
 {
-  const auto context = EL::EvaluationContext{variableStore};
-  const auto value = m_expression.evaluate(context);
+  const auto value = m_evaluationCache.evaluate(m_expression, variableStore);
 
   switch (value.type())
   {
@@ -194,6 +193,7 @@ vm::vec3 ModelDefinition::scale(
 
   if (defaultScaleExpression)
   {
+    const auto context = EL::EvaluationContext{variableStore};
     if (const auto scale = convertToScale(defaultScaleExpression->evaluate(context)))
     {
       return *scale;
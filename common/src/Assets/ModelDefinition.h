@@ -20,6 +20,7 @@
 #pragma once
 
 #include "Assets/ModelSpecification.h"
+#include "EL/EvaluationCache.h"
 #include "EL/Expression.h"
 #include "FloatType.h"
 
@@ -46,6 +47,7 @@ class ModelDefinition
 {
 private:
   EL::Expression m_expression;
+  EL::EvaluationCache m_evaluationCache;
 
 public:
   ModelDefinition();
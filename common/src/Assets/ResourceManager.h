@@ -25,8 +25,10 @@
 #include "kdl/reflection_impl.h"
 #include "kdl/vector_utils.h"
 
+#include <algorithm>
 #include <chrono>
 #include <memory>
+#include <unordered_set>
 #include <vector>
 
 namespace TrenchBroom::Assets
@@ -77,6 +79,7 @@ class ResourceManager
 {
 private:
   std::vector<std::unique_ptr<ResourceWrapperBase>> m_resources;
+  std::unordered_set<ResourceId> m_prioritizedResourceIds;
 
 public:
   bool needsProcessing() const
@@ -100,6 +103,16 @@ public:
       std::make_unique<ResourceWrapper<ResourceT>>(std::move(resource)));
   }
 
+  /**
+   * Requests that the resource with the given ID is loaded, uploaded and dropped before
+   * any other resources the next time process is called. Has no effect if no such
+   * resource is managed by this manager.
+   */
+  void prioritize(const ResourceId& resourceId)
+  {
+    m_prioritizedResourceIds.insert(resourceId);
+  }
+
   std::vector<ResourceId> process(
     TaskRunner taskRunner,
     const ProcessContext& processContext,
@@ -112,6 +125,15 @@ public:
       }}
               : std::function{[]() { return true; }};
 
+    if (!m_prioritizedResourceIds.empty())
+    {
+      std::stable_partition(
+        m_resources.begin(), m_resources.end(), [&](const auto& resourceWrapper) {
+          return m_prioritizedResourceIds.contains(resourceWrapper->id());
+        });
+      m_prioritizedResourceIds.clear();
+    }
+
     auto result = std::vector<ResourceId>{};
 
     for (auto it = m_resources.begin(); it != m_resources.end() && checkTimeout();)
@@ -145,6 +145,16 @@ void dropTexture(GLuint textureId)
   glAssert(glDeleteTextures(1, &textureId));
 }
 
+size_t buffersSize(const std::vector<TextureBuffer>& buffers)
+{
+  auto result = size_t(0);
+  for (const auto& buffer : buffers)
+  {
+    result += buffer.size();
+  }
+  return result;
+}
+
 } // namespace
 
 std::ostream& operator<<(std::ostream& lhs, const TextureMask& rhs)
@@ -307,6 +317,10 @@ void Texture::upload(const bool glContextAvailable)
           glContextAvailable ? uploadTexture(
             m_format, m_mask, textureLoadedState.buffers, m_width, m_height)
                              : 0;
+        if (glContextAvailable)
+        {
+          m_uploadedSize = buffersSize(textureLoadedState.buffers);
+        }
         return TextureReadyState{textureId};
       },
       [](TextureReadyState textureReadyState) -> TextureState {
@@ -328,6 +342,7 @@ void Texture::drop(const bool glContextAvailable)
         {
           dropTexture(textureReadyState.textureId);
         }
+        m_uploadedSize = 0;
         return TextureDroppedState{};
       },
       [](TextureDroppedState textureDroppedState) { return textureDroppedState; }),
@@ -349,6 +364,18 @@ const std::vector<TextureBuffer>& Texture::buffersIfLoaded() const
     m_state);
 }
 
+size_t Texture::memoryUsage() const
+{
+  const auto& buffers = buffersIfLoaded();
+  return sizeof(Texture) + buffers.capacity() * sizeof(TextureBuffer)
+         + buffersSize(buffers);
+}
+
+size_t Texture::uploadedSize() const
+{
+  return m_uploadedSize;
+}
+
 
 void Texture::setFilterMode(const int minFilter, const int magFilter) const
 {
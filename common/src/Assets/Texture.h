@@ -96,6 +96,9 @@ private:
 
   mutable TextureState m_state;
 
+  // the number of bytes uploaded to the GPU
+  size_t m_uploadedSize = 0;
+
   kdl_reflect_decl(
     Texture,
     m_width,
@@ -157,6 +160,18 @@ public:
 
   const std::vector<TextureBuffer>& buffersIfLoaded() const;
 
+  /**
+   * Returns the number of bytes of main memory used by this texture, including its
+   * buffers if it has not been uploaded yet.
+   */
+  size_t memoryUsage() const;
+
+  /**
+   * Returns the number of bytes of texture data that were uploaded to the GPU, or 0 if
+   * this texture is not uploaded.
+   */
+  size_t uploadedSize() const;
+
 private:
   void setFilterMode(int minFilter, int magFilter) const;
 };
@@ -0,0 +1,134 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "EvaluationCache.h"
+
+#include "EL/EvaluationContext.h"
+#include "EL/Expression.h"
+#include "EL/Value.h"
+#include "EL/VariableStore.h"
+
+namespace TrenchBroom::EL
+{
+
+EvaluationCache::EvaluationCache()
+  : m_values{MaxEntries}
+{
+}
+
+EvaluationCache::EvaluationCache(const EvaluationCache&)
+  : EvaluationCache{}
+{
+}
+
+EvaluationCache::EvaluationCache(EvaluationCache&&) noexcept
+  : EvaluationCache{}
+{
+}
+
+EvaluationCache::~EvaluationCache() = default;
+
+EvaluationCache& EvaluationCache::operator=(const EvaluationCache& other)
+{
+  if (this != &other)
+  {
+    clear();
+  }
+  return *this;
+}
+
+EvaluationCache& EvaluationCache::operator=(EvaluationCache&& other) noexcept
+{
+  if (this != &other)
+  {
+    clear();
+  }
+  return *this;
+}
+
+Value EvaluationCache::evaluate(
+  const Expression& expression, const VariableStore& variableStore) const
+{
+  auto key = makeKey(expression, variableStore);
+  if (!key)
+  {
+    return expression.evaluate(EvaluationContext{variableStore});
+  }
+
+  {
+    const auto lock = std::lock_guard{m_mutex};
+    if (const auto* value = m_values.find(*key))
+    {
+      return *value;
+    }
+  }
+
+  // evaluate without holding the lock, concurrent evaluations yield the same result
+  auto value = expression.evaluate(EvaluationContext{variableStore});
+
+  const auto lock = std::lock_guard{m_mutex};
+  m_values.insert(std::move(*key), value);
+
+  return value;
+}
+
+void EvaluationCache::clear()
+{
+  const auto lock = std::lock_guard{m_mutex};
+  m_variableNames.reset();
+  m_values.clear();
+}
+
+size_t EvaluationCache::size() const
+{
+  const auto lock = std::lock_guard{m_mutex};
+  return m_values.size();
+}
+
+std::optional<EvaluationCache::Key> EvaluationCache::makeKey(
+  const Expression& expression, const VariableStore& variableStore) const
+{
+  auto variableNames = std::shared_ptr<const std::vector<std::string>>{};
+  {
+    const auto lock = std::lock_guard{m_mutex};
+    if (!m_variableNames)
+    {
+      m_variableNames =
+        std::make_shared<const std::vector<std::string>>(expression.variableNames());
+    }
+    variableNames = m_variableNames;
+  }
+
+  auto key = Key{};
+  key.reserve(variableNames->size());
+
+  for (const auto& variableName : *variableNames)
+  {
+    const auto value = variableStore.value(variableName);
+    if (value.type() != ValueType::String)
+    {
+      return std::nullopt;
+    }
+    key.push_back(value.stringValue());
+  }
+
+  return key;
+}
+
+} // namespace TrenchBroom::EL
@@ -0,0 +1,92 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "EL/EL_Forward.h"
+
+#include "kdl/lru_cache.h"
+
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace TrenchBroom::EL
+{
+
+/**
+ * Memoizes the results of evaluating an expression against variable stores.
+ *
+ * Since expressions are free of side effects, the result of an evaluation only depends on
+ * the values of the variables which the expression references. If all of these values
+ * are strings (which is always the case for entity properties), they are used as the key
+ * to look up a previously computed result. Otherwise, the expression is evaluated
+ * without using the cache.
+ *
+ * The cache holds at most a fixed number of results and evicts the least recently used
+ * one when it is full. It must always be used with the same expression. Copying a cache
+ * yields an empty cache. The cache is thread safe.
+ */
+class EvaluationCache
+{
+public:
+  static constexpr size_t MaxEntries = 4096;
+
+private:
+  using Key = std::vector<std::string>;
+
+  mutable std::mutex m_mutex;
+  mutable std::shared_ptr<const std::vector<std::string>> m_variableNames;
+  mutable kdl::lru_cache<Key, Value> m_values;
+
+public:
+  EvaluationCache();
+  EvaluationCache(const EvaluationCache& other);
+  EvaluationCache(EvaluationCache&& other) noexcept;
+  ~EvaluationCache();
+
+  EvaluationCache& operator=(const EvaluationCache& other);
+  EvaluationCache& operator=(EvaluationCache&& other) noexcept;
+
+  /**
+   * Evaluates the given expression using the given variable store, or returns a cached
+   * result of a previous evaluation with the same variable values.
+   *
+   * @throws EL::Exception if the expression could not be evaluated
+   */
+  Value evaluate(const Expression& expression, const VariableStore& variableStore) const;
+
+  /**
+   * Removes all cached results. Must be called if the expression changes.
+   */
+  void clear();
+
+  /**
+   * Returns the number of cached results.
+   */
+  size_t size() const;
+
+private:
+  std::optional<Key> makeKey(
+    const Expression& expression, const VariableStore& variableStore) const;
+};
+
+} // namespace TrenchBroom::EL
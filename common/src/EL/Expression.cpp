@@ -24,6 +24,8 @@
 #include "Ensure.h"
 #include "Macros.h"
 
+#include "kdl/vector_utils.h"
+
 #include <sstream>
 
 namespace TrenchBroom
@@ -110,6 +112,18 @@ Expression Expression::optimize() const
   return Expression{m_expression->optimize(), m_line, m_column};
 }
 
+std::vector<std::string> Expression::variableNames() const
+{
+  auto result = std::vector<std::string>{};
+  appendVariableNames(result);
+  return kdl::vec_sort_and_remove_duplicates(std::move(result));
+}
+
+void Expression::appendVariableNames(std::vector<std::string>& variableNames) const
+{
+  m_expression->appendVariableNames(variableNames);
+}
+
 size_t Expression::line() const
 {
   return m_line;
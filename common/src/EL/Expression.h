@@ -25,6 +25,7 @@
 #include <iosfwd>
 #include <memory>
 #include <string>
+#include <vector>
 
 namespace TrenchBroom
 {
@@ -65,6 +66,14 @@ public:
   Value evaluate(const EvaluationContext& context) const;
   Expression optimize() const;
 
+  /**
+   * Returns the sorted names of all variables referenced by this expression, without
+   * duplicates. Since expressions have no side effects, the result of evaluating this
+   * expression depends only on the values of these variables.
+   */
+  std::vector<std::string> variableNames() const;
+  void appendVariableNames(std::vector<std::string>& variableNames) const;
+
   size_t line() const;
   size_t column() const;
 
@@ -110,6 +110,8 @@ std::unique_ptr<ExpressionImpl> LiteralExpression::optimize() const
   return std::make_unique<LiteralExpression>(m_value);
 }
 
+void LiteralExpression::appendVariableNames(std::vector<std::string>&) const {}
+
 bool LiteralExpression::operator==(const ExpressionImpl& rhs) const
 {
   return rhs == *this;
@@ -140,6 +142,12 @@ std::unique_ptr<ExpressionImpl> VariableExpression::optimize() const
   return std::make_unique<VariableExpression>(m_variableName);
 }
 
+void VariableExpression::appendVariableNames(
+  std::vector<std::string>& variableNames) const
+{
+  variableNames.push_back(m_variableName);
+}
+
 bool VariableExpression::operator==(const ExpressionImpl& rhs) const
 {
   return rhs == *this;
@@ -212,6 +220,15 @@ std::unique_ptr<ExpressionImpl> ArrayExpression::optimize() const
   return std::make_unique<LiteralExpression>(Value{std::move(values)});
 }
 
+void ArrayExpression::appendVariableNames(
+  std::vector<std::string>& variableNames) const
+{
+  for (const auto& element : m_elements)
+  {
+    element.appendVariableNames(variableNames);
+  }
+}
+
 bool ArrayExpression::operator==(const ExpressionImpl& rhs) const
 {
   return rhs == *this;
@@ -280,6 +297,14 @@ std::unique_ptr<ExpressionImpl> MapExpression::optimize() const
   return std::make_unique<LiteralExpression>(Value{std::move(values)});
 }
 
+void MapExpression::appendVariableNames(std::vector<std::string>& variableNames) const
+{
+  for (const auto& [key, expression] : m_elements)
+  {
+    expression.appendVariableNames(variableNames);
+  }
+}
+
 bool MapExpression::operator==(const ExpressionImpl& rhs) const
 {
   return rhs == *this;
@@ -443,6 +468,12 @@ std::unique_ptr<ExpressionImpl> UnaryExpression::optimize() const
   return std::make_unique<UnaryExpression>(m_operator, std::move(optimizedOperand));
 }
 
+void UnaryExpression::appendVariableNames(
+  std::vector<std::string>& variableNames) const
+{
+  m_operand.appendVariableNames(variableNames);
+}
+
 bool UnaryExpression::operator==(const ExpressionImpl& rhs) const
 {
   return rhs == *this;
@@ -1187,6 +1218,13 @@ size_t BinaryExpression::precedence() const
   };
 }
 
+void BinaryExpression::appendVariableNames(
+  std::vector<std::string>& variableNames) const
+{
+  m_leftOperand.appendVariableNames(variableNames);
+  m_rightOperand.appendVariableNames(variableNames);
+}
+
 bool BinaryExpression::operator==(const ExpressionImpl& rhs) const
 {
   return rhs == *this;
@@ -1315,6 +1353,13 @@ std::unique_ptr<ExpressionImpl> SubscriptExpression::optimize() const
     std::move(optimizedLeftOperand), std::move(optimizedRightOperand));
 }
 
+void SubscriptExpression::appendVariableNames(
+  std::vector<std::string>& variableNames) const
+{
+  m_leftOperand.appendVariableNames(variableNames);
+  m_rightOperand.appendVariableNames(variableNames);
+}
+
 bool SubscriptExpression::operator==(const ExpressionImpl& rhs) const
 {
   return rhs == *this;
@@ -1365,6 +1410,15 @@ std::unique_ptr<ExpressionImpl> SwitchExpression::optimize() const
   return std::make_unique<SwitchExpression>(std::move(optimizedExpressions));
 }
 
+void SwitchExpression::appendVariableNames(
+  std::vector<std::string>& variableNames) const
+{
+  for (const auto& case_ : m_cases)
+  {
+    case_.appendVariableNames(variableNames);
+  }
+}
+
 bool SwitchExpression::operator==(const ExpressionImpl& rhs) const
 {
   return rhs == *this;
@@ -39,6 +39,7 @@ public:
 
   virtual Value evaluate(const EvaluationContext& context) const = 0;
   virtual std::unique_ptr<ExpressionImpl> optimize() const = 0;
+  virtual void appendVariableNames(std::vector<std::string>& variableNames) const = 0;
 
   virtual size_t precedence() const;
 
@@ -70,6 +71,7 @@ public:
 
   Value evaluate(const EvaluationContext& context) const override;
   std::unique_ptr<ExpressionImpl> optimize() const override;
+  void appendVariableNames(std::vector<std::string>& variableNames) const override;
 
   bool operator==(const ExpressionImpl& rhs) const override;
   bool operator==(const LiteralExpression& rhs) const override;
@@ -88,6 +90,7 @@ public:
 
   Value evaluate(const EvaluationContext& context) const override;
   std::unique_ptr<ExpressionImpl> optimize() const override;
+  void appendVariableNames(std::vector<std::string>& variableNames) const override;
 
   bool operator==(const ExpressionImpl& rhs) const override;
   bool operator==(const VariableExpression& rhs) const override;
@@ -106,6 +109,7 @@ public:
 
   Value evaluate(const EvaluationContext& context) const override;
   std::unique_ptr<ExpressionImpl> optimize() const override;
+  void appendVariableNames(std::vector<std::string>& variableNames) const override;
 
   bool operator==(const ExpressionImpl& rhs) const override;
   bool operator==(const ArrayExpression& rhs) const override;
@@ -124,6 +128,7 @@ public:
 
   Value evaluate(const EvaluationContext& context) const override;
   std::unique_ptr<ExpressionImpl> optimize() const override;
+  void appendVariableNames(std::vector<std::string>& variableNames) const override;
 
   bool operator==(const ExpressionImpl& rhs) const override;
   bool operator==(const MapExpression& rhs) const override;
@@ -152,6 +157,7 @@ public:
 
   Value evaluate(const EvaluationContext& context) const override;
   std::unique_ptr<ExpressionImpl> optimize() const override;
+  void appendVariableNames(std::vector<std::string>& variableNames) const override;
 
   bool operator==(const ExpressionImpl& rhs) const override;
   bool operator==(const UnaryExpression& rhs) const override;
@@ -204,6 +210,7 @@ public:
 
   Value evaluate(const EvaluationContext& context) const override;
   std::unique_ptr<ExpressionImpl> optimize() const override;
+  void appendVariableNames(std::vector<std::string>& variableNames) const override;
 
   size_t precedence() const override;
 
@@ -228,6 +235,7 @@ public:
 
   Value evaluate(const EvaluationContext& context) const override;
   std::unique_ptr<ExpressionImpl> optimize() const override;
+  void appendVariableNames(std::vector<std::string>& variableNames) const override;
 
   bool operator==(const ExpressionImpl& rhs) const override;
   bool operator==(const SubscriptExpression& rhs) const override;
@@ -246,6 +254,7 @@ public:
 
   Value evaluate(const EvaluationContext& context) const override;
   std::unique_ptr<ExpressionImpl> optimize() const override;
+  void appendVariableNames(std::vector<std::string>& variableNames) const override;
 
   bool operator==(const ExpressionImpl& rhs) const override;
   bool operator==(const SwitchExpression& rhs) const override;
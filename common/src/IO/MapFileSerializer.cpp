@@ -30,6 +30,7 @@
 #include "Model/GroupNode.h"
 #include "Model/LayerNode.h"
 #include "Model/PatchNode.h"
+#include "Model/SerializedText.h"
 #include "Model/WorldNode.h"
 
 #include "kdl/overload.h"
@@ -39,7 +40,7 @@
 
 #include <fmt/format.h>
 
-#include <iterator> // for std::ostreambuf_iterator
+#include <iterator> // for std::back_inserter, std::ostreambuf_iterator
 #include <memory>
 #include <sstream>
 #include <utility>
@@ -53,8 +54,8 @@ namespace IO
 class QuakeFileSerializer : public MapFileSerializer
 {
 public:
-  explicit QuakeFileSerializer(std::ostream& stream)
-    : MapFileSerializer(stream)
+  QuakeFileSerializer(const Model::MapFormat format, std::ostream& stream)
+    : MapFileSerializer(format, stream)
   {
   }
 
@@ -147,8 +148,8 @@ protected:
 class Quake2FileSerializer : public QuakeFileSerializer
 {
 public:
-  explicit Quake2FileSerializer(std::ostream& stream)
-    : QuakeFileSerializer(stream)
+  Quake2FileSerializer(const Model::MapFormat format, std::ostream& stream)
+    : QuakeFileSerializer(format, stream)
   {
   }
 
@@ -181,8 +182,8 @@ protected:
 class Quake2ValveFileSerializer : public Quake2FileSerializer
 {
 public:
-  explicit Quake2ValveFileSerializer(std::ostream& stream)
-    : Quake2FileSerializer(stream)
+  Quake2ValveFileSerializer(const Model::MapFormat format, std::ostream& stream)
+    : Quake2FileSerializer(format, stream)
   {
   }
 
@@ -207,8 +208,8 @@ private:
   std::string SurfaceColorFormat;
 
 public:
-  explicit DaikatanaFileSerializer(std::ostream& stream)
-    : Quake2FileSerializer(stream)
+  DaikatanaFileSerializer(const Model::MapFormat format, std::ostream& stream)
+    : Quake2FileSerializer(format, stream)
     , SurfaceColorFormat(" %d %d %d")
   {
   }
@@ -246,8 +247,8 @@ protected:
 class Hexen2FileSerializer : public QuakeFileSerializer
 {
 public:
-  explicit Hexen2FileSerializer(std::ostream& stream)
-    : QuakeFileSerializer(stream)
+  Hexen2FileSerializer(const Model::MapFormat format, std::ostream& stream)
+    : QuakeFileSerializer(format, stream)
   {
   }
 
@@ -264,8 +265,8 @@ private:
 class ValveFileSerializer : public QuakeFileSerializer
 {
 public:
-  explicit ValveFileSerializer(std::ostream& stream)
-    : QuakeFileSerializer(stream)
+  ValveFileSerializer(const Model::MapFormat format, std::ostream& stream)
+    : QuakeFileSerializer(format, stream)
   {
   }
 
@@ -284,38 +285,62 @@ std::unique_ptr<NodeSerializer> MapFileSerializer::create(
   switch (format)
   {
   case Model::MapFormat::Standard:
-    return std::make_unique<QuakeFileSerializer>(stream);
+    return std::make_unique<QuakeFileSerializer>(format, stream);
   case Model::MapFormat::Quake2:
     // TODO 2427: Implement Quake3 serializers and use them
   case Model::MapFormat::Quake3:
   case Model::MapFormat::Quake3_Legacy:
-    return std::make_unique<Quake2FileSerializer>(stream);
+    return std::make_unique<Quake2FileSerializer>(format, stream);
   case Model::MapFormat::Quake2_Valve:
   case Model::MapFormat::Quake3_Valve:
-    return std::make_unique<Quake2ValveFileSerializer>(stream);
+    return std::make_unique<Quake2ValveFileSerializer>(format, stream);
   case Model::MapFormat::Daikatana:
-    return std::make_unique<DaikatanaFileSerializer>(stream);
+    return std::make_unique<DaikatanaFileSerializer>(format, stream);
   case Model::MapFormat::Valve:
-    return std::make_unique<ValveFileSerializer>(stream);
+    return std::make_unique<ValveFileSerializer>(format, stream);
   case Model::MapFormat::Hexen2:
-    return std::make_unique<Hexen2FileSerializer>(stream);
+    return std::make_unique<Hexen2FileSerializer>(format, stream);
   case Model::MapFormat::Unknown:
     throw FileFormatException("Unknown map file format");
     switchDefault();
   }
 }
 
-MapFileSerializer::MapFileSerializer(std::ostream& stream)
+namespace
+{
+// the size at which buffered output is written to the stream
+constexpr auto FlushSize = size_t(1024u * 1024u);
+
+template <typename NodeT>
+bool hasSerializedText(const NodeT& node, const Model::MapFormat format)
+{
+  const auto serializedText = node.serializedText();
+  return serializedText && serializedText->format == format;
+}
+
+template <typename NodeT>
+std::shared_ptr<const Model::SerializedText> getSerializedText(
+  const NodeT& node, const Model::MapFormat format)
+{
+  auto serializedText = node.serializedText();
+  ensure(
+    serializedText && serializedText->format == format,
+    "attempted to serialize a node which was not passed to doBeginFile");
+  return serializedText;
+}
+
+} // namespace
+
+MapFileSerializer::MapFileSerializer(const Model::MapFormat format, std::ostream& stream)
   : m_line(1)
   , m_stream(stream)
+  , m_format(format)
 {
 }
 
 void MapFileSerializer::doBeginFile(const std::vector<const Model::Node*>& rootNodes)
 {
-  ensure(m_nodeToPrecomputedString.empty(), "MapFileSerializer may not be reused");
-
-  // collect nodes
+  // collect nodes that have changed since they were last serialized in this format
   std::vector<std::variant<const Model::BrushNode*, const Model::PatchNode*>>
     nodesToSerialize;
   nodesToSerialize.reserve(rootNodes.size());
@@ -335,53 +360,61 @@ void MapFileSerializer::doBeginFile(const std::vector<const Model::Node*>& rootN
       [](auto&& thisLambda, const Model::EntityNode* entity) {
         entity->visitChildren(thisLambda);
       },
-      [&](const Model::BrushNode* brush) { nodesToSerialize.push_back(brush); },
-      [&](const Model::PatchNode* patchNode) { nodesToSerialize.push_back(patchNode); }));
-
-  // serialize brushes to strings in parallel
-  using Entry = std::pair<const Model::Node*, PrecomputedString>;
-  std::vector<Entry> result =
-    kdl::vec_parallel_transform(std::move(nodesToSerialize), [&](const auto& node) {
-      return std::visit(
-        kdl::overload(
-          [&](const Model::BrushNode* brushNode) {
-            return Entry{brushNode, writeBrushFaces(brushNode->brush())};
-          },
-          [&](const Model::PatchNode* patchNode) {
-            return Entry{patchNode, writePatch(patchNode->patch())};
-          }),
-        node);
-    });
-
-  // move strings into a map
-  for (auto& entry : result)
-  {
-    m_nodeToPrecomputedString.insert(std::move(entry));
-  }
+      [&](const Model::BrushNode* brush) {
+        if (!hasSerializedText(*brush, m_format))
+        {
+          nodesToSerialize.push_back(brush);
+        }
+      },
+      [&](const Model::PatchNode* patchNode) {
+        if (!hasSerializedText(*patchNode, m_format))
+        {
+          nodesToSerialize.push_back(patchNode);
+        }
+      }));
+
+  // serialize brushes to strings in parallel, each task only touches its own node
+  kdl::parallel_for(nodesToSerialize.size(), [&](const size_t i) {
+    std::visit(
+      kdl::overload(
+        [&](const Model::BrushNode* brushNode) {
+          brushNode->setSerializedText(std::make_shared<const Model::SerializedText>(
+            writeBrushFaces(brushNode->brush())));
+        },
+        [&](const Model::PatchNode* patchNode) {
+          patchNode->setSerializedText(std::make_shared<const Model::SerializedText>(
+            writePatch(patchNode->patch())));
+        }),
+      nodesToSerialize[i]);
+  });
 }
 
-void MapFileSerializer::doEndFile() {}
+void MapFileSerializer::doEndFile()
+{
+  flush();
+}
 
 void MapFileSerializer::doBeginEntity(const Model::Node* /* node */)
 {
-  fmt::format_to(std::ostreambuf_iterator<char>(m_stream), "// entity {}\n", entityNo());
+  fmt::format_to(std::back_inserter(m_buffer), "// entity {}\n", entityNo());
   ++m_line;
   m_startLineStack.push_back(m_line);
-  fmt::format_to(std::ostreambuf_iterator<char>(m_stream), "{{\n");
+  fmt::format_to(std::back_inserter(m_buffer), "{{\n");
   ++m_line;
 }
 
 void MapFileSerializer::doEndEntity(const Model::Node* node)
 {
-  fmt::format_to(std::ostreambuf_iterator<char>(m_stream), "}}\n");
+  fmt::format_to(std::back_inserter(m_buffer), "}}\n");
   ++m_line;
   setFilePosition(node);
+  flush(FlushSize);
 }
 
 void MapFileSerializer::doEntityProperty(const Model::EntityProperty& attribute)
 {
   fmt::format_to(
-    std::ostreambuf_iterator<char>(m_stream),
+    std::back_inserter(m_buffer),
     "\"{}\" \"{}\"\n",
     escapeEntityProperties(attribute.key()),
     escapeEntityProperties(attribute.value()));
@@ -390,29 +423,27 @@ void MapFileSerializer::doEntityProperty(const Model::EntityProperty& attribute)
 
 void MapFileSerializer::doBrush(const Model::BrushNode* brush)
 {
-  fmt::format_to(std::ostreambuf_iterator<char>(m_stream), "// brush {}\n", brushNo());
+  fmt::format_to(std::back_inserter(m_buffer), "// brush {}\n", brushNo());
   ++m_line;
   m_startLineStack.push_back(m_line);
-  fmt::format_to(std::ostreambuf_iterator<char>(m_stream), "{{\n");
+  fmt::format_to(std::back_inserter(m_buffer), "{{\n");
   ++m_line;
 
   // write pre-serialized brush faces
-  auto it = m_nodeToPrecomputedString.find(brush);
-  ensure(
-    it != std::end(m_nodeToPrecomputedString),
-    "attempted to serialize a brush which was not passed to doBeginFile");
-  const PrecomputedString& precomputedString = it->second;
-  m_stream << precomputedString.string;
-  m_line += precomputedString.lineCount;
+  const auto serializedText = getSerializedText(*brush, m_format);
+  m_buffer += serializedText->text;
+  m_line += serializedText->lineCount;
 
-  fmt::format_to(std::ostreambuf_iterator<char>(m_stream), "}}\n");
+  fmt::format_to(std::back_inserter(m_buffer), "}}\n");
   ++m_line;
   setFilePosition(brush);
+  flush(FlushSize);
 }
 
 void MapFileSerializer::doBrushFace(const Model::BrushFace& face)
 {
   const size_t lines = 1u;
+  flush();
   doWriteBrushFace(m_stream, face);
   face.setFilePosition(m_line, lines);
   m_line += lines;
@@ -420,20 +451,26 @@ void MapFileSerializer::doBrushFace(const Model::BrushFace& face)
 
 void MapFileSerializer::doPatch(const Model::PatchNode* patchNode)
 {
-  fmt::format_to(std::ostreambuf_iterator<char>(m_stream), "// brush {}\n", brushNo());
+  fmt::format_to(std::back_inserter(m_buffer), "// brush {}\n", brushNo());
   ++m_line;
   m_startLineStack.push_back(m_line);
 
   // write pre-serialized patch
-  auto it = m_nodeToPrecomputedString.find(patchNode);
-  ensure(
-    it != std::end(m_nodeToPrecomputedString),
-    "attempted to serialize a patch which was not passed to doBeginFile");
-  const PrecomputedString& precomputedString = it->second;
-  m_stream << precomputedString.string;
-  m_line += precomputedString.lineCount;
+  const auto serializedText = getSerializedText(*patchNode, m_format);
+  m_buffer += serializedText->text;
+  m_line += serializedText->lineCount;
 
   setFilePosition(patchNode);
+  flush(FlushSize);
+}
+
+void MapFileSerializer::flush(const size_t minSize)
+{
+  if (!m_buffer.empty() && m_buffer.size() >= minSize)
+  {
+    m_stream.write(m_buffer.data(), std::streamsize(m_buffer.size()));
+    m_buffer.clear();
+  }
 }
 
 void MapFileSerializer::setFilePosition(const Model::Node* node)
@@ -453,7 +490,7 @@ size_t MapFileSerializer::startLine()
 /**
  * Threadsafe
  */
-MapFileSerializer::PrecomputedString MapFileSerializer::writeBrushFaces(
+Model::SerializedText MapFileSerializer::writeBrushFaces(
   const Model::Brush& brush) const
 {
   std::stringstream stream;
@@ -461,10 +498,10 @@ MapFileSerializer::PrecomputedString MapFileSerializer::writeBrushFaces(
   {
     doWriteBrushFace(stream, face);
   }
-  return PrecomputedString{stream.str(), brush.faces().size()};
+  return Model::SerializedText{m_format, stream.str(), brush.faces().size()};
 }
 
-MapFileSerializer::PrecomputedString MapFileSerializer::writePatch(
+Model::SerializedText MapFileSerializer::writePatch(
   const Model::BezierPatch& patch) const
 {
   size_t lineCount = 0u;
@@ -513,7 +550,7 @@ MapFileSerializer::PrecomputedString MapFileSerializer::writePatch(
   fmt::format_to(std::ostreambuf_iterator<char>(stream), "}}\n");
   ++lineCount;
 
-  return PrecomputedString{stream.str(), lineCount};
+  return Model::SerializedText{m_format, stream.str(), lineCount};
 }
 } // namespace IO
 } // namespace TrenchBroom
@@ -24,6 +24,7 @@
 
 #include <iosfwd>
 #include <memory>
+#include <string>
 #include <vector>
 
 namespace TrenchBroom
@@ -37,6 +38,7 @@ class BrushFace;
 class EntityProperty;
 class Node;
 class PatchNode;
+struct SerializedText;
 } // namespace Model
 
 namespace IO
@@ -48,20 +50,20 @@ private:
   LineStack m_startLineStack;
   size_t m_line;
   std::ostream& m_stream;
+  Model::MapFormat m_format;
 
-  struct PrecomputedString
-  {
-    std::string string;
-    size_t lineCount;
-  };
-  std::unordered_map<const Model::Node*, PrecomputedString> m_nodeToPrecomputedString;
+  /**
+   * Output is collected here and written to the stream in large chunks to avoid many
+   * small writes.
+   */
+  std::string m_buffer;
 
 public:
   static std::unique_ptr<NodeSerializer> create(
     Model::MapFormat format, std::ostream& stream);
 
 protected:
-  explicit MapFileSerializer(std::ostream& stream);
+  MapFileSerializer(Model::MapFormat format, std::ostream& stream);
 
 private:
   void doBeginFile(const std::vector<const Model::Node*>& rootNodes) override;
@@ -76,14 +78,16 @@ private:
   void doPatch(const Model::PatchNode* patchNode) override;
 
 private:
+  void flush(size_t minSize = 0u);
+
   void setFilePosition(const Model::Node* node);
   size_t startLine();
 
 private: // threadsafe
   virtual void doWriteBrushFace(
     std::ostream& stream, const Model::BrushFace& face) const = 0;
-  PrecomputedString writeBrushFaces(const Model::Brush& brush) const;
-  PrecomputedString writePatch(const Model::BezierPatch& patch) const;
+  Model::SerializedText writeBrushFaces(const Model::Brush& brush) const;
+  Model::SerializedText writePatch(const Model::BezierPatch& patch) const;
 };
 } // namespace IO
 } // namespace TrenchBroom
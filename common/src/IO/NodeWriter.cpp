@@ -29,6 +29,7 @@
 #include "Model/Node.h"
 #include "Model/PatchNode.h"
 #include "Model/WorldNode.h"
+#include "Profiler.h"
 
 #include "kdl/overload.h"
 #include "kdl/string_format.h"
@@ -106,6 +107,8 @@ void NodeWriter::setExporting(const bool exporting)
 
 void NodeWriter::writeMap()
 {
+  profileZone("IO", "Write map");
+
   m_serializer->beginFile({&m_world});
   writeDefaultLayer();
   writeCustomLayers();
@@ -29,103 +29,323 @@
 #include "Model/Polyhedron.h"
 
 #include "kdl/overload.h"
+#include "kdl/parallel.h"
+
+#include "vm/vec.h"
 
 #include <fmt/format.h>
 
+#include <algorithm>
+#include <array>
+#include <functional>
 #include <iostream>
+#include <iterator>
+#include <map>
+#include <unordered_map>
 #include <utility>
 
 namespace TrenchBroom::IO
 {
+namespace
+{
 
-std::ostream& operator<<(std::ostream& str, const ObjSerializer::IndexedVertex& vertex)
+/**
+ * Hashes vectors such that vectors which are equal according to vm::operator== have
+ * equal hashes. In particular, -0 and +0 are equal, and so are all NaNs.
+ */
+struct VecHash
 {
-  str << " " << (vertex.vertex + 1u) << "/" << (vertex.uvCoords + 1u) << "/"
-      << (vertex.normal + 1u);
-  return str;
-}
+  template <typename T, size_t S>
+  size_t operator()(const vm::vec<T, S>& v) const
+  {
+    auto result = size_t(0);
+    for (size_t i = 0; i < S; ++i)
+    {
+      const auto c = v[i] != v[i] ? T(0) : v[i] + T(0);
+      result ^= std::hash<T>{}(c) + 0x9e3779b9 + (result << 6) + (result >> 2);
+    }
+    return result;
+  }
+};
 
-std::ostream& operator<<(std::ostream& str, const ObjSerializer::BrushObject& object)
+/**
+ * Assigns an index to every distinct value in the order in which the values are first
+ * inserted. Most objects have only a few distinct values, so small lists are searched
+ * linearly and a hash map is only built once the list grows.
+ */
+template <typename V>
+class IndexMap
 {
-  str << "o entity" << object.entityNo << "_brush" << object.brushNo << "\n";
-  for (const auto& face : object.faces)
+private:
+  static constexpr size_t MaxLinearSearchSize = 32;
+
+  std::vector<V> m_list;
+  std::unordered_map<V, size_t, VecHash> m_map;
+
+public:
+  const std::vector<V>& list() const { return m_list; }
+
+  size_t index(const V& v)
   {
-    str << "usemtl " << face.materialName << "\n";
-    str << "f";
-    for (const auto& vertex : face.verts)
+    if (m_list.size() < MaxLinearSearchSize)
     {
-      str << " " << vertex;
+      const auto it = std::find(m_list.begin(), m_list.end(), v);
+      if (it != m_list.end())
+      {
+        return static_cast<size_t>(std::distance(m_list.begin(), it));
+      }
+
+      m_list.push_back(v);
+      if (m_list.size() == MaxLinearSearchSize)
+      {
+        for (size_t i = 0; i < m_list.size(); ++i)
+        {
+          m_map.emplace(m_list[i], i);
+        }
+      }
+      return m_list.size() - 1u;
     }
-    str << "\n";
+
+    const auto [it, inserted] = m_map.try_emplace(v, m_list.size());
+    if (inserted)
+    {
+      m_list.push_back(v);
+    }
+    return it->second;
   }
-  return str;
-}
+};
+
+struct IndexedVertex
+{
+  size_t vertex;
+  size_t uvCoords;
+  size_t normal;
+};
 
-std::ostream& operator<<(std::ostream& str, const ObjSerializer::PatchObject& object)
+struct BrushObjectFace
 {
-  str << "o entity" << object.entityNo << "_patch" << object.patchNo << "\n";
-  str << "usemtl " << object.materialName << "\n";
-  for (const auto& quad : object.quads)
+  std::vector<IndexedVertex> verts;
+  const std::string* materialName;
+  const Assets::Material* material;
+};
+
+struct BrushObject
+{
+  size_t entityNo;
+  size_t brushNo;
+  std::vector<BrushObjectFace> faces;
+};
+
+struct PatchQuad
+{
+  std::array<IndexedVertex, 4u> verts;
+};
+
+struct PatchObject
+{
+  size_t entityNo;
+  size_t patchNo;
+  std::vector<PatchQuad> quads;
+  const std::string* materialName;
+  const Assets::Material* material;
+};
+
+using Object = std::variant<BrushObject, PatchObject>;
+
+/**
+ * The geometry of a single brush or patch. The indices of the object's vertices refer to
+ * the lists of this object.
+ */
+struct ObjectGeometry
+{
+  Object object;
+  IndexMap<vm::vec3> vertices;
+  IndexMap<vm::vec2f> uvCoords;
+  IndexMap<vm::vec3> normals;
+};
+
+ObjectGeometry gatherBrushGeometry(
+  const Model::BrushNode& brushNode, const size_t entityNo, const size_t brushNo)
+{
+  auto result = ObjectGeometry{BrushObject{entityNo, brushNo, {}}, {}, {}, {}};
+  auto& brushObject = std::get<BrushObject>(result.object);
+
+  const auto& brush = brushNode.brush();
+  brushObject.faces.reserve(brush.faceCount());
+
+  for (const auto& face : brush.faces())
   {
-    str << "f";
-    for (const auto& vertex : quad.verts)
+    const auto normalIndex = result.normals.index(face.boundary().normal);
+
+    auto indexedVertices = std::vector<IndexedVertex>{};
+    indexedVertices.reserve(face.vertexCount());
+
+    for (const auto* vertex : face.vertices())
     {
-      str << " " << vertex;
+      const auto& position = vertex->position();
+      const auto vertexIndex = result.vertices.index(position);
+      const auto uvCoordsIndex = result.uvCoords.index(face.uvCoords(position));
+
+      indexedVertices.push_back(IndexedVertex{vertexIndex, uvCoordsIndex, normalIndex});
     }
-    str << "\n";
+
+    brushObject.faces.push_back(BrushObjectFace{
+      std::move(indexedVertices), &face.attributes().materialName(), face.material()});
   }
-  return str;
+
+  return result;
 }
 
-std::ostream& operator<<(std::ostream& str, const ObjSerializer::Object& object)
+ObjectGeometry gatherPatchGeometry(
+  const Model::PatchNode& patchNode, const size_t entityNo, const size_t patchNo)
 {
-  std::visit(
-    kdl::overload(
-      [&](const ObjSerializer::BrushObject& brushObject) { str << brushObject; },
-      [&](const ObjSerializer::PatchObject& patchObject) { str << patchObject; }),
-    object);
-  return str;
+  const auto& patch = patchNode.patch();
+  auto result = ObjectGeometry{
+    PatchObject{entityNo, patchNo, {}, &patch.materialName(), patch.material()},
+    {},
+    {},
+    {}};
+  auto& patchObject = std::get<PatchObject>(result.object);
+
+  // export at full detail instead of using the node's curvature adaptive grid
+  const auto patchGrid =
+    Model::makePatchGrid(patch, Model::DefaultSubdivisionsPerSurface);
+  patchObject.quads.reserve(patchGrid.quadRowCount() * patchGrid.quadColumnCount());
+
+  const auto makeIndexedVertex = [&](const auto& p) {
+    const auto positionIndex = result.vertices.index(p.position);
+    const auto uvCoordsIndex = result.uvCoords.index(vm::vec2f{p.uvCoords});
+    const auto normalIndex = result.normals.index(p.normal);
+
+    return IndexedVertex{positionIndex, uvCoordsIndex, normalIndex};
+  };
+
+  for (size_t row = 0u; row < patchGrid.pointRowCount - 1u; ++row)
+  {
+    for (size_t col = 0u; col < patchGrid.pointColumnCount - 1u; ++col)
+    {
+      // counter clockwise order
+      patchObject.quads.push_back(PatchQuad{{
+        makeIndexedVertex(patchGrid.point(row, col)),
+        makeIndexedVertex(patchGrid.point(row + 1u, col)),
+        makeIndexedVertex(patchGrid.point(row + 1u, col + 1u)),
+        makeIndexedVertex(patchGrid.point(row, col + 1u)),
+      }});
+    }
+  }
+
+  return result;
 }
 
-ObjSerializer::ObjSerializer(
-  std::ostream& objStream,
-  std::ostream& mtlStream,
-  std::string mtlFilename,
-  IO::ObjExportOptions options)
-  : m_objStream{objStream}
-  , m_mtlStream{mtlStream}
-  , m_mtlFilename{std::move(mtlFilename)}
-  , m_options{std::move(options)}
+/**
+ * Maps the object local indices of the given vertices to file wide indices.
+ */
+template <typename Vertices>
+void remapIndices(
+  Vertices& vertices,
+  const size_t vertexOffset,
+  const std::vector<size_t>& uvCoordsIndices,
+  const std::vector<size_t>& normalIndices)
 {
-  ensure(m_objStream.good(), "obj stream is good");
-  ensure(m_mtlStream.good(), "mtl stream is good");
+  for (auto& vertex : vertices)
+  {
+    vertex.vertex += vertexOffset;
+    vertex.uvCoords = uvCoordsIndices[vertex.uvCoords];
+    vertex.normal = normalIndices[vertex.normal];
+  }
 }
 
-void ObjSerializer::doBeginFile(const std::vector<const Model::Node*>& /* rootNodes */) {}
-
-static void writeMtlFile(
-  std::ostream& str,
-  const std::vector<ObjSerializer::Object>& objects,
-  const IO::ObjExportOptions& options)
+/**
+ * Formats the given values in parallel and writes the results to the given stream in
+ * order. The values are processed in batches so that only the text of one batch is held
+ * in memory at a time.
+ */
+template <typename T, typename F>
+void writeParallel(std::ostream& str, const std::vector<T>& values, const F& format)
 {
-  auto usedMaterials = std::map<std::string, const Assets::Material*>{};
+  constexpr auto ChunkSize = size_t(1024);
+  constexpr auto BatchSize = 64 * ChunkSize;
 
-  for (const auto& object : objects)
+  for (size_t batchStart = 0; batchStart < values.size(); batchStart += BatchSize)
   {
-    std::visit(
-      kdl::overload(
-        [&](const ObjSerializer::BrushObject& brushObject) {
-          for (const auto& face : brushObject.faces)
+    const auto batchEnd = std::min(batchStart + BatchSize, values.size());
+    const auto chunkCount = (batchEnd - batchStart + ChunkSize - 1) / ChunkSize;
+
+    auto buffers = std::vector<std::string>(chunkCount);
+    kdl::parallel_for(chunkCount, [&](const size_t i) {
+      const auto chunkStart = batchStart + i * ChunkSize;
+      const auto chunkEnd = std::min(chunkStart + ChunkSize, batchEnd);
+
+      auto& buffer = buffers[i];
+      for (size_t j = chunkStart; j < chunkEnd; ++j)
+      {
+        format(buffer, values[j]);
+      }
+    });
+
+    for (const auto& buffer : buffers)
+    {
+      str << buffer;
+    }
+  }
+}
+
+void formatIndexedVertex(std::string& buffer, const IndexedVertex& vertex)
+{
+  fmt::format_to(
+    std::back_inserter(buffer),
+    "  {}/{}/{}",
+    vertex.vertex + 1u,
+    vertex.uvCoords + 1u,
+    vertex.normal + 1u);
+}
+
+void formatObject(std::string& buffer, const Object& object)
+{
+  std::visit(
+    kdl::overload(
+      [&](const BrushObject& brushObject) {
+        fmt::format_to(
+          std::back_inserter(buffer),
+          "o entity{}_brush{}\n",
+          brushObject.entityNo,
+          brushObject.brushNo);
+        for (const auto& face : brushObject.faces)
+        {
+          fmt::format_to(std::back_inserter(buffer), "usemtl {}\nf", *face.materialName);
+          for (const auto& vertex : face.verts)
           {
-            usedMaterials[face.materialName] = face.material;
+            formatIndexedVertex(buffer, vertex);
           }
-        },
-        [&](const ObjSerializer::PatchObject& patchObject) {
-          usedMaterials[patchObject.materialName] = patchObject.material;
-        }),
-      object);
-  }
+          buffer += "\n";
+        }
+      },
+      [&](const PatchObject& patchObject) {
+        fmt::format_to(
+          std::back_inserter(buffer),
+          "o entity{}_patch{}\nusemtl {}\n",
+          patchObject.entityNo,
+          patchObject.patchNo,
+          *patchObject.materialName);
+        for (const auto& quad : patchObject.quads)
+        {
+          buffer += "f";
+          for (const auto& vertex : quad.verts)
+          {
+            formatIndexedVertex(buffer, vertex);
+          }
+          buffer += "\n";
+        }
+      }),
+    object);
+  buffer += "\n";
+}
 
+void writeMtlFile(
+  std::ostream& str,
+  const std::map<std::string, const Assets::Material*>& usedMaterials,
+  const IO::ObjExportOptions& options)
+{
   const auto basePath = options.exportPath.parent_path();
   for (const auto& [materialName, material] : usedMaterials)
   {
@@ -151,159 +371,153 @@ static void writeMtlFile(
   }
 }
 
-static void writeVertices(std::ostream& str, const std::vector<vm::vec3>& vertices)
+void writeObjFile(
+  std::ostream& str,
+  const std::string& mtlFilename,
+  const std::vector<vm::vec3>& vertices,
+  const std::vector<vm::vec2f>& uvCoords,
+  const std::vector<vm::vec3>& normals,
+  const std::vector<Object>& objects)
 {
+  str << "mtllib " << mtlFilename << "\n";
+
   str << "# vertices\n";
-  for (const auto& elem : vertices)
-  {
+  writeParallel(str, vertices, [](auto& buffer, const auto& vertex) {
     // no idea why I have to switch Y and Z
     fmt::format_to(
-      std::ostreambuf_iterator<char>(str), "v {} {} {}\n", elem.x(), elem.z(), -elem.y());
-  }
-}
+      std::back_inserter(buffer), "v {} {} {}\n", vertex.x(), vertex.z(), -vertex.y());
+  });
+  str << "\n";
 
-static void writeUVCoords(std::ostream& str, const std::vector<vm::vec2f>& uvCoords)
-{
   str << "# texture coordinates\n";
-  for (const auto& elem : uvCoords)
-  {
+  writeParallel(str, uvCoords, [](auto& buffer, const auto& uv) {
     // multiplying Y by -1 needed to get the UV's to appear correct in Blender and UE4
     // (see: https://github.com/TrenchBroom/TrenchBroom/issues/2851 )
-    fmt::format_to(
-      std::ostreambuf_iterator<char>(str), "vt {} {}\n", elem.x(), -elem.y());
-  }
-}
+    fmt::format_to(std::back_inserter(buffer), "vt {} {}\n", uv.x(), -uv.y());
+  });
+  str << "\n";
 
-static void writeNormals(std::ostream& str, const std::vector<vm::vec3>& normals)
-{
   str << "# normals\n";
-  for (const auto& elem : normals)
-  {
+  writeParallel(str, normals, [](auto& buffer, const auto& normal) {
     // no idea why I have to switch Y and Z
     fmt::format_to(
-      std::ostreambuf_iterator<char>(str),
-      "vn {} {} {}\n",
-      elem.x(),
-      elem.z(),
-      -elem.y());
-  }
-}
-
-static void writeObjFile(
-  std::ostream& str,
-  const std::string mtlFilename,
-  const std::vector<vm::vec3>& vertices,
-  const std::vector<vm::vec2f>& uvCoords,
-  const std::vector<vm::vec3>& normals,
-  const std::vector<ObjSerializer::Object>& objects)
-{
-
-  str << "mtllib " << mtlFilename << "\n";
-  writeVertices(str, vertices);
-  str << "\n";
-  writeUVCoords(str, uvCoords);
-  str << "\n";
-  writeNormals(str, normals);
+      std::back_inserter(buffer), "vn {} {} {}\n", normal.x(), normal.z(), -normal.y());
+  });
   str << "\n";
 
-  for (const auto& object : objects)
-  {
-    str << object;
-    str << "\n";
-  }
+  writeParallel(str, objects, formatObject);
 }
 
-void ObjSerializer::doEndFile()
+} // namespace
+
+ObjSerializer::ObjSerializer(
+  std::ostream& objStream,
+  std::ostream& mtlStream,
+  std::string mtlFilename,
+  IO::ObjExportOptions options)
+  : m_objStream{objStream}
+  , m_mtlStream{mtlStream}
+  , m_mtlFilename{std::move(mtlFilename)}
+  , m_options{std::move(options)}
 {
-  writeMtlFile(m_mtlStream, m_objects, m_options);
-  writeObjFile(
-    m_objStream,
-    m_mtlFilename,
-    m_vertices.list(),
-    m_uvCoords.list(),
-    m_normals.list(),
-    m_objects);
+  ensure(m_objStream.good(), "obj stream is good");
+  ensure(m_mtlStream.good(), "mtl stream is good");
 }
 
-void ObjSerializer::doBeginEntity(const Model::Node*) {}
-void ObjSerializer::doEndEntity(const Model::Node*) {}
-void ObjSerializer::doEntityProperty(const Model::EntityProperty&) {}
-
-void ObjSerializer::doBrush(const Model::BrushNode* brush)
+void ObjSerializer::doBeginFile(const std::vector<const Model::Node*>& /* rootNodes */)
 {
-  m_currentBrush = BrushObject{entityNo(), brushNo(), {}};
-  m_currentBrush->faces.reserve(brush->brush().faceCount());
-
-  // Vertex positions inserted from now on should get new indices
-  m_vertices.clearIndices();
-
-  for (const auto& face : brush->brush().faces())
-  {
-    doBrushFace(face);
-  }
-
-  m_objects.emplace_back(std::move(*m_currentBrush));
-  m_currentBrush = std::nullopt;
+  m_objectNodes.clear();
 }
 
-void ObjSerializer::doBrushFace(const Model::BrushFace& face)
+void ObjSerializer::doEndFile()
 {
-  const auto& normal = face.boundary().normal;
-  const auto normalIndex = m_normals.index(normal);
+  // gather the geometry of each node in parallel
+  auto geometries = std::vector<ObjectGeometry>(m_objectNodes.size());
+  kdl::parallel_for(m_objectNodes.size(), [&](const size_t i) {
+    const auto& objectNode = m_objectNodes[i];
+    geometries[i] = std::visit(
+      kdl::overload(
+        [&](const Model::BrushNode* brushNode) {
+          return gatherBrushGeometry(
+            *brushNode, objectNode.entityNo, objectNode.brushNo);
+        },
+        [&](const Model::PatchNode* patchNode) {
+          return gatherPatchGeometry(
+            *patchNode, objectNode.entityNo, objectNode.brushNo);
+        }),
+      objectNode.node);
+  });
+
+  // Merge the geometry in node order. Vertex positions are only shared within an object,
+  // but UV coordinates and normals are shared by all objects.
+  auto vertices = std::vector<vm::vec3>{};
+  auto uvCoords = IndexMap<vm::vec2f>{};
+  auto normals = IndexMap<vm::vec3>{};
+  auto usedMaterials = std::map<std::string, const Assets::Material*>{};
 
-  auto indexedVertices = std::vector<IndexedVertex>{};
-  indexedVertices.reserve(face.vertexCount());
+  auto objects = std::vector<Object>{};
+  objects.reserve(geometries.size());
 
-  for (const auto* vertex : face.vertices())
+  for (auto& geometry : geometries)
   {
-    const auto& position = vertex->position();
-    const auto uvCoords = face.uvCoords(position);
+    const auto vertexOffset = vertices.size();
+    vertices.insert(
+      vertices.end(), geometry.vertices.list().begin(), geometry.vertices.list().end());
 
-    const auto vertexIndex = m_vertices.index(position);
-    const auto uvCoordsIndex = m_uvCoords.index(uvCoords);
-
-    indexedVertices.push_back(IndexedVertex{vertexIndex, uvCoordsIndex, normalIndex});
-  }
+    auto uvCoordsIndices = std::vector<size_t>{};
+    uvCoordsIndices.reserve(geometry.uvCoords.list().size());
+    for (const auto& uv : geometry.uvCoords.list())
+    {
+      uvCoordsIndices.push_back(uvCoords.index(uv));
+    }
 
-  m_currentBrush->faces.emplace_back(BrushFace{
-    std::move(indexedVertices), face.attributes().materialName(), face.material()});
-}
+    auto normalIndices = std::vector<size_t>{};
+    normalIndices.reserve(geometry.normals.list().size());
+    for (const auto& normal : geometry.normals.list())
+    {
+      normalIndices.push_back(normals.index(normal));
+    }
 
-void ObjSerializer::doPatch(const Model::PatchNode* patchNode)
-{
-  const auto& patch = patchNode->patch();
-  auto patchObject =
-    PatchObject{entityNo(), brushNo(), {}, patch.materialName(), patch.material()};
+    std::visit(
+      kdl::overload(
+        [&](BrushObject& brushObject) {
+          for (auto& face : brushObject.faces)
+          {
+            remapIndices(face.verts, vertexOffset, uvCoordsIndices, normalIndices);
+            usedMaterials[*face.materialName] = face.material;
+          }
+        },
+        [&](PatchObject& patchObject) {
+          for (auto& quad : patchObject.quads)
+          {
+            remapIndices(quad.verts, vertexOffset, uvCoordsIndices, normalIndices);
+          }
+          usedMaterials[*patchObject.materialName] = patchObject.material;
+        }),
+      geometry.object);
 
-  const auto& patchGrid = patchNode->grid();
-  patchObject.quads.reserve(patchGrid.quadRowCount() * patchGrid.quadColumnCount());
+    objects.push_back(std::move(geometry.object));
+  }
 
-  // Vertex positions inserted from now on should get new indices
-  m_vertices.clearIndices();
+  writeMtlFile(m_mtlStream, usedMaterials, m_options);
+  writeObjFile(
+    m_objStream, m_mtlFilename, vertices, uvCoords.list(), normals.list(), objects);
+}
 
-  const auto makeIndexedVertex = [&](const auto& p) {
-    const auto positionIndex = m_vertices.index(p.position);
-    const auto uvCoordsIndex = m_uvCoords.index(vm::vec2f{p.uvCoords});
-    const auto normalIndex = m_normals.index(p.normal);
+void ObjSerializer::doBeginEntity(const Model::Node*) {}
+void ObjSerializer::doEndEntity(const Model::Node*) {}
+void ObjSerializer::doEntityProperty(const Model::EntityProperty&) {}
 
-    return IndexedVertex{positionIndex, uvCoordsIndex, normalIndex};
-  };
+void ObjSerializer::doBrush(const Model::BrushNode* brush)
+{
+  m_objectNodes.push_back(ObjectNode{entityNo(), brushNo(), brush});
+}
 
-  for (size_t row = 0u; row < patchGrid.pointRowCount - 1u; ++row)
-  {
-    for (size_t col = 0u; col < patchGrid.pointColumnCount - 1u; ++col)
-    {
-      // counter clockwise order
-      patchObject.quads.push_back(PatchQuad{{
-        makeIndexedVertex(patchGrid.point(row, col)),
-        makeIndexedVertex(patchGrid.point(row + 1u, col)),
-        makeIndexedVertex(patchGrid.point(row + 1u, col + 1u)),
-        makeIndexedVertex(patchGrid.point(row, col + 1u)),
-      }});
-    }
-  }
+void ObjSerializer::doBrushFace(const Model::BrushFace&) {}
 
-  m_objects.emplace_back(std::move(patchObject));
+void ObjSerializer::doPatch(const Model::PatchNode* patchNode)
+{
+  m_objectNodes.push_back(ObjectNode{entityNo(), brushNo(), patchNode});
 }
 
 } // namespace TrenchBroom::IO
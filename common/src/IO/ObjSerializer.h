@@ -19,122 +19,49 @@
 
 #pragma once
 
-#include "FloatType.h"
 #include "IO/ExportOptions.h"
 #include "IO/NodeSerializer.h"
 
-#include "vm/forward.h"
-
-#include <array>
 #include <iosfwd>
-#include <map>
-#include <optional>
 #include <string>
 #include <variant>
 #include <vector>
 
-namespace TrenchBroom::Assets
-{
-class Material;
-}
-
 namespace TrenchBroom::Model
 {
 class BrushNode;
 class BrushFace;
 class EntityProperty;
 class Node;
+class PatchNode;
 } // namespace TrenchBroom::Model
 
 namespace TrenchBroom::IO
 {
+/**
+ * Exports brushes and patches as OBJ and MTL files.
+ *
+ * The nodes are only recorded while the node writer traverses the map. When the file
+ * ends, their geometry is gathered in parallel, merged into the shared vertex, UV
+ * coordinate and normal lists in node order, and the output is formatted in parallel
+ * batches. The output only depends on the exported nodes, not on the number of threads.
+ */
 class ObjSerializer : public NodeSerializer
 {
-public:
-  template <typename V>
-  class IndexMap
-  {
-  private:
-    std::map<V, size_t> m_map;
-    std::vector<V> m_list;
-
-  public:
-    const std::vector<V>& list() const { return m_list; }
-
-    size_t index(const V& v)
-    {
-      const auto it = m_map.emplace(v, m_list.size()).first;
-      const size_t index = it->second;
-      if (index == m_list.size())
-      {
-        m_list.push_back(v);
-      }
-      return index;
-    }
-
-    /**
-     * Values inserted after this is called will not reuse indices from before this
-     * is called.
-     */
-    void clearIndices() { m_map.clear(); }
-  };
-
-  struct IndexedVertex
-  {
-    size_t vertex;
-    size_t uvCoords;
-    size_t normal;
-  };
-
-  struct BrushFace
-  {
-    std::vector<IndexedVertex> verts;
-    std::string materialName;
-    const Assets::Material* material;
-  };
-
-  struct BrushObject
+private:
+  struct ObjectNode
   {
     size_t entityNo;
     size_t brushNo;
-    std::vector<BrushFace> faces;
+    std::variant<const Model::BrushNode*, const Model::PatchNode*> node;
   };
 
-  struct PatchQuad
-  {
-    std::array<IndexedVertex, 4u> verts;
-  };
-
-  struct PatchObject
-  {
-    size_t entityNo;
-    size_t patchNo;
-    std::vector<PatchQuad> quads;
-    std::string materialName;
-    const Assets::Material* material;
-  };
-
-  using Object = std::variant<BrushObject, PatchObject>;
-
-  friend std::ostream& operator<<(std::ostream& str, const IndexedVertex& vertex);
-  friend std::ostream& operator<<(std::ostream& str, const BrushFace& face);
-  friend std::ostream& operator<<(std::ostream& str, const BrushObject& object);
-  friend std::ostream& operator<<(std::ostream& str, const PatchQuad& quad);
-  friend std::ostream& operator<<(std::ostream& str, const PatchObject& object);
-  friend std::ostream& operator<<(std::ostream& str, const Object& object);
-
-private:
   std::ostream& m_objStream;
   std::ostream& m_mtlStream;
   std::string m_mtlFilename;
   ObjExportOptions m_options;
 
-  IndexMap<vm::vec3> m_vertices;
-  IndexMap<vm::vec2f> m_uvCoords;
-  IndexMap<vm::vec3> m_normals;
-
-  std::optional<BrushObject> m_currentBrush;
-  std::vector<Object> m_objects;
+  std::vector<ObjectNode> m_objectNodes;
 
 public:
   ObjSerializer(
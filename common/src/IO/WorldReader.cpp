@@ -31,6 +31,7 @@
 #include "Model/ModelUtils.h"
 #include "Model/VisibilityState.h"
 #include "Model/WorldNode.h"
+#include "Profiler.h"
 
 #include "kdl/grouped_range.h"
 #include "kdl/result.h"
@@ -73,9 +74,22 @@ WorldReader::WorldReader(
   std::string_view str,
   const Model::MapFormat sourceAndTargetMapFormat,
   const Model::EntityPropertyConfig& entityPropertyConfig)
-  : MapReader{std::move(str), sourceAndTargetMapFormat, sourceAndTargetMapFormat, entityPropertyConfig}
+  : WorldReader{
+      std::move(str),
+      sourceAndTargetMapFormat,
+      sourceAndTargetMapFormat,
+      entityPropertyConfig}
+{
+}
+
+WorldReader::WorldReader(
+  std::string_view str,
+  const Model::MapFormat sourceMapFormat,
+  const Model::MapFormat targetMapFormat,
+  const Model::EntityPropertyConfig& entityPropertyConfig)
+  : MapReader{std::move(str), sourceMapFormat, targetMapFormat, entityPropertyConfig}
   , m_worldNode{std::make_unique<Model::WorldNode>(
-      entityPropertyConfig, Model::Entity{}, sourceAndTargetMapFormat)}
+      entityPropertyConfig, Model::Entity{}, targetMapFormat)}
 {
   m_worldNode->disableNodeTreeUpdates();
 }
@@ -86,6 +100,18 @@ std::unique_ptr<Model::WorldNode> WorldReader::tryRead(
   const vm::bbox3& worldBounds,
   const Model::EntityPropertyConfig& entityPropertyConfig,
   ParserStatus& status)
+{
+  return tryRead(
+    str, mapFormatsToTry, std::nullopt, worldBounds, entityPropertyConfig, status);
+}
+
+std::unique_ptr<Model::WorldNode> WorldReader::tryRead(
+  std::string_view str,
+  const std::vector<Model::MapFormat>& mapFormatsToTry,
+  const std::optional<Model::MapFormat> targetMapFormat,
+  const vm::bbox3& worldBounds,
+  const Model::EntityPropertyConfig& entityPropertyConfig,
+  ParserStatus& status)
 {
   auto parserExceptions = std::vector<std::tuple<Model::MapFormat, std::string>>{};
 
@@ -98,7 +124,8 @@ std::unique_ptr<Model::WorldNode> WorldReader::tryRead(
 
     try
     {
-      auto reader = WorldReader{str, mapFormat, entityPropertyConfig};
+      auto reader = WorldReader{
+        str, mapFormat, targetMapFormat.value_or(mapFormat), entityPropertyConfig};
       return reader.read(worldBounds, status);
     }
     catch (const ParserException& e)
@@ -184,6 +211,8 @@ void setLinkIds(Model::WorldNode& worldNode, ParserStatus& status)
 std::unique_ptr<Model::WorldNode> WorldReader::read(
   const vm::bbox3& worldBounds, ParserStatus& status)
 {
+  profileZone("IO", "Read map");
+
   readEntities(worldBounds, status);
   sanitizeLayerSortIndicies(*m_worldNode, status);
   setLinkIds(*m_worldNode, status);
@@ -23,6 +23,7 @@
 #include "IO/MapReader.h"
 
 #include <memory>
+#include <optional>
 #include <string>
 #include <tuple>
 #include <vector>
@@ -58,6 +59,16 @@ public:
     Model::MapFormat sourceAndTargetMapFormat,
     const Model::EntityPropertyConfig& entityPropertyConfig);
 
+  /**
+   * Creates a reader that parses the given string as the given source map format and
+   * converts the brush faces to the given target map format.
+   */
+  WorldReader(
+    std::string_view str,
+    Model::MapFormat sourceMapFormat,
+    Model::MapFormat targetMapFormat,
+    const Model::EntityPropertyConfig& entityPropertyConfig);
+
   std::unique_ptr<Model::WorldNode> read(
     const vm::bbox3& worldBounds, ParserStatus& status);
 
@@ -79,6 +90,27 @@ public:
     const Model::EntityPropertyConfig& entityPropertyConfig,
     ParserStatus& status);
 
+  /**
+   * Try to parse the given string as the given map formats, in order, and convert the
+   * result to the given target map format. If no target map format is given, the world
+   * retains the format that was successfully parsed.
+   *
+   * @param str the string to parse
+   * @param mapFormatsToTry formats to try, in order
+   * @param targetMapFormat the format of the returned world
+   * @param worldBounds world bounds
+   * @param status status
+   * @return the world node
+   * @throws WorldReaderException if `str` can't be parsed by any of the given formats
+   */
+  static std::unique_ptr<Model::WorldNode> tryRead(
+    std::string_view str,
+    const std::vector<Model::MapFormat>& mapFormatsToTry,
+    std::optional<Model::MapFormat> targetMapFormat,
+    const vm::bbox3& worldBounds,
+    const Model::EntityPropertyConfig& entityPropertyConfig,
+    ParserStatus& status);
+
 private: // implement MapReader interface
   Model::Node* onWorldNode(
     std::unique_ptr<Model::WorldNode> worldNode, ParserStatus& status) override;
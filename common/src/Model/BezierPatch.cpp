@@ -23,6 +23,7 @@
 #include "Ensure.h"
 
 #include "kdl/reflection_impl.h"
+#include "kdl/string_utils.h"
 
 #include "vm/bbox_io.h"
 #include "vm/bezier_surface.h"
@@ -245,21 +246,61 @@ void evaluateSurface(
   }
 }
 
+namespace
+{
+struct GridSample
+{
+  size_t surfaceIndex;
+  FloatType t;
+};
+
+/**
+ * Returns, for each grid row (or column), the index of the surface row (or column) to
+ * sample and the parameter value at which to sample it.
+ */
+std::vector<GridSample> makeGridSamples(const std::vector<size_t>& subdivisionsPerSurface)
+{
+  auto result = std::vector<GridSample>{{0u, 0.0}};
+  for (size_t surfaceIndex = 0u; surfaceIndex < subdivisionsPerSurface.size();
+       ++surfaceIndex)
+  {
+    const auto quadsPerSurfaceSide = size_t(1) << subdivisionsPerSurface[surfaceIndex];
+    for (size_t i = 1u; i <= quadsPerSurfaceSide; ++i)
+    {
+      result.push_back(
+        {surfaceIndex,
+         static_cast<FloatType>(i) / static_cast<FloatType>(quadsPerSurfaceSide)});
+    }
+  }
+  return result;
+}
+} // namespace
+
 std::vector<BezierPatch::Point> BezierPatch::evaluate(
   const size_t subdivisionsPerSurface) const
 {
+  return evaluate(
+    std::vector<size_t>(surfaceRowCount(), subdivisionsPerSurface),
+    std::vector<size_t>(surfaceColumnCount(), subdivisionsPerSurface));
+}
+
+std::vector<BezierPatch::Point> BezierPatch::evaluate(
+  const std::vector<size_t>& subdivisionsPerSurfaceRow,
+  const std::vector<size_t>& subdivisionsPerSurfaceColumn) const
+{
+  assert(subdivisionsPerSurfaceRow.size() == surfaceRowCount());
+  assert(subdivisionsPerSurfaceColumn.size() == surfaceColumnCount());
+
   // collect the control points for each surface in this patch
   const auto allSurfaceControlPoints =
     collectAllSurfaceControlPoints(m_controlPoints, m_pointRowCount, m_pointColumnCount);
 
-  const auto quadsPerSurfaceSide = (1u << subdivisionsPerSurface);
-
-  // determine dimensions of the resulting point grid
-  const size_t gridPointRowCount = surfaceRowCount() * quadsPerSurfaceSide + 1u;
-  const size_t gridPointColumnCount = surfaceColumnCount() * quadsPerSurfaceSide + 1u;
+  // determine the surface and the parameter value to sample for each grid row and column
+  const auto rowSamples = makeGridSamples(subdivisionsPerSurfaceRow);
+  const auto columnSamples = makeGridSamples(subdivisionsPerSurfaceColumn);
 
   auto grid = std::vector<BezierPatch::Point>{};
-  grid.reserve(gridPointRowCount * gridPointColumnCount);
+  grid.reserve(rowSamples.size() * columnSamples.size());
 
   /*
   Next we sample the surfaces to compute each point in the grid.
@@ -281,6 +322,10 @@ std::vector<BezierPatch::Point> BezierPatch::evaluate(
   Note that for shared grid points, either u or v or both are always 1. This is necessary
   because we are still sampling the preceeding surface for the shared grid points.
 
+  Each surface row and each surface column can be subdivided a different number of times,
+  but all surfaces in a surface row (column) share the same grid rows (columns). Adjacent
+  surfaces therefore always share their boundary points, and the grid has no cracks.
+
             0   1/4  2/4  3/4   1   1/4  2/4  3/4   1 -- value of u
             0    0    0    0    0    1    1    1    1 -- surface column index
             0    1    2    3    4    5    6    7    8 -- grid column index
@@ -309,21 +354,10 @@ std::vector<BezierPatch::Point> BezierPatch::evaluate(
   value of v
   */
 
-  for (size_t gridRow = 0u; gridRow < gridPointRowCount; ++gridRow)
+  for (const auto& [surfaceRow, v] : rowSamples)
   {
-    const size_t surfaceRow =
-      (gridRow > 0u ? gridRow - 1u : gridRow) / quadsPerSurfaceSide;
-    const FloatType v = static_cast<FloatType>(gridRow - surfaceRow * quadsPerSurfaceSide)
-                        / static_cast<FloatType>(quadsPerSurfaceSide);
-
-    for (size_t gridCol = 0u; gridCol < gridPointColumnCount; ++gridCol)
+    for (const auto& [surfaceCol, u] : columnSamples)
     {
-      const size_t surfaceCol =
-        (gridCol > 0u ? gridCol - 1u : gridCol) / quadsPerSurfaceSide;
-      const FloatType u =
-        static_cast<FloatType>(gridCol - surfaceCol * quadsPerSurfaceSide)
-        / static_cast<FloatType>(quadsPerSurfaceSide);
-
       const auto& surfaceControlPoints =
         allSurfaceControlPoints[surfaceRow * surfaceColumnCount() + surfaceCol];
       auto point = vm::evaluate_quadratic_bezier_surface(surfaceControlPoints, u, v);
@@ -334,4 +368,10 @@ std::vector<BezierPatch::Point> BezierPatch::evaluate(
   return grid;
 }
 
+size_t BezierPatch::memoryUsage() const
+{
+  return sizeof(BezierPatch) + m_controlPoints.capacity() * sizeof(Point)
+         + kdl::str_allocated_size(m_materialName);
+}
+
 } // namespace TrenchBroom::Model
@@ -100,6 +100,15 @@ public: // control points:
   void transform(const vm::mat4x4& transformation);
 
   std::vector<Point> evaluate(size_t subdivisionsPerSurface) const;
+  std::vector<Point> evaluate(
+    const std::vector<size_t>& subdivisionsPerSurfaceRow,
+    const std::vector<size_t>& subdivisionsPerSurfaceColumn) const;
+
+  /**
+   * Returns an estimate of the number of bytes used by this patch. The estimate does not
+   * account for allocator overhead.
+   */
+  size_t memoryUsage() const;
 };
 
 } // namespace TrenchBroom::Model
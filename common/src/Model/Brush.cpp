@@ -35,6 +35,7 @@
 #include "kdl/string_utils.h"
 #include "kdl/vector_utils.h"
 
+#include "vm/bbox.h"
 #include "vm/intersection.h"
 #include "vm/mat.h"
 #include "vm/mat_ext.h"
@@ -69,22 +70,10 @@ Brush::Brush() {}
 
 Brush::Brush(const Brush& other)
   : m_faces{other.m_faces}
-  , m_geometry{
-      other.m_geometry
-        ? std::make_unique<BrushGeometry>(*other.m_geometry, CopyCallback())
-        : nullptr}
+  , m_geometry{other.m_geometry}
+  , m_packedFaces{other.m_packedFaces}
 {
-  if (m_geometry)
-  {
-    for (BrushFaceGeometry* faceGeometry : m_geometry->faces())
-    {
-      if (const auto faceIndex = faceGeometry->payload())
-      {
-        BrushFace& face = m_faces[*faceIndex];
-        face.setGeometry(faceGeometry);
-      }
-    }
-  }
+  updateFaceGeometries();
 }
 
 Brush::Brush(Brush&& other) noexcept = default;
@@ -116,7 +105,7 @@ Result<void> Brush::updateGeometryFromFaces(const vm::bbox3& worldBounds)
   // First, add all faces to the brush geometry
   BrushFace::sortFaces(m_faces);
 
-  auto geometry = std::make_unique<BrushGeometry>(worldBounds);
+  auto geometry = std::make_shared<BrushGeometry>(worldBounds);
 
   for (size_t i = 0u; i < m_faces.size(); ++i)
   {
@@ -160,12 +149,57 @@ Result<void> Brush::updateGeometryFromFaces(const vm::bbox3& worldBounds)
 
   m_faces = std::move(remainingFaces);
   m_geometry = std::move(geometry);
+  m_packedFaces = std::make_shared<const PackedBrushFaces>(m_faces, *m_geometry);
 
   assert(checkFaceLinks());
 
   return kdl::void_success;
 }
 
+void Brush::translateGeometry(const vm::vec3& delta)
+{
+  auto& geometry = mutableGeometry();
+  geometry.translate(delta);
+  geometry.correctVertexPositions();
+
+  // use the translated face boundaries so that the face planes remain identical to them
+  for (auto* faceGeometry : geometry.faces())
+  {
+    faceGeometry->setPlane(m_faces[*faceGeometry->payload()].boundary());
+  }
+
+  m_packedFaces = std::make_shared<const PackedBrushFaces>(m_faces, geometry);
+
+  assert(checkFaceLinks());
+}
+
+BrushGeometry& Brush::mutableGeometry()
+{
+  ensure(m_geometry != nullptr, "geometry is null");
+
+  if (m_geometry.use_count() > 1)
+  {
+    m_geometry = std::make_shared<BrushGeometry>(*m_geometry, CopyCallback());
+    updateFaceGeometries();
+  }
+  return *m_geometry;
+}
+
+void Brush::updateFaceGeometries()
+{
+  if (m_geometry)
+  {
+    for (BrushFaceGeometry* faceGeometry : m_geometry->faces())
+    {
+      if (const auto faceIndex = faceGeometry->payload())
+      {
+        BrushFace& face = m_faces[*faceIndex];
+        face.setGeometry(faceGeometry);
+      }
+    }
+  }
+}
+
 const vm::bbox3& Brush::bounds() const
 {
   ensure(m_geometry != nullptr, "geometry is null");
@@ -240,6 +274,12 @@ std::vector<BrushFace>& Brush::faces()
   return m_faces;
 }
 
+const PackedBrushFaces& Brush::packedFaces() const
+{
+  ensure(m_packedFaces != nullptr, "packed faces are null");
+  return *m_packedFaces;
+}
+
 bool Brush::closed() const
 {
   ensure(m_geometry != nullptr, "geometry is null");
@@ -260,6 +300,24 @@ bool Brush::fullySpecified() const
   return true;
 }
 
+size_t Brush::memoryUsage() const
+{
+  auto result = sizeof(Brush) + (m_faces.capacity() - m_faces.size()) * sizeof(BrushFace);
+  for (const auto& face : m_faces)
+  {
+    result += face.memoryUsage();
+  }
+  if (m_geometry)
+  {
+    result += m_geometry->memoryUsage() / size_t(m_geometry.use_count());
+  }
+  if (m_packedFaces)
+  {
+    result += m_packedFaces->memoryUsage() / size_t(m_packedFaces.use_count());
+  }
+  return result;
+}
+
 void Brush::cloneFaceAttributesFrom(const Brush& brush)
 {
   for (auto& destination : m_faces)
@@ -517,21 +575,7 @@ const Brush::EdgeList& Brush::edges() const
 
 bool Brush::containsPoint(const vm::vec3& point) const
 {
-  if (!bounds().contains(point))
-  {
-    return false;
-  }
-  else
-  {
-    for (const auto& face : m_faces)
-    {
-      if (face.boundary().point_status(point) == vm::plane_status::above)
-      {
-        return false;
-      }
-    }
-    return true;
-  }
+  return bounds().contains(point) && m_packedFaces->containsPoint(point);
 }
 
 std::vector<const BrushFace*> Brush::incidentFaces(const BrushVertex* vertex) const
@@ -1182,6 +1226,18 @@ Result<void> Brush::transform(
     }
   }
 
+  if (vm::strip_translation(transformation) == vm::mat4x4::identity())
+  {
+    // Brushes that touch the world bounds are invalid, but translating the geometry
+    // would not detect this, so we keep a safe distance to the world bounds.
+    const auto delta = transformation * vm::vec3::zero();
+    if (worldBounds.contains(bounds().translate(delta).expand(1.0)))
+    {
+      translateGeometry(delta);
+      return kdl::void_success;
+    }
+  }
+
   return updateGeometryFromFaces(worldBounds);
 }
 
@@ -1215,7 +1271,17 @@ bool Brush::intersects(const vm::bbox3& bounds) const
 
 bool Brush::intersects(const Brush& brush) const
 {
-  return m_geometry->intersects(*brush.m_geometry);
+  if (!bounds().intersects(brush.bounds()))
+  {
+    return false;
+  }
+
+  if (!m_geometry->polyhedron() || !brush.m_geometry->polyhedron())
+  {
+    return m_geometry->intersects(*brush.m_geometry);
+  }
+
+  return m_packedFaces->intersects(*brush.m_packedFaces);
 }
 
 Result<Brush> Brush::createBrush(
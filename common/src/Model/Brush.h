@@ -22,6 +22,7 @@
 #include "FloatType.h"
 #include "Macros.h"
 #include "Model/BrushGeometry.h"
+#include "Model/PackedBrushFaces.h"
 #include "Result.h"
 
 #include "kdl/reflection_decl.h"
@@ -56,7 +57,12 @@ public:
 
 private:
   std::vector<BrushFace> m_faces;
-  std::unique_ptr<BrushGeometry> m_geometry;
+
+  // The geometry and the packed faces are shared between copies of a brush, e.g. undo
+  // snapshots and linked groups. The brush only modifies its geometry after detaching it
+  // in mutableGeometry, and users of the face geometries must treat them as read only.
+  std::shared_ptr<BrushGeometry> m_geometry;
+  std::shared_ptr<const PackedBrushFaces> m_packedFaces;
 
   kdl_reflect_decl(Brush, m_faces);
 
@@ -78,6 +84,23 @@ private:
 
   Result<void> updateGeometryFromFaces(const vm::bbox3& worldBounds);
 
+  /**
+   * Translates the geometry of this brush by the given delta without rebuilding it from
+   * the face boundaries, which must already have been translated.
+   */
+  void translateGeometry(const vm::vec3& delta);
+
+  /**
+   * Returns the geometry of this brush for modification. If the geometry is shared with
+   * other brushes, it is copied first.
+   */
+  BrushGeometry& mutableGeometry();
+
+  /**
+   * Sets the geometry of each face to the corresponding face of the current geometry.
+   */
+  void updateFaceGeometries();
+
 public:
   const vm::bbox3& bounds() const;
 
@@ -97,9 +120,25 @@ public: // face management:
   const std::vector<BrushFace>& faces() const;
   std::vector<BrushFace>& faces();
 
+  /**
+   * Returns the planes and polygons of the faces of this brush in flat arrays. The packed
+   * faces are rebuilt whenever the geometry of this brush changes, and the face indices
+   * correspond to the indices of the faces of this brush.
+   */
+  const PackedBrushFaces& packedFaces() const;
+
   bool closed() const;
   bool fullySpecified() const;
 
+  /**
+   * Returns an estimate of the number of bytes used by this brush, including its faces
+   * and its geometry. The estimate does not account for allocator overhead.
+   *
+   * If the geometry is shared with other brushes, it is attributed to each of them in
+   * equal parts, so that the estimates of all brushes add up to the total memory usage.
+   */
+  size_t memoryUsage() const;
+
 public: // clone face attributes from matching faces of other brushes
   void cloneFaceAttributesFrom(const Brush& brush);
   void cloneFaceAttributesFrom(const std::vector<const Brush*>& brushes);
@@ -318,6 +357,9 @@ public:
   /**
    * Applies the given transformation to this brush.
    *
+   * If the transformation is a translation that keeps the brush within the world
+   * bounds, the geometry is translated instead of being rebuilt from the faces.
+   *
    * If the brush becomes invalid, an error is returned.
    *
    * @param worldBounds the world bounds
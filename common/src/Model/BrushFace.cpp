@@ -794,6 +794,12 @@ BrushFaceGeometry* BrushFace::geometry() const
   return m_geometry;
 }
 
+size_t BrushFace::memoryUsage() const
+{
+  return sizeof(BrushFace) + kdl::str_allocated_size(m_attributes.materialName())
+         + m_uvCoordSystem->memoryUsage();
+}
+
 void BrushFace::setGeometry(BrushFaceGeometry* geometry)
 {
   m_geometry = geometry;
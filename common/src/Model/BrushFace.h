@@ -256,6 +256,12 @@ public:
   BrushFaceGeometry* geometry() const;
   void setGeometry(BrushFaceGeometry* geometry);
 
+  /**
+   * Returns the number of bytes used by this face, including its material name and UV
+   * coordinate system, but not including its geometry, which is owned by the brush.
+   */
+  size_t memoryUsage() const;
+
   size_t lineNumber() const;
   void setFilePosition(size_t lineNumber, size_t lineCount) const;
 
@@ -33,8 +33,10 @@
 #include "Model/LayerNode.h"
 #include "Model/LinkedGroupUtils.h"
 #include "Model/ModelUtils.h"
+#include "Model/PackedBrushFaces.h"
 #include "Model/PatchNode.h"
 #include "Model/PickResult.h"
+#include "Model/SerializedText.h"
 #include "Model/TagVisitor.h"
 #include "Model/UVCoordSystem.h"
 #include "Model/Validator.h"
@@ -61,6 +63,7 @@
 #include <iterator>
 #include <set>
 #include <string>
+#include <tuple>
 #include <vector>
 
 namespace TrenchBroom
@@ -120,6 +123,7 @@ Brush BrushNode::setBrush(Brush brush)
   updateSelectedFaceCount();
   invalidateIssues();
   invalidateVertexCache();
+  m_serializedText.reset();
 
   return brush;
 }
@@ -144,14 +148,31 @@ void BrushNode::deselectFace(const size_t faceIndex)
 void BrushNode::updateFaceTags(const size_t faceIndex, TagManager& tagManager)
 {
   m_brush.face(faceIndex).updateTags(tagManager);
+  invalidateCachedEditorStates();
+}
+
+static auto resolvedSurfaceData(const BrushFace& face)
+{
+  return std::tuple{
+    face.resolvedSurfaceContents(),
+    face.resolvedSurfaceFlags(),
+    face.resolvedSurfaceValue()};
 }
 
 void BrushNode::setFaceMaterial(const size_t faceIndex, Assets::Material* material)
 {
-  m_brush.face(faceIndex).setMaterial(material);
+  auto& face = m_brush.face(faceIndex);
+  const auto previousSurfaceData = resolvedSurfaceData(face);
+  face.setMaterial(material);
 
   invalidateIssues();
   invalidateVertexCache();
+
+  // the material only affects the serialized text through its default surface data
+  if (resolvedSurfaceData(face) != previousSurfaceData)
+  {
+    m_serializedText.reset();
+  }
 }
 
 static bool containsPatch(const Brush& brush, const PatchGrid& grid)
@@ -184,10 +205,13 @@ bool BrushNode::contains(const Node* node) const
 }
 
 static bool faceIntersectsEdge(
-  const BrushFace& face, const vm::vec3& p0, const vm::vec3& p1)
+  const PackedBrushFaces& faces,
+  const size_t faceIndex,
+  const vm::vec3& p0,
+  const vm::vec3& p1)
 {
   const auto ray = vm::ray3{p0, p1 - p0}; // not normalized
-  if (const auto dist = face.intersectWithRay(ray))
+  if (const auto dist = faces.intersectWithRay(faceIndex, ray))
   {
     // dist is scaled by inverse of vm::length(p1 - p0)
     return *dist >= 0.0 && *dist <= 1.0;
@@ -213,7 +237,8 @@ static bool intersectsPatch(const Brush& brush, const PatchGrid& grid)
   }
 
   // now check if any quad edge of the given grid intersects with any face
-  for (const auto& face : brush.faces())
+  const auto& packedFaces = brush.packedFaces();
+  for (size_t faceIndex = 0u; faceIndex < packedFaces.faceCount(); ++faceIndex)
   {
     // check row edges
     for (size_t row = 0u; row < grid.pointRowCount; ++row)
@@ -222,7 +247,7 @@ static bool intersectsPatch(const Brush& brush, const PatchGrid& grid)
       {
         const auto& p0 = grid.point(row, col).position;
         const auto& p1 = grid.point(row, col + 1u).position;
-        if (faceIntersectsEdge(face, p0, p1))
+        if (faceIntersectsEdge(packedFaces, faceIndex, p0, p1))
         {
           return true;
         }
@@ -235,7 +260,7 @@ static bool intersectsPatch(const Brush& brush, const PatchGrid& grid)
       {
         const auto& p0 = grid.point(row, col).position;
         const auto& p1 = grid.point(row + 1u, col).position;
-        if (faceIntersectsEdge(face, p0, p1))
+        if (faceIntersectsEdge(packedFaces, faceIndex, p0, p1))
         {
           return true;
         }
@@ -319,6 +344,7 @@ Node* BrushNode::doClone(
 {
   auto result = std::make_unique<BrushNode>(m_brush);
   result->cloneLinkId(*this, setLinkIds);
+  result->m_serializedText = m_serializedText;
   cloneAttributes(result.get());
   return result.release();
 }
@@ -387,10 +413,10 @@ std::optional<std::tuple<FloatType, size_t>> BrushNode::findFaceHit(
 {
   if (vm::intersect_ray_bbox(ray, logicalBounds()))
   {
-    for (size_t i = 0u; i < m_brush.faceCount(); ++i)
+    const auto& packedFaces = m_brush.packedFaces();
+    for (size_t i = 0u; i < packedFaces.faceCount(); ++i)
     {
-      const auto& face = m_brush.face(i);
-      if (const auto distance = face.intersectWithRay(ray))
+      if (const auto distance = packedFaces.intersectWithRay(i, ray))
       {
         return std::tuple{*distance, i};
       }
@@ -424,6 +450,17 @@ Renderer::BrushRendererBrushCache& BrushNode::brushRendererBrushCache() const
   return *m_brushRendererBrushCache;
 }
 
+std::shared_ptr<const SerializedText> BrushNode::serializedText() const
+{
+  return m_serializedText;
+}
+
+void BrushNode::setSerializedText(
+  std::shared_ptr<const SerializedText> serializedText) const
+{
+  m_serializedText = std::move(serializedText);
+}
+
 void BrushNode::initializeTags(TagManager& tagManager)
 {
   Taggable::initializeTags(tagManager);
@@ -439,7 +476,7 @@ void BrushNode::clearTags()
   {
     face.clearTags();
   }
-  Taggable::clearTags();
+  Node::clearTags();
 }
 
 void BrushNode::updateTags(TagManager& tagManager)
@@ -448,7 +485,7 @@ void BrushNode::updateTags(TagManager& tagManager)
   {
     face.updateTags(tagManager);
   }
-  Taggable::updateTags(tagManager);
+  Node::updateTags(tagManager);
 }
 
 bool BrushNode::allFacesHaveAnyTagInMask(TagType::Type tagMask) const
@@ -56,6 +56,7 @@ class GroupNode;
 class LayerNode;
 
 class ModelFactory;
+struct SerializedText;
 
 class BrushNode : public Node, public Object
 {
@@ -71,6 +72,7 @@ private:
     m_brushRendererBrushCache; // unique_ptr for breaking header dependencies
   Brush m_brush;               // must be destroyed before the brush renderer cache
   size_t m_selectedFaceCount = 0u;
+  mutable std::shared_ptr<const SerializedText> m_serializedText;
 
 public:
   explicit BrushNode(Brush brush);
@@ -138,6 +140,13 @@ public: // renderer cache
   void invalidateVertexCache();
   Renderer::BrushRendererBrushCache& brushRendererBrushCache() const;
 
+public: // serialized text cache
+  /**
+   * Only exposed to be called by MapFileSerializer
+   */
+  std::shared_ptr<const SerializedText> serializedText() const;
+  void setSerializedText(std::shared_ptr<const SerializedText> serializedText) const;
+
 private: // implement Taggable interface
 public:
   void initializeTags(TagManager& tagManager) override;
@@ -32,13 +32,22 @@
 #include "Model/PatchNode.h"
 #include "Model/WorldNode.h"
 #include "PreferenceManager.h"
-#include "Preferences.h"
+
+#include <atomic>
 
 namespace TrenchBroom
 {
 namespace Model
 {
+namespace
+{
+// every context uses its own cache versions so that the nodes can tell them apart
+std::atomic<std::uint64_t> nextCacheVersion = 1;
+} // namespace
+
 EditorContext::EditorContext()
+  : m_cacheVersion{nextCacheVersion++}
+  , m_preferences{PreferenceManager::instance().snapshot()}
 {
   reset();
 }
@@ -49,6 +58,7 @@ void EditorContext::reset()
   m_hiddenEntityDefinitions.reset();
   m_blockSelection = false;
   m_currentGroup = nullptr;
+  clearCachedStates();
 }
 
 TagType::Type EditorContext::hiddenTags() const
@@ -61,6 +71,7 @@ void EditorContext::setHiddenTags(const TagType::Type hiddenTags)
   if (hiddenTags != m_hiddenTags)
   {
     m_hiddenTags = hiddenTags;
+    clearCachedStates();
     editorContextDidChangeNotifier();
   }
 }
@@ -83,6 +94,7 @@ void EditorContext::setEntityDefinitionHidden(
   if (definition != nullptr && entityDefinitionHidden(definition) != hidden)
   {
     m_hiddenEntityDefinitions[definition->index()] = hidden;
+    clearCachedStates();
     editorContextDidChangeNotifier();
   }
 }
@@ -153,79 +165,85 @@ bool EditorContext::visible(const Model::LayerNode* layerNode) const
 
 bool EditorContext::visible(const Model::GroupNode* groupNode) const
 {
-  if (groupNode->selected())
-  {
-    return true;
-  }
-  if (!anyChildVisible(groupNode))
-  {
-    return false;
-  }
-  return groupNode->visible();
+  return cachedState(groupNode, VisibleValid, Visible, [&]() {
+    if (groupNode->selected())
+    {
+      return true;
+    }
+    if (!anyChildVisible(groupNode))
+    {
+      return false;
+    }
+    return groupNode->visible();
+  });
 }
 
 bool EditorContext::visible(const Model::EntityNode* entityNode) const
 {
-  if (entityNode->selected())
-  {
-    return true;
-  }
+  return cachedState(entityNode, VisibleValid, Visible, [&]() {
+    if (entityNode->selected())
+    {
+      return true;
+    }
 
-  if (!entityNode->entity().pointEntity())
-  {
-    if (!anyChildVisible(entityNode))
+    if (!entityNode->entity().pointEntity())
     {
-      return false;
+      if (!anyChildVisible(entityNode))
+      {
+        return false;
+      }
+      return true;
     }
-    return true;
-  }
 
-  if (!entityNode->visible())
-  {
-    return false;
-  }
+    if (!entityNode->visible())
+    {
+      return false;
+    }
 
-  if (entityNode->entity().pointEntity() && !pref(Preferences::ShowPointEntities))
-  {
-    return false;
-  }
+    if (entityNode->entity().pointEntity() && !m_preferences->showPointEntities)
+    {
+      return false;
+    }
 
-  if (entityDefinitionHidden(entityNode))
-  {
-    return false;
-  }
+    if (entityDefinitionHidden(entityNode))
+    {
+      return false;
+    }
 
-  return true;
+    return true;
+  });
 }
 
 bool EditorContext::visible(const Model::BrushNode* brushNode) const
 {
-  if (brushNode->selected())
-  {
-    return true;
-  }
+  return cachedState(brushNode, VisibleValid, Visible, [&]() {
+    if (brushNode->selected())
+    {
+      return true;
+    }
 
-  if (!pref(Preferences::ShowBrushes))
-  {
-    return false;
-  }
+    if (!m_preferences->showBrushes)
+    {
+      return false;
+    }
 
-  if (brushNode->hasTag(m_hiddenTags))
-  {
-    return false;
-  }
+    if (brushNode->hasTag(m_hiddenTags))
+    {
+      return false;
+    }
 
-  if (brushNode->allFacesHaveAnyTagInMask(m_hiddenTags))
-  {
-    return false;
-  }
+    if (brushNode->allFacesHaveAnyTagInMask(m_hiddenTags))
+    {
+      return false;
+    }
 
-  if (entityDefinitionHidden(brushNode->entity()))
-  {
-    return false;
-  }
+    if (entityDefinitionHidden(brushNode->entity()))
+    {
+      return false;
+    }
 
-  return brushNode->visible();
+    return brushNode->visible();
+  });
 }
 
 bool EditorContext::visible(
@@ -236,17 +254,19 @@ bool EditorContext::visible(
 
 bool EditorContext::visible(const Model::PatchNode* patchNode) const
 {
-  if (patchNode->selected())
-  {
-    return true;
-  }
+  return cachedState(patchNode, VisibleValid, Visible, [&]() {
+    if (patchNode->selected())
+    {
+      return true;
+    }
 
-  if (patchNode->hasTag(m_hiddenTags))
-  {
-    return false;
-  }
+    if (patchNode->hasTag(m_hiddenTags))
+    {
+      return false;
+    }
 
-  return patchNode->visible();
+    return patchNode->visible();
+  });
 }
 
 bool EditorContext::anyChildVisible(const Model::Node* node) const
@@ -257,9 +277,47 @@ bool EditorContext::anyChildVisible(const Model::Node* node) const
   });
 }
 
+template <typename F>
+bool EditorContext::cachedState(
+  const Model::Node* node,
+  const CachedStateFlags validFlag,
+  const CachedStateFlags valueFlag,
+  const F& computeState) const
+{
+  validateCachedStates();
+
+  if (const auto flags = node->cachedEditorState(m_cacheVersion); flags & validFlag)
+  {
+    return flags & valueFlag;
+  }
+
+  // computing the state can cache other states of the same node, so the flags must be
+  // read again afterwards
+  const auto state = computeState();
+  const auto flags = node->cachedEditorState(m_cacheVersion);
+  node->setCachedEditorState(
+    m_cacheVersion, std::uint8_t(flags | validFlag | (state ? valueFlag : 0)));
+  return state;
+}
+
+void EditorContext::validateCachedStates() const
+{
+  const auto& prefs = PreferenceManager::instance();
+  if (prefs.snapshotVersion() != m_preferences->version)
+  {
+    clearCachedStates();
+    m_preferences = prefs.snapshot();
+  }
+}
+
+void EditorContext::clearCachedStates() const
+{
+  m_cacheVersion = nextCacheVersion++;
+}
+
 bool EditorContext::editable(const Model::Node* node) const
 {
-  return node->editable();
+  return cachedState(node, EditableValid, Editable, [&]() { return node->editable(); });
 }
 
 bool EditorContext::editable(
@@ -291,19 +349,25 @@ bool EditorContext::selectable(const Model::LayerNode*) const
 
 bool EditorContext::selectable(const Model::GroupNode* groupNode) const
 {
-  return visible(groupNode) && editable(groupNode) && !groupNode->opened()
-         && inOpenGroup(groupNode);
+  return cachedState(groupNode, SelectableValid, Selectable, [&]() {
+    return visible(groupNode) && editable(groupNode) && !groupNode->opened()
+           && inOpenGroup(groupNode);
+  });
 }
 
 bool EditorContext::selectable(const Model::EntityNode* entityNode) const
 {
-  return visible(entityNode) && editable(entityNode) && !entityNode->hasChildren()
-         && inOpenGroup(entityNode);
+  return cachedState(entityNode, SelectableValid, Selectable, [&]() {
+    return visible(entityNode) && editable(entityNode) && !entityNode->hasChildren()
+           && inOpenGroup(entityNode);
+  });
 }
 
 bool EditorContext::selectable(const Model::BrushNode* brushNode) const
 {
-  return visible(brushNode) && editable(brushNode) && inOpenGroup(brushNode);
+  return cachedState(brushNode, SelectableValid, Selectable, [&]() {
+    return visible(brushNode) && editable(brushNode) && inOpenGroup(brushNode);
+  });
 }
 
 bool EditorContext::selectable(
@@ -314,7 +378,9 @@ bool EditorContext::selectable(
 
 bool EditorContext::selectable(const Model::PatchNode* patchNode) const
 {
-  return visible(patchNode) && editable(patchNode) && inOpenGroup(patchNode);
+  return cachedState(patchNode, SelectableValid, Selectable, [&]() {
+    return visible(patchNode) && editable(patchNode) && inOpenGroup(patchNode);
+  });
 }
 
 bool EditorContext::canChangeSelection() const
@@ -21,9 +21,13 @@
 
 #include "Model/TagType.h"
 #include "Notifier.h"
+#include "PreferenceSnapshot.h"
 
 #include "kdl/bitset.h"
 
+#include <cstdint>
+#include <memory>
+
 namespace TrenchBroom
 {
 namespace Assets
@@ -54,6 +58,26 @@ private:
 
   Model::GroupNode* m_currentGroup;
 
+  enum CachedStateFlags : std::uint8_t
+  {
+    VisibleValid = 1 << 0,
+    Visible = 1 << 1,
+    EditableValid = 1 << 2,
+    Editable = 1 << 3,
+    SelectableValid = 1 << 4,
+    Selectable = 1 << 5,
+  };
+
+  /**
+   * Identifies the visibility, editability and selectability states that this context
+   * cached in the nodes. The nodes invalidate their cached states when they or their
+   * ancestors or descendants change. The version changes when any of the hidden tags or
+   * hidden entity definitions change, or when a new preference snapshot is published,
+   * which invalidates the states cached in all nodes at once.
+   */
+  mutable std::uint64_t m_cacheVersion;
+  mutable std::shared_ptr<const PreferenceSnapshot> m_preferences;
+
 public:
   Notifier<> editorContextDidChangeNotifier;
 
@@ -90,6 +114,15 @@ public:
 private:
   bool anyChildVisible(const Model::Node* node) const;
 
+  template <typename F>
+  bool cachedState(
+    const Model::Node* node,
+    CachedStateFlags validFlag,
+    CachedStateFlags valueFlag,
+    const F& computeState) const;
+  void validateCachedStates() const;
+  void clearCachedStates() const;
+
 public:
   bool editable(const Model::Node* node) const;
   bool editable(const Model::BrushNode* brushNode, const Model::BrushFace& face) const;
@@ -483,4 +483,24 @@ void Entity::transform(const vm::mat4x4& transformation, const bool updateAngleP
   }
 }
 
+size_t Entity::memoryUsage() const
+{
+  auto result = sizeof(Entity) + m_properties.capacity() * sizeof(EntityProperty)
+                + m_protectedProperties.capacity() * sizeof(std::string);
+  for (const auto& property : m_properties)
+  {
+    result +=
+      kdl::str_allocated_size(property.key()) + kdl::str_allocated_size(property.value());
+  }
+  for (const auto& key : m_protectedProperties)
+  {
+    result += kdl::str_allocated_size(key);
+  }
+  if (m_cachedClassname)
+  {
+    result += kdl::str_allocated_size(*m_cachedClassname);
+  }
+  return result;
+}
+
 } // namespace TrenchBroom::Model
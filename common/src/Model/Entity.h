@@ -188,6 +188,12 @@ public: // property management
   std::vector<EntityProperty> numberedProperties(const std::string& property) const;
 
   void transform(const vm::mat4x4& transformation, bool updateAngleProperty);
+
+  /**
+   * Returns an estimate of the number of bytes used by this entity, including its
+   * properties. The estimate does not account for allocator overhead.
+   */
+  size_t memoryUsage() const;
 };
 
 } // namespace TrenchBroom::Model
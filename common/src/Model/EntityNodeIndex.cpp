@@ -27,8 +27,9 @@
 #include "kdl/compact_trie.h"
 #include "kdl/vector_utils.h"
 
+#include <future>
 #include <iterator>
-#include <list>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -56,26 +57,26 @@ EntityNodeIndexQuery EntityNodeIndexQuery::any()
   return EntityNodeIndexQuery(Type_Any);
 }
 
-std::set<EntityNodeBase*> EntityNodeIndexQuery::execute(
+std::vector<EntityNodeBase*> EntityNodeIndexQuery::execute(
   const EntityNodeStringIndex& index) const
 {
-  std::set<EntityNodeBase*> result;
+  std::vector<EntityNodeBase*> result;
   switch (m_type)
   {
   case Type_Exact:
-    index.find_matches(m_pattern, std::inserter(result, std::end(result)));
+    index.find_matches(m_pattern, std::back_inserter(result));
     break;
   case Type_Prefix:
-    index.find_matches(m_pattern + "*", std::inserter(result, std::end(result)));
+    index.find_matches(m_pattern + "*", std::back_inserter(result));
     break;
   case Type_Numbered:
-    index.find_matches(m_pattern + "%*", std::inserter(result, std::end(result)));
+    index.find_matches(m_pattern + "%*", std::back_inserter(result));
     break;
   case Type_Any:
     break;
     switchDefault();
   }
-  return result;
+  return kdl::vec_sort_and_remove_duplicates(std::move(result));
 }
 
 bool EntityNodeIndexQuery::execute(
@@ -113,6 +114,22 @@ std::vector<Model::EntityProperty> EntityNodeIndexQuery::execute(
   }
 }
 
+bool EntityNodeIndexQuery::execute(const EntityProperty& property) const
+{
+  switch (m_type)
+  {
+  case Type_Exact:
+    return property.hasKey(m_pattern);
+  case Type_Prefix:
+    return property.hasPrefix(m_pattern);
+  case Type_Numbered:
+    return property.hasNumberedPrefix(m_pattern);
+  case Type_Any:
+    return true;
+    switchDefault();
+  }
+}
+
 EntityNodeIndexQuery::EntityNodeIndexQuery(const Type type, const std::string& pattern)
   : m_type(type)
   , m_pattern(pattern)
@@ -142,13 +159,14 @@ void EntityNodeIndex::removeEntityNode(EntityNodeBase* node)
 void EntityNodeIndex::addProperty(
   EntityNodeBase* node, const std::string& key, const std::string& value)
 {
-  m_keyIndex->insert(key, node);
-  m_valueIndex->insert(value, node);
+  m_pendingProperties.push_back({node, key, value});
 }
 
 void EntityNodeIndex::removeProperty(
   EntityNodeBase* node, const std::string& key, const std::string& value)
 {
+  flushPendingProperties();
+
   m_keyIndex->remove(key, node);
   m_valueIndex->remove(value, node);
 }
@@ -156,6 +174,8 @@ void EntityNodeIndex::removeProperty(
 std::vector<EntityNodeBase*> EntityNodeIndex::findEntityNodes(
   const EntityNodeIndexQuery& keyQuery, const std::string& value) const
 {
+  flushPendingProperties();
+
   // first, find Nodes which have `value` as the value for any key
   std::vector<EntityNodeBase*> result;
   m_valueIndex->find_matches(value, std::back_inserter(result));
@@ -182,6 +202,8 @@ std::vector<EntityNodeBase*> EntityNodeIndex::findEntityNodes(
 
 std::vector<std::string> EntityNodeIndex::allKeys() const
 {
+  flushPendingProperties();
+
   std::vector<std::string> result;
   m_keyIndex->get_keys(std::back_inserter(result));
   return result;
@@ -190,19 +212,78 @@ std::vector<std::string> EntityNodeIndex::allKeys() const
 std::vector<std::string> EntityNodeIndex::allValuesForKeys(
   const EntityNodeIndexQuery& keyQuery) const
 {
+  flushPendingProperties();
+
   std::vector<std::string> result;
 
-  const std::set<EntityNodeBase*> nameResult = keyQuery.execute(*m_keyIndex);
-  for (const auto node : nameResult)
+  // match the properties in place to avoid copying every matching property of every node
+  const auto nameResult = keyQuery.execute(*m_keyIndex);
+  for (const auto* node : nameResult)
   {
-    const auto matchingProperties = keyQuery.execute(node);
-    for (const auto& property : matchingProperties)
+    for (const auto& property : node->entity().properties())
     {
-      result.push_back(property.value());
+      if (keyQuery.execute(property))
+      {
+        result.push_back(property.value());
+      }
     }
   }
 
   return result;
 }
+
+void EntityNodeIndex::flush()
+{
+  flushPendingProperties();
+}
+
+size_t EntityNodeIndex::memoryUsage() const
+{
+  const auto lock = std::lock_guard{m_pendingPropertiesMutex};
+  return sizeof(EntityNodeIndex) + m_keyIndex->memory_usage()
+         + m_valueIndex->memory_usage()
+         + m_pendingProperties.capacity() * sizeof(PendingProperty);
+}
+
+void EntityNodeIndex::flushPendingProperties() const
+{
+  // below this size, the overhead of starting a thread outweighs the gains
+  static constexpr auto MinParallelBatchSize = size_t(1024);
+
+  const auto lock = std::lock_guard{m_pendingPropertiesMutex};
+  if (m_pendingProperties.empty())
+  {
+    return;
+  }
+
+  const auto insertKeys = [&]() {
+    for (const auto& pendingProperty : m_pendingProperties)
+    {
+      m_keyIndex->insert(pendingProperty.key, pendingProperty.node);
+    }
+  };
+
+  const auto insertValues = [&]() {
+    for (const auto& pendingProperty : m_pendingProperties)
+    {
+      m_valueIndex->insert(pendingProperty.value, pendingProperty.node);
+    }
+  };
+
+  if (m_pendingProperties.size() < MinParallelBatchSize)
+  {
+    insertKeys();
+    insertValues();
+  }
+  else
+  {
+    // the tries are independent of each other, so they can be built concurrently
+    auto keysInserted = std::async(std::launch::async, insertKeys);
+    insertValues();
+    keysInserted.get();
+  }
+
+  m_pendingProperties.clear();
+}
 } // namespace Model
 } // namespace TrenchBroom
@@ -22,7 +22,7 @@
 #include "kdl/compact_trie_forward.h"
 
 #include <memory>
-#include <set>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -56,19 +56,43 @@ public:
   static EntityNodeIndexQuery numbered(const std::string& pattern);
   static EntityNodeIndexQuery any();
 
-  std::set<EntityNodeBase*> execute(const EntityNodeStringIndex& index) const;
+  std::vector<EntityNodeBase*> execute(const EntityNodeStringIndex& index) const;
   bool execute(const EntityNodeBase* node, const std::string& value) const;
   std::vector<Model::EntityProperty> execute(const EntityNodeBase* node) const;
+  bool execute(const EntityProperty& property) const;
 
 private:
   explicit EntityNodeIndexQuery(Type type, const std::string& pattern = "");
 };
 
+/**
+ * Indexes entity nodes by their property keys and values.
+ *
+ * Added properties are not inserted into the index immediately. Instead, they are
+ * buffered and inserted in a batch when the index is queried next or when a property is
+ * removed. Large batches are inserted into the key and value tries concurrently, which
+ * speeds up building the index when a map is loaded or a large number of entities is
+ * added at once.
+ *
+ * The const queries may be called concurrently. The pending properties are inserted
+ * while holding a lock, so the first of several concurrent queries inserts them and the
+ * others wait for it. The other member functions must not be called concurrently with
+ * any other member function.
+ */
 class EntityNodeIndex
 {
 private:
+  struct PendingProperty
+  {
+    EntityNodeBase* node;
+    std::string key;
+    std::string value;
+  };
+
   std::unique_ptr<EntityNodeStringIndex> m_keyIndex;
   std::unique_ptr<EntityNodeStringIndex> m_valueIndex;
+  mutable std::mutex m_pendingPropertiesMutex;
+  mutable std::vector<PendingProperty> m_pendingProperties;
 
 public:
   EntityNodeIndex();
@@ -86,6 +110,20 @@ public:
     const EntityNodeIndexQuery& keyQuery, const std::string& value) const;
   std::vector<std::string> allKeys() const;
   std::vector<std::string> allValuesForKeys(const EntityNodeIndexQuery& keyQuery) const;
+
+  /**
+   * Inserts the pending properties into the index. Call this after adding a large number
+   * of entity nodes so that subsequent queries do not have to wait for the insertion.
+   */
+  void flush();
+
+  /**
+   * Returns an estimate of the number of bytes used by this index.
+   */
+  size_t memoryUsage() const;
+
+private:
+  void flushPendingProperties() const;
 };
 } // namespace Model
 } // namespace TrenchBroom
@@ -48,6 +48,7 @@
 #include <functional>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 namespace TrenchBroom::Model
@@ -122,11 +123,41 @@ bool GroupNode::hasPendingChanges() const
 void GroupNode::setHasPendingChanges(const bool hasPendingChanges)
 {
   m_hasPendingChanges = hasPendingChanges;
+  m_pendingChangedNodes = std::nullopt;
+}
+
+const std::optional<std::vector<Node*>>& GroupNode::pendingChangedNodes() const
+{
+  return m_pendingChangedNodes;
+}
+
+void GroupNode::addPendingChangedNodes(const std::vector<Node*>& changedNodes)
+{
+  if (!m_hasPendingChanges)
+  {
+    m_hasPendingChanges = true;
+    m_pendingChangedNodes = changedNodes;
+  }
+  else if (m_pendingChangedNodes)
+  {
+    // a transaction such as a drag changes the same nodes many times
+    auto& pendingChangedNodes = *m_pendingChangedNodes;
+    auto knownNodes =
+      std::unordered_set<Node*>{pendingChangedNodes.begin(), pendingChangedNodes.end()};
+    for (auto* node : changedNodes)
+    {
+      if (knownNodes.insert(node).second)
+      {
+        pendingChangedNodes.push_back(node);
+      }
+    }
+  }
 }
 
 void GroupNode::setEditState(const EditState editState)
 {
   m_editState = editState;
+  invalidateCachedEditorStates();
 }
 
 void GroupNode::setAncestorEditState(const EditState editState)
@@ -250,12 +281,6 @@ void GroupNode::doNodePhysicalBoundsDidChange()
   invalidateBounds();
 }
 
-void GroupNode::doChildPhysicalBoundsDidChange()
-{
-  invalidateBounds();
-  nodePhysicalBoundsDidChange();
-}
-
 bool GroupNode::doSelectable() const
 {
   return true;
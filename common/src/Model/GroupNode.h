@@ -70,6 +70,13 @@ private:
 
   bool m_hasPendingChanges = false;
 
+  /**
+   * If only the contents of some descendants of this group have changed since the pending
+   * changes were last propagated, this contains those descendants. It is unset if the
+   * structure of this group has changed, in which case the entire group must be updated.
+   */
+  std::optional<std::vector<Node*>> m_pendingChangedNodes;
+
 public:
   explicit GroupNode(Group group);
 
@@ -89,6 +96,19 @@ public:
   bool hasPendingChanges() const;
   void setHasPendingChanges(bool hasPendingChanges);
 
+  /**
+   * Returns the descendants whose contents have changed if these are the only pending
+   * changes of this group, and an empty optional otherwise.
+   */
+  const std::optional<std::vector<Node*>>& pendingChangedNodes() const;
+
+  /**
+   * Records that the contents of the given descendants have changed. Unless this group
+   * already has other pending changes, only the given nodes need to be propagated to the
+   * other members of its link set.
+   */
+  void addPendingChangedNodes(const std::vector<Node*>& changedNodes);
+
 private:
   void setEditState(EditState editState);
   void setAncestorEditState(EditState editState);
@@ -115,7 +135,6 @@ private: // implement methods inherited from Node
   void doChildWasRemoved(Node* node) override;
 
   void doNodePhysicalBoundsDidChange() override;
-  void doChildPhysicalBoundsDidChange() override;
 
   bool doSelectable() const override;
 
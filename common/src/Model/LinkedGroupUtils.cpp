@@ -33,8 +33,12 @@
 #include "kdl/result_fold.h"
 #include "kdl/zip_iterator.h"
 
+#include <algorithm>
+#include <iterator>
+#include <optional>
 #include <string_view>
 #include <unordered_map>
+#include <variant>
 
 namespace TrenchBroom::Model
 {
@@ -262,6 +266,45 @@ Result<std::unique_ptr<Node>> cloneAndTransformRecursive(
            });
 }
 
+/**
+ * Returns a copy of the contents of the given node, transformed by the given
+ * transformation.
+ */
+Result<NodeContents> transformNodeContents(
+  const Node& node, const vm::bbox3& worldBounds, const vm::mat4x4& transformation)
+{
+  return node.accept(kdl::overload(
+    [](const WorldNode*) -> Result<NodeContents> {
+      ensure(false, "Linked group structure is valid");
+    },
+    [](const LayerNode*) -> Result<NodeContents> {
+      ensure(false, "Linked group structure is valid");
+    },
+    [&](const GroupNode* groupNode) -> Result<NodeContents> {
+      auto group = groupNode->group();
+      group.transform(transformation);
+      return NodeContents{std::move(group)};
+    },
+    [&](const EntityNode* entityNode) -> Result<NodeContents> {
+      const auto updateAngleProperty =
+        entityNode->entityPropertyConfig().updateAnglePropertyAfterTransform;
+      auto entity = entityNode->entity();
+      entity.transform(transformation, updateAngleProperty);
+      return NodeContents{std::move(entity)};
+    },
+    [&](const BrushNode* brushNode) -> Result<NodeContents> {
+      auto brush = brushNode->brush();
+      return brush.transform(worldBounds, transformation, true)
+             | kdl::and_then(
+               [&]() -> Result<NodeContents> { return NodeContents{std::move(brush)}; });
+    },
+    [&](const PatchNode* patchNode) -> Result<NodeContents> {
+      auto patch = patchNode->patch();
+      patch.transform(transformation);
+      return NodeContents{std::move(patch)};
+    }));
+}
+
 /**
  * Given a node, clones its children recursively and applies the given transform.
  *
@@ -278,38 +321,10 @@ Result<std::vector<std::unique_ptr<Node>>> cloneAndTransformChildren(
   // `nodesToClone`
   auto transformResults =
     kdl::vec_parallel_transform(nodesToClone, [&](const Node* nodeToTransform) {
-      return nodeToTransform->accept(kdl::overload(
-        [](const WorldNode*) -> TransformResult {
-          ensure(false, "Linked group structure is valid");
-        },
-        [](const LayerNode*) -> TransformResult {
-          ensure(false, "Linked group structure is valid");
-        },
-        [&](const GroupNode* groupNode) -> TransformResult {
-          auto group = groupNode->group();
-          group.transform(transformation);
-          return std::make_pair(nodeToTransform, NodeContents{std::move(group)});
-        },
-        [&](const EntityNode* entityNode) -> TransformResult {
-          const auto updateAngleProperty =
-            entityNode->entityPropertyConfig().updateAnglePropertyAfterTransform;
-          auto entity = entityNode->entity();
-          entity.transform(transformation, updateAngleProperty);
-          return std::make_pair(nodeToTransform, NodeContents{std::move(entity)});
-        },
-        [&](const BrushNode* brushNode) -> TransformResult {
-          auto brush = brushNode->brush();
-          return brush.transform(worldBounds, transformation, true)
-                 | kdl::and_then([&]() -> TransformResult {
-                     return std::make_pair(
-                       nodeToTransform, NodeContents{std::move(brush)});
-                   });
-        },
-        [&](const PatchNode* patchNode) -> TransformResult {
-          auto patch = patchNode->patch();
-          patch.transform(transformation);
-          return std::make_pair(nodeToTransform, NodeContents{std::move(patch)});
-        }));
+      return transformNodeContents(*nodeToTransform, worldBounds, transformation)
+             | kdl::and_then([&](auto contents) -> TransformResult {
+                 return std::make_pair(nodeToTransform, std::move(contents));
+               });
     });
 
   return std::move(transformResults) | kdl::fold()
@@ -403,19 +418,8 @@ void preserveGroupNames(
       [](const PatchNode*) {}));
 }
 
-void preserveEntityProperties(
-  EntityNode& clonedEntityNode, const EntityNode& correspondingEntityNode)
+void preserveEntityProperties(Entity& clonedEntity, const Entity& correspondingEntity)
 {
-  if (
-    clonedEntityNode.entity().protectedProperties().empty()
-    && correspondingEntityNode.entity().protectedProperties().empty())
-  {
-    return;
-  }
-
-  auto clonedEntity = clonedEntityNode.entity();
-  const auto& correspondingEntity = correspondingEntityNode.entity();
-
   const auto allProtectedProperties = kdl::vec_sort_and_remove_duplicates(kdl::vec_concat(
     clonedEntity.protectedProperties(), correspondingEntity.protectedProperties()));
 
@@ -430,7 +434,20 @@ void preserveEntityProperties(
       clonedEntity.addOrUpdateProperty(propertyKey, *propertyValue);
     }
   }
+}
 
+void preserveEntityProperties(
+  EntityNode& clonedEntityNode, const EntityNode& correspondingEntityNode)
+{
+  if (
+    clonedEntityNode.entity().protectedProperties().empty()
+    && correspondingEntityNode.entity().protectedProperties().empty())
+  {
+    return;
+  }
+
+  auto clonedEntity = clonedEntityNode.entity();
+  preserveEntityProperties(clonedEntity, correspondingEntityNode.entity());
   clonedEntityNode.setEntity(std::move(clonedEntity));
 }
 
@@ -500,6 +517,182 @@ Result<UpdateLinkedGroupsResult> updateLinkedGroups(
 namespace
 {
 
+/**
+ * Returns the positions of the given node and its ancestors within their respective
+ * parents, starting at the given ancestor node. Returns an empty optional if the given
+ * node is not a descendant of the given ancestor node.
+ */
+std::optional<std::vector<size_t>> getChildIndexPath(
+  const Node& ancestorNode, const Node& node)
+{
+  auto result = std::vector<size_t>{};
+
+  const auto* currentNode = &node;
+  while (currentNode != &ancestorNode)
+  {
+    const auto* parentNode = currentNode->parent();
+    if (!parentNode)
+    {
+      return std::nullopt;
+    }
+
+    const auto& siblings = parentNode->children();
+    const auto it = std::find(siblings.begin(), siblings.end(), currentNode);
+    result.push_back(size_t(std::distance(siblings.begin(), it)));
+    currentNode = parentNode;
+  }
+
+  std::reverse(result.begin(), result.end());
+  return result;
+}
+
+Node* findNodeByChildIndexPath(Node& rootNode, const std::vector<size_t>& childIndexPath)
+{
+  auto* currentNode = &rootNode;
+  for (const auto childIndex : childIndexPath)
+  {
+    if (childIndex >= currentNode->childCount())
+    {
+      return nullptr;
+    }
+    currentNode = currentNode->children()[childIndex];
+  }
+  return currentNode;
+}
+
+const std::string* getLinkId(const Node& node)
+{
+  return node.accept(kdl::overload(
+    [](const WorldNode*) -> const std::string* { return nullptr; },
+    [](const LayerNode*) -> const std::string* { return nullptr; },
+    [](const Object* object) -> const std::string* { return &object->linkId(); }));
+}
+
+bool isLinkedTo(const Node& sourceNode, const Node& targetNode)
+{
+  const auto* sourceLinkId = getLinkId(sourceNode);
+  const auto* targetLinkId = getLinkId(targetNode);
+  return sourceLinkId && targetLinkId && *sourceLinkId == *targetLinkId;
+}
+
+void preserveContents(NodeContents& contents, const Node& correspondingNode)
+{
+  std::visit(
+    kdl::overload(
+      [](Layer&) {},
+      [&](Group& group) {
+        if (const auto* correspondingGroupNode =
+              dynamic_cast<const GroupNode*>(&correspondingNode))
+        {
+          group.setName(correspondingGroupNode->group().name());
+        }
+      },
+      [&](Entity& entity) {
+        if (const auto* correspondingEntityNode =
+              dynamic_cast<const EntityNode*>(&correspondingNode))
+        {
+          preserveEntityProperties(entity, correspondingEntityNode->entity());
+        }
+      },
+      [](Brush&) {},
+      [](BezierPatch&) {}),
+    contents.get());
+}
+
+bool isWithinWorldBounds(
+  const NodeContents& contents, const Node& targetNode, const vm::bbox3& worldBounds)
+{
+  return std::visit(
+    kdl::overload(
+      [](const Layer&) { return true; },
+      [](const Group&) { return true; },
+      [&](const Entity& entity) {
+        // the bounds of a brush entity are the bounds of its children, which are checked
+        // separately if they have changed
+        return worldBounds.contains(
+          targetNode.hasChildren()
+            ? computeLogicalBounds(targetNode.children())
+            : entity.definitionBounds().translate(entity.origin()));
+      },
+      [&](const Brush& brush) { return worldBounds.contains(brush.bounds()); },
+      [&](const BezierPatch& patch) { return worldBounds.contains(patch.bounds()); }),
+    contents.get());
+}
+
+} // namespace
+
+Result<UpdateLinkedNodesResult> updateLinkedNodes(
+  const GroupNode& sourceGroupNode,
+  const std::vector<GroupNode*>& targetGroupNodes,
+  const std::vector<Node*>& changedNodes,
+  const vm::bbox3& worldBounds)
+{
+  const auto& sourceGroup = sourceGroupNode.group();
+  const auto invertedSourceTransformation = vm::invert(sourceGroup.transformation());
+  if (!invertedSourceTransformation)
+  {
+    return Error{"Group transformation is not invertible"};
+  }
+
+  const auto sourceNodes = kdl::vec_sort_and_remove_duplicates(changedNodes);
+
+  auto childIndexPaths = std::vector<std::vector<size_t>>{};
+  childIndexPaths.reserve(sourceNodes.size());
+  for (const auto* sourceNode : sourceNodes)
+  {
+    auto childIndexPath = getChildIndexPath(sourceGroupNode, *sourceNode);
+    if (!childIndexPath || childIndexPath->empty())
+    {
+      return Error{"Changed node is not a descendant of the linked group"};
+    }
+    childIndexPaths.push_back(std::move(*childIndexPath));
+  }
+
+  const auto targetGroupNodesToUpdate =
+    kdl::vec_erase(targetGroupNodes, &sourceGroupNode);
+  return kdl::vec_parallel_transform(
+           targetGroupNodesToUpdate,
+           [&](auto* targetGroupNode) {
+             const auto transformation =
+               targetGroupNode->group().transformation() * *invertedSourceTransformation;
+             return kdl::vec_transform(
+                      kdl::make_zip_range(sourceNodes, childIndexPaths),
+                      [&](auto nodeAndPath) -> Result<std::pair<Node*, NodeContents>> {
+                        const auto& [sourceNode, childIndexPath] = nodeAndPath;
+
+                        auto* targetNode =
+                          findNodeByChildIndexPath(*targetGroupNode, childIndexPath);
+                        if (!targetNode || !isLinkedTo(*sourceNode, *targetNode))
+                        {
+                          return Error{"Inconsistent linked group structure"};
+                        }
+
+                        return transformNodeContents(
+                                 *sourceNode, worldBounds, transformation)
+                               | kdl::and_then(
+                                 [&](auto contents)
+                                   -> Result<std::pair<Node*, NodeContents>> {
+                                   preserveContents(contents, *targetNode);
+                                   if (!isWithinWorldBounds(
+                                         contents, *targetNode, worldBounds))
+                                   {
+                                     return Error{
+                                       "Updating a linked node would exceed world "
+                                       "bounds"};
+                                   }
+                                   return std::pair{targetNode, std::move(contents)};
+                                 });
+                      })
+                    | kdl::fold();
+           })
+         | kdl::fold() | kdl::transform([](auto nestedUpdateLists) {
+             return kdl::vec_flatten(std::move(nestedUpdateLists));
+           });
+}
+
+namespace
+{
+
 template <typename N1, typename N2>
 Result<N1*> tryCast(N2& targetNode)
 {
@@ -25,6 +25,7 @@
 #include "Model/EntityNode.h"
 #include "Model/GroupNode.h"
 #include "Model/LayerNode.h"
+#include "Model/NodeContents.h"
 #include "Model/NodeVisitor.h"
 #include "Model/PatchNode.h"
 #include "Model/WorldNode.h"
@@ -137,6 +138,34 @@ Result<UpdateLinkedGroupsResult> updateLinkedGroups(
   const std::vector<Model::GroupNode*>& targetGroupNodes,
   const vm::bbox3& worldBounds);
 
+using UpdateLinkedNodesResult = std::vector<std::pair<Node*, NodeContents>>;
+
+/**
+ * Updates the nodes linked to the given changed nodes in the given target group nodes.
+ *
+ * Unlike updateLinkedGroups, this function does not clone the children of the source
+ * group node. Instead, only the contents of the given changed nodes are transformed into
+ * the target groups. This requires that the structure of the source group and the target
+ * groups has not changed, which is verified by checking that every changed node has a
+ * node with the same link ID at the same position in every target group.
+ *
+ * Group names and protected entity properties are preserved in the same way as in
+ * updateLinkedGroups.
+ *
+ * If this operation fails for any changed node and target group, then an error is
+ * returned. In addition to the conditions listed for updateLinkedGroups, the operation
+ * fails if a changed node is not a descendant of the source group node or if it has no
+ * corresponding node in a target group.
+ *
+ * If this operation succeeds, a vector of pairs is returned where each pair consists of
+ * a node in a target group and its new contents.
+ */
+Result<UpdateLinkedNodesResult> updateLinkedNodes(
+  const GroupNode& sourceGroupNode,
+  const std::vector<Model::GroupNode*>& targetGroupNodes,
+  const std::vector<Node*>& changedNodes,
+  const vm::bbox3& worldBounds);
+
 std::vector<Error> initializeLinkIds(const std::vector<Node*>& nodes);
 
 
@@ -27,6 +27,7 @@
 #include "Model/NodeQueries.h"
 #include "Polyhedron.h"
 
+#include "kdl/string_utils.h"
 #include "kdl/vector_utils.h"
 
 #include <vector>
@@ -382,4 +383,57 @@ std::vector<EntityNode*> filterEntityNodes(const std::vector<Node*>& nodes)
   return result;
 }
 
+size_t NodeMemoryUsage::total() const
+{
+  return containers + entities + brushes + patches;
+}
+
+namespace
+{
+template <typename N>
+size_t nodeMemoryUsage(const N& node)
+{
+  return sizeof(N) + node.children().capacity() * sizeof(Node*);
+}
+} // namespace
+
+NodeMemoryUsage computeMemoryUsage(const std::vector<Node*>& nodes)
+{
+  auto result = NodeMemoryUsage{};
+  Node::visitAll(
+    nodes,
+    kdl::overload(
+      [&](auto&& thisLambda, const WorldNode* worldNode) {
+        result.containers += nodeMemoryUsage(*worldNode) - sizeof(Entity)
+                             + worldNode->entity().memoryUsage();
+        worldNode->visitChildren(thisLambda);
+      },
+      [&](auto&& thisLambda, const LayerNode* layerNode) {
+        result.containers +=
+          nodeMemoryUsage(*layerNode) + kdl::str_allocated_size(layerNode->name());
+        layerNode->visitChildren(thisLambda);
+      },
+      [&](auto&& thisLambda, const GroupNode* groupNode) {
+        result.containers +=
+          nodeMemoryUsage(*groupNode) + kdl::str_allocated_size(groupNode->name());
+        groupNode->visitChildren(thisLambda);
+      },
+      [&](auto&& thisLambda, const EntityNode* entityNode) {
+        result.entities += nodeMemoryUsage(*entityNode) - sizeof(Entity)
+                           + entityNode->entity().memoryUsage();
+        entityNode->visitChildren(thisLambda);
+      },
+      [&](const BrushNode* brushNode) {
+        result.brushes += nodeMemoryUsage(*brushNode) - sizeof(Brush)
+                          + brushNode->brush().memoryUsage();
+      },
+      [&](const PatchNode* patchNode) {
+        const auto& gridPoints = patchNode->grid().points;
+        result.patches += nodeMemoryUsage(*patchNode) - sizeof(BezierPatch)
+                          + patchNode->patch().memoryUsage()
+                          + gridPoints.capacity() * sizeof(PatchGrid::Point);
+      }));
+  return result;
+}
+
 } // namespace TrenchBroom::Model
@@ -82,4 +82,25 @@ vm::bbox3 computePhysicalBounds(
 std::vector<BrushNode*> filterBrushNodes(const std::vector<Node*>& nodes);
 std::vector<EntityNode*> filterEntityNodes(const std::vector<Node*>& nodes);
 
+/**
+ * An estimate of the number of bytes used by nodes and their contents, grouped by the
+ * type of node. Worlds, layers and groups are counted as containers.
+ */
+struct NodeMemoryUsage
+{
+  size_t containers = 0;
+  size_t entities = 0;
+  size_t brushes = 0;
+  size_t patches = 0;
+
+  size_t total() const;
+};
+
+/**
+ * Returns an estimate of the number of bytes used by the given nodes and their
+ * descendants. The estimate does not account for allocator overhead or caches such as
+ * renderer data.
+ */
+NodeMemoryUsage computeMemoryUsage(const std::vector<Node*>& nodes);
+
 } // namespace TrenchBroom::Model
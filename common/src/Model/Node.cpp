@@ -443,7 +443,9 @@ void Node::setParent(Node* parent)
   if (parent != m_parent)
   {
     parentWillChange();
+    invalidateCachedEditorStates();
     m_parent = parent;
+    invalidateCachedEditorStates();
     parentDidChange();
   }
 }
@@ -491,6 +493,7 @@ void Node::nodeWillChange()
 
 void Node::nodeDidChange()
 {
+  invalidateCachedEditorStates();
   if (m_parent)
   {
     m_parent->childDidChange(this);
@@ -587,6 +590,7 @@ void Node::select()
   {
     assert(!m_selected);
     m_selected = true;
+    invalidateCachedEditorStates();
     if (m_parent)
     {
       m_parent->childWasSelected();
@@ -600,6 +604,7 @@ void Node::deselect()
   {
     assert(m_selected);
     m_selected = false;
+    invalidateCachedEditorStates();
     if (m_parent)
     {
       m_parent->childWasDeselected();
@@ -735,6 +740,7 @@ bool Node::setVisibilityState(const VisibilityState visibility)
   if (visibility != m_visibilityState)
   {
     m_visibilityState = visibility;
+    invalidateCachedEditorStates();
     return true;
   }
   return false;
@@ -778,6 +784,7 @@ bool Node::setLockState(const LockState lockState)
   if (lockState != m_lockState)
   {
     m_lockState = lockState;
+    invalidateCachedEditorStates();
     return true;
   }
   return false;
@@ -791,6 +798,61 @@ bool Node::lockedByOtherSelection() const
 void Node::setLockedByOtherSelection(const bool lockedByOtherSelection)
 {
   m_lockedByOtherSelection = lockedByOtherSelection;
+  invalidateCachedEditorStates();
+}
+
+void Node::updateTags(TagManager& tagManager)
+{
+  Taggable::updateTags(tagManager);
+  invalidateCachedEditorStates();
+}
+
+void Node::clearTags()
+{
+  Taggable::clearTags();
+  invalidateCachedEditorStates();
+}
+
+std::uint8_t Node::cachedEditorState(const std::uint64_t cacheVersion) const
+{
+  return m_cachedEditorStateVersion == cacheVersion
+           ? m_cachedEditorState.load(std::memory_order_relaxed)
+           : 0;
+}
+
+void Node::setCachedEditorState(
+  const std::uint64_t cacheVersion, const std::uint8_t state) const
+{
+  m_cachedEditorStateVersion = cacheVersion;
+  m_cachedEditorState.store(state, std::memory_order_relaxed);
+}
+
+void Node::invalidateCachedEditorState() const
+{
+  // only write if necessary, nodes are created and tagged in parallel
+  if (m_cachedEditorState.load(std::memory_order_relaxed) != 0)
+  {
+    m_cachedEditorState.store(0, std::memory_order_relaxed);
+  }
+}
+
+void Node::invalidateCachedEditorStates() const
+{
+  // the visibility of a node depends on its children, and its visibility, editability and
+  // selectability depend on its ancestors
+  for (const auto* node = this; node; node = node->m_parent)
+  {
+    node->invalidateCachedEditorState();
+  }
+
+  const auto invalidateDescendants = [](const auto& recurse, const Node& node) -> void {
+    for (const auto* child : node.m_children)
+    {
+      child->invalidateCachedEditorState();
+      recurse(recurse, *child);
+    }
+  };
+  invalidateDescendants(invalidateDescendants, *this);
 }
 
 void Node::pick(
@@ -33,6 +33,8 @@
 #include "vm/util.h"
 
 #include <algorithm>
+#include <atomic>
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <vector>
@@ -85,6 +87,11 @@ private:
   mutable bool m_issuesValid = false;
   IssueType m_hiddenIssues = 0;
 
+  // the state cached by EditorContext, only valid for the cache version it was computed
+  // for; atomic because brush nodes are tagged in parallel
+  mutable std::uint64_t m_cachedEditorStateVersion = 0;
+  mutable std::atomic<std::uint8_t> m_cachedEditorState = 0;
+
 protected:
   Node();
 
@@ -350,6 +357,27 @@ public: // visibility, locking
   bool lockedByOtherSelection() const;
   void setLockedByOtherSelection(bool lockedByOtherSelection);
 
+public: // tagging
+  void updateTags(TagManager& tagManager) override;
+  void clearTags() override;
+
+public: // editor context state cache
+  /**
+   * Returns the state that an editor context cached for this node with the given cache
+   * version, or 0 if the cached state is invalid or was cached with a different version.
+   *
+   * The cached state is invalidated whenever this node, one of its ancestors or one of its
+   * descendants changes.
+   */
+  std::uint8_t cachedEditorState(std::uint64_t cacheVersion) const;
+  void setCachedEditorState(std::uint64_t cacheVersion, std::uint8_t state) const;
+
+protected:
+  void invalidateCachedEditorStates() const;
+
+private:
+  void invalidateCachedEditorState() const;
+
 public: // picking
   void pick(const EditorContext& editorContext, const vm::ray3& ray, PickResult& result);
   void findNodesContaining(const vm::vec3& point, std::vector<Node*>& result);
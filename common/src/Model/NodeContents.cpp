@@ -22,6 +22,7 @@
 #include "Model/BrushFace.h"
 
 #include "kdl/overload.h"
+#include "kdl/string_utils.h"
 
 namespace TrenchBroom
 {
@@ -55,5 +56,20 @@ std::variant<Layer, Group, Entity, Brush, BezierPatch>& NodeContents::get()
 {
   return m_contents;
 }
+
+size_t NodeContents::memoryUsage() const
+{
+  return sizeof(NodeContents)
+         + std::visit(
+           kdl::overload(
+             [](const Layer& layer) { return kdl::str_allocated_size(layer.name()); },
+             [](const Group& group) { return kdl::str_allocated_size(group.name()); },
+             [](const Entity& entity) { return entity.memoryUsage() - sizeof(Entity); },
+             [](const Brush& brush) { return brush.memoryUsage() - sizeof(Brush); },
+             [](const BezierPatch& patch) {
+               return patch.memoryUsage() - sizeof(BezierPatch);
+             }),
+           m_contents);
+}
 } // namespace Model
 } // namespace TrenchBroom
@@ -45,6 +45,12 @@ public:
 
   const std::variant<Layer, Group, Entity, Brush, BezierPatch>& get() const;
   std::variant<Layer, Group, Entity, Brush, BezierPatch>& get();
+
+  /**
+   * Returns an estimate of the number of bytes used by the contained object. The estimate
+   * does not account for allocator overhead.
+   */
+  size_t memoryUsage() const;
 };
 } // namespace Model
 } // namespace TrenchBroom
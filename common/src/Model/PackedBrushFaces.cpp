@@ -0,0 +1,254 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PackedBrushFaces.h"
+
+#include "Ensure.h"
+#include "Model/BrushFace.h"
+#include "Model/BrushGeometry.h"
+#include "Model/Polyhedron.h"
+
+#include "vm/constants.h"
+#include "vm/intersection.h"
+#include "vm/plane.h"
+#include "vm/ray.h"
+
+#include <iterator>
+
+namespace TrenchBroom::Model
+{
+namespace
+{
+
+/**
+ * Returns above if at least one of the given points is above the given plane and none
+ * are below, below if no point is above, and inside otherwise. This matches
+ * Polyhedron::pointStatus.
+ */
+vm::plane_status pointStatus(
+  const vm::vec3& normal, const FloatType distance, const std::vector<vm::vec3>& points)
+{
+  constexpr auto epsilon = vm::constants<FloatType>::point_status_epsilon();
+
+  auto above = false;
+  auto below = false;
+  for (const auto& point : points)
+  {
+    const auto pointDistance = vm::dot(point, normal) - distance;
+    above = above || pointDistance > epsilon;
+    below = below || pointDistance < -epsilon;
+    if (above && below)
+    {
+      return vm::plane_status::inside;
+    }
+  }
+  return above ? vm::plane_status::above : vm::plane_status::below;
+}
+
+/**
+ * Indicates whether any of the given planes has all of the given points above it.
+ */
+bool separate(
+  const std::vector<vm::vec3>& normals,
+  const std::vector<FloatType>& distances,
+  const std::vector<vm::vec3>& points)
+{
+  for (size_t i = 0u; i < normals.size(); ++i)
+  {
+    if (pointStatus(normals[i], distances[i], points) == vm::plane_status::above)
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+} // namespace
+
+PackedBrushFaces::PackedBrushFaces() = default;
+
+PackedBrushFaces::PackedBrushFaces(
+  const std::vector<BrushFace>& faces, const BrushGeometry& geometry)
+{
+  m_normals.reserve(faces.size());
+  m_distances.reserve(faces.size());
+  m_polygonOffsets.reserve(faces.size() + 1u);
+  m_polygonOffsets.push_back(0u);
+
+  for (const auto& face : faces)
+  {
+    const auto* faceGeometry = face.geometry();
+    ensure(faceGeometry != nullptr, "geometry is null");
+
+    m_normals.push_back(face.boundary().normal);
+    m_distances.push_back(face.boundary().distance);
+    m_polygonOffsets.push_back(m_polygonOffsets.back() + faceGeometry->vertexCount());
+  }
+
+  m_vertexPositions.reserve(m_polygonOffsets.back());
+  for (const auto& face : faces)
+  {
+    for (const auto* halfEdge : face.geometry()->boundary())
+    {
+      m_vertexPositions.push_back(halfEdge->origin()->position());
+    }
+  }
+
+  m_vertices.reserve(geometry.vertexCount());
+  for (const auto* vertex : geometry.vertices())
+  {
+    m_vertices.push_back(vertex->position());
+  }
+
+  m_edgeOrigins.reserve(geometry.edgeCount());
+  m_edgeVectors.reserve(geometry.edgeCount());
+  for (const auto* edge : geometry.edges())
+  {
+    m_edgeOrigins.push_back(edge->firstVertex()->position());
+    m_edgeVectors.push_back(edge->vector());
+  }
+}
+
+size_t PackedBrushFaces::faceCount() const
+{
+  return m_normals.size();
+}
+
+const std::vector<vm::vec3>& PackedBrushFaces::normals() const
+{
+  return m_normals;
+}
+
+const std::vector<FloatType>& PackedBrushFaces::distances() const
+{
+  return m_distances;
+}
+
+const std::vector<vm::vec3>& PackedBrushFaces::vertexPositions() const
+{
+  return m_vertexPositions;
+}
+
+const std::vector<size_t>& PackedBrushFaces::polygonOffsets() const
+{
+  return m_polygonOffsets;
+}
+
+const std::vector<vm::vec3>& PackedBrushFaces::vertices() const
+{
+  return m_vertices;
+}
+
+const std::vector<vm::vec3>& PackedBrushFaces::edgeOrigins() const
+{
+  return m_edgeOrigins;
+}
+
+const std::vector<vm::vec3>& PackedBrushFaces::edgeVectors() const
+{
+  return m_edgeVectors;
+}
+
+bool PackedBrushFaces::containsPoint(const vm::vec3& point) const
+{
+  constexpr auto epsilon = vm::constants<FloatType>::point_status_epsilon();
+
+  for (size_t i = 0u; i < m_normals.size(); ++i)
+  {
+    if (vm::dot(point, m_normals[i]) - m_distances[i] > epsilon)
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+std::optional<FloatType> PackedBrushFaces::intersectWithRay(
+  const size_t faceIndex, const vm::ray3& ray) const
+{
+  const auto& normal = m_normals[faceIndex];
+  const auto cos = vm::dot(normal, ray.direction);
+  if (cos >= FloatType(0))
+  {
+    return std::nullopt;
+  }
+
+  const auto begin = std::next(
+    m_vertexPositions.begin(), static_cast<std::ptrdiff_t>(m_polygonOffsets[faceIndex]));
+  const auto end = std::next(
+    m_vertexPositions.begin(),
+    static_cast<std::ptrdiff_t>(m_polygonOffsets[faceIndex + 1u]));
+  return vm::intersect_ray_polygon(
+    ray, vm::plane3{m_distances[faceIndex], normal}, begin, end);
+}
+
+bool PackedBrushFaces::intersects(const PackedBrushFaces& other) const
+{
+  // separating axis theorem
+  // http://www.geometrictools.com/Documentation/MethodOfSeparatingAxes.pdf
+
+  if (separate(m_normals, m_distances, other.m_vertices))
+  {
+    return false;
+  }
+  if (separate(other.m_normals, other.m_distances, m_vertices))
+  {
+    return false;
+  }
+
+  for (size_t i = 0u; i < m_edgeVectors.size(); ++i)
+  {
+    const auto& edgeOrigin = m_edgeOrigins[i];
+    const auto& edgeVector = m_edgeVectors[i];
+
+    for (const auto& otherEdgeVector : other.m_edgeVectors)
+    {
+      const auto normal = vm::cross(edgeVector, otherEdgeVector);
+      if (!vm::is_zero(normal, vm::constants<FloatType>::almost_zero()))
+      {
+        const auto distance = vm::dot(edgeOrigin, normal);
+
+        const auto status = pointStatus(normal, distance, m_vertices);
+        if (status != vm::plane_status::inside)
+        {
+          const auto otherStatus = pointStatus(normal, distance, other.m_vertices);
+          if (otherStatus != vm::plane_status::inside && status != otherStatus)
+          {
+            return false;
+          }
+        }
+      }
+    }
+  }
+
+  return true;
+}
+
+size_t PackedBrushFaces::memoryUsage() const
+{
+  return sizeof(PackedBrushFaces) + m_normals.capacity() * sizeof(vm::vec3)
+         + m_distances.capacity() * sizeof(FloatType)
+         + m_vertexPositions.capacity() * sizeof(vm::vec3)
+         + m_polygonOffsets.capacity() * sizeof(size_t)
+         + m_vertices.capacity() * sizeof(vm::vec3)
+         + m_edgeOrigins.capacity() * sizeof(vm::vec3)
+         + m_edgeVectors.capacity() * sizeof(vm::vec3);
+}
+
+} // namespace TrenchBroom::Model
@@ -0,0 +1,109 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "FloatType.h"
+#include "Model/BrushGeometry.h"
+
+#include "vm/forward.h"
+#include "vm/vec.h"
+
+#include <optional>
+#include <vector>
+
+namespace TrenchBroom::Model
+{
+class BrushFace;
+
+/**
+ * Stores the planes and the polygon vertices of the faces of a brush in flat arrays, so
+ * that queries which visit every face don't have to follow the pointers of the brush
+ * geometry.
+ *
+ * The face at index i of the brush has the normal normals()[i], the distance
+ * distances()[i], and its polygon consists of the vertex positions in the range
+ * [polygonOffsets()[i], polygonOffsets()[i+1]). The polygon vertices are stored in the
+ * same order as the boundary of the face geometry.
+ *
+ * Additionally, the positions of the vertices of the brush geometry and the edges of the
+ * brush geometry are stored without duplicates. An edge is stored as the position of its
+ * first vertex and the vector from its first to its second vertex.
+ */
+class PackedBrushFaces
+{
+private:
+  std::vector<vm::vec3> m_normals;
+  std::vector<FloatType> m_distances;
+  std::vector<vm::vec3> m_vertexPositions;
+  std::vector<size_t> m_polygonOffsets;
+  std::vector<vm::vec3> m_vertices;
+  std::vector<vm::vec3> m_edgeOrigins;
+  std::vector<vm::vec3> m_edgeVectors;
+
+public:
+  PackedBrushFaces();
+
+  /**
+   * Creates packed faces from the given faces and their geometry. Every face must have a
+   * face geometry that belongs to the given geometry.
+   */
+  PackedBrushFaces(const std::vector<BrushFace>& faces, const BrushGeometry& geometry);
+
+  size_t faceCount() const;
+
+  const std::vector<vm::vec3>& normals() const;
+  const std::vector<FloatType>& distances() const;
+  const std::vector<vm::vec3>& vertexPositions() const;
+  const std::vector<size_t>& polygonOffsets() const;
+  const std::vector<vm::vec3>& vertices() const;
+  const std::vector<vm::vec3>& edgeOrigins() const;
+  const std::vector<vm::vec3>& edgeVectors() const;
+
+  /**
+   * Indicates whether the given point is not above any of the face planes. This is
+   * equivalent to checking the point status of the point against each face boundary.
+   */
+  bool containsPoint(const vm::vec3& point) const;
+
+  /**
+   * Intersects the given ray with the polygon of the face with the given index. Like
+   * BrushFace::intersectWithRay, only hits on the front side of the face are reported.
+   */
+  std::optional<FloatType> intersectWithRay(size_t faceIndex, const vm::ray3& ray) const;
+
+  /**
+   * Indicates whether the convex polyhedra represented by these and the given packed
+   * faces intersect, using the separating axis theorem. The candidate axes are the face
+   * normals of both polyhedra and the cross products of every pair of their edges.
+   *
+   * This performs exactly the same computations as Polyhedron::intersects does for two
+   * polyhedra, so both give the same results. The bounds of the polyhedra are not
+   * checked.
+   */
+  bool intersects(const PackedBrushFaces& other) const;
+
+  /**
+   * Returns an estimate of the number of bytes used by these packed faces. The estimate
+   * does not account for allocator overhead.
+   */
+  size_t memoryUsage() const;
+};
+
+} // namespace TrenchBroom::Model
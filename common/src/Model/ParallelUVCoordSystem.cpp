@@ -142,6 +142,11 @@ std::unique_ptr<UVCoordSystem> ParallelUVCoordSystem::clone() const
   return std::make_unique<ParallelUVCoordSystem>(uAxis(), vAxis());
 }
 
+size_t ParallelUVCoordSystem::memoryUsage() const
+{
+  return sizeof(ParallelUVCoordSystem);
+}
+
 std::unique_ptr<UVCoordSystemSnapshot> ParallelUVCoordSystem::takeSnapshot() const
 {
   return std::make_unique<ParallelUVCoordSystemSnapshot>(this);
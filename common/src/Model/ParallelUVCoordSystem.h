@@ -72,6 +72,7 @@ public:
     const BrushFaceAttributes& attribs);
 
   std::unique_ptr<UVCoordSystem> clone() const override;
+  size_t memoryUsage() const override;
   std::unique_ptr<UVCoordSystemSnapshot> takeSnapshot() const override;
   void restoreSnapshot(const UVCoordSystemSnapshot& snapshot) override;
 
@@ -539,6 +539,11 @@ std::unique_ptr<UVCoordSystem> ParaxialUVCoordSystem::clone() const
   return std::make_unique<ParaxialUVCoordSystem>(m_index, m_uAxis, m_vAxis);
 }
 
+size_t ParaxialUVCoordSystem::memoryUsage() const
+{
+  return sizeof(ParaxialUVCoordSystem);
+}
+
 std::unique_ptr<UVCoordSystemSnapshot> ParaxialUVCoordSystem::takeSnapshot() const
 {
   return std::unique_ptr<UVCoordSystemSnapshot>();
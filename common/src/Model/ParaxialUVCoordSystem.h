@@ -58,6 +58,7 @@ public:
   static std::tuple<vm::vec3, vm::vec3, vm::vec3> axes(size_t index);
 
   std::unique_ptr<UVCoordSystem> clone() const override;
+  size_t memoryUsage() const override;
   std::unique_ptr<UVCoordSystemSnapshot> takeSnapshot() const override;
   void restoreSnapshot(const UVCoordSystemSnapshot& snapshot) override;
 
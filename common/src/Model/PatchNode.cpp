@@ -29,6 +29,7 @@
 #include "Model/LinkedGroupUtils.h"
 #include "Model/ModelUtils.h"
 #include "Model/PickResult.h"
+#include "Model/SerializedText.h"
 #include "Model/TagVisitor.h"
 #include "Model/WorldNode.h"
 
@@ -47,7 +48,9 @@
 namespace TrenchBroom::Model
 {
 
-constexpr static size_t DefaultSubdivisionsPerSurface = 3u;
+// The maximum error of a patch grid along its rows and along its columns. The errors add
+// up in the interior of a surface, so the grid is within half a unit of the surface.
+constexpr static auto MaxPatchGridError = static_cast<FloatType>(0.25);
 
 kdl_reflect_impl(PatchGrid::Point);
 
@@ -267,14 +270,222 @@ std::vector<vm::vec3> computeGridNormals(
   return normals;
 }
 
+kdl_reflect_impl(PatchSubdivisions);
+
+namespace
+{
+
+/**
+ * Returns the smallest number of subdivisions, but at most the given maximum, that brings
+ * the given approximation error down to the given maximum error. Every subdivision halves
+ * the parameter interval, which divides the error of a piecewise linear approximation of
+ * a quadratic curve by four.
+ */
+size_t subdivisionsForError(
+  FloatType error, const FloatType maxError, const size_t maxSubdivisions)
+{
+  auto subdivisions = size_t(0);
+  while (subdivisions < maxSubdivisions && error > maxError)
+  {
+    error /= static_cast<FloatType>(4);
+    ++subdivisions;
+  }
+  return subdivisions;
+}
+
+/**
+ * Returns the index of the first grid row (or column) of each surface row (or column),
+ * followed by the index of the last grid row (or column).
+ */
+std::vector<size_t> gridOffsets(const std::vector<size_t>& subdivisionsPerSurface)
+{
+  auto result = std::vector<size_t>{0u};
+  result.reserve(subdivisionsPerSurface.size() + 1u);
+  for (const auto subdivisions : subdivisionsPerSurface)
+  {
+    result.push_back(result.back() + (size_t(1) << subdivisions));
+  }
+  return result;
+}
+
+std::vector<vm::bbox3> computeSurfaceBounds(
+  const PatchGrid& grid, const PatchSubdivisions& subdivisions)
+{
+  const auto rowOffsets = gridOffsets(subdivisions.perSurfaceRow);
+  const auto columnOffsets = gridOffsets(subdivisions.perSurfaceColumn);
+
+  auto result = std::vector<vm::bbox3>{};
+  result.reserve(
+    subdivisions.perSurfaceRow.size() * subdivisions.perSurfaceColumn.size());
+
+  for (size_t surfaceRow = 0u; surfaceRow + 1u < rowOffsets.size(); ++surfaceRow)
+  {
+    for (size_t surfaceCol = 0u; surfaceCol + 1u < columnOffsets.size(); ++surfaceCol)
+    {
+      auto boundsBuilder = vm::bbox3::builder{};
+      for (size_t row = rowOffsets[surfaceRow]; row <= rowOffsets[surfaceRow + 1u];
+           ++row)
+      {
+        for (size_t col = columnOffsets[surfaceCol];
+             col <= columnOffsets[surfaceCol + 1u];
+             ++col)
+        {
+          boundsBuilder.add(grid.point(row, col).position);
+        }
+      }
+      result.push_back(boundsBuilder.bounds());
+    }
+  }
+
+  return result;
+}
+
+} // namespace
+
+/**
+ * Each surface of a patch is a biquadratic Bezier surface with 3*3 control points. Along
+ * each row or column of control points p0, p1, p2, the surface is a quadratic curve, and
+ * the distance between that curve and the line segment connecting its end points is at
+ * most |p0 - 2 * p1 + p2| / 4. A surface row is subdivided until this error is below the
+ * maximum error for every column of control points in that surface row, and vice versa
+ * for surface columns.
+ *
+ * A surface whose rows and columns are straight lines can still be twisted. Such a
+ * surface is subdivided further until the error of splitting each grid quad into two
+ * triangles is below the maximum error, too.
+ *
+ * The UV coordinates are interpolated linearly across each grid triangle. If the UV
+ * coordinates of a surface row or column are not linear, the texture mapping would
+ * depend on the number of subdivisions, so such surface rows and columns are always
+ * subdivided the maximum number of times.
+ */
+PatchSubdivisions computePatchSubdivisions(
+  const BezierPatch& patch, const FloatType maxError, const size_t maxSubdivisions)
+{
+  const auto controlPoint = [&](const size_t row, const size_t col) {
+    return patch.controlPoint(row, col).xyz();
+  };
+  const auto uvCoords = [&](const size_t row, const size_t col) {
+    const auto& point = patch.controlPoint(row, col);
+    return vm::vec2{point[3], point[4]};
+  };
+  const auto isLinear = [](const auto& uv0, const auto& uv1, const auto& uv2) {
+    return vm::is_zero(
+      uv0 - static_cast<FloatType>(2) * uv1 + uv2,
+      vm::constants<FloatType>::almost_zero());
+  };
+
+  // the maximum distance between a quadratic curve and the chord between its end points
+  const auto curveError = [](const auto& p0, const auto& p1, const auto& p2) {
+    return vm::length(p0 - static_cast<FloatType>(2) * p1 + p2)
+           / static_cast<FloatType>(4);
+  };
+
+  auto perSurfaceRow = std::vector<size_t>{};
+  perSurfaceRow.reserve(patch.surfaceRowCount());
+  for (size_t surfaceRow = 0u; surfaceRow < patch.surfaceRowCount(); ++surfaceRow)
+  {
+    auto error = static_cast<FloatType>(0);
+    auto linearUVs = true;
+    for (size_t col = 0u; col < patch.pointColumnCount(); ++col)
+    {
+      const auto row = 2u * surfaceRow;
+      error = vm::max(
+        error,
+        curveError(
+          controlPoint(row, col),
+          controlPoint(row + 1u, col),
+          controlPoint(row + 2u, col)));
+      linearUVs = linearUVs
+                  && isLinear(
+                    uvCoords(row, col), uvCoords(row + 1u, col), uvCoords(row + 2u, col));
+    }
+    perSurfaceRow.push_back(
+      linearUVs ? subdivisionsForError(error, maxError, maxSubdivisions)
+                : maxSubdivisions);
+  }
+
+  auto perSurfaceColumn = std::vector<size_t>{};
+  perSurfaceColumn.reserve(patch.surfaceColumnCount());
+  for (size_t surfaceCol = 0u; surfaceCol < patch.surfaceColumnCount(); ++surfaceCol)
+  {
+    auto error = static_cast<FloatType>(0);
+    auto linearUVs = true;
+    for (size_t row = 0u; row < patch.pointRowCount(); ++row)
+    {
+      const auto col = 2u * surfaceCol;
+      error = vm::max(
+        error,
+        curveError(
+          controlPoint(row, col),
+          controlPoint(row, col + 1u),
+          controlPoint(row, col + 2u)));
+      linearUVs = linearUVs
+                  && isLinear(
+                    uvCoords(row, col), uvCoords(row, col + 1u), uvCoords(row, col + 2u));
+    }
+    perSurfaceColumn.push_back(
+      linearUVs ? subdivisionsForError(error, maxError, maxSubdivisions)
+                : maxSubdivisions);
+  }
+
+  for (size_t surfaceRow = 0u; surfaceRow < patch.surfaceRowCount(); ++surfaceRow)
+  {
+    for (size_t surfaceCol = 0u; surfaceCol < patch.surfaceColumnCount(); ++surfaceCol)
+    {
+      const auto row = 2u * surfaceRow;
+      const auto col = 2u * surfaceCol;
+      const auto twist = vm::length(
+        controlPoint(row, col) - controlPoint(row, col + 2u)
+        - controlPoint(row + 2u, col) + controlPoint(row + 2u, col + 2u));
+
+      auto& rowSubdivisions = perSurfaceRow[surfaceRow];
+      auto& columnSubdivisions = perSurfaceColumn[surfaceCol];
+
+      // bilinear UV coordinates cannot be interpolated linearly across triangles either
+      if (!vm::is_zero(
+            uvCoords(row, col) - uvCoords(row, col + 2u) - uvCoords(row + 2u, col)
+              + uvCoords(row + 2u, col + 2u),
+            vm::constants<FloatType>::almost_zero()))
+      {
+        rowSubdivisions = maxSubdivisions;
+        columnSubdivisions = maxSubdivisions;
+      }
+      while ((rowSubdivisions < maxSubdivisions || columnSubdivisions < maxSubdivisions)
+             && twist
+                    / static_cast<FloatType>(
+                      size_t(4) << (rowSubdivisions + columnSubdivisions))
+                  > maxError)
+      {
+        auto& subdivisions =
+          rowSubdivisions <= columnSubdivisions && rowSubdivisions < maxSubdivisions
+            ? rowSubdivisions
+            : columnSubdivisions;
+        ++subdivisions;
+      }
+    }
+  }
+
+  return {std::move(perSurfaceRow), std::move(perSurfaceColumn)};
+}
+
 PatchGrid makePatchGrid(const BezierPatch& patch, const size_t subdivisionsPerSurface)
 {
-  const size_t gridPointRowCount =
-    patch.surfaceRowCount() * (size_t(1) << subdivisionsPerSurface) + 1u;
+  return makePatchGrid(
+    patch,
+    PatchSubdivisions{
+      std::vector<size_t>(patch.surfaceRowCount(), subdivisionsPerSurface),
+      std::vector<size_t>(patch.surfaceColumnCount(), subdivisionsPerSurface)});
+}
+
+PatchGrid makePatchGrid(const BezierPatch& patch, const PatchSubdivisions& subdivisions)
+{
+  const size_t gridPointRowCount = gridOffsets(subdivisions.perSurfaceRow).back() + 1u;
   const size_t gridPointColumnCount =
-    patch.surfaceColumnCount() * (size_t(1) << subdivisionsPerSurface) + 1u;
+    gridOffsets(subdivisions.perSurfaceColumn).back() + 1u;
 
-  const auto patchGrid = patch.evaluate(subdivisionsPerSurface);
+  const auto patchGrid =
+    patch.evaluate(subdivisions.perSurfaceRow, subdivisions.perSurfaceColumn);
   const auto normals =
     computeGridNormals(patchGrid, gridPointRowCount, gridPointColumnCount);
   assert(patchGrid.size() == normals.size());
@@ -297,8 +508,8 @@ const HitType::Type PatchNode::PatchHitType = HitType::freeType();
 
 PatchNode::PatchNode(BezierPatch patch)
   : m_patch{std::move(patch)}
-  , m_grid{makePatchGrid(m_patch, DefaultSubdivisionsPerSurface)}
 {
+  updateGrid();
 }
 
 const EntityNodeBase* PatchNode::entity() const
@@ -338,7 +549,8 @@ BezierPatch PatchNode::setPatch(BezierPatch patch)
   const auto boundsChange = NotifyPhysicalBoundsChange{*this};
 
   auto previousPatch = std::exchange(m_patch, std::move(patch));
-  m_grid = makePatchGrid(m_patch, DefaultSubdivisionsPerSurface);
+  updateGrid();
+  m_serializedText.reset();
   return previousPatch;
 }
 
@@ -352,6 +564,25 @@ const PatchGrid& PatchNode::grid() const
   return m_grid;
 }
 
+std::shared_ptr<const SerializedText> PatchNode::serializedText() const
+{
+  return m_serializedText;
+}
+
+void PatchNode::setSerializedText(
+  std::shared_ptr<const SerializedText> serializedText) const
+{
+  m_serializedText = std::move(serializedText);
+}
+
+void PatchNode::updateGrid()
+{
+  m_subdivisions =
+    computePatchSubdivisions(m_patch, MaxPatchGridError, DefaultSubdivisionsPerSurface);
+  m_grid = makePatchGrid(m_patch, m_subdivisions);
+  m_surfaceBounds = computeSurfaceBounds(m_grid, m_subdivisions);
+}
+
 const std::string& PatchNode::doGetName() const
 {
   static const auto name = std::string{"patch"};
@@ -389,6 +620,7 @@ Node* PatchNode::doClone(const vm::bbox3&, const SetLinkId setLinkIds) const
 {
   auto result = std::make_unique<PatchNode>(m_patch);
   result->cloneLinkId(*this, setLinkIds);
+  result->m_serializedText = m_serializedText;
   return result.release();
 }
 
@@ -434,18 +666,38 @@ void PatchNode::doPick(
     return false;
   };
 
-  for (size_t row = 0u; row < m_grid.pointRowCount - 1u; ++row)
+  const auto rowOffsets = gridOffsets(m_subdivisions.perSurfaceRow);
+  const auto columnOffsets = gridOffsets(m_subdivisions.perSurfaceColumn);
+  const auto surfaceColumnCount = m_subdivisions.perSurfaceColumn.size();
+
+  // only test the triangles of those surfaces whose bounds are hit by the pick ray
+  for (size_t surfaceRow = 0u; surfaceRow + 1u < rowOffsets.size(); ++surfaceRow)
   {
-    for (size_t col = 0u; col < m_grid.pointColumnCount - 1u; ++col)
+    for (size_t surfaceCol = 0u; surfaceCol < surfaceColumnCount; ++surfaceCol)
     {
-      const auto v0 = m_grid.point(row, col).position;
-      const auto v1 = m_grid.point(row, col + 1u).position;
-      const auto v2 = m_grid.point(row + 1u, col + 1u).position;
-      const auto v3 = m_grid.point(row + 1u, col).position;
+      const auto& surfaceBounds =
+        m_surfaceBounds[surfaceRow * surfaceColumnCount + surfaceCol];
+      if (!vm::intersect_ray_bbox(
+            pickRay, surfaceBounds.expand(vm::constants<FloatType>::almost_zero())))
+      {
+        continue;
+      }
 
-      if (pickTriangle(v0, v1, v2) || pickTriangle(v2, v3, v0))
+      for (size_t row = rowOffsets[surfaceRow]; row < rowOffsets[surfaceRow + 1u]; ++row)
       {
-        return;
+        for (size_t col = columnOffsets[surfaceCol]; col < columnOffsets[surfaceCol + 1u];
+             ++col)
+        {
+          const auto v0 = m_grid.point(row, col).position;
+          const auto v1 = m_grid.point(row, col + 1u).position;
+          const auto v2 = m_grid.point(row + 1u, col + 1u).position;
+          const auto v3 = m_grid.point(row + 1u, col).position;
+
+          if (pickTriangle(v0, v1, v2) || pickTriangle(v2, v3, v0))
+          {
+            return;
+          }
+        }
       }
     }
   }
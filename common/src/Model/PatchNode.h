@@ -29,7 +29,9 @@
 #include "vm/bbox.h"
 #include "vm/vec.h"
 
+#include <memory>
 #include <optional>
+#include <vector>
 
 namespace TrenchBroom::Assets
 {
@@ -39,6 +41,7 @@ class Material;
 namespace TrenchBroom::Model
 {
 class EntityNodeBase;
+struct SerializedText;
 
 struct PatchGrid
 {
@@ -70,9 +73,39 @@ std::vector<vm::vec3> computeGridNormals(
   size_t pointRowCount,
   size_t pointColumnCount);
 
-// public for testing
+/**
+ * The number of times each surface row and each surface column of a patch is subdivided
+ * when it is tessellated. All surfaces in a surface row (column) share the same number of
+ * subdivisions so that the resulting grid is free of cracks.
+ */
+struct PatchSubdivisions
+{
+  std::vector<size_t> perSurfaceRow;
+  std::vector<size_t> perSurfaceColumn;
+
+  kdl_reflect_decl(PatchSubdivisions, perSurfaceRow, perSurfaceColumn);
+};
+
+/**
+ * Computes the number of subdivisions required for each surface row and each surface
+ * column of the given patch such that the tessellated grid deviates from the curved
+ * surface by at most the given error. Flat surfaces are not subdivided at all unless their
+ * UV coordinates are not linear, and the number of subdivisions is capped at the given
+ * maximum.
+ */
+PatchSubdivisions computePatchSubdivisions(
+  const BezierPatch& patch, FloatType maxError, size_t maxSubdivisions);
+
+/**
+ * The maximum number of subdivisions per surface when tessellating a patch.
+ */
+constexpr size_t DefaultSubdivisionsPerSurface = 3u;
+
 PatchGrid makePatchGrid(const BezierPatch& patch, size_t subdivisionsPerSurface);
 
+// public for testing
+PatchGrid makePatchGrid(const BezierPatch& patch, const PatchSubdivisions& subdivisions);
+
 class PatchNode : public Node, public Object
 {
 public:
@@ -80,7 +113,10 @@ public:
 
 private:
   BezierPatch m_patch;
+  PatchSubdivisions m_subdivisions;
   PatchGrid m_grid;
+  std::vector<vm::bbox3> m_surfaceBounds;
+  mutable std::shared_ptr<const SerializedText> m_serializedText;
 
 public:
   explicit PatchNode(BezierPatch patch);
@@ -95,6 +131,15 @@ public:
 
   const PatchGrid& grid() const;
 
+  /**
+   * Only exposed to be called by MapFileSerializer
+   */
+  std::shared_ptr<const SerializedText> serializedText() const;
+  void setSerializedText(std::shared_ptr<const SerializedText> serializedText) const;
+
+private:
+  void updateGrid();
+
 private: // implement Node interface
   const std::string& doGetName() const override;
   const vm::bbox3& doGetLogicalBounds() const override;
@@ -22,6 +22,8 @@
 #include "Ensure.h"
 #include "Error.h"
 #include "IO/DiskIO.h"
+#include "IO/File.h"
+#include "IO/Reader.h"
 
 #include "kdl/reflection_impl.h"
 #include "kdl/result.h"
@@ -31,17 +33,32 @@
 #include "vm/ray.h"
 #include "vm/vec_io.h"
 
+#include <algorithm>
 #include <cassert>
 #include <istream>
+#include <limits>
+#include <optional>
 
 namespace TrenchBroom::Model
 {
 
+namespace
+{
+constexpr size_t SegmentsPerBlock = 64;
+}
+
 PointTrace::PointTrace(std::vector<vm::vec3f> points)
   : m_points{std::move(points)}
   , m_current{0}
 {
   ensure(!m_points.empty(), "Point trace is not empty");
+
+  for (size_t i = 0; i < m_points.size(); i += SegmentsPerBlock)
+  {
+    const auto last = std::min(i + SegmentsPerBlock + 1, m_points.size());
+    m_blockBounds.push_back(vm::bbox3f::merge_all(
+      std::next(m_points.begin(), long(i)), std::next(m_points.begin(), long(last))));
+  }
 }
 
 bool PointTrace::hasNextPoint() const
@@ -96,48 +113,95 @@ void PointTrace::retreat()
   }
 }
 
-namespace
+size_t PointTrace::indexOfNearestPoint(const vm::vec3f& position) const
 {
+  if (m_points.size() == 1)
+  {
+    return 0;
+  }
 
-std::vector<vm::vec3f> smoothPoints(const std::vector<vm::vec3f>& points)
-{
-  assert(points.size() > 1);
-
-  auto result = std::vector<vm::vec3f>{points[0]};
-
-  auto it =
-    std::find_if(std::next(std::begin(points)), std::end(points), [&](const auto& p) {
-      return p != points[0];
-    });
+  auto result = size_t(0);
+  auto minDistance = std::numeric_limits<float>::max();
 
-  if (it == std::end(points))
+  for (size_t block = 0; block < m_blockBounds.size(); ++block)
   {
-    return result;
+    const auto& bounds = m_blockBounds[block];
+    if (vm::squared_distance(position, bounds.constrain(position)) >= minDistance)
+    {
+      continue;
+    }
+
+    const auto first = block * SegmentsPerBlock;
+    const auto last = std::min(first + SegmentsPerBlock, m_points.size() - 1);
+    for (size_t i = first; i < last; ++i)
+    {
+      const auto& start = m_points[i];
+      const auto vector = m_points[i + 1] - start;
+      const auto squaredLength = vm::squared_length(vector);
+      const auto t =
+        squaredLength > 0.0f
+          ? std::clamp(vm::dot(position - start, vector) / squaredLength, 0.0f, 1.0f)
+          : 0.0f;
+
+      const auto distance = vm::squared_distance(position, start + t * vector);
+      if (distance < minDistance)
+      {
+        minDistance = distance;
+        result = t < 0.5f ? i : i + 1;
+      }
+    }
   }
 
-  result.push_back(*it);
-  ++it;
+  return result;
+}
+
+void PointTrace::setCurrentPoint(const size_t index)
+{
+  ensure(index < m_points.size(), "index is in range");
+  m_current = index;
+}
 
-  auto ray = vm::ray3f{result[0], vm::normalize(result[1] - result[0])};
-  while (it != std::end(points))
+namespace
+{
+
+/**
+ * Collapses runs of points that lie (nearly) on a line into a single segment as the
+ * points are added, so that only the simplified polyline is kept in memory.
+ */
+class PolylineSimplifier
+{
+private:
+  std::vector<vm::vec3f> m_points;
+  std::optional<vm::ray3f> m_ray;
+
+public:
+  void add(const vm::vec3f& point)
   {
-    const auto& cur = *it;
-    const auto dist = vm::squared_distance(ray, cur).distance;
-    if (dist > 1.0f)
+    if (m_points.empty())
+    {
+      m_points.push_back(point);
+    }
+    else if (!m_ray)
+    {
+      if (point != m_points.front())
+      {
+        m_ray = vm::ray3f{m_points.front(), vm::normalize(point - m_points.front())};
+        m_points.push_back(point);
+      }
+    }
+    else if (vm::squared_distance(*m_ray, point).distance > 1.0f)
     {
-      ray = vm::ray3f{result.back(), vm::normalize(cur - result.back())};
-      result.push_back(cur);
+      m_ray = vm::ray3f{m_points.back(), vm::normalize(point - m_points.back())};
+      m_points.push_back(point);
     }
     else
     {
-      result.back() = cur;
+      m_points.back() = point;
     }
-    ++it;
   }
 
-  assert(result.size() > 1);
-  return result;
-}
+  std::vector<vm::vec3f> points() && { return std::move(m_points); }
+};
 
 std::vector<vm::vec3f> segmentizePoints(const std::vector<vm::vec3f>& points)
 {
@@ -167,19 +231,39 @@ std::vector<vm::vec3f> segmentizePoints(const std::vector<vm::vec3f>& points)
 
 kdl_reflect_impl(PointTrace);
 
-Result<PointTrace> loadPointFile(std::istream& stream)
+Result<PointTrace> loadPointFile(std::string_view str)
 {
-  const auto str = std::string{std::istreambuf_iterator<char>{stream}, {}};
+  static constexpr auto Separators = std::string_view{" \t\n\r(),;"};
 
-  auto points = std::vector<vm::vec3f>{};
-  vm::parse_all<float, 3>(str, std::back_inserter(points));
+  auto simplifier = PolylineSimplifier{};
+  auto numPoints = size_t(0);
+  auto point = vm::vec3f{};
+  auto component = size_t(0);
 
-  if (points.size() < 2)
+  for (auto first = str.find_first_not_of(Separators); first != std::string_view::npos;
+       first = str.find_first_not_of(Separators, first))
+  {
+    const auto last = std::min(str.find_first_of(Separators, first), str.size());
+
+    // like std::atof, treat malformed numbers as zero
+    const auto token = str.substr(first, last - first);
+    point[component++] = kdl::str_to_float(token).value_or(0.0f);
+    if (component == 3)
+    {
+      simplifier.add(point);
+      ++numPoints;
+      component = 0;
+    }
+
+    first = last;
+  }
+
+  if (numPoints < 2)
   {
     return Error{"PointFile must contain at least two points"};
   }
 
-  points = smoothPoints(points);
+  auto points = std::move(simplifier).points();
   if (points.size() < 2)
   {
     return Error{"PointFile must contain at least two points"};
@@ -189,4 +273,18 @@ Result<PointTrace> loadPointFile(std::istream& stream)
   return PointTrace{std::move(points)};
 }
 
+Result<PointTrace> loadPointFile(std::istream& stream)
+{
+  const auto str = std::string{std::istreambuf_iterator<char>{stream}, {}};
+  return loadPointFile(std::string_view{str});
+}
+
+Result<PointTrace> loadPointFile(const std::filesystem::path& path)
+{
+  return IO::Disk::openFile(path) | kdl::and_then([](auto file) {
+           auto reader = file->reader().buffer();
+           return loadPointFile(reader.stringView());
+         });
+}
+
 } // namespace TrenchBroom::Model
@@ -23,10 +23,13 @@
 
 #include "kdl/reflection_decl.h"
 
+#include "vm/bbox.h"
 #include "vm/forward.h"
 #include "vm/vec.h"
 
+#include <filesystem>
 #include <iosfwd>
+#include <string_view>
 #include <vector>
 
 namespace TrenchBroom::Model
@@ -37,6 +40,10 @@ private:
   std::vector<vm::vec3f> m_points;
   size_t m_current;
 
+  // the bounds of each block of consecutive segments, used to skip whole blocks when
+  // searching for the point nearest to a position
+  std::vector<vm::bbox3f> m_blockBounds;
+
 public:
   explicit PointTrace(std::vector<vm::vec3f> points);
 
@@ -50,8 +57,27 @@ public:
   void advance();
   void retreat();
 
+  /**
+   * Returns the index of the point that is closest to the given position. The trace is
+   * searched segment by segment, and of the segment closest to the given position, the
+   * end point closer to the position is returned.
+   */
+  size_t indexOfNearestPoint(const vm::vec3f& position) const;
+
+  /**
+   * Makes the point at the given index the current point.
+   */
+  void setCurrentPoint(size_t index);
+
   kdl_reflect_decl(PointTrace, m_points, m_current);
 };
 
+/**
+ * Parses a point file or a LIN file. The points are simplified while they are read,
+ * collapsing runs of (nearly) collinear points into a single segment, so that the raw
+ * points of very long traces are never held in memory at once.
+ */
+Result<PointTrace> loadPointFile(std::string_view str);
 Result<PointTrace> loadPointFile(std::istream& stream);
+Result<PointTrace> loadPointFile(const std::filesystem::path& path);
 } // namespace TrenchBroom::Model
@@ -1331,6 +1331,13 @@ public: // Accessors
    */
   FaceList& faces();
 
+  /**
+   * Returns an estimate of the number of bytes used by this polyhedron, including its
+   * vertices, edges, half edges and faces. The estimate does not account for allocator
+   * overhead.
+   */
+  size_t memoryUsage() const;
+
   /**
    * Checks whether this polyhedron has any face with the given vertex positions, up to
    * the given epsilon.
@@ -1554,6 +1561,18 @@ private:
    */
   void updateBounds();
 
+public: // Transformation
+  /**
+   * Translates the positions of all vertices and the planes of all faces of this
+   * polyhedron by the given delta. The topology of this polyhedron and the payloads of
+   * its vertices and faces remain unchanged.
+   *
+   * Updates the bounds of this polyhedron afterwards.
+   *
+   * @param delta the vector by which to translate this polyhedron
+   */
+  void translate(const vm::vec<T, 3>& delta);
+
 public: // Vertex correction and edge healing
   /**
    * Rounds each component of position of every vertex to the nearest integer if the
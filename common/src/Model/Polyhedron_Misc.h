@@ -533,6 +533,15 @@ typename Polyhedron<T, FP, VP>::FaceList& Polyhedron<T, FP, VP>::faces()
   return m_faces;
 }
 
+template <typename T, typename FP, typename VP>
+size_t Polyhedron<T, FP, VP>::memoryUsage() const
+{
+  // every edge has two half edges, and every vertex, edge, half edge and face is
+  // allocated separately
+  return sizeof(Polyhedron) + vertexCount() * sizeof(Vertex) + edgeCount() * sizeof(Edge)
+         + 2u * edgeCount() * sizeof(HalfEdge) + faceCount() * sizeof(Face);
+}
+
 template <typename T, typename FP, typename VP>
 bool Polyhedron<T, FP, VP>::hasFace(
   const std::vector<vm::vec<T, 3>>& positions, const T epsilon) const
@@ -801,6 +810,22 @@ void Polyhedron<T, FP, VP>::updateBounds()
   }
 }
 
+template <typename T, typename FP, typename VP>
+void Polyhedron<T, FP, VP>::translate(const vm::vec<T, 3>& delta)
+{
+  for (auto* vertex : m_vertices)
+  {
+    vertex->setPosition(vertex->position() + delta);
+  }
+  for (auto* face : m_faces)
+  {
+    const auto& plane = face->plane();
+    face->setPlane(
+      vm::plane<T, 3>{plane.distance + vm::dot(delta, plane.normal), plane.normal});
+  }
+  updateBounds();
+}
+
 template <typename T, typename FP, typename VP>
 void Polyhedron<T, FP, VP>::correctVertexPositions(const size_t decimals, const T epsilon)
 {
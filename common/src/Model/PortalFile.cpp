@@ -21,28 +21,75 @@
 
 #include "Error.h"
 #include "IO/DiskIO.h"
+#include "IO/File.h"
+#include "IO/Reader.h"
 
 #include "kdl/result.h"
 #include "kdl/string_format.h"
 #include "kdl/string_utils.h"
 
-#include "vm/forward.h"
 #include "vm/polygon.h"
 #include "vm/vec.h"
 
+#include <cassert>
+#include <iterator>
+#include <optional>
 #include <string>
 
 namespace TrenchBroom::Model
 {
 
-PortalFile::PortalFile(std::vector<vm::polygon3f> portals)
-  : m_portals{std::move(portals)}
+PortalFile::PortalFile(std::vector<vm::vec3f> vertices, std::vector<size_t> offsets)
+  : m_vertices{std::move(vertices)}
+  , m_offsets{std::move(offsets)}
 {
+  assert(!m_offsets.empty());
+  assert(m_offsets.front() == 0);
+  assert(m_offsets.back() == m_vertices.size());
 }
 
-const std::vector<vm::polygon3f>& PortalFile::portals() const
+PortalFile::PortalFile(const std::vector<vm::polygon3f>& portals)
+  : m_offsets{0}
 {
-  return m_portals;
+  for (const auto& portal : portals)
+  {
+    m_vertices.insert(m_vertices.end(), portal.begin(), portal.end());
+    m_offsets.push_back(m_vertices.size());
+  }
+}
+
+size_t PortalFile::portalCount() const
+{
+  return m_offsets.size() - 1;
+}
+
+std::span<const vm::vec3f> PortalFile::portal(const size_t index) const
+{
+  assert(index < portalCount());
+  return std::span{m_vertices}.subspan(
+    m_offsets[index], m_offsets[index + 1] - m_offsets[index]);
+}
+
+const std::vector<vm::vec3f>& PortalFile::vertices() const
+{
+  return m_vertices;
+}
+
+const std::vector<size_t>& PortalFile::offsets() const
+{
+  return m_offsets;
+}
+
+std::vector<vm::polygon3f> PortalFile::portals() const
+{
+  auto result = std::vector<vm::polygon3f>{};
+  result.reserve(portalCount());
+  for (size_t i = 0; i < portalCount(); ++i)
+  {
+    const auto vertices = portal(i);
+    result.emplace_back(std::vector<vm::vec3f>{vertices.begin(), vertices.end()});
+  }
+  return result;
 }
 
 bool canLoadPortalFile(const std::filesystem::path& path)
@@ -52,97 +99,185 @@ bool canLoadPortalFile(const std::filesystem::path& path)
          | kdl::transform_error([](const auto&) { return false; }) | kdl::value();
 }
 
-Result<PortalFile> loadPortalFile(std::istream& stream)
+namespace
+{
+
+/**
+ * Splits the lines of a portal file into tokens without copying them.
+ */
+class LineScanner
+{
+private:
+  std::string_view m_str;
+
+public:
+  explicit LineScanner(const std::string_view str)
+    : m_str{str}
+  {
+  }
+
+  bool atEnd() const { return m_str.empty(); }
+
+  std::string_view nextLine()
+  {
+    const auto end = m_str.find('\n');
+    const auto line = m_str.substr(0, end);
+    m_str.remove_prefix(end == std::string_view::npos ? m_str.size() : end + 1);
+    return line;
+  }
+};
+
+std::optional<std::string_view> nextToken(std::string_view& line)
+{
+  static constexpr auto Separators = std::string_view{"() \t\r"};
+
+  const auto first = line.find_first_not_of(Separators);
+  if (first == std::string_view::npos)
+  {
+    line = {};
+    return std::nullopt;
+  }
+
+  const auto last = std::min(line.find_first_of(Separators, first), line.size());
+  const auto token = line.substr(first, last - first);
+  line.remove_prefix(last);
+  return token;
+}
+
+size_t countTokens(std::string_view line)
+{
+  auto count = size_t(0);
+  while (nextToken(line))
+  {
+    ++count;
+  }
+  return count;
+}
+
+std::optional<size_t> parseSize(std::string_view line)
 {
-  static const auto lineSplitter = "() \n\t\r";
+  const auto token = nextToken(line);
+  return token ? kdl::str_to_size(*token) : std::nullopt;
+}
+
+std::optional<float> parseFloat(std::string_view& line)
+{
+  const auto token = nextToken(line);
+  return token ? kdl::str_to_float(*token) : std::nullopt;
+}
+
+} // namespace
 
-  auto line = std::string{};
-  auto numPortals = 0ul;
+Result<PortalFile> loadPortalFile(const std::string_view str)
+{
+  auto scanner = LineScanner{str};
+  auto numPortals = std::optional<size_t>{};
   auto prt1ForQ3 = false;
 
   // read header
-  std::getline(stream, line);
-  const auto formatCode = kdl::str_trim(line); // trim off any trailing \r
+  const auto formatCode = kdl::str_trim(scanner.nextLine()); // trim off any trailing \r
 
   if (formatCode == "PRT1")
   {
-    std::getline(stream, line); // number of leafs (ignored)
-    std::getline(stream, line); // number of portals
-    numPortals = std::stoul(line);
-    const auto mark = stream.tellg();
-    std::getline(stream, line);
-    // If this line contains a single value, it is Q3-style PRT1 (value is
-    // number of solid faces -- will ignore). Otherwise is Q1/Q2 style and we
-    // will rewind the stream to process this line accordingly.
-    const auto componentsCheck = kdl::str_split(line, lineSplitter);
-    if (componentsCheck.size() == 1)
+    scanner.nextLine(); // number of leafs (ignored)
+    numPortals = parseSize(scanner.nextLine());
+
+    // If the next line contains a single value, it is Q3-style PRT1 (value is number of
+    // solid faces -- will ignore). Otherwise is Q1/Q2 style and we will process this line
+    // as a portal.
+    auto peek = scanner;
+    if (countTokens(peek.nextLine()) == 1)
     {
       prt1ForQ3 = true;
-    }
-    else
-    {
-      stream.seekg(mark);
+      scanner = peek;
     }
   }
   else if (formatCode == "PRT2")
   {
-    std::getline(stream, line); // number of leafs (ignored)
-    std::getline(stream, line); // number of clusters (ignored)
-    std::getline(stream, line); // number of portals
-    numPortals = std::stoul(line);
+    scanner.nextLine(); // number of leafs (ignored)
+    scanner.nextLine(); // number of clusters (ignored)
+    numPortals = parseSize(scanner.nextLine());
   }
   else if (formatCode == "PRT1-AM")
   {
-    std::getline(stream, line); // number of clusters (ignored)
-    std::getline(stream, line); // number of portals
-    numPortals = std::stoul(line);
-    std::getline(stream, line); // number of leafs (ignored)
+    scanner.nextLine(); // number of clusters (ignored)
+    numPortals = parseSize(scanner.nextLine());
+    scanner.nextLine(); // number of leafs (ignored)
   }
   else
   {
     return Error{"Unknown portal format: " + formatCode};
   }
 
-  if (!stream.good())
+  if (!numPortals || scanner.atEnd())
   {
     return Error{"Error reading header"};
   }
 
   // read portals
-  auto portals = std::vector<vm::polygon3f>{};
-  portals.reserve(numPortals);
+  auto vertices = std::vector<vm::vec3f>{};
+  auto offsets = std::vector<size_t>{};
+  vertices.reserve(*numPortals * 4);
+  offsets.reserve(*numPortals + 1);
+  offsets.push_back(0);
 
-  for (size_t i = 0; i < numPortals; ++i)
+  for (size_t i = 0; i < *numPortals; ++i)
   {
-    std::getline(stream, line);
-    const auto components = kdl::str_split(line, lineSplitter);
+    if (scanner.atEnd())
+    {
+      return Error{"Error reading portal"};
+    }
 
-    if (!stream.good() || components.size() < 3)
+    auto line = scanner.nextLine();
+    const auto numPoints = parseSize(line);
+
+    // skip the point count and the two leafs, and the hint flag for Q3 style PRT1
+    const auto numSkippedTokens = prt1ForQ3 ? 4u : 3u;
+    for (size_t j = 0; j < numSkippedTokens; ++j)
+    {
+      if (!nextToken(line))
+      {
+        return Error{"Error reading portal"};
+      }
+    }
+
+    if (!numPoints)
     {
       return Error{"Error reading portal"};
     }
 
-    auto verts = std::vector<vm::vec3f>{};
-    auto ptr = prt1ForQ3 ? 4u : 3u;
-    const int numPoints = std::stoi(components.at(0));
-    for (int j = 0; j < numPoints; ++j)
+    for (size_t j = 0; j < *numPoints; ++j)
     {
-      if (ptr + 2 >= components.size())
+      const auto x = parseFloat(line);
+      const auto y = parseFloat(line);
+      const auto z = parseFloat(line);
+      if (!x || !y || !z)
       {
         return Error{"Error reading portal"};
       }
 
-      verts.emplace_back(
-        std::stof(components.at(ptr)),
-        std::stof(components.at(ptr + 1)),
-        std::stof(components.at(ptr + 2)));
-      ptr += 3;
+      vertices.emplace_back(*x, *y, *z);
     }
 
-    portals.emplace_back(std::move(verts));
+    offsets.push_back(vertices.size());
   }
-  return PortalFile{std::move(portals)};
+
+  return PortalFile{std::move(vertices), std::move(offsets)};
+}
+
+Result<PortalFile> loadPortalFile(std::istream& stream)
+{
+  const auto str =
+    std::string{std::istreambuf_iterator<char>{stream}, std::istreambuf_iterator<char>{}};
+  return loadPortalFile(std::string_view{str});
 }
 
+Result<PortalFile> loadPortalFile(const std::filesystem::path& path)
+{
+  return IO::Disk::openFile(path) | kdl::and_then([](auto file) {
+           auto reader = file->reader().buffer();
+           return loadPortalFile(reader.stringView());
+         });
+}
 
 } // namespace TrenchBroom::Model
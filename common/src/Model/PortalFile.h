@@ -22,26 +22,47 @@
 #include "Result.h"
 
 #include "vm/forward.h"
+#include "vm/vec.h"
 
 #include <filesystem>
 #include <iosfwd>
+#include <span>
+#include <string_view>
 #include <vector>
 
 namespace TrenchBroom::Model
 {
 
+/**
+ * The portals of a portal file. The vertices of all portals are stored in a single array,
+ * and the vertices of the i-th portal are the range [offsets[i], offsets[i+1]) of that
+ * array.
+ */
 class PortalFile
 {
 private:
-  std::vector<vm::polygon3f> m_portals;
+  std::vector<vm::vec3f> m_vertices;
+  std::vector<size_t> m_offsets;
 
 public:
-  explicit PortalFile(std::vector<vm::polygon3f> portals);
+  PortalFile(std::vector<vm::vec3f> vertices, std::vector<size_t> offsets);
+  explicit PortalFile(const std::vector<vm::polygon3f>& portals);
+
+  size_t portalCount() const;
+  std::span<const vm::vec3f> portal(size_t index) const;
+
+  const std::vector<vm::vec3f>& vertices() const;
+  const std::vector<size_t>& offsets() const;
 
-  const std::vector<vm::polygon3f>& portals() const;
+  /**
+   * Returns a copy of the portals as polygons.
+   */
+  std::vector<vm::polygon3f> portals() const;
 };
 
 bool canLoadPortalFile(const std::filesystem::path& path);
+Result<PortalFile> loadPortalFile(std::string_view str);
 Result<PortalFile> loadPortalFile(std::istream& stream);
+Result<PortalFile> loadPortalFile(const std::filesystem::path& path);
 
 } // namespace TrenchBroom::Model
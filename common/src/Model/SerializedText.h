@@ -0,0 +1,42 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "Model/MapFormat.h"
+
+#include <cstddef>
+#include <string>
+
+namespace TrenchBroom::Model
+{
+
+/**
+ * The text that was written for a brush or patch node the last time it was serialized
+ * to a map file of the given format. Nodes cache this and drop it whenever they change
+ * in a way that affects their serialized form.
+ */
+struct SerializedText
+{
+  MapFormat format;
+  std::string text;
+  size_t lineCount;
+};
+
+} // namespace TrenchBroom::Model
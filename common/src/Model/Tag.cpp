@@ -307,6 +307,11 @@ bool TagMatcher::canDisable() const
   return false;
 }
 
+bool TagMatcher::matchesFaceAttributesOnly() const
+{
+  return false;
+}
+
 std::ostream& operator<<(std::ostream& str, const TagMatcher& matcher)
 {
   matcher.appendToStream(str);
@@ -378,6 +383,11 @@ bool SmartTag::canDisable() const
   return m_matcher->canDisable();
 }
 
+bool SmartTag::matchesFaceAttributesOnly() const
+{
+  return m_matcher->matchesFaceAttributesOnly();
+}
+
 void SmartTag::appendToStream(std::ostream& str) const
 {
   kdl::struct_stream{str} << "SmartTag"
@@ -363,6 +363,16 @@ public:
    */
   virtual bool canDisable() const;
 
+  /**
+   * Indicates whether this tag matcher only matches brush faces, and whether its result
+   * for a brush face depends only on the face's material name, material, and resolved
+   * surface flags and contents. The tag manager caches the results of such matchers for
+   * each combination of these values.
+   *
+   * @return true if this tag matcher only depends on face attributes and false otherwise
+   */
+  virtual bool matchesFaceAttributesOnly() const;
+
   /**
    * Returns a new copy of this tag matcher.
    */
@@ -447,6 +457,13 @@ public:
    */
   bool canDisable() const;
 
+  /**
+   * Indicates whether this tag's matcher only depends on face attributes.
+   *
+   * @see TagMatcher::matchesFaceAttributesOnly
+   */
+  bool matchesFaceAttributesOnly() const;
+
   void appendToStream(std::ostream& str) const override;
 };
 } // namespace Model
@@ -20,8 +20,10 @@
 #include "TagManager.h"
 
 #include "Ensure.h"
+#include "Model/BrushFace.h"
 #include "Model/Tag.h"
 #include "Model/TagType.h"
+#include "Model/TagVisitor.h"
 
 #include <algorithm>
 #include <stdexcept>
@@ -31,6 +33,27 @@ namespace TrenchBroom
 {
 namespace Model
 {
+namespace
+{
+class FindBrushFaceVisitor : public ConstTagVisitor
+{
+private:
+  const BrushFace* m_face = nullptr;
+
+public:
+  const BrushFace* face() const { return m_face; }
+
+  void visit(const BrushFace& face) override { m_face = &face; }
+};
+
+const BrushFace* findBrushFace(const Taggable& taggable)
+{
+  auto visitor = FindBrushFaceVisitor{};
+  taggable.accept(visitor);
+  return visitor.face();
+}
+} // namespace
+
 bool TagManager::TagCmp::operator()(const SmartTag& lhs, const SmartTag& rhs) const
 {
   return lhs.name() < rhs.name();
@@ -110,19 +133,103 @@ void TagManager::registerSmartTags(const std::vector<SmartTag>& tags)
 
     it->setIndex(nextIndex);
   }
+
+  m_faceAttributeTags = TagType::NoType;
+  for (const auto& tag : m_smartTags)
+  {
+    if (tag.matchesFaceAttributesOnly())
+    {
+      m_faceAttributeTags |= tag.type();
+    }
+  }
+
+  clearFaceTagCache();
 }
 
 void TagManager::clearSmartTags()
 {
   m_smartTags.clear();
+  m_faceAttributeTags = TagType::NoType;
+  clearFaceTagCache();
 }
 
 void TagManager::updateTags(Taggable& taggable) const
 {
+  if (m_faceAttributeTags == TagType::NoType)
+  {
+    for (const auto& tag : m_smartTags)
+    {
+      tag.update(taggable);
+    }
+    return;
+  }
+
+  // tags that only depend on face attributes never match anything but brush faces
+  const auto* face = findBrushFace(taggable);
+  const auto faceTags = face ? faceAttributeTagMask(*face) : TagType::NoType;
+
   for (const auto& tag : m_smartTags)
   {
-    tag.update(taggable);
+    if ((tag.type() & m_faceAttributeTags) == 0)
+    {
+      tag.update(taggable);
+    }
+    else if ((tag.type() & faceTags) != 0)
+    {
+      taggable.addTag(tag);
+    }
+    else
+    {
+      taggable.removeTag(tag);
+    }
+  }
+}
+
+void TagManager::clearFaceTagCache()
+{
+  const auto lock = std::lock_guard{m_faceTagCacheMutex};
+  m_faceTagCache.clear();
+}
+
+TagType::Type TagManager::faceAttributeTagMask(const BrushFace& face) const
+{
+  const auto& materialName = face.attributes().materialName();
+  const auto* material = face.material();
+  const auto surfaceFlags = face.resolvedSurfaceFlags();
+  const auto surfaceContents = face.resolvedSurfaceContents();
+
+  {
+    const auto lock = std::lock_guard{m_faceTagCacheMutex};
+    if (const auto it = m_faceTagCache.find(materialName); it != m_faceTagCache.end())
+    {
+      for (const auto& cachedFaceTags : it->second)
+      {
+        if (
+          cachedFaceTags.material == material
+          && cachedFaceTags.surfaceFlags == surfaceFlags
+          && cachedFaceTags.surfaceContents == surfaceContents)
+        {
+          return cachedFaceTags.tagMask;
+        }
+      }
+    }
   }
+
+  // the matchers are evaluated without holding the lock, so another thread may add the
+  // same entry concurrently, but that is harmless since both entries are identical
+  auto tagMask = TagType::NoType;
+  for (const auto& tag : m_smartTags)
+  {
+    if ((tag.type() & m_faceAttributeTags) != 0 && tag.matches(face))
+    {
+      tagMask |= tag.type();
+    }
+  }
+
+  const auto lock = std::lock_guard{m_faceTagCacheMutex};
+  m_faceTagCache[materialName].push_back(
+    CachedFaceTags{material, surfaceFlags, surfaceContents, tagMask});
+  return tagMask;
 }
 
 size_t TagManager::freeTagIndex()
@@ -23,14 +23,29 @@
 
 #include "kdl/vector_set.h"
 
+#include <mutex>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 namespace TrenchBroom
 {
+namespace Assets
+{
+class Material;
+}
+
 namespace Model
 {
+class BrushFace;
+
 /**
  * Manages the tags used in a document and updates smart tags on taggable objects.
+ *
+ * The results of smart tags whose matchers only depend on face attributes are cached per
+ * material name, material and resolved surface flags and contents, so that tagging a
+ * brush face usually amounts to a table lookup. Tags can be updated from multiple
+ * threads concurrently.
  */
 class TagManager
 {
@@ -45,6 +60,18 @@ private:
 
   kdl::vector_set<SmartTag, TagCmp> m_smartTags;
 
+  struct CachedFaceTags
+  {
+    const Assets::Material* material;
+    int surfaceFlags;
+    int surfaceContents;
+    TagType::Type tagMask;
+  };
+
+  TagType::Type m_faceAttributeTags = TagType::NoType;
+  mutable std::mutex m_faceTagCacheMutex;
+  mutable std::unordered_map<std::string, std::vector<CachedFaceTags>> m_faceTagCache;
+
 public:
   /**
    * Returns a vector containing all smart tags registered with this manager.
@@ -114,7 +141,13 @@ public:
    */
   void updateTags(Taggable& taggable) const;
 
+  /**
+   * Clears the cached tags of brush faces. Must be called when the materials change.
+   */
+  void clearFaceTagCache();
+
 private:
+  TagType::Type faceAttributeTagMask(const BrushFace& face) const;
   size_t freeTagIndex();
 };
 } // namespace Model
@@ -153,6 +153,11 @@ bool MaterialTagMatcher::canEnable() const
   return true;
 }
 
+bool MaterialTagMatcher::matchesFaceAttributesOnly() const
+{
+  return true;
+}
+
 void MaterialTagMatcher::appendToStream(std::ostream& str) const
 {
   kdl::struct_stream{str} << "MaterialTagMatcher";
@@ -356,6 +361,11 @@ bool FlagsTagMatcher::canDisable() const
   return true;
 }
 
+bool FlagsTagMatcher::matchesFaceAttributesOnly() const
+{
+  return true;
+}
+
 void FlagsTagMatcher::appendToStream(std::ostream& str) const
 {
   kdl::struct_stream{str} << "FlagsTagMatcher"
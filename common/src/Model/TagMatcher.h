@@ -46,6 +46,7 @@ class MaterialTagMatcher : public TagMatcher
 public:
   void enable(TagMatcherCallback& callback, MapFacade& facade) const override;
   bool canEnable() const override;
+  bool matchesFaceAttributesOnly() const override;
   void appendToStream(std::ostream& str) const override;
 
 private:
@@ -112,6 +113,7 @@ public:
   void disable(TagMatcherCallback& callback, MapFacade& facade) const override;
   bool canEnable() const override;
   bool canDisable() const override;
+  bool matchesFaceAttributesOnly() const override;
   void appendToStream(std::ostream& str) const override;
 };
 
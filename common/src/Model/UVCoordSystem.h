@@ -65,6 +65,8 @@ public:
   friend bool operator!=(const UVCoordSystem& lhs, const UVCoordSystem& rhs);
 
   virtual std::unique_ptr<UVCoordSystem> clone() const = 0;
+  // Returns the number of bytes used by this coordinate system
+  virtual size_t memoryUsage() const = 0;
   virtual std::unique_ptr<UVCoordSystemSnapshot> takeSnapshot() const = 0;
   virtual void restoreSnapshot(const UVCoordSystemSnapshot& snapshot) = 0;
 
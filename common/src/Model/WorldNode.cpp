@@ -20,6 +20,7 @@
 #include "WorldNode.h"
 
 #include "Ensure.h"
+#include "Exceptions.h"
 #include "Model/BrushFace.h"
 #include "Model/BrushNode.h"
 #include "Model/EntityNode.h"
@@ -30,16 +31,21 @@
 #include "Model/TagVisitor.h"
 #include "Model/Validator.h"
 #include "Model/ValidatorRegistry.h"
+#include "Profiler.h"
 #include "octree.h"
 
 #include "kdl/overload.h"
+#include "kdl/parallel.h"
 #include "kdl/result.h"
 #include "kdl/vector_utils.h"
 
+#include "vm/bbox.h"
 #include "vm/bbox_io.h"
 
 #include <sstream>
 #include <string>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 namespace TrenchBroom
@@ -83,8 +89,9 @@ MapFormat WorldNode::mapFormat() const
   return m_mapFormat;
 }
 
-const WorldNode::NodeTree& WorldNode::nodeTree() const
+const WorldNode::NodeTree& WorldNode::nodeTree()
 {
+  applyPendingNodeTreeUpdates();
   return *m_nodeTree;
 }
 
@@ -183,6 +190,11 @@ const EntityNodeIndex& WorldNode::entityNodeIndex() const
   return *m_entityNodeIndex;
 }
 
+void WorldNode::flushEntityNodeIndex()
+{
+  m_entityNodeIndex->flush();
+}
+
 std::vector<const Validator*> WorldNode::registeredValidators() const
 {
   return m_validatorRegistry->registeredValidators();
@@ -207,6 +219,7 @@ void WorldNode::unregisterAllValidators()
 
 void WorldNode::disableNodeTreeUpdates()
 {
+  applyPendingNodeTreeUpdates();
   m_updateNodeTree = false;
 }
 
@@ -217,6 +230,8 @@ void WorldNode::enableNodeTreeUpdates()
 
 void WorldNode::rebuildNodeTree()
 {
+  profileZone("Model", "Rebuild node tree");
+
   auto nodes = std::vector<Model::Node*>{};
   const auto addNode = [&](auto* node) {
     if (node->shouldAddToSpacialIndex())
@@ -245,10 +260,103 @@ void WorldNode::rebuildNodeTree()
     [&](BrushNode* brush) { addNode(brush); },
     [&](PatchNode* patch) { addNode(patch); }));
 
+  m_pendingNodeTreeNodes.clear();
+  m_pendingNodeTreeChanges.clear();
+
+  // computing the bounds of a brush entity merges the bounds of its children, so the
+  // bounds are computed in parallel
   m_nodeTree->clear();
-  for (auto* node : nodes)
+  m_nodeTree->apply(
+    {},
+    kdl::vec_parallel_transform(
+      std::move(nodes),
+      [](auto* node) { return std::pair{node->physicalBounds(), node}; }),
+    0.0);
+}
+
+void WorldNode::applyPendingNodeTreeUpdates()
+{
+  const auto makeException = [](const auto& message, const Node* node) {
+    auto str = std::stringstream();
+    str << message << " with bounds " << node->physicalBounds() << ": " << node;
+    return NodeTreeException{str.str()};
+  };
+
+  auto nodesToRemove = std::vector<Node*>{};
+  auto nodesToInsert = std::vector<std::pair<vm::bbox3, Node*>>{};
+
+  for (auto* node : m_pendingNodeTreeNodes)
+  {
+    if (const auto it = m_pendingNodeTreeChanges.find(node);
+        it != m_pendingNodeTreeChanges.end())
+    {
+      if (it->second != NodeTreeChange::Insert)
+      {
+        if (!m_nodeTree->contains(node))
+        {
+          throw makeException("Node not found", node);
+        }
+        nodesToRemove.push_back(node);
+      }
+      else if (m_nodeTree->contains(node))
+      {
+        throw makeException("Node already in tree", node);
+      }
+
+      if (it->second != NodeTreeChange::Remove)
+      {
+        nodesToInsert.emplace_back(node->physicalBounds(), node);
+      }
+      m_pendingNodeTreeChanges.erase(it);
+    }
+  }
+  m_pendingNodeTreeNodes.clear();
+
+  if (!nodesToRemove.empty() || !nodesToInsert.empty())
   {
-    m_nodeTree->insert(node->physicalBounds(), node);
+    profileZone("Model", "Update node tree");
+    profileCounter(
+      "Model", "Node tree updates", nodesToRemove.size() + nodesToInsert.size());
+    m_nodeTree->apply(
+      nodesToRemove, std::move(nodesToInsert), m_nodeTreeRebuildThreshold);
+  }
+}
+
+void WorldNode::setNodeTreeRebuildThreshold(const double nodeTreeRebuildThreshold)
+{
+  m_nodeTreeRebuildThreshold = nodeTreeRebuildThreshold;
+}
+
+void WorldNode::addPendingNodeTreeChange(Node* node, const NodeTreeChange change)
+{
+  const auto [it, inserted] = m_pendingNodeTreeChanges.try_emplace(node, change);
+  if (inserted)
+  {
+    m_pendingNodeTreeNodes.push_back(node);
+    return;
+  }
+
+  auto& pendingChange = it->second;
+  switch (change)
+  {
+  case NodeTreeChange::Insert:
+    // the node was removed and is now added again
+    pendingChange = NodeTreeChange::Update;
+    break;
+  case NodeTreeChange::Remove:
+    if (pendingChange == NodeTreeChange::Insert)
+    {
+      // the node was never added to the node tree
+      m_pendingNodeTreeChanges.erase(it);
+    }
+    else
+    {
+      pendingChange = NodeTreeChange::Remove;
+    }
+    break;
+  case NodeTreeChange::Update:
+    // a pending insertion or update will use the node's current bounds
+    break;
   }
 }
 
@@ -294,7 +402,13 @@ Node* WorldNode::doCloneRecursively(
   assert(myChildren[0] == m_defaultLayer);
 
   auto* worldNode = static_cast<WorldNode*>(clone(worldBounds, setLinkIds));
-  worldNode->defaultLayer()->addChildren(
+
+  // the clone has its own default layer, so we only transfer the layer's state
+  auto* defaultLayerClone = worldNode->defaultLayer();
+  defaultLayerClone->setLayer(m_defaultLayer->layer());
+  defaultLayerClone->setVisibilityState(m_defaultLayer->visibilityState());
+  defaultLayerClone->setLockState(m_defaultLayer->lockState());
+  defaultLayerClone->addChildren(
     cloneRecursively(worldBounds, m_defaultLayer->children(), setLinkIds));
 
   if (myChildren.size() > 1)
@@ -353,16 +467,20 @@ void WorldNode::doDescendantWasAdded(Node* node, const size_t /* depth */)
   // being connected and add it or any descendants that need to be added.
   if (m_updateNodeTree)
   {
+    const auto doInsert = [&](auto* nodeToInsert) {
+      addPendingNodeTreeChange(nodeToInsert, NodeTreeChange::Insert);
+    };
+
     node->accept(kdl::overload(
       [&](auto&& thisLambda, WorldNode* world) { world->visitChildren(thisLambda); },
       [&](auto&& thisLambda, LayerNode* layer) { layer->visitChildren(thisLambda); },
       [&](auto&& thisLambda, GroupNode* group) { group->visitChildren(thisLambda); },
       [&](auto&& thisLambda, EntityNode* entity) {
-        m_nodeTree->insert(entity->physicalBounds(), entity);
+        doInsert(entity);
         entity->visitChildren(thisLambda);
       },
-      [&](BrushNode* brush) { m_nodeTree->insert(brush->physicalBounds(), brush); },
-      [&](PatchNode* patch) { m_nodeTree->insert(patch->physicalBounds(), patch); }));
+      [&](BrushNode* brush) { doInsert(brush); },
+      [&](PatchNode* patch) { doInsert(patch); }));
   }
 
   const auto updatePersistentId = [&](auto* persistentNode) {
@@ -402,13 +520,7 @@ void WorldNode::doDescendantWillBeRemoved(Node* node, const size_t /* depth */)
   if (m_updateNodeTree)
   {
     const auto doRemove = [&](auto* nodeToRemove) {
-      if (!m_nodeTree->remove(nodeToRemove))
-      {
-        auto str = std::stringstream();
-        str << "Node not found with bounds " << nodeToRemove->physicalBounds() << ": "
-            << nodeToRemove;
-        throw NodeTreeException{str.str()};
-      }
+      addPendingNodeTreeChange(nodeToRemove, NodeTreeChange::Remove);
     };
 
     node->accept(kdl::overload(
@@ -428,13 +540,17 @@ void WorldNode::doDescendantPhysicalBoundsDidChange(Node* node)
 {
   if (m_updateNodeTree)
   {
+    const auto doUpdate = [&](auto* changedNode) {
+      addPendingNodeTreeChange(changedNode, NodeTreeChange::Update);
+    };
+
     node->accept(kdl::overload(
       [](WorldNode*) {},
       [](LayerNode*) {},
       [](GroupNode*) {},
-      [&](EntityNode* entity) { m_nodeTree->update(entity->physicalBounds(), entity); },
-      [&](BrushNode* brush) { m_nodeTree->update(brush->physicalBounds(), brush); },
-      [&](PatchNode* patch) { m_nodeTree->update(patch->physicalBounds(), patch); }));
+      [&](EntityNode* entity) { doUpdate(entity); },
+      [&](BrushNode* brush) { doUpdate(brush); },
+      [&](PatchNode* patch) { doUpdate(patch); }));
   }
 }
 
@@ -446,6 +562,9 @@ bool WorldNode::doSelectable() const
 void WorldNode::doPick(
   const EditorContext& editorContext, const vm::ray3& ray, PickResult& pickResult)
 {
+  profileZone("Model", "Pick");
+
+  applyPendingNodeTreeUpdates();
   for (auto* node : m_nodeTree->find_intersectors(ray))
   {
     node->pick(editorContext, ray, pickResult);
@@ -454,6 +573,7 @@ void WorldNode::doPick(
 
 void WorldNode::doFindNodesContaining(const vm::vec3& point, std::vector<Node*>& result)
 {
+  applyPendingNodeTreeUpdates();
   for (auto* node : m_nodeTree->find_containers(point))
   {
     node->findNodesContaining(point, result);
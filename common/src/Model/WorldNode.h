@@ -31,6 +31,7 @@
 
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace TrenchBroom
@@ -60,6 +61,22 @@ private:
   std::unique_ptr<NodeTree> m_nodeTree;
   bool m_updateNodeTree;
 
+  enum class NodeTreeChange
+  {
+    Insert,
+    Remove,
+    Update,
+  };
+
+  /**
+   * The changes that have not been applied to the node tree yet. The vector records the
+   * order in which the nodes were first changed, and it may contain nodes whose changes
+   * cancelled each other out. The map holds the combined change for each node.
+   */
+  std::vector<Node*> m_pendingNodeTreeNodes;
+  std::unordered_map<Node*, NodeTreeChange> m_pendingNodeTreeChanges;
+  double m_nodeTreeRebuildThreshold = 0.25;
+
   IdType m_nextPersistentId = 1;
 
 public:
@@ -76,7 +93,10 @@ public:
 
   MapFormat mapFormat() const;
 
-  const NodeTree& nodeTree() const;
+  /**
+   * Returns the node tree after applying all pending changes to it.
+   */
+  const NodeTree& nodeTree();
 
 public: // layer management
   LayerNode* defaultLayer();
@@ -131,6 +151,13 @@ private:
 public: // index
   const EntityNodeIndex& entityNodeIndex() const;
 
+  /**
+   * Inserts the pending entity properties into the entity node index. Call this before
+   * querying the index from several threads, e.g. before running the validators
+   * concurrently, so that the queries do not have to wait for the insertion.
+   */
+  void flushEntityNodeIndex();
+
 public: // validator registration
   std::vector<const Validator*> registeredValidators() const;
   std::vector<const IssueQuickFix*> quickFixes(IssueType issueTypes) const;
@@ -142,6 +169,25 @@ public: // node tree bulk updating
   void enableNodeTreeUpdates();
   void rebuildNodeTree();
 
+  /**
+   * Applies all pending changes to the node tree in one batch. Nodes that are added,
+   * removed or whose bounds change are not inserted, removed or updated in the node
+   * tree right away because a single edit can change many nodes, or the bounds of a
+   * node many times, e.g. when all brushes of a brush entity are transformed. The
+   * changes are applied when the node tree is queried or when a transaction is
+   * committed.
+   */
+  void applyPendingNodeTreeUpdates();
+
+  /**
+   * Sets the fraction of the nodes in the node tree that must change before pending
+   * changes are applied by rebuilding the node tree instead of updating it.
+   */
+  void setNodeTreeRebuildThreshold(double nodeTreeRebuildThreshold);
+
+private:
+  void addPendingNodeTreeChange(Node* node, NodeTreeChange change);
+
 private:
   void invalidateAllIssues();
 
@@ -40,26 +40,82 @@
 #include "View/Actions.h"
 
 #include <string>
+#include <tuple>
 #include <vector>
 
 namespace TrenchBroom
 {
 // PreferenceManager
 
+namespace
+{
+
+template <typename GetValue>
+std::shared_ptr<PreferenceSnapshot> makeSnapshot(const GetValue& getValue)
+{
+  auto snapshot = std::make_shared<PreferenceSnapshot>();
+  snapshot->showPointEntities = getValue(Preferences::ShowPointEntities);
+  snapshot->showBrushes = getValue(Preferences::ShowBrushes);
+  snapshot->alignmentLock = getValue(Preferences::AlignmentLock);
+  snapshot->handleRadius = getValue(Preferences::HandleRadius);
+  return snapshot;
+}
+
+auto snapshotValues(const PreferenceSnapshot& snapshot)
+{
+  return std::tie(
+    snapshot.showPointEntities,
+    snapshot.showBrushes,
+    snapshot.alignmentLock,
+    snapshot.handleRadius);
+}
+
+} // namespace
+
 std::unique_ptr<PreferenceManager> PreferenceManager::m_instance;
 bool PreferenceManager::m_initialized = false;
 
+PreferenceManager::PreferenceManager()
+  : m_snapshot{makeSnapshot([](auto& preference) { return preference.defaultValue(); })}
+{
+}
+
 PreferenceManager& PreferenceManager::instance()
 {
   ensure(m_instance != nullptr, "Preference manager is set");
   if (!m_initialized)
   {
     m_instance->initialize();
+    m_instance->updateSnapshot();
     m_initialized = true;
   }
   return *m_instance;
 }
 
+std::shared_ptr<const PreferenceSnapshot> PreferenceManager::snapshot() const
+{
+  const auto lock = std::lock_guard{m_snapshotMutex};
+  return m_snapshot;
+}
+
+std::uint64_t PreferenceManager::snapshotVersion() const
+{
+  return m_snapshotVersion.load(std::memory_order_acquire);
+}
+
+void PreferenceManager::updateSnapshot()
+{
+  auto snapshot = makeSnapshot([&](auto& preference) { return get(preference); });
+
+  const auto lock = std::lock_guard{m_snapshotMutex};
+  if (snapshotValues(*snapshot) != snapshotValues(*m_snapshot))
+  {
+    snapshot->version = m_snapshot->version + 1;
+    m_snapshot = std::move(snapshot);
+    m_snapshotVersion.store(m_snapshot->version, std::memory_order_release);
+  }
+}
+
 namespace
 {
 bool shouldSaveInstantly()
@@ -300,6 +356,9 @@ void AppPreferenceManager::invalidatePreferences()
     unused(path);
     prefPtr->setValid(false);
   }
+
+  // the snapshot is not loaded lazily, so it must be updated right away
+  updateSnapshot();
 }
 
 /**
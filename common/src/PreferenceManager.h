@@ -30,14 +30,18 @@
 #include "Macros.h"
 #include "Notifier.h"
 #include "Preference.h"
+#include "PreferenceSnapshot.h"
 #include "Result.h"
 
 #include "kdl/result.h"
 #include "kdl/vector_set.h"
 
+#include <atomic>
+#include <cstdint>
 #include <filesystem>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <vector>
 
 class QTextStream;
@@ -54,9 +58,15 @@ private:
   static std::unique_ptr<PreferenceManager> m_instance;
   static bool m_initialized;
 
+  mutable std::mutex m_snapshotMutex;
+  std::shared_ptr<const PreferenceSnapshot> m_snapshot;
+  std::atomic<std::uint64_t> m_snapshotVersion = 0;
+
 protected:
   std::map<std::filesystem::path, std::unique_ptr<PreferenceBase>> m_dynamicPreferences;
 
+  PreferenceManager();
+
 public:
   Notifier<const std::filesystem::path&> preferenceDidChangeNotifier;
 
@@ -122,6 +132,7 @@ public:
 
     preference.setValue(value);
     preference.setValid(true);
+    updateSnapshot();
 
     savePreference(preference);
     if (saveInstantly())
@@ -138,12 +149,32 @@ public:
     set(preference, preference.defaultValue());
   }
 
+  /**
+   * Returns the most recently published snapshot of the preference values. Unlike get,
+   * this can be called from any thread.
+   */
+  std::shared_ptr<const PreferenceSnapshot> snapshot() const;
+
+  /**
+   * Returns the version of the most recently published snapshot. This can be called from
+   * any thread and is cheaper than snapshot() if the caller only needs to detect changes.
+   */
+  std::uint64_t snapshotVersion() const;
+
   virtual void initialize() = 0;
 
   virtual bool saveInstantly() const = 0;
   virtual void saveChanges() = 0;
   virtual void discardChanges() = 0;
 
+protected:
+  /**
+   * Publishes a new snapshot of the current preference values if any of the values in the
+   * snapshot changed. Must be called on the main thread whenever the values of the
+   * preferences change.
+   */
+  void updateSnapshot();
+
 private:
   virtual void validatePreference(PreferenceBase&) = 0;
   virtual void savePreference(PreferenceBase&) = 0;
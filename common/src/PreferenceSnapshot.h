@@ -0,0 +1,54 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+namespace TrenchBroom
+{
+
+/**
+ * An immutable copy of the values of the preferences that are read in hot paths or that
+ * must be passed to worker threads.
+ *
+ * Snapshots are created by the preference manager. Initially, the snapshot holds the
+ * default values of the preferences, and a new snapshot with a unique, increasing version
+ * is published whenever one of these preferences changes. Unlike the preference manager,
+ * snapshots can be read from any thread.
+ *
+ * When adding a preference here, also update makeSnapshot and snapshotValues in
+ * PreferenceManager.cpp.
+ */
+struct PreferenceSnapshot
+{
+  std::uint64_t version = 0;
+
+  // Editor context
+  bool showPointEntities;
+  bool showBrushes;
+
+  // Transformations
+  bool alignmentLock;
+
+  // Handles
+  float handleRadius;
+};
+
+} // namespace TrenchBroom
@@ -60,6 +60,9 @@ Preference<Color> PortalFileBorderColor(
 Preference<Color> PortalFileFillColor(
   "Renderer/Colors/Portal file fill", Color(1.0f, 0.4f, 0.4f, 0.2f));
 Preference<bool> ShowFPS("Renderer/Show FPS", false);
+#ifdef TB_ENABLE_PROFILER
+Preference<bool> ShowProfilerStatistics("Renderer/Show profiler statistics", false);
+#endif
 
 Preference<Color>& axisColor(vm::axis::type axis)
 {
@@ -329,6 +332,9 @@ const std::vector<PreferenceBase*>& staticPreferences()
     &PortalFileBorderColor,
     &PortalFileFillColor,
     &ShowFPS,
+#ifdef TB_ENABLE_PROFILER
+    &ShowProfilerStatistics,
+#endif
     &CompassBackgroundColor,
     &CompassBackgroundOutlineColor,
     &CompassAxisOutlineColor,
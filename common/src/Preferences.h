@@ -54,6 +54,9 @@ extern Preference<Color> PointFileColor;
 extern Preference<Color> PortalFileBorderColor;
 extern Preference<Color> PortalFileFillColor;
 extern Preference<bool> ShowFPS;
+#ifdef TB_ENABLE_PROFILER
+extern Preference<bool> ShowProfilerStatistics;
+#endif
 
 Preference<Color>& axisColor(vm::axis::type axis);
 
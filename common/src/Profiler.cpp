@@ -0,0 +1,401 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Profiler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <iomanip>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <ostream>
+#include <string_view>
+#include <utility>
+
+namespace TrenchBroom
+{
+namespace
+{
+
+/**
+ * A ring buffer of events that is written by a single thread without taking a lock and
+ * that can be read by other threads at any time.
+ *
+ * The writer announces the sequence number of the event it is about to write before
+ * writing the event into its slot, and publishes it afterwards. A reader copies the
+ * published events and then checks which of them the writer may have overwritten in the
+ * meantime, similar to a seqlock. The slots consist of atomics so that reading a slot
+ * while it is being written is not a data race.
+ */
+class EventBuffer
+{
+private:
+  struct Slot
+  {
+    std::atomic<ProfilerEventType> type;
+    std::atomic<const char*> category;
+    std::atomic<const char*> name;
+    std::atomic<ProfilerEvent::Clock::rep> start;
+    std::atomic<ProfilerEvent::Clock::rep> duration;
+    std::atomic<std::int64_t> value;
+  };
+
+  std::vector<Slot> m_slots;
+  // the number of events whose recording has started
+  std::atomic<std::size_t> m_writing = 0;
+  // the number of events whose recording has finished
+  std::atomic<std::size_t> m_written = 0;
+  // the number of events that were recorded before the buffer was last cleared
+  std::atomic<std::size_t> m_cleared = 0;
+
+public:
+  const std::size_t threadIndex;
+
+  explicit EventBuffer(const std::size_t threadIndex_)
+    : m_slots(Profiler::EventsPerThread)
+    , threadIndex{threadIndex_}
+  {
+  }
+
+  /**
+   * Must only be called by the thread that owns this buffer.
+   */
+  void record(const ProfilerEvent& event)
+  {
+    constexpr auto relaxed = std::memory_order_relaxed;
+
+    const auto index = m_written.load(relaxed);
+    m_writing.store(index + 1, relaxed);
+    // order the announcement before the writes to the slot
+    std::atomic_thread_fence(std::memory_order_release);
+
+    auto& slot = m_slots[index % Profiler::EventsPerThread];
+    slot.type.store(event.type, relaxed);
+    slot.category.store(event.category, relaxed);
+    slot.name.store(event.name, relaxed);
+    slot.start.store(event.start.time_since_epoch().count(), relaxed);
+    slot.duration.store(event.duration.count(), relaxed);
+    slot.value.store(event.value, relaxed);
+
+    m_written.store(index + 1, std::memory_order_release);
+  }
+
+  /**
+   * Appends the retained events that started in the given time interval [from, to) to
+   * the given vector. Can be called by any thread.
+   */
+  void copyEvents(
+    std::vector<ProfilerEvent>& result,
+    const ProfilerEvent::Clock::time_point from,
+    const ProfilerEvent::Clock::time_point to) const
+  {
+    constexpr auto relaxed = std::memory_order_relaxed;
+
+    const auto end = m_written.load(std::memory_order_acquire);
+    const auto begin = std::max(
+      m_cleared.load(relaxed),
+      end > Profiler::EventsPerThread ? end - Profiler::EventsPerThread : 0);
+
+    auto events = std::vector<std::pair<std::size_t, ProfilerEvent>>{};
+    for (auto index = begin; index < end; ++index)
+    {
+      const auto& slot = m_slots[index % Profiler::EventsPerThread];
+      events.emplace_back(
+        index,
+        ProfilerEvent{
+          slot.type.load(relaxed),
+          slot.category.load(relaxed),
+          slot.name.load(relaxed),
+          ProfilerEvent::Clock::time_point{
+            ProfilerEvent::Clock::duration{slot.start.load(relaxed)}},
+          ProfilerEvent::Clock::duration{slot.duration.load(relaxed)},
+          slot.value.load(relaxed),
+          threadIndex});
+    }
+
+    // if the writer has overwritten a slot while we were reading it, we see the
+    // announcement of the overwriting event here
+    std::atomic_thread_fence(std::memory_order_acquire);
+    const auto writing = m_writing.load(relaxed);
+    const auto firstValid =
+      writing > Profiler::EventsPerThread ? writing - Profiler::EventsPerThread : 0;
+
+    for (const auto& [index, event] : events)
+    {
+      if (index >= firstValid && event.start >= from && event.start < to)
+      {
+        result.push_back(event);
+      }
+    }
+  }
+
+  /**
+   * Discards the events recorded so far. Can be called by any thread.
+   */
+  void clear() { m_cleared.store(m_written.load(std::memory_order_acquire)); }
+};
+
+struct EventBufferRegistry
+{
+  std::mutex mutex;
+  std::vector<std::shared_ptr<EventBuffer>> buffers;
+  std::vector<std::shared_ptr<EventBuffer>> freeBuffers;
+};
+
+EventBufferRegistry& registry()
+{
+  static auto instance = EventBufferRegistry{};
+  return instance;
+}
+
+/**
+ * Acquires an event buffer for the current thread and returns it to the registry when
+ * the thread exits, so that threads spawned for parallel work don't accumulate buffers.
+ */
+class ThreadEventBuffer
+{
+private:
+  std::shared_ptr<EventBuffer> m_buffer;
+
+public:
+  ThreadEventBuffer()
+  {
+    auto& r = registry();
+    const auto lock = std::lock_guard{r.mutex};
+    if (!r.freeBuffers.empty())
+    {
+      m_buffer = std::move(r.freeBuffers.back());
+      r.freeBuffers.pop_back();
+    }
+    else
+    {
+      m_buffer = std::make_shared<EventBuffer>(r.buffers.size());
+      r.buffers.push_back(m_buffer);
+    }
+  }
+
+  ~ThreadEventBuffer()
+  {
+    auto& r = registry();
+    const auto lock = std::lock_guard{r.mutex};
+    r.freeBuffers.push_back(std::move(m_buffer));
+  }
+
+  ThreadEventBuffer(const ThreadEventBuffer&) = delete;
+  ThreadEventBuffer& operator=(const ThreadEventBuffer&) = delete;
+
+  EventBuffer& get() { return *m_buffer; }
+};
+
+EventBuffer& threadEventBuffer()
+{
+  thread_local auto buffer = ThreadEventBuffer{};
+  return buffer.get();
+}
+
+void writeJsonString(std::ostream& str, const char* s)
+{
+  str << '"';
+  for (; *s != '\0'; ++s)
+  {
+    const auto c = *s;
+    switch (c)
+    {
+    case '"':
+      str << "\\\"";
+      break;
+    case '\\':
+      str << "\\\\";
+      break;
+    case '\n':
+      str << "\\n";
+      break;
+    case '\t':
+      str << "\\t";
+      break;
+    default:
+      if (static_cast<unsigned char>(c) < 0x20)
+      {
+        str << "\\u" << std::hex << std::setw(4) << std::setfill('0')
+            << static_cast<int>(c) << std::dec << std::setfill(' ');
+      }
+      else
+      {
+        str << c;
+      }
+      break;
+    }
+  }
+  str << '"';
+}
+
+double toMicroseconds(const ProfilerEvent::Clock::duration duration)
+{
+  return std::chrono::duration<double, std::micro>{duration}.count();
+}
+
+} // namespace
+
+namespace Profiler
+{
+
+void recordZone(
+  const char* category,
+  const char* name,
+  const ProfilerEvent::Clock::time_point start,
+  const ProfilerEvent::Clock::time_point end)
+{
+  auto& buffer = threadEventBuffer();
+  buffer.record(ProfilerEvent{
+    ProfilerEventType::Zone, category, name, start, end - start, 0, buffer.threadIndex});
+}
+
+void recordCounter(const char* category, const char* name, const std::int64_t value)
+{
+  auto& buffer = threadEventBuffer();
+  buffer.record(ProfilerEvent{
+    ProfilerEventType::Counter,
+    category,
+    name,
+    ProfilerEvent::Clock::now(),
+    ProfilerEvent::Clock::duration::zero(),
+    value,
+    buffer.threadIndex});
+}
+
+std::vector<ProfilerEvent> events(
+  const ProfilerEvent::Clock::time_point from, const ProfilerEvent::Clock::time_point to)
+{
+  auto result = std::vector<ProfilerEvent>{};
+
+  auto& r = registry();
+  const auto registryLock = std::lock_guard{r.mutex};
+  for (const auto& buffer : r.buffers)
+  {
+    buffer->copyEvents(result, from, to);
+  }
+
+  std::stable_sort(result.begin(), result.end(), [](const auto& lhs, const auto& rhs) {
+    return lhs.start < rhs.start;
+  });
+  return result;
+}
+
+void clear()
+{
+  auto& r = registry();
+  const auto registryLock = std::lock_guard{r.mutex};
+  for (const auto& buffer : r.buffers)
+  {
+    buffer->clear();
+  }
+}
+
+std::vector<ProfilerZoneStatistics> zoneStatistics(
+  const std::vector<ProfilerEvent>& events)
+{
+  auto result = std::vector<ProfilerZoneStatistics>{};
+  auto indices = std::map<std::pair<std::string_view, std::string_view>, std::size_t>{};
+
+  for (const auto& event : events)
+  {
+    if (event.type == ProfilerEventType::Zone)
+    {
+      const auto [it, inserted] =
+        indices.emplace(std::pair{event.category, event.name}, result.size());
+      if (inserted)
+      {
+        result.push_back(ProfilerZoneStatistics{
+          event.category, event.name, 0, ProfilerEvent::Clock::duration::zero()});
+      }
+
+      auto& statistics = result[it->second];
+      ++statistics.count;
+      statistics.totalDuration += event.duration;
+    }
+  }
+
+  std::stable_sort(result.begin(), result.end(), [](const auto& lhs, const auto& rhs) {
+    return lhs.totalDuration > rhs.totalDuration;
+  });
+  return result;
+}
+
+void writeChromeTrace(std::ostream& str, const std::vector<ProfilerEvent>& events)
+{
+  const auto origin = std::accumulate(
+    events.begin(),
+    events.end(),
+    ProfilerEvent::Clock::time_point::max(),
+    [](const auto& time, const auto& event) { return std::min(time, event.start); });
+
+  const auto flags = str.flags();
+  const auto precision = str.precision();
+  str << std::fixed << std::setprecision(3);
+
+  str << "{\"traceEvents\":[";
+  for (auto it = events.begin(); it != events.end(); ++it)
+  {
+    const auto& event = *it;
+    if (it != events.begin())
+    {
+      str << ",";
+    }
+    str << "\n{\"name\":";
+    writeJsonString(str, event.name);
+    str << ",\"cat\":";
+    writeJsonString(str, event.category);
+    str << ",\"pid\":1,\"tid\":" << event.threadIndex
+        << ",\"ts\":" << toMicroseconds(event.start - origin);
+
+    switch (event.type)
+    {
+    case ProfilerEventType::Zone:
+      str << ",\"ph\":\"X\",\"dur\":" << toMicroseconds(event.duration);
+      break;
+    case ProfilerEventType::Counter:
+      str << ",\"ph\":\"C\",\"args\":{\"value\":" << event.value << "}";
+      break;
+    }
+    str << "}";
+  }
+  str << "\n]}\n";
+
+  str.flags(flags);
+  str.precision(precision);
+}
+
+} // namespace Profiler
+
+ProfilerZone::ProfilerZone(const char* category, const char* name)
+  : m_category{category}
+  , m_name{name}
+  , m_start{ProfilerEvent::Clock::now()}
+{
+}
+
+ProfilerZone::~ProfilerZone()
+{
+  Profiler::recordZone(m_category, m_name, m_start, ProfilerEvent::Clock::now());
+}
+
+} // namespace TrenchBroom
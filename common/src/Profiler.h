@@ -0,0 +1,169 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#ifdef TB_ENABLE_PROFILER
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <vector>
+
+namespace TrenchBroom
+{
+
+enum class ProfilerEventType
+{
+  Zone,
+  Counter,
+};
+
+/**
+ * A single event recorded by the profiler. Zone events record the time spent in a scope,
+ * counter events record a value at a point in time.
+ *
+ * The category and name must be string literals or otherwise outlive the profiler.
+ */
+struct ProfilerEvent
+{
+  using Clock = std::chrono::steady_clock;
+
+  ProfilerEventType type;
+  const char* category;
+  const char* name;
+  Clock::time_point start;
+  Clock::duration duration;
+  std::int64_t value;
+  std::size_t threadIndex;
+};
+
+/**
+ * The number of times a zone was recorded and the total time spent in it.
+ */
+struct ProfilerZoneStatistics
+{
+  const char* category;
+  const char* name;
+  std::size_t count;
+  ProfilerEvent::Clock::duration totalDuration;
+};
+
+/**
+ * Records profiler events into thread local ring buffers. Each ring buffer retains the
+ * most recent events recorded by its thread, older events are overwritten. The ring
+ * buffers of threads that have exited are reused by new threads, so the thread index of
+ * an event identifies a ring buffer rather than a particular thread.
+ *
+ * Recording an event does not take a lock because only the owning thread writes to a
+ * ring buffer. Reading the events copies the ring buffers while their threads keep
+ * recording and discards the events that were overwritten during the copy.
+ *
+ * Events are usually recorded using the profileZone and profileCounter macros. The
+ * profiler is only available if TB_ENABLE_PROFILER is defined, otherwise the macros
+ * compile to nothing.
+ */
+namespace Profiler
+{
+
+/**
+ * The number of events retained per thread.
+ */
+constexpr std::size_t EventsPerThread = 1u << 12;
+
+void recordZone(
+  const char* category,
+  const char* name,
+  ProfilerEvent::Clock::time_point start,
+  ProfilerEvent::Clock::time_point end);
+
+void recordCounter(const char* category, const char* name, std::int64_t value);
+
+/**
+ * Returns the retained events of all threads that started in the given time interval
+ * [from, to), sorted by their start time.
+ */
+std::vector<ProfilerEvent> events(
+  ProfilerEvent::Clock::time_point from = ProfilerEvent::Clock::time_point::min(),
+  ProfilerEvent::Clock::time_point to = ProfilerEvent::Clock::time_point::max());
+
+/**
+ * Discards all retained events.
+ */
+void clear();
+
+/**
+ * Aggregates the zone events among the given events by category and name. The result is
+ * sorted by descending total duration.
+ */
+std::vector<ProfilerZoneStatistics> zoneStatistics(
+  const std::vector<ProfilerEvent>& events);
+
+/**
+ * Writes the given events to the given stream in the Chrome trace event format. The
+ * result can be loaded into chrome://tracing or Perfetto.
+ */
+void writeChromeTrace(std::ostream& str, const std::vector<ProfilerEvent>& events);
+
+} // namespace Profiler
+
+/**
+ * Records a zone event for the lifetime of an instance.
+ */
+class ProfilerZone
+{
+private:
+  const char* m_category;
+  const char* m_name;
+  ProfilerEvent::Clock::time_point m_start;
+
+public:
+  ProfilerZone(const char* category, const char* name);
+  ~ProfilerZone();
+
+  ProfilerZone(const ProfilerZone&) = delete;
+  ProfilerZone& operator=(const ProfilerZone&) = delete;
+};
+
+} // namespace TrenchBroom
+
+#endif
+
+#define profilerConcat2(lhs, rhs) lhs##rhs
+#define profilerConcat(lhs, rhs) profilerConcat2(lhs, rhs)
+
+#ifdef TB_ENABLE_PROFILER
+// Records the time spent in the enclosing scope
+#define profileZone(category, name)                                                      \
+  const auto profilerConcat(profilerZone_, __LINE__) =                                   \
+    TrenchBroom::ProfilerZone(category, name)
+// Records the current value of a counter
+#define profileCounter(category, name, value)                                            \
+  TrenchBroom::Profiler::recordCounter(category, name, static_cast<std::int64_t>(value))
+#else
+#define profileZone(category, name)                                                      \
+  do                                                                                     \
+  {                                                                                      \
+  } while (false)
+#define profileCounter(category, name, value)                                            \
+  do                                                                                     \
+  {                                                                                      \
+  } while (false)
+#endif
@@ -28,6 +28,7 @@
 #include "Model/TagAttribute.h"
 #include "PreferenceManager.h"
 #include "Preferences.h"
+#include "Profiler.h"
 #include "Renderer/BrushRendererArrays.h"
 #include "Renderer/BrushRendererBrushCache.h"
 #include "Renderer/RenderContext.h"
@@ -383,6 +384,9 @@ void BrushRenderer::validate()
 {
   assert(!valid());
 
+  profileZone("Renderer", "Validate brushes");
+  profileCounter("Renderer", "Invalid brushes", m_invalidBrushes.size());
+
   for (auto* brushNode : m_invalidBrushes)
   {
     validateBrush(*brushNode);
@@ -25,6 +25,7 @@
 #include "Model/Polyhedron.h"
 
 #include <algorithm>
+#include <unordered_map>
 
 namespace TrenchBroom::Renderer
 {
@@ -79,6 +80,12 @@ void BrushRendererBrushCache::validateVertexCache(const Model::BrushNode& brushN
   m_cachedFacesSortedByMaterial.clear();
   m_cachedFacesSortedByMaterial.reserve(brush.faceCount());
 
+  // The index of each vertex, relative to the brush's first vertex being 0. This is used
+  // below when building the edge cache. The brush geometry may be shared with other
+  // brushes, so we must not store the indices in the vertex payloads.
+  auto vertexIndices = std::unordered_map<const Model::BrushVertex*, size_t>{};
+  vertexIndices.reserve(brush.vertexCount());
+
   for (const auto& face : brush.faces())
   {
     const auto indexOfFirstVertexRelativeToBrush = m_cachedVertices.size();
@@ -87,21 +94,15 @@ void BrushRendererBrushCache::validateVertexCache(const Model::BrushNode& brushN
     auto& boundary = face.geometry()->boundary();
     for (auto it = std::rbegin(boundary), end = std::rend(boundary); it != end; ++it)
     {
-      auto* currentHalfEdge = *it;
-      auto* vertex = currentHalfEdge->origin();
+      const auto* vertex = (*it)->origin();
 
-      // Set the vertex payload to the index, relative to the brush's first vertex being
-      // 0. This is used below when building the edge cache. NOTE: we'll overwrite the
-      // payload as we visit the same vertex several times while visiting different faces,
-      // this is fine.
-      const auto currentIndex = m_cachedVertices.size();
-      vertex->setPayload(static_cast<GLuint>(currentIndex));
+      // NOTE: we'll overwrite the index as we visit the same vertex several times while
+      // visiting different faces, this is fine.
+      vertexIndices[vertex] = m_cachedVertices.size();
 
       const auto& position = vertex->position();
       m_cachedVertices.emplace_back(
         vm::vec3f{position}, vm::vec3f{face.boundary().normal}, face.uvCoords(position));
-
-      currentHalfEdge = currentHalfEdge->previous();
     }
 
     // face cache
@@ -131,8 +132,9 @@ void BrushRendererBrushCache::validateVertexCache(const Model::BrushNode& brushN
     const auto& face1 = brush.face(*faceIndex1);
     const auto& face2 = brush.face(*faceIndex2);
 
-    const auto vertexIndex1RelativeToBrush = currentEdge->firstVertex()->payload();
-    const auto vertexIndex2RelativeToBrush = currentEdge->secondVertex()->payload();
+    const auto vertexIndex1RelativeToBrush = vertexIndices.at(currentEdge->firstVertex());
+    const auto vertexIndex2RelativeToBrush =
+      vertexIndices.at(currentEdge->secondVertex());
 
     m_cachedEdges.emplace_back(
       &face1, &face2, vertexIndex1RelativeToBrush, vertexIndex2RelativeToBrush);
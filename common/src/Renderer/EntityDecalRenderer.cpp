@@ -321,7 +321,7 @@ void EntityDecalRenderer::validateDecalData(
 
   const auto& document = kdl::mem_lock(m_document);
   const auto& editorContext = document->editorContext();
-  const auto* world = document->world();
+  auto* world = document->world();
 
   // collect all the brush nodes that touch the entity's bbox
   const auto entityBounds = entityNode->physicalBounds();
@@ -19,6 +19,7 @@
 
 #include "FontManager.h"
 
+#include "Renderer/AttrString.h"
 #include "Renderer/FontDescriptor.h"
 #include "Renderer/FreeTypeFontFactory.h"
 #include "Renderer/TextureFont.h"
@@ -29,8 +30,11 @@ namespace TrenchBroom
 {
 namespace Renderer
 {
+const size_t FontManager::MaxCachedGlyphRuns = 16384;
+
 FontManager::FontManager()
   : m_factory(std::make_unique<FreeTypeFontFactory>())
+  , m_glyphRunCache(MaxCachedGlyphRuns)
 {
 }
 
@@ -38,6 +42,7 @@ FontManager::~FontManager() = default;
 
 void FontManager::clearCache()
 {
+  m_glyphRunCache.clear();
   m_cache.clear();
 }
 
@@ -53,6 +58,21 @@ TextureFont& FontManager::font(const FontDescriptor& fontDescriptor)
   return *it->second;
 }
 
+std::shared_ptr<const GlyphRun> FontManager::glyphRun(
+  const FontDescriptor& fontDescriptor, const AttrString& string)
+{
+  auto key = std::make_pair(fontDescriptor, string);
+  if (const auto* glyphRun = m_glyphRunCache.find(key))
+  {
+    return *glyphRun;
+  }
+
+  const auto& textureFont = font(fontDescriptor);
+  auto glyphRun = std::make_shared<const GlyphRun>(
+    GlyphRun{textureFont.quads(string, true), textureFont.measure(string)});
+  return m_glyphRunCache.insert(std::move(key), std::move(glyphRun));
+}
+
 FontDescriptor FontManager::selectFontSize(
   const FontDescriptor& fontDescriptor,
   const std::string& string,
@@ -21,29 +21,61 @@
 
 #include "Macros.h"
 
+#include "kdl/lru_cache.h"
+
+#include "vm/forward.h"
+#include "vm/vec.h"
+
 #include <map>
 #include <memory>
 #include <string>
+#include <utility>
+#include <vector>
 
 namespace TrenchBroom
 {
 namespace Renderer
 {
+class AttrString;
 class FontDescriptor;
 class FontFactory;
 class TextureFont;
 
+/**
+ * The laid out glyphs of a string. The vertices alternate between the position and the
+ * texture coordinates of the corners of the glyph quads, which are wound clockwise.
+ */
+struct GlyphRun
+{
+  std::vector<vm::vec2f> vertices;
+  vm::vec2f size;
+};
+
 class FontManager
 {
 private:
+  static const size_t MaxCachedGlyphRuns;
+
   std::unique_ptr<FontFactory> m_factory;
   std::map<FontDescriptor, std::unique_ptr<TextureFont>> m_cache;
+  kdl::lru_cache<std::pair<FontDescriptor, AttrString>, std::shared_ptr<const GlyphRun>>
+    m_glyphRunCache;
 
 public:
   FontManager();
   ~FontManager();
 
   TextureFont& font(const FontDescriptor& fontDescriptor);
+
+  /**
+   * Returns the glyph run of the given string when rendered with the given font. Glyph
+   * runs are cached because the same strings, such as entity classnames, are laid out
+   * again in every frame. Once the cache is full, the least recently used glyph run is
+   * evicted.
+   */
+  std::shared_ptr<const GlyphRun> glyphRun(
+    const FontDescriptor& fontDescriptor, const AttrString& string);
+
   FontDescriptor selectFontSize(
     const FontDescriptor& fontDescriptor,
     const std::string& string,
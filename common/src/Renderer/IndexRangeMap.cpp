@@ -204,5 +204,17 @@ void IndexRangeMap::forEachPrimitive(
     }
   }
 }
+
+size_t IndexRangeMap::memoryUsage() const
+{
+  auto result = sizeof(IndexRangeMap) + sizeof(PrimTypeToIndexData);
+  for (const auto& primType : PrimTypeValues)
+  {
+    const auto& indicesAndCounts = m_data->get(primType);
+    result += indicesAndCounts.indices.capacity() * sizeof(GLint)
+              + indicesAndCounts.counts.capacity() * sizeof(GLsizei);
+  }
+  return result;
+}
 } // namespace Renderer
 } // namespace TrenchBroom
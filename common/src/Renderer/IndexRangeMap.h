@@ -165,6 +165,12 @@ public:
    */
   void forEachPrimitive(
     std::function<void(PrimType, size_t index, size_t count)> func) const;
+
+  /**
+   * Returns an estimate of the number of bytes used by this index range map. The data of
+   * copies of this map is shared, but it is included in the estimate of every copy.
+   */
+  size_t memoryUsage() const;
 };
 } // namespace Renderer
 } // namespace TrenchBroom
@@ -35,6 +35,7 @@
 #include "Model/WorldNode.h"
 #include "PreferenceManager.h"
 #include "Preferences.h"
+#include "Profiler.h"
 #include "Renderer/BrushRenderer.h"
 #include "Renderer/EntityDecalRenderer.h"
 #include "Renderer/EntityLinkRenderer.h"
@@ -229,6 +230,8 @@ void MapRenderer::restoreSelectionColors()
 
 void MapRenderer::render(RenderContext& renderContext, RenderBatch& renderBatch)
 {
+  profileZone("Renderer", "Render map");
+
   setupGL(renderBatch);
   renderDefaultOpaque(renderContext, renderBatch);
   renderLockedOpaque(renderContext, renderBatch);
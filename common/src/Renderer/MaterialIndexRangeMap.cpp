@@ -160,6 +160,20 @@ void MaterialIndexRangeMap::forEachPrimitive(
   }
 }
 
+size_t MaterialIndexRangeMap::memoryUsage() const
+{
+  // every element of an std::map is stored in a separately allocated node along with
+  // some bookkeeping pointers
+  constexpr auto mapNodeOverhead = 3u * sizeof(void*) + sizeof(int);
+
+  auto result = sizeof(MaterialIndexRangeMap) + sizeof(MaterialToIndexRangeMap);
+  for (const auto& [material, indexRangeMap] : *m_data)
+  {
+    result += mapNodeOverhead + sizeof(material) + indexRangeMap.memoryUsage();
+  }
+  return result;
+}
+
 IndexRangeMap& MaterialIndexRangeMap::findCurrent(const Material* material)
 {
   if (!isCurrent(material))
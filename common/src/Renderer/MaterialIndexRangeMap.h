@@ -186,6 +186,12 @@ public:
     std::function<void(const Material* material, PrimType, size_t index, size_t count)>
       func) const;
 
+  /**
+   * Returns an estimate of the number of bytes used by this index range map. The data of
+   * copies of this map is shared, but it is included in the estimate of every copy.
+   */
+  size_t memoryUsage() const;
+
 private:
   IndexRangeMap& findCurrent(const Material* material);
   bool isCurrent(const Material* material) const;
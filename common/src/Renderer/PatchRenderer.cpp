@@ -19,41 +19,31 @@
 
 #include "PatchRenderer.h"
 
-#include "Assets/Material.h"
-#include "Assets/Texture.h"
 #include "Model/EditorContext.h"
 #include "Model/PatchNode.h"
-#include "PreferenceManager.h"
-#include "Preferences.h"
-#include "Renderer/ActiveShader.h"
-#include "Renderer/Camera.h"
+#include "Renderer/BrushRendererArrays.h"
 #include "Renderer/GLVertexType.h"
-#include "Renderer/IndexRangeMapBuilder.h"
-#include "Renderer/MaterialIndexArrayMapBuilder.h"
-#include "Renderer/MaterialIndexArrayRenderer.h"
-#include "Renderer/RenderBatch.h"
 #include "Renderer/RenderContext.h"
-#include "Renderer/RenderUtils.h"
-#include "Renderer/ShaderManager.h"
-#include "Renderer/Shaders.h"
-#include "Renderer/VertexArray.h"
 
-#include "kdl/vector_utils.h"
-
-#include "vm/forward.h"
 #include "vm/vec.h"
 
+#include <cassert>
+
 namespace TrenchBroom::Renderer
 {
 
 PatchRenderer::PatchRenderer(const Model::EditorContext& editorContext)
   : m_editorContext{editorContext}
 {
+  clear();
 }
 
+PatchRenderer::~PatchRenderer() = default;
+
 void PatchRenderer::setDefaultColor(const Color& faceColor)
 {
   m_defaultColor = faceColor;
+  m_faceRenderer = FaceRenderer{m_vertexArray, m_faces, m_defaultColor};
 }
 
 void PatchRenderer::setGrayscale(const bool grayscale)
@@ -98,47 +88,96 @@ void PatchRenderer::setOccludedEdgeColor(const Color& occludedEdgeColor)
 
 void PatchRenderer::invalidate()
 {
-  m_valid = false;
+  for (const auto* patchNode : m_allPatches)
+  {
+    removePatchFromVbo(*patchNode);
+  }
+  m_invalidPatches = m_allPatches;
+
+  assert(m_patchInfo.empty());
+  assert(m_faces->empty());
+}
+
+bool PatchRenderer::valid() const
+{
+  return m_invalidPatches.empty();
 }
 
 void PatchRenderer::clear()
 {
-  m_patchNodes.clear();
-  invalidate();
+  m_patchInfo.clear();
+  m_allPatches.clear();
+  m_invalidPatches.clear();
+
+  m_vertexArray = std::make_shared<BrushVertexArray>();
+  m_edgeIndices = std::make_shared<BrushIndexArray>();
+  m_faces = std::make_shared<MaterialToBrushIndicesMap>();
+
+  m_faceRenderer = FaceRenderer{m_vertexArray, m_faces, m_defaultColor};
+  m_edgeRenderer = IndexedEdgeRenderer{m_vertexArray, m_edgeIndices};
 }
 
 void PatchRenderer::addPatch(const Model::PatchNode* patchNode)
 {
-  if (m_patchNodes.insert(patchNode).second)
+  // i.e. insert the patch as "invalid" if it's not already present.
+  // if it is present, its validity is unchanged.
+  if (m_allPatches.insert(patchNode).second)
   {
-    invalidate();
+    assert(m_patchInfo.find(patchNode) == std::end(m_patchInfo));
+    assertResult(m_invalidPatches.insert(patchNode).second);
   }
 }
 
 void PatchRenderer::removePatch(const Model::PatchNode* patchNode)
 {
-  if (auto it = m_patchNodes.find(patchNode); it != std::end(m_patchNodes))
+  m_allPatches.erase(patchNode);
+
+  if (m_invalidPatches.erase(patchNode) > 0u)
   {
-    m_patchNodes.erase(it);
-    invalidate();
+    // invalid patches are not in the VBO, so we can return now.
+    assert(m_patchInfo.find(patchNode) == std::end(m_patchInfo));
+    return;
   }
+
+  removePatchFromVbo(*patchNode);
 }
 
-void PatchRenderer::invalidatePatch(const Model::PatchNode*)
+void PatchRenderer::invalidatePatch(const Model::PatchNode* patchNode)
 {
-  invalidate();
+  // skip if patch is already invalid
+  if (m_invalidPatches.count(patchNode) > 0u)
+  {
+    return;
+  }
+
+  // skip if patch is not in the renderer
+  if (m_allPatches.count(patchNode) == 0u)
+  {
+    return;
+  }
+
+  removePatchFromVbo(*patchNode);
+  m_invalidPatches.insert(patchNode);
 }
 
 void PatchRenderer::render(RenderContext& renderContext, RenderBatch& renderBatch)
 {
-  if (!m_valid)
+  if (m_allPatches.empty())
+  {
+    return;
+  }
+
+  if (!valid())
   {
     validate();
   }
 
   if (renderContext.showFaces())
   {
-    renderBatch.add(this);
+    m_faceRenderer.setGrayscale(m_grayscale);
+    m_faceRenderer.setTint(m_tint);
+    m_faceRenderer.setTintColor(m_tintColor);
+    m_faceRenderer.render(renderBatch);
   }
 
   if (renderContext.showEdges())
@@ -151,279 +190,185 @@ void PatchRenderer::render(RenderContext& renderContext, RenderBatch& renderBatc
   }
 }
 
-static MaterialIndexArrayRenderer buildMeshRenderer(
-  const std::vector<const Model::PatchNode*>& patchNodes,
-  const Model::EditorContext& editorContext)
+void PatchRenderer::validate()
 {
-  size_t vertexCount = 0u;
-  auto indexArrayMapSize = MaterialIndexArrayMap::Size{};
-
-  for (const auto* patchNode : patchNodes)
+  for (const auto* patchNode : m_invalidPatches)
   {
-    if (editorContext.visible(patchNode))
-    {
-      vertexCount += patchNode->grid().pointRowCount * patchNode->grid().pointColumnCount;
-
-      const auto* material = patchNode->patch().material();
-      const auto quadCount =
-        patchNode->grid().quadRowCount() * patchNode->grid().quadColumnCount();
-      indexArrayMapSize.inc(material, PrimType::Triangles, 6u * quadCount);
-    }
+    validatePatch(*patchNode);
   }
+  m_invalidPatches.clear();
+  assert(valid());
+}
 
-  using Vertex = GLVertexTypes::P3NT2::Vertex;
-  auto vertices = std::vector<Vertex>{};
-  vertices.reserve(vertexCount);
-
-  auto indexArrayMapBuilder = MaterialIndexArrayMapBuilder{indexArrayMapSize};
-  using Index = MaterialIndexArrayMapBuilder::Index;
-
-  for (const auto* patchNode : patchNodes)
-  {
-    if (editorContext.visible(patchNode))
-    {
-      const auto vertexOffset = vertices.size();
-
-      const auto& grid = patchNode->grid();
-      auto gridVertices = kdl::vec_transform(grid.points, [](const auto& p) {
-        return Vertex{vm::vec3f{p.position}, vm::vec3f{p.normal}, vm::vec2f{p.uvCoords}};
-      });
-      vertices = kdl::vec_concat(std::move(vertices), std::move(gridVertices));
-
-      const auto* material = patchNode->patch().material();
-
-      const auto pointsPerRow = grid.pointColumnCount;
-      for (size_t row = 0u; row < grid.quadRowCount(); ++row)
-      {
-        for (size_t col = 0u; col < grid.quadColumnCount(); ++col)
-        {
-          const auto i0 = vertexOffset + row * pointsPerRow + col;
-          const auto i1 = vertexOffset + row * pointsPerRow + col + 1u;
-          const auto i2 = vertexOffset + (row + 1u) * pointsPerRow + col + 1u;
-          const auto i3 = vertexOffset + (row + 1u) * pointsPerRow + col;
-
-          indexArrayMapBuilder.addTriangle(
-            material,
-            static_cast<Index>(i0),
-            static_cast<Index>(i1),
-            static_cast<Index>(i2));
-          indexArrayMapBuilder.addTriangle(
-            material,
-            static_cast<Index>(i2),
-            static_cast<Index>(i3),
-            static_cast<Index>(i0));
-        }
-      }
-    }
-  }
+namespace
+{
 
-  auto vertexArray = VertexArray::move(std::move(vertices));
-  auto indexArray = IndexArray::move(std::move(indexArrayMapBuilder.indices()));
-  return MaterialIndexArrayRenderer{
-    std::move(vertexArray),
-    std::move(indexArray),
-    std::move(indexArrayMapBuilder.ranges())};
+size_t edgeLoopVertexCount(const Model::PatchGrid& grid)
+{
+  return (grid.pointRowCount + grid.pointColumnCount - 2u) * 2u;
 }
 
-static DirectEdgeRenderer buildEdgeRenderer(
-  const std::vector<const Model::PatchNode*>& patchNodes,
-  const Model::EditorContext& editorContext)
+/**
+ * Writes the indices of the vertices on the boundary of the given grid as pairs of line
+ * indices.
+ */
+void addEdgeLoopIndices(
+  GLuint* dest, const Model::PatchGrid& grid, const GLuint patchVerticesStartIndex)
 {
-  size_t vertexCount = 0u;
-  auto indexRangeMapSize = IndexRangeMap::Size{};
+  const auto vertexIndex = [&](const size_t row, const size_t col) {
+    return patchVerticesStartIndex
+           + static_cast<GLuint>(row * grid.pointColumnCount + col);
+  };
 
-  for (const auto* patchNode : patchNodes)
+  // walk around the patch to collect the edge vertices
+  // for each side, collect the first vertex up to but not including the last vertex
+
+  const auto t = 0u;
+  const auto b = grid.pointRowCount - 1u;
+  const auto l = 0u;
+  const auto r = grid.pointColumnCount - 1u;
+
+  auto row = t;
+  auto col = l;
+
+  auto* currentDest = dest;
+  const auto addEdge = [&](const GLuint i0, const GLuint i1) {
+    *(currentDest++) = i0;
+    *(currentDest++) = i1;
+  };
+
+  while (col < r)
   {
-    if (editorContext.visible(patchNode))
-    {
-      vertexCount +=
-        (patchNode->grid().pointRowCount + patchNode->grid().pointColumnCount - 2u) * 2u;
-      indexRangeMapSize.inc(PrimType::LineLoop, vertexCount);
-    }
+    addEdge(vertexIndex(row, col), vertexIndex(row, col + 1u));
+    ++col;
   }
+  assert(row == t && col == r);
 
-  auto indexRangeMapBuilder =
-    IndexRangeMapBuilder<GLVertexTypes::P3>{vertexCount, indexRangeMapSize};
+  while (row < b)
+  {
+    addEdge(vertexIndex(row, col), vertexIndex(row + 1u, col));
+    ++row;
+  }
+  assert(row == b && col == r);
 
-  for (const auto* patchNode : patchNodes)
+  while (col > l)
   {
-    if (editorContext.visible(patchNode))
-    {
-      const auto& grid = patchNode->grid();
-
-      auto edgeLoopVertices = std::vector<GLVertexTypes::P3::Vertex>{};
-      edgeLoopVertices.reserve((grid.pointRowCount + grid.pointColumnCount - 2u) * 2u);
-
-      // walk around the patch to collect the edge vertices
-      // for each side, collect the first vertex up to but not including the last vertex
-
-      const auto t = 0u;
-      const auto b = grid.pointRowCount - 1u;
-      const auto l = 0u;
-      const auto r = grid.pointColumnCount - 1u;
-
-      auto row = t;
-      auto col = l;
-
-      while (col < r)
-      {
-        edgeLoopVertices.emplace_back(vm::vec3f{grid.point(row, col++).position});
-      }
-      assert(row == t && col == r);
-
-      while (row < b)
-      {
-        edgeLoopVertices.emplace_back(vm::vec3f{grid.point(row++, col).position});
-      }
-      assert(row == b && col == r);
-
-      while (col > l)
-      {
-        edgeLoopVertices.emplace_back(vm::vec3f{grid.point(row, col--).position});
-      }
-      assert(row == b && col == l);
-
-      while (row > t)
-      {
-        edgeLoopVertices.emplace_back(vm::vec3f{grid.point(row--, col).position});
-      }
-      assert(row == t && col == l);
-
-      indexRangeMapBuilder.addLineLoop(edgeLoopVertices);
-    }
+    addEdge(vertexIndex(row, col), vertexIndex(row, col - 1u));
+    --col;
   }
+  assert(row == b && col == l);
 
-  auto vertexArray = VertexArray::move(std::move(indexRangeMapBuilder.vertices()));
-  auto indexRangeMap = std::move(indexRangeMapBuilder.indices());
-  return DirectEdgeRenderer{std::move(vertexArray), std::move(indexRangeMap)};
+  while (row > t)
+  {
+    addEdge(vertexIndex(row, col), vertexIndex(row - 1u, col));
+    --row;
+  }
+  assert(row == t && col == l);
+
+  assert(currentDest == dest + 2u * edgeLoopVertexCount(grid));
+  unused(currentDest);
 }
 
-void PatchRenderer::validate()
+} // namespace
+
+void PatchRenderer::validatePatch(const Model::PatchNode& patchNode)
 {
-  if (!m_valid)
-  {
-    m_patchMeshRenderer = buildMeshRenderer(m_patchNodes.get_data(), m_editorContext);
-    m_edgeRenderer = buildEdgeRenderer(m_patchNodes.get_data(), m_editorContext);
+  assert(m_allPatches.count(&patchNode) == 1u);
+  assert(m_patchInfo.find(&patchNode) == std::end(m_patchInfo));
 
-    m_valid = true;
+  if (!m_editorContext.visible(&patchNode))
+  {
+    return;
   }
-}
 
-void PatchRenderer::prepareVerticesAndIndices(VboManager& vboManager)
-{
-  m_patchMeshRenderer.prepare(vboManager);
-}
+  const auto& grid = patchNode.grid();
+  const auto* material = patchNode.patch().material();
 
-namespace
-{
-struct RenderFunc : public MaterialRenderFunc
-{
-  ActiveShader& shader;
-  bool applyMaterial;
-  const Color& defaultColor;
-  int minFilter;
-  int magFilter;
-
-  RenderFunc(
-    ActiveShader& i_shader,
-    const bool i_applyMaterial,
-    const Color& i_defaultColor,
-    const int i_minFilter,
-    const int i_magFilter)
-    : shader{i_shader}
-    , applyMaterial{i_applyMaterial}
-    , defaultColor{i_defaultColor}
-    , minFilter{i_minFilter}
-    , magFilter{i_magFilter}
+  // insert vertices
+  const auto vertexCount = grid.points.size();
+  auto [vertexBlock, vertexDest] =
+    m_vertexArray->getPointerToInsertVerticesAt(vertexCount);
+  const auto patchVerticesStartIndex = static_cast<GLuint>(vertexBlock->pos);
+
+  for (const auto& point : grid.points)
   {
+    *(vertexDest++) = GLVertexTypes::P3NT2::Vertex{
+      vm::vec3f{point.position}, vm::vec3f{point.normal}, vm::vec2f{point.uvCoords}};
   }
 
-  void before(const Assets::Material* material) override
+  auto& info = m_patchInfo[&patchNode];
+  info.vertexHolderKey = vertexBlock;
+  info.material = material;
+
+  // insert edge indices
+  auto [edgeIndicesKey, edgeIndexDest] =
+    m_edgeIndices->getPointerToInsertElementsAt(2u * edgeLoopVertexCount(grid));
+  info.edgeIndicesKey = edgeIndicesKey;
+  addEdgeLoopIndices(edgeIndexDest, grid, patchVerticesStartIndex);
+
+  // insert face indices
+  auto& holderPtr = (*m_faces)[material];
+  if (holderPtr == nullptr)
   {
-    shader.set("GridColor", gridColorForMaterial(material));
-    if (const auto* texture = getTexture(material))
-    {
-      material->activate(minFilter, magFilter);
-      shader.set("ApplyMaterial", applyMaterial);
-      shader.set("Color", texture->averageColor());
-    }
-    else
-    {
-      shader.set("ApplyMaterial", false);
-      shader.set("Color", defaultColor);
-    }
+    // inserts into map!
+    holderPtr = std::make_shared<BrushIndexArray>();
   }
 
-  void after(const Assets::Material* material) override
+  const auto quadCount = grid.quadRowCount() * grid.quadColumnCount();
+  auto [faceIndicesKey, faceIndexDest] =
+    holderPtr->getPointerToInsertElementsAt(6u * quadCount);
+  info.faceIndicesKey = faceIndicesKey;
+
+  const auto pointsPerRow = grid.pointColumnCount;
+  for (size_t row = 0u; row < grid.quadRowCount(); ++row)
   {
-    if (material)
+    for (size_t col = 0u; col < grid.quadColumnCount(); ++col)
     {
-      material->deactivate();
+      const auto i0 =
+        patchVerticesStartIndex + static_cast<GLuint>(row * pointsPerRow + col);
+      const auto i1 =
+        patchVerticesStartIndex + static_cast<GLuint>(row * pointsPerRow + col + 1u);
+      const auto i2 = patchVerticesStartIndex
+                      + static_cast<GLuint>((row + 1u) * pointsPerRow + col + 1u);
+      const auto i3 =
+        patchVerticesStartIndex + static_cast<GLuint>((row + 1u) * pointsPerRow + col);
+
+      *(faceIndexDest++) = i0;
+      *(faceIndexDest++) = i1;
+      *(faceIndexDest++) = i2;
+      *(faceIndexDest++) = i2;
+      *(faceIndexDest++) = i3;
+      *(faceIndexDest++) = i0;
     }
   }
-};
-} // namespace
+}
 
-void PatchRenderer::doRender(RenderContext& context)
+void PatchRenderer::removePatchFromVbo(const Model::PatchNode& patchNode)
 {
-  auto& shaderManager = context.shaderManager();
-  auto shader = ActiveShader{shaderManager, Shaders::FaceShader};
-  auto& prefs = PreferenceManager::instance();
-
-  const bool applyMaterial = context.showMaterials();
-  const bool shadeFaces = context.shadeFaces();
-  const bool showFog = context.showFog();
-
-  glAssert(glEnable(GL_TEXTURE_2D));
-  glAssert(glActiveTexture(GL_TEXTURE0));
-  shader.set("Brightness", prefs.get(Preferences::Brightness));
-  shader.set("RenderGrid", context.showGrid());
-  shader.set("GridSize", static_cast<float>(context.gridSize()));
-  shader.set("GridAlpha", prefs.get(Preferences::GridAlpha));
-  shader.set("ApplyMaterial", applyMaterial);
-  shader.set("Material", 0);
-  shader.set("ApplyTinting", m_tint);
-  if (m_tint)
+  auto it = m_patchInfo.find(&patchNode);
+  if (it == std::end(m_patchInfo))
   {
-    shader.set("TintColor", m_tintColor);
+    // This means PatchRenderer::validatePatch skipped rendering the patch, so it was
+    // never uploaded to the VBO's
+    return;
   }
-  shader.set("GrayScale", m_grayscale);
-  shader.set("CameraPosition", context.camera().position());
-  shader.set("ShadeFaces", shadeFaces);
-  shader.set("ShowFog", showFog);
-  shader.set("Alpha", 1.0);
-  shader.set("EnableMasked", false);
-  shader.set("ShowSoftMapBounds", !context.softMapBounds().is_empty());
-  shader.set("SoftMapBoundsMin", context.softMapBounds().min);
-  shader.set("SoftMapBoundsMax", context.softMapBounds().max);
-  shader.set(
-    "SoftMapBoundsColor",
-    vm::vec4f{
-      prefs.get(Preferences::SoftMapBoundsColor).r(),
-      prefs.get(Preferences::SoftMapBoundsColor).g(),
-      prefs.get(Preferences::SoftMapBoundsColor).b(),
-      0.1f});
-
-  auto func = RenderFunc{
-    shader,
-    applyMaterial,
-    m_defaultColor,
-    context.minFilterMode(),
-    context.magFilterMode()};
-
-  /*
-  if (m_alpha < 1.0f) {
-      glAssert(glDepthMask(GL_FALSE));
-  }
-  */
 
-  m_patchMeshRenderer.render(func);
+  const auto& info = it->second;
+
+  // update Vbo's
+  m_vertexArray->deleteVerticesWithKey(info.vertexHolderKey);
+  m_edgeIndices->zeroElementsWithKey(info.edgeIndicesKey);
 
-  /*
-  if (m_alpha < 1.0f) {
-      glAssert(glDepthMask(GL_TRUE));
+  auto faceIndexHolder = m_faces->at(info.material);
+  faceIndexHolder->zeroElementsWithKey(info.faceIndicesKey);
+  if (!faceIndexHolder->hasValidIndices())
+  {
+    // There are no indices left to render for this material, so delete the <Material,
+    // BrushIndexArray> entry from the map
+    m_faces->erase(info.material);
   }
-  */
+
+  m_patchInfo.erase(it);
 }
 
 } // namespace TrenchBroom::Renderer
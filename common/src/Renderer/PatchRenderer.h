@@ -20,13 +20,19 @@
 #pragma once
 
 #include "Color.h"
+#include "Macros.h"
+#include "Renderer/AllocationTracker.h"
 #include "Renderer/EdgeRenderer.h"
-#include "Renderer/MaterialIndexArrayRenderer.h"
-#include "Renderer/Renderable.h"
+#include "Renderer/FaceRenderer.h"
 
-#include "kdl/vector_set.h"
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
 
-#include <vector>
+namespace TrenchBroom::Assets
+{
+class Material;
+}
 
 namespace TrenchBroom::Model
 {
@@ -36,20 +42,54 @@ class PatchNode;
 
 namespace TrenchBroom::Renderer
 {
+class BrushIndexArray;
+class BrushVertexArray;
 class RenderBatch;
 class RenderContext;
-class VboManager;
 
-class PatchRenderer : public IndexedRenderable
+/**
+ * Renders patch meshes and their edges.
+ *
+ * The tessellated patch grids are stored in shared vertex and index arrays in which
+ * every patch owns a separately allocated block, similar to BrushRenderer. Invalidating a
+ * patch only frees its blocks, and only invalid patches are tessellated and uploaded
+ * again when the renderer is validated.
+ */
+class PatchRenderer
 {
 private:
   const Model::EditorContext& m_editorContext;
 
-  bool m_valid = true;
-  kdl::vector_set<const Model::PatchNode*> m_patchNodes;
+  struct PatchInfo
+  {
+    AllocationTracker::Block* vertexHolderKey;
+    const Assets::Material* material;
+    AllocationTracker::Block* faceIndicesKey;
+    AllocationTracker::Block* edgeIndicesKey;
+  };
+
+  /**
+   * Tracks all patches that are stored in the VBO, with the information necessary to
+   * remove them from the VBO later.
+   */
+  std::unordered_map<const Model::PatchNode*, PatchInfo> m_patchInfo;
+
+  /**
+   * If a patch is in the VBO, it's always valid.
+   * If a patch is valid, it might not be in the VBO if it is not visible.
+   */
+  std::unordered_set<const Model::PatchNode*> m_allPatches;
+  std::unordered_set<const Model::PatchNode*> m_invalidPatches;
+
+  std::shared_ptr<BrushVertexArray> m_vertexArray;
+  std::shared_ptr<BrushIndexArray> m_edgeIndices;
 
-  MaterialIndexArrayRenderer m_patchMeshRenderer;
-  DirectEdgeRenderer m_edgeRenderer;
+  using MaterialToBrushIndicesMap =
+    std::unordered_map<const Assets::Material*, std::shared_ptr<BrushIndexArray>>;
+  std::shared_ptr<MaterialToBrushIndicesMap> m_faces;
+
+  FaceRenderer m_faceRenderer;
+  IndexedEdgeRenderer m_edgeRenderer;
 
   Color m_defaultColor;
   bool m_grayscale = false;
@@ -64,6 +104,7 @@ private:
 
 public:
   explicit PatchRenderer(const Model::EditorContext& editorContext);
+  ~PatchRenderer();
 
   void setDefaultColor(const Color& faceColor);
   void setGrayscale(bool grayscale);
@@ -95,6 +136,7 @@ public:
    * Equivalent to invalidatePatch() on all added patches.
    */
   void invalidate();
+  bool valid() const;
   /**
    * Equivalent to removePatch() on all added patches.
    */
@@ -117,12 +159,23 @@ public:
 
   void render(RenderContext& renderContext, RenderBatch& renderBatch);
 
-private:
+  /**
+   * Only exposed for benchmarking.
+   */
   void validate();
 
-private: // implement IndexedRenderable interface
-  void prepareVerticesAndIndices(VboManager& vboManager) override;
-  void doRender(RenderContext& renderContext) override;
+private:
+  void validatePatch(const Model::PatchNode& patchNode);
+
+  /**
+   * If the given patch is not currently in the VBO, it's silently ignored.
+   * Otherwise, it's removed from the VBO (having its indices zeroed out, causing it to no
+   * longer draw). The patch's "valid" state is not touched inside here, but the
+   * m_patchInfo is updated.
+   */
+  void removePatchFromVbo(const Model::PatchNode& patchNode);
+
+  deleteCopyAndMove(PatchRenderer);
 };
 
 } // namespace TrenchBroom::Renderer
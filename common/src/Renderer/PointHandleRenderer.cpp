@@ -100,6 +100,7 @@ void PointHandleRenderer::renderHandles(
   RenderContext& renderContext, const HandleMap& map, Circle& circle, const float opacity)
 {
   const Camera& camera = renderContext.camera();
+  const auto handleRadius = PreferenceManager::instance().snapshot()->handleRadius;
   ActiveShader shader(renderContext.shaderManager(), Shaders::HandleShader);
 
   for (const auto& [color, positions] : map)
@@ -114,8 +115,7 @@ void PointHandleRenderer::renderHandles(
       // edges, etc.) from clipping into the handle
       if (renderContext.render3D())
       {
-        nudgeTowardsCamera =
-          vm::normalize(camera.position() - position) * pref(Preferences::HandleRadius);
+        nudgeTowardsCamera = vm::normalize(camera.position() - position) * handleRadius;
       }
 
       const vm::vec3f offset =
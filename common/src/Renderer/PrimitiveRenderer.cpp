@@ -302,6 +302,63 @@ void PrimitiveRenderer::renderFilledPolygon(
     .addTriangleFan(Vertex::toList(positions.size(), std::begin(positions)));
 }
 
+void PrimitiveRenderer::renderPolygons(
+  const Color& color,
+  const float lineWidth,
+  const PrimitiveRendererOcclusionPolicy occlusionPolicy,
+  const std::span<const vm::vec3f> positions,
+  const std::span<const size_t> offsets)
+{
+  auto vertices = std::vector<Vertex>{};
+  vertices.reserve(2 * positions.size());
+
+  for (size_t i = 0; i + 1 < offsets.size(); ++i)
+  {
+    const auto first = offsets[i];
+    const auto last = offsets[i + 1];
+    for (size_t j = first; j < last; ++j)
+    {
+      vertices.emplace_back(positions[j]);
+      vertices.emplace_back(positions[j + 1 < last ? j + 1 : first]);
+    }
+  }
+
+  if (!vertices.empty())
+  {
+    m_lineMeshes[LineRenderAttributes(color, lineWidth, occlusionPolicy)].addLines(
+      vertices);
+  }
+}
+
+void PrimitiveRenderer::renderFilledPolygons(
+  const Color& color,
+  const PrimitiveRendererOcclusionPolicy occlusionPolicy,
+  const PrimitiveRendererCullingPolicy cullingPolicy,
+  const std::span<const vm::vec3f> positions,
+  const std::span<const size_t> offsets)
+{
+  auto vertices = std::vector<Vertex>{};
+  vertices.reserve(3 * positions.size());
+
+  for (size_t i = 0; i + 1 < offsets.size(); ++i)
+  {
+    const auto first = offsets[i];
+    const auto last = offsets[i + 1];
+    for (size_t j = first + 1; j + 1 < last; ++j)
+    {
+      vertices.emplace_back(positions[first]);
+      vertices.emplace_back(positions[j]);
+      vertices.emplace_back(positions[j + 1]);
+    }
+  }
+
+  if (!vertices.empty())
+  {
+    m_triangleMeshes[TriangleRenderAttributes(color, occlusionPolicy, cullingPolicy)]
+      .addTriangles(vertices);
+  }
+}
+
 void PrimitiveRenderer::renderCylinder(
   const Color& color,
   const float radius,
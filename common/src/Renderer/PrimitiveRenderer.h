@@ -24,6 +24,7 @@
 #include "Renderer/Renderable.h"
 
 #include <map>
+#include <span>
 #include <vector>
 
 namespace TrenchBroom
@@ -156,6 +157,30 @@ public:
     PrimitiveRendererCullingPolicy cullingPolicy,
     const std::vector<vm::vec3f>& positions);
 
+  /**
+   * Renders the outlines of many polygons at once. The vertices of the i-th polygon are
+   * the range [offsets[i], offsets[i+1]) of the given positions. All outlines are added
+   * as independent lines so that they can be drawn with a single draw call.
+   */
+  void renderPolygons(
+    const Color& color,
+    float lineWidth,
+    PrimitiveRendererOcclusionPolicy occlusionPolicy,
+    std::span<const vm::vec3f> positions,
+    std::span<const size_t> offsets);
+
+  /**
+   * Renders many filled polygons at once. The vertices of the i-th polygon are the range
+   * [offsets[i], offsets[i+1]) of the given positions. All polygons are triangulated so
+   * that they can be drawn with a single draw call.
+   */
+  void renderFilledPolygons(
+    const Color& color,
+    PrimitiveRendererOcclusionPolicy occlusionPolicy,
+    PrimitiveRendererCullingPolicy cullingPolicy,
+    std::span<const vm::vec3f> positions,
+    std::span<const size_t> offsets);
+
   void renderCylinder(
     const Color& color,
     float radius,
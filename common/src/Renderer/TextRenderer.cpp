@@ -31,10 +31,15 @@
 #include "Renderer/TextAnchor.h"
 #include "Renderer/TextureFont.h"
 
+#include "vm/bbox.h"
 #include "vm/forward.h"
 #include "vm/mat_ext.h"
 #include "vm/vec.h"
 
+#include <algorithm>
+#include <cmath>
+#include <unordered_map>
+
 namespace TrenchBroom
 {
 namespace Renderer
@@ -44,20 +49,18 @@ const float TextRenderer::DefaultMinZoomFactor = 0.5f;
 const vm::vec2f TextRenderer::DefaultInset = vm::vec2f(4.0f, 4.0f);
 const size_t TextRenderer::RectCornerSegments = 3;
 const float TextRenderer::RectCornerRadius = 3.0f;
+const float TextRenderer::ClusterCellSize = 64.0f;
 
 TextRenderer::Entry::Entry(
-  std::vector<vm::vec2f>& i_vertices,
-  const vm::vec2f& i_size,
+  std::shared_ptr<const GlyphRun> i_glyphRun,
   const vm::vec3f& i_offset,
   const Color& i_textColor,
   const Color& i_backgroundColor)
-  : size(i_size)
+  : glyphRun(std::move(i_glyphRun))
   , offset(i_offset)
   , textColor(i_textColor)
   , backgroundColor(i_backgroundColor)
 {
-  using std::swap;
-  swap(vertices, i_vertices);
 }
 
 TextRenderer::EntryCollection::EntryCollection()
@@ -112,40 +115,27 @@ void TextRenderer::renderString(
   if (distance <= 0.0f)
     return;
 
-  if (!isVisible(renderContext, string, position, distance, onTop))
-    return;
-
   FontManager& fontManager = renderContext.fontManager();
-  TextureFont& font = fontManager.font(m_fontDescriptor);
+  auto glyphRun = fontManager.glyphRun(m_fontDescriptor, string);
 
-  std::vector<vm::vec2f> vertices = font.quads(string, true);
-  const float alphaFactor = computeAlphaFactor(renderContext, distance, onTop);
-  const vm::vec2f size = font.measure(string);
-  const vm::vec3f offset = position.offset(camera, size);
+  if (!isVisible(renderContext, glyphRun->size, position, distance, onTop))
+    return;
 
-  if (onTop)
-    addEntry(
-      m_entriesOnTop,
-      Entry(
-        vertices,
-        size,
-        offset,
-        Color(textColor, alphaFactor * textColor.a()),
-        Color(backgroundColor, alphaFactor * backgroundColor.a())));
-  else
-    addEntry(
-      m_entries,
-      Entry(
-        vertices,
-        size,
-        offset,
-        Color(textColor, alphaFactor * textColor.a()),
-        Color(backgroundColor, alphaFactor * backgroundColor.a())));
+  const float alphaFactor = computeAlphaFactor(renderContext, distance, onTop);
+  const vm::vec3f offset = position.offset(camera, glyphRun->size);
+
+  addEntry(
+    onTop ? m_entriesOnTop : m_entries,
+    Entry(
+      std::move(glyphRun),
+      offset,
+      Color(textColor, alphaFactor * textColor.a()),
+      Color(backgroundColor, alphaFactor * backgroundColor.a())));
 }
 
 bool TextRenderer::isVisible(
   RenderContext& renderContext,
-  const AttrString& string,
+  const vm::vec2f& stringSize,
   const TextAnchor& position,
   const float distance,
   const bool onTop) const
@@ -161,7 +151,7 @@ bool TextRenderer::isVisible(
   const Camera& camera = renderContext.camera();
   const Camera::Viewport& viewport = camera.viewport();
 
-  const vm::vec2f size = stringSize(renderContext, string);
+  const vm::vec2f size = round(stringSize);
   const vm::vec2f offset = vm::vec2f(position.offset(camera, size)) - m_inset;
   const vm::vec2f actualSize = size + 2.0f * m_inset;
 
@@ -191,19 +181,11 @@ float TextRenderer::computeAlphaFactor(
   }
 }
 
-void TextRenderer::addEntry(EntryCollection& collection, const Entry& entry)
+void TextRenderer::addEntry(EntryCollection& collection, Entry entry)
 {
-  collection.entries.push_back(entry);
-  collection.textVertexCount += entry.vertices.size();
+  collection.textVertexCount += entry.glyphRun->vertices.size() / 2;
   collection.rectVertexCount += roundedRect2DVertexCount(RectCornerSegments);
-}
-
-vm::vec2f TextRenderer::stringSize(
-  RenderContext& renderContext, const AttrString& string) const
-{
-  FontManager& fontManager = renderContext.fontManager();
-  TextureFont& font = fontManager.font(m_fontDescriptor);
-  return round(font.measure(string));
+  collection.entries.push_back(std::move(entry));
 }
 
 void TextRenderer::doPrepareVertices(VboManager& vboManager)
@@ -221,9 +203,19 @@ void TextRenderer::prepare(
   std::vector<RectVertex> rectVertices;
   rectVertices.reserve(collection.rectVertexCount);
 
-  for (const Entry& entry : collection.entries)
+  if (onTop)
   {
-    addEntry(entry, onTop, textVertices, rectVertices);
+    for (const Entry& entry : collection.entries)
+    {
+      addEntry(entry, onTop, textVertices, rectVertices);
+    }
+  }
+  else
+  {
+    for (const Entry* entry : unobstructedEntries(collection.entries))
+    {
+      addEntry(*entry, onTop, textVertices, rectVertices);
+    }
   }
 
   collection.textArray = VertexArray::move(std::move(textVertices));
@@ -233,14 +225,87 @@ void TextRenderer::prepare(
   collection.rectArray.prepare(vboManager);
 }
 
+std::vector<const TextRenderer::Entry*> TextRenderer::unobstructedEntries(
+  const EntryList& entries) const
+{
+  auto sortedEntries = std::vector<const Entry*>{};
+  sortedEntries.reserve(entries.size());
+  for (const auto& entry : entries)
+  {
+    sortedEntries.push_back(&entry);
+  }
+
+  // prefer the labels that are closest to the camera
+  std::stable_sort(
+    sortedEntries.begin(), sortedEntries.end(), [](const auto* lhs, const auto* rhs) {
+      return lhs->offset.z() < rhs->offset.z();
+    });
+
+  // the screen is divided into square cells, and each cell records the bounds of the
+  // accepted labels that touch it
+  auto cells = std::unordered_map<long long, std::vector<vm::bbox2f>>{};
+  const auto cellKey = [](const long long x, const long long y) {
+    return (x << 32) ^ (y & 0xffffffff);
+  };
+
+  auto result = std::vector<const Entry*>{};
+  result.reserve(entries.size());
+
+  for (const auto* entry : sortedEntries)
+  {
+    const auto min = entry->offset.xy() - m_inset;
+    const auto max = entry->offset.xy() + entry->glyphRun->size + m_inset;
+    const auto bounds = vm::bbox2f{min, max};
+
+    const auto minX = static_cast<long long>(std::floor(min.x() / ClusterCellSize));
+    const auto minY = static_cast<long long>(std::floor(min.y() / ClusterCellSize));
+    const auto maxX = static_cast<long long>(std::floor(max.x() / ClusterCellSize));
+    const auto maxY = static_cast<long long>(std::floor(max.y() / ClusterCellSize));
+
+    const auto isObstructed = [&]() {
+      for (auto x = minX; x <= maxX; ++x)
+      {
+        for (auto y = minY; y <= maxY; ++y)
+        {
+          if (const auto it = cells.find(cellKey(x, y)); it != cells.end())
+          {
+            if (std::any_of(
+                  it->second.begin(), it->second.end(), [&](const auto& other) {
+                    return bounds.intersects(other);
+                  }))
+            {
+              return true;
+            }
+          }
+        }
+      }
+      return false;
+    };
+
+    if (!isObstructed())
+    {
+      for (auto x = minX; x <= maxX; ++x)
+      {
+        for (auto y = minY; y <= maxY; ++y)
+        {
+          cells[cellKey(x, y)].push_back(bounds);
+        }
+      }
+      result.push_back(entry);
+    }
+  }
+
+  return result;
+}
+
 void TextRenderer::addEntry(
   const Entry& entry,
   const bool /* onTop */,
   std::vector<TextVertex>& textVertices,
   std::vector<RectVertex>& rectVertices)
 {
-  const std::vector<vm::vec2f>& stringVertices = entry.vertices;
-  const vm::vec2f& stringSize = entry.size;
+  const std::vector<vm::vec2f>& stringVertices = entry.glyphRun->vertices;
+  const vm::vec2f& stringSize = entry.glyphRun->size;
 
   const vm::vec3f& offset = entry.offset;
 
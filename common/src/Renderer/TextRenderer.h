@@ -28,6 +28,7 @@
 #include "vm/forward.h"
 #include "vm/vec.h"
 
+#include <memory>
 #include <vector>
 
 namespace TrenchBroom
@@ -35,6 +36,7 @@ namespace TrenchBroom
 namespace Renderer
 {
 class AttrString;
+struct GlyphRun;
 class RenderContext;
 class TextAnchor;
 
@@ -46,18 +48,17 @@ private:
   static const vm::vec2f DefaultInset;
   static const size_t RectCornerSegments;
   static const float RectCornerRadius;
+  static const float ClusterCellSize;
 
   struct Entry
   {
-    std::vector<vm::vec2f> vertices;
-    vm::vec2f size;
+    std::shared_ptr<const GlyphRun> glyphRun;
     vm::vec3f offset;
     Color textColor;
     Color backgroundColor;
 
     Entry(
-      std::vector<vm::vec2f>& i_vertices,
-      const vm::vec2f& i_size,
+      std::shared_ptr<const GlyphRun> i_glyphRun,
       const vm::vec3f& i_offset,
       const Color& i_textColor,
       const Color& i_backgroundColor);
@@ -119,20 +120,25 @@ private:
 
   bool isVisible(
     RenderContext& renderContext,
-    const AttrString& string,
+    const vm::vec2f& size,
     const TextAnchor& position,
     float distance,
     bool onTop) const;
   float computeAlphaFactor(
     const RenderContext& renderContext, float distance, bool onTop) const;
-  void addEntry(EntryCollection& collection, const Entry& entry);
-
-  vm::vec2f stringSize(RenderContext& renderContext, const AttrString& string) const;
+  void addEntry(EntryCollection& collection, Entry entry);
 
 private:
   void doPrepareVertices(VboManager& vboManager) override;
   void prepare(EntryCollection& collection, bool onTop, VboManager& vboManager);
 
+  /**
+   * Returns the entries that do not overlap any entry that is closer to the camera.
+   * Overlapping labels are unreadable anyway, so dropping them before their vertices are
+   * built saves most of the work when many labels are crowded together on screen.
+   */
+  std::vector<const Entry*> unobstructedEntries(const EntryList& entries) const;
+
   void addEntry(
     const Entry& entry,
     bool onTop,
@@ -1758,6 +1758,14 @@ void ActionManager::createViewMenu()
     [](ActionExecutionContext& context) {
       return context.hasDocument() && context.frame()->canMoveCameraToPreviousPoint();
     }));
+  cameraMenu.addItem(createMenuAction(
+    std::filesystem::path{"Menu/View/Camera/Move to Nearest Point"},
+    QObject::tr("Move Camera to Nearest Point"),
+    0,
+    [](ActionExecutionContext& context) { context.frame()->moveCameraToNearestPoint(); },
+    [](ActionExecutionContext& context) {
+      return context.hasDocument() && context.frame()->canMoveCameraToNearestPoint();
+    }));
   cameraMenu.addItem(createMenuAction(
     std::filesystem::path{"Menu/View/Camera/Reset 2D Cameras"},
     QObject::tr("Reset 2D Cameras"),
@@ -1902,8 +1910,9 @@ void ActionManager::createRunMenu()
 
 void ActionManager::createDebugMenu()
 {
-#ifndef NDEBUG
+#if !defined(NDEBUG) || defined(TB_ENABLE_PROFILER)
   auto& debugMenu = createMainMenu("Debug");
+#ifndef NDEBUG
   debugMenu.addItem(createMenuAction(
     std::filesystem::path{"Menu/Debug/Print Vertices"},
     QObject::tr("Print Vertices to Console"),
@@ -1964,6 +1973,27 @@ void ActionManager::createDebugMenu()
     [](ActionExecutionContext& context) { context.frame()->debugShowPalette(); },
     [](ActionExecutionContext& context) { return context.hasDocument(); }));
 #endif
+#ifdef TB_ENABLE_PROFILER
+#ifndef NDEBUG
+  debugMenu.addSeparator();
+#endif
+  debugMenu.addItem(createMenuAction(
+    std::filesystem::path{"Menu/Debug/Show Profiler Statistics"},
+    QObject::tr("Show Profiler Statistics"),
+    0,
+    [](ActionExecutionContext& context) {
+      context.frame()->debugToggleProfilerStatistics();
+    },
+    [](ActionExecutionContext& context) { return context.hasDocument(); },
+    [](ActionExecutionContext&) { return pref(Preferences::ShowProfilerStatistics); }));
+  debugMenu.addItem(createMenuAction(
+    std::filesystem::path{"Menu/Debug/Export Profiler Trace..."},
+    QObject::tr("Export Profiler Trace..."),
+    0,
+    [](ActionExecutionContext& context) { context.frame()->debugExportProfilerTrace(); },
+    [](ActionExecutionContext& context) { return context.hasDocument(); }));
+#endif
+#endif
 }
 
 void ActionManager::createHelpMenu()
@@ -1979,6 +2009,12 @@ void ActionManager::createHelpMenu()
       app.showManual();
     },
     [](ActionExecutionContext&) { return true; }));
+  helpMenu.addItem(createMenuAction(
+    std::filesystem::path{"Menu/Help/Print Memory Usage to Console"},
+    QObject::tr("Print Memory Usage to Console"),
+    0,
+    [](ActionExecutionContext& context) { context.frame()->printMemoryUsage(); },
+    [](ActionExecutionContext& context) { return context.hasDocument(); }));
   helpMenu.addItem(createMenuAction(
     std::filesystem::path{"Menu/File/About TrenchBroom"},
     QObject::tr("About TrenchBroom"),
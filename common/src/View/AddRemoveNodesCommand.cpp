@@ -22,6 +22,7 @@
 #include "Ensure.h"
 #include "Error.h"
 #include "Macros.h"
+#include "Model/ModelUtils.h"
 #include "Model/Node.h"
 #include "View/MapDocumentCommandFacade.h"
 
@@ -78,6 +79,17 @@ AddRemoveNodesCommand::AddRemoveNodesCommand(
   }
 }
 
+size_t AddRemoveNodesCommand::memoryUsage() const
+{
+  // only the nodes to add are owned by this command
+  auto result = UpdateLinkedGroupsCommandBase::memoryUsage();
+  for (const auto& [parent, children] : m_nodesToAdd)
+  {
+    result += Model::computeMemoryUsage(children).total();
+  }
+  return result;
+}
+
 std::string AddRemoveNodesCommand::makeName(const Action action)
 {
   switch (action)
@@ -60,6 +60,8 @@ public:
     Action action, const std::map<Model::Node*, std::vector<Model::Node*>>& nodes);
   ~AddRemoveNodesCommand() override;
 
+  size_t memoryUsage() const override;
+
 private:
   static std::string makeName(Action action);
 
@@ -25,6 +25,9 @@
 #include "IO/FileSystem.h"
 #include "IO/PathInfo.h"
 #include "IO/TraversalMode.h"
+#include "Logger.h"
+#include "Model/Game.h"
+#include "Model/WorldNode.h"
 #include "View/MapDocument.h"
 
 #include "kdl/memory_utils.h"
@@ -69,8 +72,26 @@ Autosaver::Autosaver(
 {
 }
 
+Autosaver::~Autosaver()
+{
+  if (m_pendingAutosave.valid())
+  {
+    m_pendingAutosave.wait();
+  }
+}
+
 void Autosaver::triggerAutosave(Logger& logger)
 {
+  if (m_pendingAutosave.valid())
+  {
+    if (
+      m_pendingAutosave.wait_for(std::chrono::seconds{0}) != std::future_status::ready)
+    {
+      return;
+    }
+    finishPendingAutosave(logger);
+  }
+
   if (!kdl::mem_expired(m_document))
   {
     auto document = kdl::mem_lock(m_document);
@@ -153,10 +174,39 @@ Result<void> cleanBackups(
          | kdl::fold();
 }
 
+Result<std::filesystem::path> writeBackup(
+  const Model::Game& game,
+  Model::WorldNode& world,
+  const std::filesystem::path& backupFilePath)
+{
+  // write to a temporary file first so that an interrupted autosave doesn't leave a
+  // truncated backup behind
+  const auto tempFilePath = kdl::path_add_extension(backupFilePath, ".tmp");
+  return game.writeMap(world, tempFilePath) | kdl::and_then([&]() {
+           return IO::Disk::moveFile(tempFilePath, backupFilePath);
+         })
+         | kdl::transform([&]() { return backupFilePath; });
+}
+
 } // namespace
 
+void Autosaver::finishPendingAutosave(Logger& logger)
+{
+  if (m_pendingAutosave.valid())
+  {
+    m_pendingAutosave.get() | kdl::transform([&](const auto& backupFilePath) {
+      logger.info() << "Created autosave backup at " << backupFilePath;
+    }) | kdl::transform_error([&](auto e) {
+      logger.error() << "Aborting autosave: " << e.msg;
+    });
+    m_snapshot.reset();
+  }
+}
+
 void Autosaver::autosave(Logger& logger, std::shared_ptr<MapDocument> document)
 {
+  const auto startTime = std::chrono::high_resolution_clock::now();
+
   const auto& mapPath = document->path();
   assert(IO::Disk::pathInfo(mapPath) == IO::PathInfo::File);
 
@@ -175,12 +225,24 @@ void Autosaver::autosave(Logger& logger, std::shared_ptr<MapDocument> document)
                           return fs.makeAbsolute(makeBackupName(mapBasename, backupNo));
                         });
              });
-  }) | kdl::transform([&](const auto& backupFilePath) {
+  }) | kdl::transform([&](auto backupFilePath) {
     m_lastSaveTime = Clock::now();
     m_lastModificationCount = document->modificationCount();
-    document->saveDocumentTo(backupFilePath);
-
-    logger.info() << "Created autosave backup at " << backupFilePath;
+    m_snapshot = document->makeWorldSnapshot();
+    m_pendingAutosave = std::async(
+      std::launch::async,
+      [game = document->game(),
+       world = m_snapshot.get(),
+       backupFilePath = std::move(backupFilePath)]() {
+        return writeBackup(*game, *world, backupFilePath);
+      });
+
+    const auto endTime = std::chrono::high_resolution_clock::now();
+    logger.debug() << "Autosave blocked for "
+                   << std::chrono::duration_cast<std::chrono::milliseconds>(
+                        endTime - startTime)
+                        .count()
+                   << "ms";
   }) | kdl::transform_error([&](auto e) {
     logger.error() << "Aborting autosave: " << e.msg;
   });
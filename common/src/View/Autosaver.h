@@ -19,10 +19,15 @@
 
 #pragma once
 
+#include "Error.h" // IWYU pragma: keep
 #include "IO/PathMatcher.h"
+#include "Result.h"
+
+#include "kdl/result.h"
 
 #include <chrono>
 #include <filesystem>
+#include <future>
 #include <memory>
 
 namespace TrenchBroom
@@ -30,6 +35,11 @@ namespace TrenchBroom
 class Logger;
 } // namespace TrenchBroom
 
+namespace TrenchBroom::Model
+{
+class WorldNode;
+} // namespace TrenchBroom::Model
+
 namespace TrenchBroom::View
 {
 class Command;
@@ -65,14 +75,36 @@ private:
    */
   size_t m_lastModificationCount;
 
+  /**
+   * The snapshot of the world that is being written by the pending autosave. It is
+   * destroyed on the thread that collects the result of the pending autosave.
+   */
+  std::unique_ptr<Model::WorldNode> m_snapshot;
+
+  /**
+   * The pending autosave, if any. Yields the path of the backup file that was written.
+   */
+  std::future<Result<std::filesystem::path>> m_pendingAutosave;
+
 public:
   explicit Autosaver(
     std::weak_ptr<MapDocument> document,
     std::chrono::milliseconds saveInterval = std::chrono::milliseconds(10 * 60 * 1000),
     size_t maxBackups = 50);
+  ~Autosaver();
 
+  /**
+   * Starts an autosave if the document was modified and the save interval has elapsed.
+   * The world is written to disk on a worker thread. If an autosave is still pending,
+   * no new autosave is started.
+   */
   void triggerAutosave(Logger& logger);
 
+  /**
+   * Blocks until the pending autosave, if any, has finished and logs its result.
+   */
+  void finishPendingAutosave(Logger& logger);
+
 private:
   void autosave(Logger& logger, std::shared_ptr<View::MapDocument> document);
 };
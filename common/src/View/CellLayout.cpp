@@ -24,6 +24,7 @@
 
 #include <algorithm>
 #include <cassert>
+#include <iterator>
 
 namespace TrenchBroom::View
 {
@@ -447,42 +448,37 @@ const std::vector<LayoutRow>& LayoutGroup::rows() const
   return m_rows;
 }
 
+std::span<const LayoutRow> LayoutGroup::rowsIntersectingY(
+  const float y, const float height) const
+{
+  const auto isAbove = [&](const auto& row) { return row.bounds().bottom() < y; };
+  const auto isNotBelow = [&](const auto& row) {
+    return row.bounds().top() <= y + height;
+  };
+
+  const auto first = std::partition_point(m_rows.begin(), m_rows.end(), isAbove);
+  const auto last = std::partition_point(first, m_rows.end(), isNotBelow);
+  return {first, last};
+}
+
 size_t LayoutGroup::indexOfRowAt(const float y) const
 {
-  for (size_t i = 0; i < m_rows.size(); ++i)
-  {
-    const auto& row = m_rows[i];
-    const auto& rowBounds = row.bounds();
-    if (y < rowBounds.bottom())
-    {
-      return i;
-    }
-  }
+  const auto isAbove = [&](const auto& row) { return row.bounds().bottom() <= y; };
 
-  return m_rows.size();
+  const auto it = std::partition_point(m_rows.begin(), m_rows.end(), isAbove);
+  return size_t(std::distance(m_rows.begin(), it));
 }
 
 const LayoutCell* LayoutGroup::cellAt(const float x, const float y) const
 {
-  for (size_t i = 0; i < m_rows.size(); ++i)
+  const auto isAbove = [&](const auto& row) { return row.bounds().bottom() < y; };
+
+  const auto it = std::partition_point(m_rows.begin(), m_rows.end(), isAbove);
+  if (it == m_rows.end() || y < it->bounds().top())
   {
-    const auto& row = m_rows[i];
-    const auto& rowBounds = row.bounds();
-    if (y > rowBounds.bottom())
-    {
-      continue;
-    }
-    if (y < rowBounds.top())
-    {
-      return nullptr;
-    }
-    if (const auto* cell = row.cellAt(x, y))
-    {
-      return cell;
-    }
+    return nullptr;
   }
-
-  return nullptr;
+  return it->cellAt(x, y);
 }
 
 bool LayoutGroup::hitTest(const float x, const float y) const
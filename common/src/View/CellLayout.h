@@ -23,6 +23,7 @@
 #include "vm/vec.h"
 
 #include <any>
+#include <span>
 #include <string>
 #include <vector>
 
@@ -219,6 +220,13 @@ public:
   LayoutBounds bounds() const;
 
   const std::vector<LayoutRow>& rows() const;
+
+  /**
+   * Returns the rows that intersect the given vertical range. Since the rows are ordered
+   * from top to bottom, they are found by binary search, so only the rows near the
+   * visible part of the layout are visited.
+   */
+  std::span<const LayoutRow> rowsIntersectingY(float y, float height) const;
   size_t indexOfRowAt(float y) const;
   const LayoutCell* cellAt(float x, float y) const;
 
@@ -474,35 +474,31 @@ auto collectStringVertices(
           std::end(vertices), std::begin(titleVertices), std::end(titleVertices));
       }
 
-      for (const auto& row : group.rows())
+      for (const auto& row : group.rowsIntersectingY(y, height))
       {
-        if (row.intersectsY(y, height))
+        for (const auto& cell : row.cells())
         {
-          for (const auto& cell : row.cells())
-          {
-            const auto& title = cell.title();
-            const auto bounds = cell.titleBounds();
-            const auto fontDescriptor =
-              fontManager.selectFontSize(defaultFont, title, bounds.width, 6);
-            const auto& font = fontManager.font(fontDescriptor);
-            const auto size = font.measure(title);
-
-            const auto x =
-              bounds.left() + std::max((bounds.width - size.x()) / 2.0f, 0.0f);
-
-            // y is relative to top, but OpenGL coords are relative to bottom, so invert
-            const auto yOffset = vm::vec2f{x, y + height - bounds.bottom()};
-
-            const auto quads = font.quads(title, false, yOffset);
-            const auto vertices = TextVertex::toList(
-              quads.size() / 2,
-              kdl::skip_iterator{std::begin(quads), std::end(quads), 0, 2},
-              kdl::skip_iterator{std::begin(quads), std::end(quads), 1, 2},
-              kdl::skip_iterator{std::begin(textColor), std::end(textColor), 0, 0});
-
-            stringVertices[fontDescriptor] =
-              kdl::vec_concat(std::move(stringVertices[fontDescriptor]), vertices);
-          }
+          const auto& title = cell.title();
+          const auto bounds = cell.titleBounds();
+          const auto fontDescriptor =
+            fontManager.selectFontSize(defaultFont, title, bounds.width, 6);
+          const auto& font = fontManager.font(fontDescriptor);
+          const auto size = font.measure(title);
+
+          const auto x = bounds.left() + std::max((bounds.width - size.x()) / 2.0f, 0.0f);
+
+          // y is relative to top, but OpenGL coords are relative to bottom, so invert
+          const auto yOffset = vm::vec2f{x, y + height - bounds.bottom()};
+
+          const auto quads = font.quads(title, false, yOffset);
+          const auto vertices = TextVertex::toList(
+            quads.size() / 2,
+            kdl::skip_iterator{std::begin(quads), std::end(quads), 0, 2},
+            kdl::skip_iterator{std::begin(quads), std::end(quads), 1, 2},
+            kdl::skip_iterator{std::begin(textColor), std::end(textColor), 0, 0});
+
+          stringVertices[fontDescriptor] =
+            kdl::vec_concat(std::move(stringVertices[fontDescriptor]), vertices);
         }
       }
     }
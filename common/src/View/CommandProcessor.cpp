@@ -23,6 +23,7 @@
 
 #include "Exceptions.h"
 #include "Notifier.h"
+#include "Profiler.h"
 #include "View/Command.h"
 #include "View/TransactionScope.h"
 #include "View/UndoableCommand.h"
@@ -99,6 +100,17 @@ public:
   {
   }
 
+  size_t memoryUsage() const override
+  {
+    auto result = UndoableCommand::memoryUsage()
+                  + m_commands.capacity() * sizeof(std::unique_ptr<UndoableCommand>);
+    for (const auto& command : m_commands)
+    {
+      result += command->memoryUsage();
+    }
+    return result;
+  }
+
 private:
   std::unique_ptr<CommandResult> doPerformDo(MapDocumentCommandFacade* document) override
   {
@@ -179,6 +191,20 @@ bool CommandProcessor::canRedo() const
   return m_transactionStack.empty() && !m_redoStack.empty();
 }
 
+size_t CommandProcessor::memoryUsage() const
+{
+  auto result = size_t(0);
+  for (const auto& command : m_undoStack)
+  {
+    result += command->memoryUsage();
+  }
+  for (const auto& command : m_redoStack)
+  {
+    result += command->memoryUsage();
+  }
+  return result;
+}
+
 const std::string& CommandProcessor::undoCommandName() const
 {
   if (!canUndo())
@@ -332,6 +358,8 @@ CommandProcessor::SubmitAndStoreResult CommandProcessor::executeAndStoreCommand(
 
 std::unique_ptr<CommandResult> CommandProcessor::executeCommand(Command& command)
 {
+  profileZone("View", "Execute command");
+
   notifyCommandIfNotType<TransactionCommand>(commandDoNotifier, command);
   auto result = command.performDo(m_document);
   if (result->success())
@@ -351,6 +379,8 @@ std::unique_ptr<CommandResult> CommandProcessor::executeCommand(Command& command
 
 std::unique_ptr<CommandResult> CommandProcessor::undoCommand(UndoableCommand& command)
 {
+  profileZone("View", "Undo command");
+
   notifyCommandIfNotType<TransactionCommand>(commandUndoNotifier, command);
   auto result = command.performUndo(m_document);
   if (result->success())
@@ -168,6 +168,12 @@ public:
    */
   const std::string& redoCommandName() const;
 
+  /**
+   * Returns an estimate of the number of bytes retained by the commands on the undo and
+   * redo stacks.
+   */
+  size_t memoryUsage() const;
+
   /**
    * Starts a new transaction. If a transaction is currently executing, then the newly
    * started transaction becomes a nested transaction and will be added as a command to
@@ -46,8 +46,8 @@
 #include "View/MapFrame.h"
 
 #include "kdl/memory_utils.h"
-#include "kdl/string_compare.h"
 #include "kdl/string_utils.h"
+#include "kdl/vector_utils.h"
 
 #include "vm/forward.h"
 #include "vm/mat.h"
@@ -56,6 +56,7 @@
 #include "vm/vec.h"
 
 #include <string>
+#include <unordered_set>
 #include <vector>
 
 namespace TrenchBroom::View
@@ -141,6 +142,22 @@ void EntityBrowserView::doInitLayout(Layout& layout)
   layout.setMaxUpScale(1.5f);
 }
 
+namespace
+{
+std::vector<Assets::EntityDefinition*> filterDefinitions(
+  std::vector<Assets::EntityDefinition*> definitions,
+  const std::optional<std::unordered_set<const Assets::EntityDefinition*>>& matches)
+{
+  if (matches)
+  {
+    return kdl::vec_erase_if(std::move(definitions), [&](const auto* definition) {
+      return !matches->contains(definition);
+    });
+  }
+  return definitions;
+}
+} // namespace
+
 void EntityBrowserView::doReloadLayout(Layout& layout)
 {
   const auto& fontPath = pref(Preferences::RendererFontPath());
@@ -151,12 +168,23 @@ void EntityBrowserView::doReloadLayout(Layout& layout)
   const auto& entityDefinitionManager = document->entityDefinitionManager();
   const auto font = Renderer::FontDescriptor{fontPath, static_cast<size_t>(fontSize)};
 
+  // query the name index once per reload instead of matching every definition
+  auto matches = std::optional<std::unordered_set<const Assets::EntityDefinition*>>{};
+  if (!m_filterText.empty())
+  {
+    const auto definitions =
+      entityDefinitionManager.findDefinitions(kdl::str_split(m_filterText, " "));
+    matches = std::unordered_set<const Assets::EntityDefinition*>{
+      definitions.begin(), definitions.end()};
+  }
+
   if (m_group)
   {
     for (const auto& group : entityDefinitionManager.groups())
     {
-      const auto& definitions =
-        group.definitions(Assets::EntityDefinitionType::PointEntity, m_sortOrder);
+      const auto definitions = filterDefinitions(
+        group.definitions(Assets::EntityDefinitionType::PointEntity, m_sortOrder),
+        matches);
 
       if (!definitions.empty())
       {
@@ -169,8 +197,10 @@ void EntityBrowserView::doReloadLayout(Layout& layout)
   }
   else
   {
-    const auto& definitions = entityDefinitionManager.definitions(
-      Assets::EntityDefinitionType::PointEntity, m_sortOrder);
+    const auto definitions = filterDefinitions(
+      entityDefinitionManager.definitions(
+        Assets::EntityDefinitionType::PointEntity, m_sortOrder),
+      matches);
     addEntitiesToLayout(layout, definitions, font);
   }
 }
@@ -206,26 +236,12 @@ void EntityBrowserView::addEntitiesToLayout(
   }
 }
 
-namespace
-{
-bool matchesFilterText(
-  const Assets::PointEntityDefinition& definition, const std::string& filterText)
-{
-  return filterText.empty()
-         || kdl::all_of(kdl::str_split(filterText, " "), [&](const auto& pattern) {
-              return kdl::ci::str_contains(definition.name(), pattern);
-            });
-}
-} // namespace
-
 void EntityBrowserView::addEntityToLayout(
   Layout& layout,
   const Assets::PointEntityDefinition* definition,
   const Renderer::FontDescriptor& font)
 {
-  if (
-    (!m_hideUnused || definition->usageCount() > 0)
-    && matchesFilterText(*definition, m_filterText))
+  if (!m_hideUnused || definition->usageCount() > 0)
   {
     const auto document = kdl::mem_lock(m_document);
     const auto& entityModelManager = document->entityModelManager();
@@ -330,25 +346,22 @@ void EntityBrowserView::renderBounds(Layout& layout, const float y, const float
   {
     if (group.intersectsY(y, height))
     {
-      for (const auto& row : group.rows())
+      for (const auto& row : group.rowsIntersectingY(y, height))
       {
-        if (row.intersectsY(y, height))
+        for (const auto& cell : row.cells())
         {
-          for (const auto& cell : row.cells())
+          const auto* definition = cellData(cell).entityDefinition;
+          auto* modelRenderer = cellData(cell).modelRenderer;
+
+          if (modelRenderer == nullptr)
           {
-            const auto* definition = cellData(cell).entityDefinition;
-            auto* modelRenderer = cellData(cell).modelRenderer;
-
-            if (modelRenderer == nullptr)
-            {
-              const auto itemTrans = itemTransformation(cell, y, height, false);
-              const auto& color = definition->color();
-              vm::bbox3f{definition->bounds()}.for_each_edge(
-                [&](const vm::vec3f& v1, const vm::vec3f& v2) {
-                  vertices.emplace_back(itemTrans * v1, color);
-                  vertices.emplace_back(itemTrans * v2, color);
-                });
-            }
+            const auto itemTrans = itemTransformation(cell, y, height, false);
+            const auto& color = definition->color();
+            vm::bbox3f{definition->bounds()}.for_each_edge(
+              [&](const vm::vec3f& v1, const vm::vec3f& v2) {
+                vertices.emplace_back(itemTrans * v1, color);
+                vertices.emplace_back(itemTrans * v2, color);
+              });
           }
         }
       }
@@ -391,27 +404,23 @@ void EntityBrowserView::renderModels(
   {
     if (group.intersectsY(y, height))
     {
-      for (const auto& row : group.rows())
+      for (const auto& row : group.rowsIntersectingY(y, height))
       {
-        if (row.intersectsY(y, height))
+        for (const auto& cell : row.cells())
         {
-          for (const auto& cell : row.cells())
+          if (auto* modelRenderer = cellData(cell).modelRenderer)
           {
-            if (auto* modelRenderer = cellData(cell).modelRenderer)
-            {
-              shader.set(
-                "Orientation", static_cast<int>(cellData(cell).modelOrientation));
+            shader.set("Orientation", static_cast<int>(cellData(cell).modelOrientation));
 
-              const auto itemTrans = itemTransformation(cell, y, height, true);
-              shader.set("ModelMatrix", itemTrans);
+            const auto itemTrans = itemTransformation(cell, y, height, true);
+            shader.set("ModelMatrix", itemTrans);
 
-              const auto multMatrix =
-                Renderer::MultiplyModelMatrix{transformation, itemTrans};
+            const auto multMatrix =
+              Renderer::MultiplyModelMatrix{transformation, itemTrans};
 
-              auto renderFunc = Renderer::DefaultMaterialRenderFunc{
-                pref(Preferences::TextureMinFilter), pref(Preferences::TextureMagFilter)};
-              modelRenderer->render(renderFunc);
-            }
+            auto renderFunc = Renderer::DefaultMaterialRenderFunc{
+              pref(Preferences::TextureMinFilter), pref(Preferences::TextureMagFilter)};
+            modelRenderer->render(renderFunc);
           }
         }
       }
@@ -53,6 +53,7 @@
 #include "Model/EmptyPropertyValueValidator.h"
 #include "Model/Entity.h"
 #include "Model/EntityNode.h"
+#include "Model/EntityNodeIndex.h"
 #include "Model/EntityProperties.h"
 #include "Model/Game.h"
 #include "Model/GameFactory.h"
@@ -87,6 +88,7 @@
 #include "Model/WorldNode.h"
 #include "PreferenceManager.h"
 #include "Preferences.h"
+#include "Profiler.h"
 #include "Uuid.h"
 #include "View/Actions.h"
 #include "View/AddRemoveNodesCommand.h"
@@ -107,6 +109,7 @@
 #include "View/UpdateLinkedGroupsCommand.h"
 #include "View/UpdateLinkedGroupsHelper.h"
 #include "View/ViewEffectsService.h"
+#include "octree.h"
 
 #include "kdl/collection_utils.h"
 #include "kdl/grouped_range.h"
@@ -134,6 +137,7 @@
 #include <string>
 #include <type_traits>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 namespace TrenchBroom::View
@@ -388,6 +392,7 @@ MapDocument::MapDocument()
         m_resourceManager->addResource(resource);
         return resource;
       },
+      [&](const auto& resourceId) { m_resourceManager->prioritize(resourceId); },
       logger()))
   , m_materialManager(std::make_unique<Assets::MaterialManager>(logger()))
   , m_tagManager(std::make_unique<Model::TagManager>())
@@ -964,12 +969,10 @@ void MapDocument::loadPointFile(std::filesystem::path path)
     unloadPointFile();
   }
 
-  IO::Disk::withInputStream(path, [&](auto& stream) {
-    return Model::loadPointFile(stream) | kdl::transform([&](auto trace) {
-             info() << "Loaded point file " << path;
-             m_pointFile = PointFile{std::move(trace), std::move(path)};
-             pointFileWasLoadedNotifier();
-           });
+  Model::loadPointFile(path) | kdl::transform([&](auto trace) {
+    info() << "Loaded point file " << path;
+    m_pointFile = PointFile{std::move(trace), std::move(path)};
+    pointFileWasLoadedNotifier();
   }) | kdl::transform_error([&](auto e) {
     error() << "Couldn't load portal file " << path << ": " << e.msg;
     m_pointFile = {};
@@ -1018,12 +1021,10 @@ void MapDocument::loadPortalFile(std::filesystem::path path)
   }
 
 
-  IO::Disk::withInputStream(path, [&](auto& stream) {
-    return Model::loadPortalFile(stream) | kdl::transform([&](auto portalFile) {
-             info() << "Loaded portal file " << path;
-             m_portalFile = {std::move(portalFile), std::move(path)};
-             portalFileWasLoadedNotifier();
-           });
+  Model::loadPortalFile(path) | kdl::transform([&](auto portalFile) {
+    info() << "Loaded portal file " << path;
+    m_portalFile = {std::move(portalFile), std::move(path)};
+    portalFileWasLoadedNotifier();
   }) | kdl::transform_error([&](auto e) {
     error() << "Couldn't load portal file " << path << ": " << e.msg;
     m_portalFile = std::nullopt;
@@ -2358,9 +2359,19 @@ bool MapDocument::updateLinkedGroups()
     if (const auto allChangedLinkedGroups = collectGroupsWithPendingChanges(*m_world);
         !allChangedLinkedGroups.empty())
     {
+      auto changedLinkedNodes = UpdateLinkedGroupsHelper::ChangedLinkedNodes{};
+      for (const auto* groupNode : allChangedLinkedGroups)
+      {
+        if (const auto& pendingChangedNodes = groupNode->pendingChangedNodes())
+        {
+          changedLinkedNodes[groupNode] = *pendingChangedNodes;
+        }
+      }
+
       setHasPendingChanges(allChangedLinkedGroups, false);
 
-      auto command = std::make_unique<UpdateLinkedGroupsCommand>(allChangedLinkedGroups);
+      auto command = std::make_unique<UpdateLinkedGroupsCommand>(
+        allChangedLinkedGroups, std::move(changedLinkedNodes));
       const auto result = executeAndStore(std::move(command));
       return result->success();
     }
@@ -2808,6 +2819,9 @@ bool MapDocument::swapNodeContents(
     return false;
   }
 
+  const auto swappedNodes =
+    kdl::vec_transform(nodesToSwap, [](const auto& p) { return p.first; });
+
   auto transaction = Transaction{*this};
   const auto result = executeAndStore(
     std::make_unique<SwapNodeContentsCommand>(commandName, std::move(nodesToSwap)));
@@ -2818,7 +2832,21 @@ bool MapDocument::swapNodeContents(
     return false;
   }
 
-  setHasPendingChanges(changedLinkedGroups, true);
+  // only the contents of the swapped nodes have changed, so only these nodes need to be
+  // propagated to the other members of the changed linked groups
+  for (auto* groupNode : changedLinkedGroups)
+  {
+    const auto changedNodes = kdl::vec_filter(
+      swappedNodes, [&](const auto* node) { return groupNode->isAncestorOf(node); });
+    if (changedNodes.empty())
+    {
+      groupNode->setHasPendingChanges(true);
+    }
+    else
+    {
+      groupNode->addPendingChangedNodes(changedNodes);
+    }
+  }
   return transaction.commit();
 }
 
@@ -2885,7 +2913,7 @@ bool MapDocument::transformObjects(
 
   using TransformResult = Result<std::pair<Model::Node*, Model::NodeContents>>;
 
-  const auto alignmentLock = pref(Preferences::AlignmentLock);
+  const auto alignmentLock = PreferenceManager::instance().snapshot()->alignmentLock;
   const auto updateAngleProperty =
     m_world->entityPropertyConfig().updateAnglePropertyAfterTransform;
 
@@ -4127,6 +4155,29 @@ bool MapDocument::throwExceptionDuringCommand()
   return result->success();
 }
 
+std::vector<SubsystemMemoryUsage> MapDocument::memoryUsage() const
+{
+  auto result = std::vector<SubsystemMemoryUsage>{};
+  if (m_world)
+  {
+    const auto nodeUsage = Model::computeMemoryUsage({m_world.get()});
+    result.push_back({"Brushes", nodeUsage.brushes});
+    result.push_back({"Patches", nodeUsage.patches});
+    result.push_back({"Entities", nodeUsage.entities});
+    result.push_back({"Worlds, layers and groups", nodeUsage.containers});
+    result.push_back({"Node tree", m_world->nodeTree().memory_usage()});
+    result.push_back({"Entity property index", m_world->entityNodeIndex().memoryUsage()});
+  }
+  result.push_back({"Undo history", doGetUndoMemoryUsage()});
+  result.push_back({"Textures", m_materialManager->memoryUsage()});
+  result.push_back({"Entity models", m_entityModelManager->memoryUsage()});
+  result.push_back(
+    {"Textures (GPU)",
+     m_materialManager->uploadedTextureSize()
+       + m_entityModelManager->uploadedTextureSize()});
+  return result;
+}
+
 bool MapDocument::canUndoCommand() const
 {
   return doCanUndoCommand();
@@ -4208,6 +4259,11 @@ bool MapDocument::commitTransaction()
 
   doCommitTransaction();
   m_repeatStack->commitTransaction();
+
+  if (m_world)
+  {
+    m_world->applyPendingNodeTreeUpdates();
+  }
   return true;
 }
 
@@ -4250,13 +4306,17 @@ void MapDocument::processResourcesSync(const Assets::ProcessContext& processCont
 
   if (!allProcessedResourceIds.empty())
   {
-    resourcesWereProcessedNotifier.notify(
-      kdl::vec_sort_and_remove_duplicates(std::move(allProcessedResourceIds)));
+    allProcessedResourceIds =
+      kdl::vec_sort_and_remove_duplicates(std::move(allProcessedResourceIds));
+    updateLoadedEntityModels(allProcessedResourceIds);
+    resourcesWereProcessedNotifier.notify(allProcessedResourceIds);
   }
 }
 
 void MapDocument::processResourcesAsync(const Assets::ProcessContext& processContext)
 {
+  profileZone("View", "Process resources");
+
   const auto processedResourceIds = m_resourceManager->process(
     [](auto task) { return std::async(std::move(task)); },
     processContext,
@@ -4264,6 +4324,7 @@ void MapDocument::processResourcesAsync(const Assets::ProcessContext& processCon
 
   if (!processedResourceIds.empty())
   {
+    updateLoadedEntityModels(processedResourceIds);
     resourcesWereProcessedNotifier.notify(processedResourceIds);
   }
 }
@@ -4550,6 +4611,10 @@ void MapDocument::unloadMaterials()
 {
   unsetMaterials();
   m_materialManager->clear();
+
+  // the cached face tags refer to the unloaded materials, and new materials may be
+  // allocated at the same addresses
+  m_tagManager->clearFaceTagCache();
 }
 
 static auto makeSetMaterialsVisitor(Assets::MaterialManager& manager)
@@ -4701,8 +4766,63 @@ void MapDocument::clearEntityModels()
   m_entityModelManager->clear();
 }
 
+void LoadingEntityModels::add(
+  Model::EntityNode* entityNode, const Assets::EntityModel* model)
+{
+  remove(entityNode);
+  if (model && !model->data())
+  {
+    m_entityNodesByModel[model].push_back(entityNode);
+    m_modelByEntityNode[entityNode] = model;
+  }
+}
+
+void LoadingEntityModels::remove(Model::EntityNode* entityNode)
+{
+  if (const auto it = m_modelByEntityNode.find(entityNode);
+      it != m_modelByEntityNode.end())
+  {
+    auto& entityNodes = m_entityNodesByModel[it->second];
+    entityNodes = kdl::vec_erase(std::move(entityNodes), entityNode);
+    if (entityNodes.empty())
+    {
+      m_entityNodesByModel.erase(it->second);
+    }
+    m_modelByEntityNode.erase(it);
+  }
+}
+
+std::vector<Model::EntityNode*> LoadingEntityModels::take(
+  const Assets::EntityModel* model)
+{
+  auto result = std::vector<Model::EntityNode*>{};
+  if (const auto it = m_entityNodesByModel.find(model); it != m_entityNodesByModel.end())
+  {
+    result = std::move(it->second);
+    m_entityNodesByModel.erase(it);
+    for (auto* entityNode : result)
+    {
+      m_modelByEntityNode.erase(entityNode);
+    }
+  }
+  return result;
+}
+
+bool LoadingEntityModels::empty() const
+{
+  return m_modelByEntityNode.empty();
+}
+
+void LoadingEntityModels::clear()
+{
+  m_entityNodesByModel.clear();
+  m_modelByEntityNode.clear();
+}
+
 static auto makeSetEntityModelsVisitor(
-  Assets::EntityModelManager& manager, Logger& logger)
+  Assets::EntityModelManager& manager,
+  LoadingEntityModels& loadingEntityModels,
+  Logger& logger)
 {
   return kdl::overload(
     [](auto&& thisLambda, Model::WorldNode* world) { world->visitChildren(thisLambda); },
@@ -4715,40 +4835,140 @@ static auto makeSetEntityModelsVisitor(
         });
       const auto* model = manager.model(modelSpec.path);
       entityNode->setModel(model);
+      loadingEntityModels.add(entityNode, model);
     },
     [](Model::BrushNode*) {},
     [](Model::PatchNode*) {});
 }
 
-static auto makeUnsetEntityModelsVisitor()
+static auto makeUnsetEntityModelsVisitor(LoadingEntityModels& loadingEntityModels)
 {
   return kdl::overload(
     [](auto&& thisLambda, Model::WorldNode* world) { world->visitChildren(thisLambda); },
     [](auto&& thisLambda, Model::LayerNode* layer) { layer->visitChildren(thisLambda); },
     [](auto&& thisLambda, Model::GroupNode* group) { group->visitChildren(thisLambda); },
-    [](Model::EntityNode* entity) { entity->setModel(nullptr); },
+    [&](Model::EntityNode* entityNode) {
+      loadingEntityModels.remove(entityNode);
+      entityNode->setModel(nullptr);
+    },
     [](Model::BrushNode*) {},
     [](Model::PatchNode*) {});
 }
 
 void MapDocument::setEntityModels()
 {
-  m_world->accept(makeSetEntityModelsVisitor(*m_entityModelManager, *this));
+  m_world->accept(
+    makeSetEntityModelsVisitor(*m_entityModelManager, m_loadingEntityModels, *this));
 }
 
 void MapDocument::setEntityModels(const std::vector<Model::Node*>& nodes)
 {
-  Model::Node::visitAll(nodes, makeSetEntityModelsVisitor(*m_entityModelManager, *this));
+  Model::Node::visitAll(
+    nodes,
+    makeSetEntityModelsVisitor(*m_entityModelManager, m_loadingEntityModels, *this));
 }
 
 void MapDocument::unsetEntityModels()
 {
-  m_world->accept(makeUnsetEntityModelsVisitor());
+  m_loadingEntityModels.clear();
+  m_world->accept(makeUnsetEntityModelsVisitor(m_loadingEntityModels));
 }
 
 void MapDocument::unsetEntityModels(const std::vector<Model::Node*>& nodes)
 {
-  Model::Node::visitAll(nodes, makeUnsetEntityModelsVisitor());
+  Model::Node::visitAll(nodes, makeUnsetEntityModelsVisitor(m_loadingEntityModels));
+}
+
+/**
+ * Some serializers fill in missing surface attributes from a face's material. Store these
+ * values in the face attributes so that the brush is serialized in the same way once its
+ * materials are unset.
+ */
+static void resolveSurfaceAttributes(Model::BrushNode& brushNode)
+{
+  const auto needsResolving = [](const Model::BrushFace& face) {
+    const auto& attributes = face.attributes();
+    return face.material()
+           && (attributes.hasSurfaceAttributes() || attributes.hasColor())
+           && (!attributes.surfaceContents() || !attributes.surfaceFlags()
+               || !attributes.surfaceValue());
+  };
+
+  if (kdl::none_of(brushNode.brush().faces(), needsResolving))
+  {
+    return;
+  }
+
+  auto brush = brushNode.brush();
+  for (auto& face : brush.faces())
+  {
+    if (needsResolving(face))
+    {
+      auto attributes = face.attributes();
+      attributes.setSurfaceContents(face.resolvedSurfaceContents());
+      attributes.setSurfaceFlags(face.resolvedSurfaceFlags());
+      attributes.setSurfaceValue(face.resolvedSurfaceValue());
+      face.setAttributes(attributes);
+    }
+  }
+
+  // resolving the surface data does not change the brush's serialized text
+  auto serializedText = brushNode.serializedText();
+  brushNode.setBrush(std::move(brush));
+  brushNode.setSerializedText(std::move(serializedText));
+}
+
+std::unique_ptr<Model::WorldNode> MapDocument::makeWorldSnapshot() const
+{
+  ensure(m_world, "world is null");
+
+  auto snapshot = std::unique_ptr<Model::WorldNode>{static_cast<Model::WorldNode*>(
+    m_world->cloneRecursively(m_worldBounds, Model::SetLinkId::keep))};
+
+  // the snapshot may outlive the document's assets, so it must not reference them
+  snapshot->accept(kdl::overload(
+    [](auto&& thisLambda, Model::WorldNode* world) { world->visitChildren(thisLambda); },
+    [](auto&& thisLambda, Model::LayerNode* layer) { layer->visitChildren(thisLambda); },
+    [](auto&& thisLambda, Model::GroupNode* group) { group->visitChildren(thisLambda); },
+    [](auto&& thisLambda, Model::EntityNode* entity) {
+      entity->setModel(nullptr);
+      entity->visitChildren(thisLambda);
+    },
+    [](Model::BrushNode* brushNode) { resolveSurfaceAttributes(*brushNode); },
+    [](Model::PatchNode*) {}));
+  snapshot->accept(makeUnsetMaterialsVisitor());
+  snapshot->accept(makeUnsetEntityDefinitionsVisitor());
+  return snapshot;
+}
+
+void MapDocument::updateLoadedEntityModels(
+  const std::vector<Assets::ResourceId>& resourceIds)
+{
+  // Entities use placeholder bounds while their model is loading, so their bounds must be
+  // recomputed once the model data becomes available.
+  if (m_loadingEntityModels.empty())
+  {
+    return;
+  }
+
+  auto selectionBoundsChanged = false;
+  for (const auto* model :
+       m_entityModelManager->findEntityModelsByTextureResourceId(resourceIds))
+  {
+    if (model->data())
+    {
+      for (auto* entityNode : m_loadingEntityModels.take(model))
+      {
+        entityNode->setModel(model);
+        selectionBoundsChanged = selectionBoundsChanged || entityNode->selected();
+      }
+    }
+  }
+
+  if (selectionBoundsChanged)
+  {
+    invalidateSelectionBounds();
+  }
 }
 
 std::vector<std::filesystem::path> MapDocument::externalSearchPaths() const
@@ -4916,7 +5136,12 @@ const Model::SmartTag& MapDocument::smartTag(const size_t index) const
   return m_tagManager->smartTag(index);
 }
 
-static auto makeInitializeNodeTagsVisitor(Model::TagManager& tagManager)
+/**
+ * Initializes the tags of all visited nodes except for brush nodes, which are collected
+ * in the given vector so that their tags can be initialized in parallel.
+ */
+static auto makeInitializeNodeTagsVisitor(
+  Model::TagManager& tagManager, std::vector<Model::BrushNode*>& brushNodes)
 {
   return kdl::overload(
     [&](auto&& thisLambda, Model::WorldNode* world) {
@@ -4935,10 +5160,18 @@ static auto makeInitializeNodeTagsVisitor(Model::TagManager& tagManager)
       entity->initializeTags(tagManager);
       entity->visitChildren(thisLambda);
     },
-    [&](Model::BrushNode* brush) { brush->initializeTags(tagManager); },
+    [&](Model::BrushNode* brush) { brushNodes.push_back(brush); },
     [&](Model::PatchNode* patch) { patch->initializeTags(tagManager); });
 }
 
+static void initializeBrushNodeTags(
+  const std::vector<Model::BrushNode*>& brushNodes, Model::TagManager& tagManager)
+{
+  kdl::parallel_for(brushNodes.size(), [&](const size_t i) {
+    brushNodes[i]->initializeTags(tagManager);
+  });
+}
+
 static auto makeClearNodeTagsVisitor()
 {
   return kdl::overload(
@@ -4966,12 +5199,17 @@ void MapDocument::initializeAllNodeTags(MapDocument* document)
 {
   assert(document == this);
   unused(document);
-  m_world->accept(makeInitializeNodeTagsVisitor(*m_tagManager));
+
+  auto brushNodes = std::vector<Model::BrushNode*>{};
+  m_world->accept(makeInitializeNodeTagsVisitor(*m_tagManager, brushNodes));
+  initializeBrushNodeTags(brushNodes, *m_tagManager);
 }
 
 void MapDocument::initializeNodeTags(const std::vector<Model::Node*>& nodes)
 {
-  Model::Node::visitAll(nodes, makeInitializeNodeTagsVisitor(*m_tagManager));
+  auto brushNodes = std::vector<Model::BrushNode*>{};
+  Model::Node::visitAll(nodes, makeInitializeNodeTagsVisitor(*m_tagManager, brushNodes));
+  initializeBrushNodeTags(brushNodes, *m_tagManager);
 }
 
 void MapDocument::clearNodeTags(const std::vector<Model::Node*>& nodes)
@@ -4998,6 +5236,10 @@ void MapDocument::updateFaceTags(const std::vector<Model::BrushFaceHandle>& face
 
 void MapDocument::updateAllFaceTags()
 {
+  // the cached face tags refer to the materials, which may have changed
+  m_tagManager->clearFaceTagCache();
+
+  auto brushNodes = std::vector<Model::BrushNode*>{};
   m_world->accept(kdl::overload(
     [](auto&& thisLambda, Model::WorldNode* world) { world->visitChildren(thisLambda); },
     [](auto&& thisLambda, Model::LayerNode* layer) { layer->visitChildren(thisLambda); },
@@ -5005,8 +5247,9 @@ void MapDocument::updateAllFaceTags()
     [](auto&& thisLambda, Model::EntityNode* entity) {
       entity->visitChildren(thisLambda);
     },
-    [&](Model::BrushNode* brush) { brush->initializeTags(*m_tagManager); },
+    [&](Model::BrushNode* brush) { brushNodes.push_back(brush); },
     [](Model::PatchNode*) {}));
+  initializeBrushNodeTags(brushNodes, *m_tagManager);
 }
 
 bool MapDocument::persistent() const
@@ -5154,6 +5397,7 @@ void MapDocument::preferenceDidChange(const std::filesystem::path& path)
 
     reloadMaterials();
     setMaterials();
+    updateAllFaceTags();
   }
 }
 
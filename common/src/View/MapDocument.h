@@ -40,6 +40,7 @@
 #include <memory>
 #include <optional>
 #include <string>
+#include <unordered_map>
 #include <variant>
 #include <vector>
 
@@ -53,6 +54,7 @@ namespace TrenchBroom::Assets
 class EntityDefinition;
 class EntityDefinitionFileSpec;
 class EntityDefinitionManager;
+class EntityModel;
 class EntityModelManager;
 class Material;
 class MaterialManager;
@@ -69,6 +71,7 @@ class BrushFaceHandle;
 class BrushFaceAttributes;
 class EditorContext;
 class Entity;
+class EntityNode;
 class Game;
 class Issue;
 enum class MapFormat;
@@ -109,6 +112,44 @@ struct PortalFile
   std::filesystem::path path;
 };
 
+/**
+ * Tracks the entity nodes whose entity model is still loading, so that their bounds can
+ * be updated once the model data becomes available.
+ */
+class LoadingEntityModels
+{
+private:
+  std::unordered_map<const Assets::EntityModel*, std::vector<Model::EntityNode*>>
+    m_entityNodesByModel;
+  std::unordered_map<Model::EntityNode*, const Assets::EntityModel*> m_modelByEntityNode;
+
+public:
+  /**
+   * Registers the given entity node with the given model if the model's data is not
+   * available yet. Any previous registration of the entity node is removed.
+   */
+  void add(Model::EntityNode* entityNode, const Assets::EntityModel* model);
+
+  void remove(Model::EntityNode* entityNode);
+
+  /**
+   * Removes and returns the entity nodes registered with the given model.
+   */
+  std::vector<Model::EntityNode*> take(const Assets::EntityModel* model);
+
+  bool empty() const;
+  void clear();
+};
+
+/**
+ * An estimate of the number of bytes used by a subsystem of a document.
+ */
+struct SubsystemMemoryUsage
+{
+  std::string name;
+  size_t bytes;
+};
+
 class MapDocument : public Model::MapFacade, public CachingLogger
 {
 public:
@@ -127,6 +168,7 @@ protected:
   std::unique_ptr<Assets::EntityDefinitionManager> m_entityDefinitionManager;
   std::unique_ptr<Assets::EntityModelManager> m_entityModelManager;
   std::unique_ptr<Assets::MaterialManager> m_materialManager;
+  LoadingEntityModels m_loadingEntityModels;
   std::unique_ptr<Model::TagManager> m_tagManager;
 
   std::unique_ptr<Model::EditorContext> m_editorContext;
@@ -314,6 +356,14 @@ public: // new, load, save document
   void saveDocument();
   void saveDocumentAs(const std::filesystem::path& path);
   void saveDocumentTo(const std::filesystem::path& path);
+
+  /**
+   * Returns a deep copy of the world that does not reference any of this document's
+   * materials, entity definitions or entity models. The snapshot can be written to disk
+   * on another thread while the document continues to change.
+   */
+  std::unique_ptr<Model::WorldNode> makeWorldSnapshot() const;
+
   Result<void> exportDocumentAs(const IO::ExportOptions& options);
 
 private:
@@ -643,6 +693,14 @@ public: // debug commands
   void printVertices();
   bool throwExceptionDuringCommand();
 
+public: // memory usage
+  /**
+   * Returns an estimate of the memory used by this document, broken down by subsystem.
+   * Main memory and GPU memory are reported separately. The estimates do not account for
+   * allocator overhead.
+   */
+  std::vector<SubsystemMemoryUsage> memoryUsage() const;
+
 public: // command processing
   bool canUndoCommand() const;
   bool canRedoCommand() const;
@@ -672,6 +730,7 @@ private: // subclassing interface for command processing
   virtual bool doCanRedoCommand() const = 0;
   virtual const std::string& doGetUndoCommandName() const = 0;
   virtual const std::string& doGetRedoCommandName() const = 0;
+  virtual size_t doGetUndoMemoryUsage() const = 0;
   virtual void doUndoCommand() = 0;
   virtual void doRedoCommand() = 0;
 
@@ -756,6 +815,7 @@ protected:
   void setEntityModels(const std::vector<Model::Node*>& nodes);
   void unsetEntityModels();
   void unsetEntityModels(const std::vector<Model::Node*>& nodes);
+  void updateLoadedEntityModels(const std::vector<Assets::ResourceId>& resourceIds);
 
 protected: // search paths and mods
   std::vector<std::filesystem::path> externalSearchPaths() const;
@@ -658,6 +658,11 @@ const std::string& MapDocumentCommandFacade::doGetRedoCommandName() const
   return m_commandProcessor->redoCommandName();
 }
 
+size_t MapDocumentCommandFacade::doGetUndoMemoryUsage() const
+{
+  return m_commandProcessor->memoryUsage();
+}
+
 void MapDocumentCommandFacade::doUndoCommand()
 {
   m_commandProcessor->undo();
@@ -127,6 +127,7 @@ private: // implement MapDocument interface
   bool doCanRedoCommand() const override;
   const std::string& doGetUndoCommandName() const override;
   const std::string& doGetRedoCommandName() const override;
+  size_t doGetUndoMemoryUsage() const override;
   void doUndoCommand() override;
   void doRedoCommand() override;
 
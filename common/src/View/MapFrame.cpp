@@ -42,6 +42,7 @@
 #include "Console.h"
 #include "Error.h" // IWYU pragma: keep
 #include "Exceptions.h"
+#include "IO/DiskIO.h"
 #include "IO/ExportOptions.h"
 #include "IO/PathQt.h"
 #include "Model/BrushNode.h"
@@ -60,6 +61,9 @@
 #include "Model/WorldNode.h"
 #include "PreferenceManager.h"
 #include "Preferences.h"
+#include "Profiler.h"
+#include "Renderer/Camera.h"
+#include "Renderer/VboManager.h"
 #include "TrenchBroomApp.h"
 #include "View/Actions.h"
 #include "View/Autosaver.h"
@@ -184,7 +188,9 @@ MapFrame::~MapFrame()
 
   // let's trigger a final autosave before releasing the document
   auto logger = NullLogger{};
+  m_autosaver->finishPendingAutosave(logger);
   m_autosaver->triggerAutosave(logger);
+  m_autosaver->finishPendingAutosave(logger);
 
   m_document->setViewEffectsService(nullptr);
   m_document.reset();
@@ -1974,6 +1980,20 @@ bool MapFrame::canMoveCameraToPreviousPoint() const
   return m_mapView->canMoveCameraToPreviousTracePoint();
 }
 
+void MapFrame::moveCameraToNearestPoint()
+{
+  if (canMoveCameraToNearestPoint())
+  {
+    const auto position = currentMapViewBase()->camera().position();
+    m_mapView->moveCameraToNearestTracePoint(position);
+  }
+}
+
+bool MapFrame::canMoveCameraToNearestPoint() const
+{
+  return m_mapView->canMoveCameraToNearestTracePoint();
+}
+
 void MapFrame::reset2dCameras()
 {
   if (auto* mapView2d = dynamic_cast<View::MapView2D*>(currentMapViewBase()))
@@ -2156,6 +2176,19 @@ void MapFrame::revealMaterial(const Assets::Material* material)
   m_inspector->faceInspector()->revealMaterial(material);
 }
 
+void MapFrame::printMemoryUsage()
+{
+  auto entries = m_document->memoryUsage();
+  entries.push_back(
+    {"Vertex buffers (GPU)", m_contextManager->vboManager().currentVboSize()});
+
+  logger().info() << "Memory usage:";
+  for (const auto& [name, bytes] : entries)
+  {
+    logger().info() << "  " << name << ": " << (bytes / 1024u) << " KiB";
+  }
+}
+
 void MapFrame::debugPrintVertices()
 {
   m_document->printVertices();
@@ -2282,6 +2315,32 @@ void MapFrame::debugShowPalette()
   showModelessDialog(window);
 }
 
+#ifdef TB_ENABLE_PROFILER
+void MapFrame::debugToggleProfilerStatistics()
+{
+  togglePref(Preferences::ShowProfilerStatistics);
+}
+
+void MapFrame::debugExportProfilerTrace()
+{
+  const auto fileName = QFileDialog::getSaveFileName(
+    this, tr("Export Profiler Trace"), "trace.json", "Chrome trace files (*.json)");
+  if (fileName.isEmpty())
+  {
+    return;
+  }
+
+  const auto path = IO::pathFromQString(fileName);
+  const auto events = Profiler::events();
+  IO::Disk::withOutputStream(path, [&](auto& stream) {
+    Profiler::writeChromeTrace(stream, events);
+    logger().info() << "Exported " << events.size() << " profiler events to " << path;
+  }) | kdl::transform_error([&](const auto& e) {
+    logger().error() << "Could not export profiler trace: " << e.msg;
+  });
+}
+#endif
+
 void MapFrame::focusChange(QWidget* /* oldFocus */, QWidget* newFocus)
 {
   if (auto* newMapView = dynamic_cast<MapViewBase*>(newFocus))
@@ -356,6 +356,9 @@ public:
   void moveCameraToPreviousPoint();
   bool canMoveCameraToPreviousPoint() const;
 
+  void moveCameraToNearestPoint();
+  bool canMoveCameraToNearestPoint() const;
+
   void reset2dCameras();
 
   void focusCameraOnSelection();
@@ -395,6 +398,8 @@ public:
 
   void revealMaterial(const Assets::Material* material);
 
+  void printMemoryUsage();
+
   void debugPrintVertices();
   void debugCreateBrush();
   void debugCreateCube();
@@ -403,6 +408,10 @@ public:
   void debugThrowExceptionDuringCommand();
   void debugSetWindowSize();
   void debugShowPalette();
+#ifdef TB_ENABLE_PROFILER
+  void debugToggleProfilerStatistics();
+  void debugExportProfilerTrace();
+#endif
 
   void focusChange(QWidget* oldFocus, QWidget* newFocus);
 
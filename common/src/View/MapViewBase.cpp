@@ -50,6 +50,7 @@
 #include "Model/WorldNode.h"
 #include "PreferenceManager.h"
 #include "Preferences.h"
+#include "Renderer/AttrString.h"
 #include "Renderer/Camera.h"
 #include "Renderer/Compass.h"
 #include "Renderer/FontDescriptor.h"
@@ -81,7 +82,10 @@
 #include "vm/polygon.h"
 #include "vm/util.h"
 
+#include <chrono>
+#include <iomanip>
 #include <sstream>
+#include <utility>
 #include <vector>
 
 namespace TrenchBroom::View
@@ -272,6 +276,7 @@ void MapViewBase::gridDidChange()
 
 void MapViewBase::pointFileDidChange()
 {
+  invalidatePointFileRenderer();
   update();
 }
 
@@ -287,6 +292,16 @@ void MapViewBase::preferenceDidChange(const std::filesystem::path& path)
   {
     fontManager().clearCache();
   }
+  else if (path == Preferences::PointFileColor.path())
+  {
+    invalidatePointFileRenderer();
+  }
+  else if (
+    path == Preferences::PortalFileBorderColor.path()
+    || path == Preferences::PortalFileFillColor.path())
+  {
+    invalidatePortalFileRenderer();
+  }
 
   updateActionBindings();
   update();
@@ -992,6 +1007,11 @@ bool MapViewBase::doShouldRenderFocusIndicator() const
 
 void MapViewBase::doRender()
 {
+#ifdef TB_ENABLE_PROFILER
+  const auto frameStart = ProfilerEvent::Clock::now();
+#endif
+  profileZone("View", "Frame");
+
   doPreRender();
 
   const auto& fontPath = pref(Preferences::RendererFontPath());
@@ -1042,6 +1062,9 @@ void MapViewBase::doRender()
   renderPortalFile(renderContext, renderBatch);
   renderCompass(renderBatch);
   renderFPS(renderContext, renderBatch);
+#ifdef TB_ENABLE_PROFILER
+  renderProfilerStatistics(renderContext, renderBatch, frameStart);
+#endif
 
   renderBatch.render(renderContext);
 
@@ -1096,12 +1119,33 @@ void MapViewBase::renderSoftMapBounds(
 void MapViewBase::renderPointFile(
   Renderer::RenderContext& renderContext, Renderer::RenderBatch& renderBatch)
 {
+  if (!m_pointFileRenderer)
+  {
+    validatePointFileRenderer(renderContext);
+    assert(m_pointFileRenderer != nullptr);
+  }
+  renderBatch.add(m_pointFileRenderer.get());
+}
+
+void MapViewBase::invalidatePointFileRenderer()
+{
+  m_pointFileRenderer = nullptr;
+}
+
+void MapViewBase::validatePointFileRenderer(Renderer::RenderContext&)
+{
+  assert(m_pointFileRenderer == nullptr);
+  m_pointFileRenderer = std::make_unique<Renderer::PrimitiveRenderer>();
+
   auto document = kdl::mem_lock(m_document);
   if (const auto* pointFile = document->pointFile())
   {
-    auto renderService = Renderer::RenderService{renderContext, renderBatch};
-    renderService.setForegroundColor(pref(Preferences::PointFileColor));
-    renderService.renderLineStrip(pointFile->points());
+    const auto lineWidth = 1.0f;
+    m_pointFileRenderer->renderLineStrip(
+      pref(Preferences::PointFileColor),
+      lineWidth,
+      Renderer::PrimitiveRendererOcclusionPolicy::Transparent,
+      pointFile->points());
   }
 }
 
@@ -1127,24 +1171,22 @@ void MapViewBase::validatePortalFileRenderer(Renderer::RenderContext&)
   m_portalFileRenderer = std::make_unique<Renderer::PrimitiveRenderer>();
 
   auto document = kdl::mem_lock(m_document);
-  auto* portalFile = document->portalFile();
-  if (portalFile)
+  if (const auto* portalFile = document->portalFile())
   {
-    for (const auto& poly : portalFile->portals())
-    {
-      m_portalFileRenderer->renderFilledPolygon(
-        pref(Preferences::PortalFileFillColor),
-        Renderer::PrimitiveRendererOcclusionPolicy::Hide,
-        Renderer::PrimitiveRendererCullingPolicy::ShowBackfaces,
-        poly.vertices());
-
-      const auto lineWidth = 4.0f;
-      m_portalFileRenderer->renderPolygon(
-        pref(Preferences::PortalFileBorderColor),
-        lineWidth,
-        Renderer::PrimitiveRendererOcclusionPolicy::Hide,
-        poly.vertices());
-    }
+    m_portalFileRenderer->renderFilledPolygons(
+      pref(Preferences::PortalFileFillColor),
+      Renderer::PrimitiveRendererOcclusionPolicy::Hide,
+      Renderer::PrimitiveRendererCullingPolicy::ShowBackfaces,
+      portalFile->vertices(),
+      portalFile->offsets());
+
+    const auto lineWidth = 4.0f;
+    m_portalFileRenderer->renderPolygons(
+      pref(Preferences::PortalFileBorderColor),
+      lineWidth,
+      Renderer::PrimitiveRendererOcclusionPolicy::Hide,
+      portalFile->vertices(),
+      portalFile->offsets());
   }
 }
 
@@ -1159,6 +1201,14 @@ void MapViewBase::renderCompass(Renderer::RenderBatch& renderBatch)
 void MapViewBase::renderFPS(
   Renderer::RenderContext& renderContext, Renderer::RenderBatch& renderBatch)
 {
+#ifdef TB_ENABLE_PROFILER
+  // the profiler statistics include the FPS if both are shown
+  if (pref(Preferences::ShowProfilerStatistics))
+  {
+    return;
+  }
+#endif
+
   if (pref(Preferences::ShowFPS))
   {
     auto renderService = Renderer::RenderService{renderContext, renderBatch};
@@ -1166,6 +1216,47 @@ void MapViewBase::renderFPS(
   }
 }
 
+#ifdef TB_ENABLE_PROFILER
+void MapViewBase::renderProfilerStatistics(
+  Renderer::RenderContext& renderContext,
+  Renderer::RenderBatch& renderBatch,
+  const ProfilerEvent::Clock::time_point frameStart)
+{
+  const auto previousFrameStart = std::exchange(m_previousFrameStart, frameStart);
+  if (!pref(Preferences::ShowProfilerStatistics))
+  {
+    return;
+  }
+
+  auto string = Renderer::AttrString{};
+  if (pref(Preferences::ShowFPS))
+  {
+    string.appendLeftJustified(m_currentFPS);
+  }
+
+  const auto statistics =
+    Profiler::zoneStatistics(Profiler::events(previousFrameStart, frameStart));
+  if (statistics.empty())
+  {
+    string.appendLeftJustified("No profiler events in the previous frame");
+  }
+
+  for (const auto& zone : statistics)
+  {
+    const auto milliseconds =
+      std::chrono::duration<double, std::milli>{zone.totalDuration}.count();
+
+    auto str = std::stringstream{};
+    str << zone.category << "/" << zone.name << ": " << std::fixed << std::setprecision(2)
+        << milliseconds << "ms (" << zone.count << "x)";
+    string.appendLeftJustified(str.str());
+  }
+
+  auto renderService = Renderer::RenderService{renderContext, renderBatch};
+  renderService.renderHeadsUp(string);
+}
+#endif
+
 void MapViewBase::processEvent(const KeyEvent& event)
 {
   ToolBoxConnector::processEvent(event);
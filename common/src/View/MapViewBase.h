@@ -20,6 +20,7 @@
 #pragma once
 
 #include "NotifierConnection.h"
+#include "Profiler.h"
 #include "View/ActionContext.h"
 #include "View/CameraLinkHelper.h"
 #include "View/MapView.h"
@@ -99,6 +100,7 @@ protected:
 
 private:
   std::unique_ptr<Renderer::Compass> m_compass;
+  std::unique_ptr<Renderer::PrimitiveRenderer> m_pointFileRenderer;
   std::unique_ptr<Renderer::PrimitiveRenderer> m_portalFileRenderer;
 
   /**
@@ -107,6 +109,14 @@ private:
    */
   bool m_isCurrent = false;
 
+#ifdef TB_ENABLE_PROFILER
+  /**
+   * The start time of the previous frame, used to select the profiler events shown in
+   * the profiler statistics.
+   */
+  ProfilerEvent::Clock::time_point m_previousFrameStart;
+#endif
+
   SignalDelayer* m_updateActionStatesSignalDelayer = nullptr;
 
   NotifierConnection m_notifierConnection;
@@ -334,6 +344,8 @@ private: // implement RenderView interface
     Renderer::RenderContext& renderContext, Renderer::RenderBatch& renderBatch);
   void renderPointFile(
     Renderer::RenderContext& renderContext, Renderer::RenderBatch& renderBatch);
+  void invalidatePointFileRenderer();
+  void validatePointFileRenderer(Renderer::RenderContext& renderContext);
 
   void renderPortalFile(
     Renderer::RenderContext& renderContext, Renderer::RenderBatch& renderBatch);
@@ -343,6 +355,12 @@ private: // implement RenderView interface
   void renderCompass(Renderer::RenderBatch& renderBatch);
   void renderFPS(
     Renderer::RenderContext& renderContext, Renderer::RenderBatch& renderBatch);
+#ifdef TB_ENABLE_PROFILER
+  void renderProfilerStatistics(
+    Renderer::RenderContext& renderContext,
+    Renderer::RenderBatch& renderBatch,
+    ProfilerEvent::Clock::time_point frameStart);
+#endif
 
 public: // implement InputEventProcessor interface
   void processEvent(const KeyEvent& event) override;
@@ -39,6 +39,7 @@
 #include "Renderer/VertexArray.h"
 #include "View/MapDocument.h"
 
+#include "kdl/collection_utils.h"
 #include "kdl/memory_utils.h"
 #include "kdl/skip_iterator.h"
 #include "kdl/string_compare.h"
@@ -63,8 +64,14 @@ MaterialBrowserView::MaterialBrowserView(
   , m_document{std::move(document_)}
 {
   auto document = kdl::mem_lock(m_document);
+  m_notifierConnection += document->documentWasNewedNotifier.connect(
+    this, &MaterialBrowserView::documentWasNewedOrLoaded);
+  m_notifierConnection += document->documentWasLoadedNotifier.connect(
+    this, &MaterialBrowserView::documentWasNewedOrLoaded);
+  m_notifierConnection += document->materialCollectionsDidChangeNotifier.connect(
+    this, &MaterialBrowserView::materialCollectionsDidChange);
   m_notifierConnection += document->materialUsageCountsDidChangeNotifier.connect(
-    this, &MaterialBrowserView::reloadMaterials);
+    this, &MaterialBrowserView::materialUsageCountsDidChange);
   m_notifierConnection += document->resourcesWereProcessedNotifier.connect(
     this, &MaterialBrowserView::resourcesWereProcessed);
 }
@@ -132,6 +139,23 @@ void MaterialBrowserView::revealMaterial(const Assets::Material* material)
   });
 }
 
+void MaterialBrowserView::documentWasNewedOrLoaded(MapDocument*)
+{
+  materialCollectionsDidChange();
+}
+
+void MaterialBrowserView::materialCollectionsDidChange()
+{
+  m_sortIndices.clear();
+  reloadMaterials();
+}
+
+void MaterialBrowserView::materialUsageCountsDidChange()
+{
+  m_sortIndices.erase(MaterialSortOrder::Usage);
+  reloadMaterials();
+}
+
 void MaterialBrowserView::resourcesWereProcessed(const std::vector<Assets::ResourceId>&)
 {
   reloadMaterials();
@@ -164,6 +188,9 @@ void MaterialBrowserView::doReloadLayout(Layout& layout)
 
   const auto font = Renderer::FontDescriptor{fontPath, size_t(fontSize)};
 
+  // the index is queried at most once per reload and shared by all collections
+  m_filterMatches = std::nullopt;
+
   if (m_group)
   {
     for (const auto* collection : getCollections())
@@ -259,10 +286,9 @@ std::vector<const Assets::Material*> MaterialBrowserView::filterMaterials(
   }
   if (!m_filterText.empty())
   {
+    const auto& matches = filterMatches();
     materials = kdl::vec_erase_if(std::move(materials), [&](const auto* material) {
-      return !kdl::all_of(kdl::str_split(m_filterText, " "), [&](const auto& pattern) {
-        return kdl::ci::str_contains(material->name(), pattern);
-      });
+      return !matches.contains(material);
     });
   }
   return materials;
@@ -270,12 +296,38 @@ std::vector<const Assets::Material*> MaterialBrowserView::filterMaterials(
 
 std::vector<const Assets::Material*> MaterialBrowserView::sortMaterials(
   std::vector<const Assets::Material*> materials) const
+{
+  const auto& indices = sortIndices(materials);
+  return kdl::vec_sort(std::move(materials), [&](const auto* lhs, const auto* rhs) {
+    return indices.at(lhs) < indices.at(rhs);
+  });
+}
+
+const std::unordered_set<const Assets::Material*>& MaterialBrowserView::filterMatches()
+  const
+{
+  if (!m_filterMatches)
+  {
+    auto document = kdl::mem_lock(m_document);
+    const auto matches =
+      document->materialManager().findMaterials(kdl::str_split(m_filterText, " "));
+    m_filterMatches =
+      std::unordered_set<const Assets::Material*>{matches.begin(), matches.end()};
+  }
+  return *m_filterMatches;
+}
+
+namespace
+{
+
+std::vector<const Assets::Material*> sortMaterialsBy(
+  std::vector<const Assets::Material*> materials, const MaterialSortOrder sortOrder)
 {
   const auto compareNames = [](const auto& lhs, const auto& rhs) {
     return kdl::ci::string_less{}(lhs->name(), rhs->name());
   };
 
-  switch (m_sortOrder)
+  switch (sortOrder)
   {
   case MaterialSortOrder::Name:
     return kdl::vec_sort(std::move(materials), compareNames);
@@ -289,6 +341,46 @@ std::vector<const Assets::Material*> MaterialBrowserView::sortMaterials(
   }
 }
 
+} // namespace
+
+const std::unordered_map<const Assets::Material*, size_t>& MaterialBrowserView::
+  sortIndices(const std::vector<const Assets::Material*>& materials) const
+{
+  auto it = m_sortIndices.find(m_sortOrder);
+  if (
+    it != m_sortIndices.end()
+    && !kdl::all_of(
+      materials, [&](const auto* material) { return it->second.contains(material); }))
+  {
+    // the materials were reloaded without notifying us
+    m_sortIndices.clear();
+    it = m_sortIndices.end();
+  }
+
+  if (it == m_sortIndices.end())
+  {
+    auto document = kdl::mem_lock(m_document);
+    auto allMaterials = std::vector<const Assets::Material*>{};
+    for (const auto& collection : document->materialManager().collections())
+    {
+      for (const auto& material : collection.materials())
+      {
+        allMaterials.push_back(&material);
+      }
+    }
+    allMaterials = sortMaterialsBy(std::move(allMaterials), m_sortOrder);
+
+    auto indices = std::unordered_map<const Assets::Material*, size_t>{};
+    indices.reserve(allMaterials.size());
+    for (size_t i = 0; i < allMaterials.size(); ++i)
+    {
+      indices.emplace(allMaterials[i], i);
+    }
+    it = m_sortIndices.emplace(m_sortOrder, std::move(indices)).first;
+  }
+  return it->second;
+}
+
 void MaterialBrowserView::doClear() {}
 
 void MaterialBrowserView::doRender(Layout& layout, const float y, const float height)
@@ -326,27 +418,23 @@ void MaterialBrowserView::renderBounds(Layout& layout, const float y, const floa
   {
     if (group.intersectsY(y, height))
     {
-      for (const auto& row : group.rows())
+      for (const auto& row : group.rowsIntersectingY(y, height))
       {
-        if (row.intersectsY(y, height))
+        for (const auto& cell : row.cells())
         {
-          for (const auto& cell : row.cells())
-          {
-            const auto& bounds = cell.itemBounds();
-            const auto& material = cellData(cell);
-            const auto& color = materialColor(material);
-            vertices.emplace_back(
-              vm::vec2f{bounds.left() - 2.0f, height - (bounds.top() - 2.0f - y)}, color);
-            vertices.emplace_back(
-              vm::vec2f{bounds.left() - 2.0f, height - (bounds.bottom() + 2.0f - y)},
-              color);
-            vertices.emplace_back(
-              vm::vec2f{bounds.right() + 2.0f, height - (bounds.bottom() + 2.0f - y)},
-              color);
-            vertices.emplace_back(
-              vm::vec2f{bounds.right() + 2.0f, height - (bounds.top() - 2.0f - y)},
-              color);
-          }
+          const auto& bounds = cell.itemBounds();
+          const auto& material = cellData(cell);
+          const auto& color = materialColor(material);
+          vertices.emplace_back(
+            vm::vec2f{bounds.left() - 2.0f, height - (bounds.top() - 2.0f - y)}, color);
+          vertices.emplace_back(
+            vm::vec2f{bounds.left() - 2.0f, height - (bounds.bottom() + 2.0f - y)},
+            color);
+          vertices.emplace_back(
+            vm::vec2f{bounds.right() + 2.0f, height - (bounds.bottom() + 2.0f - y)},
+            color);
+          vertices.emplace_back(
+            vm::vec2f{bounds.right() + 2.0f, height - (bounds.top() - 2.0f - y)}, color);
         }
       }
     }
@@ -388,30 +476,27 @@ void MaterialBrowserView::renderMaterials(
   {
     if (group.intersectsY(y, height))
     {
-      for (const auto& row : group.rows())
+      for (const auto& row : group.rowsIntersectingY(y, height))
       {
-        if (row.intersectsY(y, height))
+        for (const auto& cell : row.cells())
         {
-          for (const auto& cell : row.cells())
-          {
-            const auto& bounds = cell.itemBounds();
-            const auto& material = cellData(cell);
-
-            auto vertexArray = Renderer::VertexArray::move(std::vector<Vertex>{
-              Vertex{{bounds.left(), height - (bounds.top() - y)}, {0, 0}},
-              Vertex{{bounds.left(), height - (bounds.bottom() - y)}, {0, 1}},
-              Vertex{{bounds.right(), height - (bounds.bottom() - y)}, {1, 1}},
-              Vertex{{bounds.right(), height - (bounds.top() - y)}, {1, 0}},
-            });
-
-            material.activate(
-              pref(Preferences::TextureMinFilter), pref(Preferences::TextureMagFilter));
-
-            vertexArray.prepare(vboManager());
-            vertexArray.render(Renderer::PrimType::Quads);
-
-            material.deactivate();
-          }
+          const auto& bounds = cell.itemBounds();
+          const auto& material = cellData(cell);
+
+          auto vertexArray = Renderer::VertexArray::move(std::vector<Vertex>{
+            Vertex{{bounds.left(), height - (bounds.top() - y)}, {0, 0}},
+            Vertex{{bounds.left(), height - (bounds.bottom() - y)}, {0, 1}},
+            Vertex{{bounds.right(), height - (bounds.bottom() - y)}, {1, 1}},
+            Vertex{{bounds.right(), height - (bounds.top() - y)}, {1, 0}},
+          });
+
+          material.activate(
+            pref(Preferences::TextureMinFilter), pref(Preferences::TextureMagFilter));
+
+          vertexArray.prepare(vboManager());
+          vertexArray.render(Renderer::PrimType::Quads);
+
+          material.deactivate();
         }
       }
     }
@@ -24,7 +24,10 @@
 #include "View/CellView.h"
 
 #include <memory>
+#include <optional>
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 class QScrollBar;
@@ -61,6 +64,14 @@ private:
 
   const Assets::Material* m_selectedMaterial = nullptr;
 
+  // the materials that match the current filter text, looked up once per layout reload
+  mutable std::optional<std::unordered_set<const Assets::Material*>> m_filterMatches;
+  // the position of every material when sorted by the respective sort order
+  mutable std::unordered_map<
+    MaterialSortOrder,
+    std::unordered_map<const Assets::Material*, size_t>>
+    m_sortIndices;
+
   NotifierConnection m_notifierConnection;
 
 public:
@@ -81,6 +92,9 @@ public:
   void revealMaterial(const Assets::Material* material);
 
 private:
+  void documentWasNewedOrLoaded(MapDocument* document);
+  void materialCollectionsDidChange();
+  void materialUsageCountsDidChange();
   void resourcesWereProcessed(const std::vector<Assets::ResourceId>& resources);
 
   void reloadMaterials();
@@ -107,6 +121,10 @@ private:
   std::vector<const Assets::Material*> sortMaterials(
     std::vector<const Assets::Material*> materials) const;
 
+  const std::unordered_set<const Assets::Material*>& filterMatches() const;
+  const std::unordered_map<const Assets::Material*, size_t>& sortIndices(
+    const std::vector<const Assets::Material*>& materials) const;
+
   void doClear() override;
   void doRender(Layout& layout, float y, float height) override;
   bool doShouldRenderFocusIndicator() const override;
@@ -72,5 +72,18 @@ bool SwapNodeContentsCommand::doCollateWith(UndoableCommand& command)
 
   return false;
 }
+
+size_t SwapNodeContentsCommand::memoryUsage() const
+{
+  using NodeAndContents = std::pair<Model::Node*, Model::NodeContents>;
+
+  auto result = UpdateLinkedGroupsCommandBase::memoryUsage()
+                + m_nodes.capacity() * sizeof(NodeAndContents);
+  for (const auto& [node, contents] : m_nodes)
+  {
+    result += contents.memoryUsage() - sizeof(Model::NodeContents);
+  }
+  return result;
+}
 } // namespace View
 } // namespace TrenchBroom
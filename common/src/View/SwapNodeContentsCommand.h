@@ -56,6 +56,8 @@ public:
 
   bool doCollateWith(UndoableCommand& command) override;
 
+  size_t memoryUsage() const override;
+
   deleteCopyAndMove(SwapNodeContentsCommand);
 };
 } // namespace View
@@ -310,6 +310,12 @@ bool SwitchableMapViewContainer::canMoveCameraToPreviousTracePoint() const
   return false;
 }
 
+bool SwitchableMapViewContainer::canMoveCameraToNearestTracePoint() const
+{
+  auto document = kdl::mem_lock(m_document);
+  return document->isPointFileLoaded();
+}
+
 void SwitchableMapViewContainer::moveCameraToNextTracePoint()
 {
   auto document = kdl::mem_lock(m_document);
@@ -334,6 +340,18 @@ void SwitchableMapViewContainer::moveCameraToPreviousTracePoint()
   }
 }
 
+void SwitchableMapViewContainer::moveCameraToNearestTracePoint(const vm::vec3f& position)
+{
+  auto document = kdl::mem_lock(m_document);
+  assert(document->isPointFileLoaded());
+
+  if (auto* pointFile = document->pointFile())
+  {
+    pointFile->setCurrentPoint(pointFile->indexOfNearestPoint(position));
+    m_mapView->moveCameraToCurrentTracePoint();
+  }
+}
+
 bool SwitchableMapViewContainer::canMaximizeCurrentView() const
 {
   return m_mapView->canMaximizeCurrentView();
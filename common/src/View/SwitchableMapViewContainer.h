@@ -125,8 +125,10 @@ public:
 
   bool canMoveCameraToNextTracePoint() const;
   bool canMoveCameraToPreviousTracePoint() const;
+  bool canMoveCameraToNearestTracePoint() const;
   void moveCameraToNextTracePoint();
   void moveCameraToPreviousTracePoint();
+  void moveCameraToNearestTracePoint(const vm::vec3f& position);
 
   bool canMaximizeCurrentView() const;
   bool currentViewMaximized() const;
@@ -22,6 +22,8 @@
 #include "Exceptions.h"
 #include "View/MapDocumentCommandFacade.h"
 
+#include "kdl/string_utils.h"
+
 #include <string>
 
 namespace TrenchBroom
@@ -75,6 +77,11 @@ bool UndoableCommand::collateWith(UndoableCommand& command)
   return false;
 }
 
+size_t UndoableCommand::memoryUsage() const
+{
+  return sizeof(UndoableCommand) + kdl::str_allocated_size(name());
+}
+
 bool UndoableCommand::doCollateWith(UndoableCommand&)
 {
   return false;
@@ -47,6 +47,12 @@ public:
 
   virtual bool collateWith(UndoableCommand& command);
 
+  /**
+   * Returns an estimate of the number of bytes retained by this command to undo or redo
+   * it. The estimate does not account for allocator overhead.
+   */
+  virtual size_t memoryUsage() const;
+
 protected:
   virtual std::unique_ptr<CommandResult> doPerformUndo(
     MapDocumentCommandFacade* document) = 0;
@@ -39,7 +39,9 @@ namespace View
 class UpdateLinkedGroupsCommand : public UpdateLinkedGroupsCommandBase
 {
 public:
-  explicit UpdateLinkedGroupsCommand(std::vector<Model::GroupNode*> changedLinkedGroups);
+  explicit UpdateLinkedGroupsCommand(
+    std::vector<Model::GroupNode*> changedLinkedGroups,
+    UpdateLinkedGroupsHelper::ChangedLinkedNodes changedLinkedNodes = {});
   ~UpdateLinkedGroupsCommand() override;
 
   std::unique_ptr<CommandResult> doPerformDo(MapDocumentCommandFacade* document) override;
@@ -35,9 +35,11 @@ namespace View
 UpdateLinkedGroupsCommandBase::UpdateLinkedGroupsCommandBase(
   std::string name,
   const bool updateModificationCount,
-  std::vector<Model::GroupNode*> changedLinkedGroups)
+  std::vector<Model::GroupNode*> changedLinkedGroups,
+  UpdateLinkedGroupsHelper::ChangedLinkedNodes changedLinkedNodes)
   : UndoableCommand{std::move(name), updateModificationCount}
-  , m_updateLinkedGroupsHelper{std::move(changedLinkedGroups)}
+  , m_updateLinkedGroupsHelper{
+      std::move(changedLinkedGroups), std::move(changedLinkedNodes)}
 {
 }
 
@@ -107,5 +109,10 @@ bool UpdateLinkedGroupsCommandBase::collateWith(UndoableCommand& command)
   return false;
 }
 
+size_t UpdateLinkedGroupsCommandBase::memoryUsage() const
+{
+  return UndoableCommand::memoryUsage() + m_updateLinkedGroupsHelper.memoryUsage();
+}
+
 } // namespace View
 } // namespace TrenchBroom
@@ -41,7 +41,8 @@ protected:
   UpdateLinkedGroupsCommandBase(
     std::string name,
     bool updateModificationCount,
-    std::vector<Model::GroupNode*> changedLinkedGroups = {});
+    std::vector<Model::GroupNode*> changedLinkedGroups = {},
+    UpdateLinkedGroupsHelper::ChangedLinkedNodes changedLinkedNodes = {});
 
 public:
   ~UpdateLinkedGroupsCommandBase() override;
@@ -51,6 +52,8 @@ public:
 
   bool collateWith(UndoableCommand& command) override;
 
+  size_t memoryUsage() const override;
+
 private:
   deleteCopyAndMove(UpdateLinkedGroupsCommandBase);
 };
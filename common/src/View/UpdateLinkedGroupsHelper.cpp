@@ -60,8 +60,9 @@ bool checkLinkedGroupsToUpdate(const std::vector<Model::GroupNode*>& changedLink
 }
 
 UpdateLinkedGroupsHelper::UpdateLinkedGroupsHelper(
-  ChangedLinkedGroups changedLinkedGroups)
+  ChangedLinkedGroups changedLinkedGroups, ChangedLinkedNodes changedLinkedNodes)
   : m_state{kdl::vec_sort(std::move(changedLinkedGroups), compareByAncestry)}
+  , m_changedLinkedNodes{std::move(changedLinkedNodes)}
 {
 }
 
@@ -71,18 +72,43 @@ Result<void> UpdateLinkedGroupsHelper::applyLinkedGroupUpdates(
   MapDocumentCommandFacade& document)
 {
   return computeLinkedGroupUpdates(document)
-         | kdl::transform([&]() { doApplyOrUndoLinkedGroupUpdates(document); });
+         | kdl::transform([&]() { doApplyLinkedGroupUpdates(document); });
 }
 
 void UpdateLinkedGroupsHelper::undoLinkedGroupUpdates(MapDocumentCommandFacade& document)
 {
-  doApplyOrUndoLinkedGroupUpdates(document);
+  doUndoLinkedGroupUpdates(document);
+}
+
+size_t UpdateLinkedGroupsHelper::memoryUsage() const
+{
+  return std::visit(
+    kdl::overload(
+      [](const ChangedLinkedGroups& changedLinkedGroups) {
+        return changedLinkedGroups.capacity() * sizeof(Model::GroupNode*);
+      },
+      [](const LinkedGroupUpdates& linkedGroupUpdates) {
+        auto result = size_t(0);
+        for (const auto& [groupNode, replacedChildren] :
+             linkedGroupUpdates.replacedChildren)
+        {
+          const auto children = kdl::vec_transform(
+            replacedChildren, [](const auto& child) { return child.get(); });
+          result += Model::computeMemoryUsage(children).total();
+        }
+        for (const auto& [node, contents] : linkedGroupUpdates.swappedContents)
+        {
+          result += contents.memoryUsage();
+        }
+        return result;
+      }),
+    m_state);
 }
 
 void UpdateLinkedGroupsHelper::collateWith(UpdateLinkedGroupsHelper& other)
 {
   // Both helpers have already applied their changes at this point, so in both helpers,
-  // m_linkedGroups contains pairs p where
+  // m_state.replacedChildren contains pairs p where
   // - p.first is the group node to update
   // - p.second is a vector containing the group node's original children
   //
@@ -93,23 +119,68 @@ void UpdateLinkedGroupsHelper::collateWith(UpdateLinkedGroupsHelper& other)
   // is not an update for a linked group node that was updated by this helper, then we
   // will add p_o to our updates and remove it from the other helper's updates to prevent
   // the replaced node to be deleted with the other helper.
+  //
+  // Similarly, m_state.swappedContents contains the original contents of the nodes whose
+  // contents were swapped. We keep our original contents and add the other helper's
+  // original contents for nodes that we did not swap, unless these nodes are discarded
+  // because they belong to children that we replaced.
 
   auto& myLinkedGroupUpdates = std::get<LinkedGroupUpdates>(m_state);
   auto& theirLinkedGroupUpdates = std::get<LinkedGroupUpdates>(other.m_state);
 
-  for (auto& [theirGroupNodeToUpdate, theirOldChildren] : theirLinkedGroupUpdates)
+  auto discardedNodes = std::vector<const Model::Node*>{};
+  for (auto& [theirGroupNodeToUpdate, theirOldChildren] :
+       theirLinkedGroupUpdates.replacedChildren)
   {
     const auto myIt = std::find_if(
-      std::begin(myLinkedGroupUpdates),
-      std::end(myLinkedGroupUpdates),
+      std::begin(myLinkedGroupUpdates.replacedChildren),
+      std::end(myLinkedGroupUpdates.replacedChildren),
       [theirGroupNodeToUpdate = theirGroupNodeToUpdate](const auto& p) {
         return p.first == theirGroupNodeToUpdate;
       });
-    if (myIt == std::end(myLinkedGroupUpdates))
+    if (myIt == std::end(myLinkedGroupUpdates.replacedChildren))
     {
-      myLinkedGroupUpdates.emplace_back(
+      myLinkedGroupUpdates.replacedChildren.emplace_back(
         theirGroupNodeToUpdate, std::move(theirOldChildren));
     }
+    else
+    {
+      for (const auto& theirOldChild : theirOldChildren)
+      {
+        discardedNodes.push_back(theirOldChild.get());
+      }
+    }
+  }
+
+  const auto isDiscarded = [&](const Model::Node* node) {
+    return std::any_of(
+             std::begin(myLinkedGroupUpdates.replacedChildren),
+             std::end(myLinkedGroupUpdates.replacedChildren),
+             [&](const auto& p) { return p.first->isAncestorOf(node); })
+           || std::any_of(
+             std::begin(discardedNodes),
+             std::end(discardedNodes),
+             [&](const auto* discardedNode) {
+               return discardedNode == node || discardedNode->isAncestorOf(node);
+             });
+  };
+
+  for (auto& [theirNodeToSwap, theirOldContents] :
+       theirLinkedGroupUpdates.swappedContents)
+  {
+    const auto myIt = std::find_if(
+      std::begin(myLinkedGroupUpdates.swappedContents),
+      std::end(myLinkedGroupUpdates.swappedContents),
+      [theirNodeToSwap = theirNodeToSwap](const auto& p) {
+        return p.first == theirNodeToSwap;
+      });
+    if (
+      myIt == std::end(myLinkedGroupUpdates.swappedContents)
+      && !isDiscarded(theirNodeToSwap))
+    {
+      myLinkedGroupUpdates.swappedContents.emplace_back(
+        theirNodeToSwap, std::move(theirOldContents));
+    }
   }
 }
 
@@ -119,10 +190,12 @@ Result<void> UpdateLinkedGroupsHelper::computeLinkedGroupUpdates(
   return std::visit(
     kdl::overload(
       [&](const ChangedLinkedGroups& changedLinkedGroups) {
-        return computeLinkedGroupUpdates(changedLinkedGroups, document)
+        return computeLinkedGroupUpdates(
+                 changedLinkedGroups, m_changedLinkedNodes, document)
                | kdl::transform([&](auto&& linkedGroupUpdates) {
                    m_state =
                      std::forward<decltype(linkedGroupUpdates)>(linkedGroupUpdates);
+                   m_changedLinkedNodes.clear();
                  });
       },
       [](const LinkedGroupUpdates&) -> Result<void> { return kdl::void_success; }),
@@ -131,7 +204,9 @@ Result<void> UpdateLinkedGroupsHelper::computeLinkedGroupUpdates(
 
 Result<UpdateLinkedGroupsHelper::LinkedGroupUpdates> UpdateLinkedGroupsHelper::
   computeLinkedGroupUpdates(
-    const ChangedLinkedGroups& changedLinkedGroups, MapDocumentCommandFacade& document)
+    const ChangedLinkedGroups& changedLinkedGroups,
+    const ChangedLinkedNodes& changedLinkedNodes,
+    MapDocumentCommandFacade& document)
 {
   if (!checkLinkedGroupsToUpdate(changedLinkedGroups))
   {
@@ -146,24 +221,86 @@ Result<UpdateLinkedGroupsHelper::LinkedGroupUpdates> UpdateLinkedGroupsHelper::
                Model::collectGroupsWithLinkId({document.world()}, groupNode->linkId()),
                groupNode);
 
-             return Model::updateLinkedGroups(
-               *groupNode, groupNodesToUpdate, worldBounds);
+             const auto updateChildren = [&]() {
+               return Model::updateLinkedGroups(
+                        *groupNode, groupNodesToUpdate, worldBounds)
+                      | kdl::transform([](auto replacedChildren) {
+                          return LinkedGroupUpdates{std::move(replacedChildren), {}};
+                        });
+             };
+
+             const auto it = changedLinkedNodes.find(groupNode);
+             if (it == changedLinkedNodes.end())
+             {
+               return updateChildren();
+             }
+
+             // if the changed nodes cannot be propagated individually, fall back to
+             // replacing all children
+             return Model::updateLinkedNodes(
+                      *groupNode, groupNodesToUpdate, it->second, worldBounds)
+                    | kdl::transform([](auto swappedContents) {
+                        return LinkedGroupUpdates{{}, std::move(swappedContents)};
+                      })
+                    | kdl::or_else([&](const auto&) { return updateChildren(); });
            })
          | kdl::fold()
-         | kdl::and_then([&](auto nestedUpdateLists) -> Result<LinkedGroupUpdates> {
-             return kdl::vec_flatten(std::move(nestedUpdateLists));
+         | kdl::and_then([&](auto updateLists) -> Result<LinkedGroupUpdates> {
+             auto result = LinkedGroupUpdates{};
+
+             // nested linked groups can yield several updates for the same node, but
+             // each node must be swapped only once so that undoing restores its
+             // original contents
+             auto swappedNodes = std::unordered_set<const Model::Node*>{};
+             for (auto& updates : updateLists)
+             {
+               result.replacedChildren = kdl::vec_concat(
+                 std::move(result.replacedChildren), std::move(updates.replacedChildren));
+               for (auto& [node, contents] : updates.swappedContents)
+               {
+                 if (swappedNodes.insert(node).second)
+                 {
+                   result.swappedContents.emplace_back(node, std::move(contents));
+                 }
+               }
+             }
+             return result;
            });
 }
 
-void UpdateLinkedGroupsHelper::doApplyOrUndoLinkedGroupUpdates(
+void UpdateLinkedGroupsHelper::doApplyLinkedGroupUpdates(
+  MapDocumentCommandFacade& document)
+{
+  // The contents must be swapped before the children are replaced because the swapped
+  // nodes may be among the replaced children.
+  std::visit(
+    kdl::overload(
+      [](const ChangedLinkedGroups&) {},
+      [&](LinkedGroupUpdates& linkedGroupUpdates) {
+        if (!linkedGroupUpdates.swappedContents.empty())
+        {
+          document.performSwapNodeContents(linkedGroupUpdates.swappedContents);
+        }
+        linkedGroupUpdates.replacedChildren =
+          document.performReplaceChildren(std::move(linkedGroupUpdates.replacedChildren));
+      }),
+    m_state);
+}
+
+void UpdateLinkedGroupsHelper::doUndoLinkedGroupUpdates(
   MapDocumentCommandFacade& document)
 {
   std::visit(
     kdl::overload(
       [](const ChangedLinkedGroups&) {},
-      [&](LinkedGroupUpdates&& linkedGroupUpdates) {
-        m_state = document.performReplaceChildren(std::move(linkedGroupUpdates));
+      [&](LinkedGroupUpdates& linkedGroupUpdates) {
+        linkedGroupUpdates.replacedChildren =
+          document.performReplaceChildren(std::move(linkedGroupUpdates.replacedChildren));
+        if (!linkedGroupUpdates.swappedContents.empty())
+        {
+          document.performSwapNodeContents(linkedGroupUpdates.swappedContents);
+        }
       }),
-    std::move(m_state));
+    m_state);
 }
 } // namespace TrenchBroom::View
@@ -19,9 +19,11 @@
 
 #pragma once
 
+#include "Model/NodeContents.h"
 #include "Result.h"
 
 #include <memory>
+#include <unordered_map>
 #include <utility>
 #include <variant>
 #include <vector>
@@ -53,28 +55,52 @@ bool checkLinkedGroupsToUpdate(const std::vector<Model::GroupNode*>& changedLink
  * updated, and these linked groups are replaced with their replacements. Calling
  * applyLinkedGroupUpdates replaces the replacement nodes with their original
  * corresponding groups again, effectively undoing the change.
+ *
+ * If only the contents of some nodes of a changed linked group have changed, these nodes
+ * can be passed as well. Then only the contents of the corresponding nodes in the other
+ * members of the link set are swapped instead of replacing all of their children.
  */
 class UpdateLinkedGroupsHelper
 {
-private:
+public:
   using ChangedLinkedGroups = std::vector<Model::GroupNode*>;
-  using LinkedGroupUpdates =
-    std::vector<std::pair<Model::Node*, std::vector<std::unique_ptr<Model::Node>>>>;
+  using ChangedLinkedNodes =
+    std::unordered_map<const Model::GroupNode*, std::vector<Model::Node*>>;
+
+private:
+  struct LinkedGroupUpdates
+  {
+    std::vector<std::pair<Model::Node*, std::vector<std::unique_ptr<Model::Node>>>>
+      replacedChildren;
+    std::vector<std::pair<Model::Node*, Model::NodeContents>> swappedContents;
+  };
+
   std::variant<ChangedLinkedGroups, LinkedGroupUpdates> m_state;
+  ChangedLinkedNodes m_changedLinkedNodes;
 
 public:
-  explicit UpdateLinkedGroupsHelper(ChangedLinkedGroups changedLinkedGroups);
+  explicit UpdateLinkedGroupsHelper(
+    ChangedLinkedGroups changedLinkedGroups, ChangedLinkedNodes changedLinkedNodes = {});
   ~UpdateLinkedGroupsHelper();
 
   Result<void> applyLinkedGroupUpdates(MapDocumentCommandFacade& document);
   void undoLinkedGroupUpdates(MapDocumentCommandFacade& document);
   void collateWith(UpdateLinkedGroupsHelper& other);
 
+  /**
+   * Returns an estimate of the number of bytes used by the replaced nodes and swapped
+   * contents retained by this helper.
+   */
+  size_t memoryUsage() const;
+
 private:
   Result<void> computeLinkedGroupUpdates(MapDocumentCommandFacade& document);
   static Result<LinkedGroupUpdates> computeLinkedGroupUpdates(
-    const ChangedLinkedGroups& changedLinkedGroups, MapDocumentCommandFacade& document);
+    const ChangedLinkedGroups& changedLinkedGroups,
+    const ChangedLinkedNodes& changedLinkedNodes,
+    MapDocumentCommandFacade& document);
 
-  void doApplyOrUndoLinkedGroupUpdates(MapDocumentCommandFacade& document);
+  void doApplyLinkedGroupUpdates(MapDocumentCommandFacade& document);
+  void doUndoLinkedGroupUpdates(MapDocumentCommandFacade& document);
 };
 } // namespace TrenchBroom::View
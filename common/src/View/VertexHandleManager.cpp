@@ -22,7 +22,6 @@
 #include "FloatType.h"
 #include "Model/Polyhedron.h"
 #include "PreferenceManager.h"
-#include "Preferences.h"
 #include "View/Grid.h"
 
 #include "vm/distance.h"
@@ -35,6 +34,14 @@ namespace TrenchBroom
 {
 namespace View
 {
+namespace
+{
+FloatType currentHandleRadius()
+{
+  return static_cast<FloatType>(PreferenceManager::instance().snapshot()->handleRadius);
+}
+} // namespace
+
 VertexHandleManagerBase::~VertexHandleManagerBase() {}
 
 const Model::HitType::Type VertexHandleManager::HandleHitType =
@@ -45,11 +52,10 @@ void VertexHandleManager::pick(
   const Renderer::Camera& camera,
   Model::PickResult& pickResult) const
 {
+  const auto handleRadius = currentHandleRadius();
   for (const auto& [position, info] : m_handles)
   {
-    if (
-      const auto distance = camera.pickPointHandle(
-        pickRay, position, static_cast<FloatType>(pref(Preferences::HandleRadius))))
+    if (const auto distance = camera.pickPointHandle(pickRay, position, handleRadius))
     {
       const auto hitPoint = vm::point_at_distance(pickRay, *distance);
       const auto error = vm::squared_distance(pickRay, position).distance;
@@ -96,17 +102,16 @@ void EdgeHandleManager::pickGridHandle(
   const Grid& grid,
   Model::PickResult& pickResult) const
 {
+  const auto handleRadius = currentHandleRadius();
   for (const auto& [position, info] : m_handles)
   {
     if (
-      const auto edgeDist = camera.pickLineSegmentHandle(
-        pickRay, position, FloatType(pref(Preferences::HandleRadius))))
+      const auto edgeDist = camera.pickLineSegmentHandle(pickRay, position, handleRadius))
     {
       const auto pointHandle =
         grid.snap(vm::point_at_distance(pickRay, *edgeDist), position);
       if (
-        const auto pointDist = camera.pickPointHandle(
-          pickRay, pointHandle, FloatType(pref(Preferences::HandleRadius))))
+        const auto pointDist = camera.pickPointHandle(pickRay, pointHandle, handleRadius))
       {
         const auto hitPoint = vm::point_at_distance(pickRay, *pointDist);
         pickResult.addHit(Model::Hit(
@@ -121,13 +126,12 @@ void EdgeHandleManager::pickCenterHandle(
   const Renderer::Camera& camera,
   Model::PickResult& pickResult) const
 {
+  const auto handleRadius = currentHandleRadius();
   for (const auto& [position, info] : m_handles)
   {
     const auto pointHandle = position.center();
 
-    if (
-      const auto pointDist = camera.pickPointHandle(
-        pickRay, pointHandle, FloatType(pref(Preferences::HandleRadius))))
+    if (const auto pointDist = camera.pickPointHandle(pickRay, pointHandle, handleRadius))
     {
       const auto hitPoint = vm::point_at_distance(pickRay, *pointDist);
       pickResult.addHit(Model::Hit(HandleHitType, *pointDist, hitPoint, position));
@@ -174,6 +178,7 @@ void FaceHandleManager::pickGridHandle(
   const Grid& grid,
   Model::PickResult& pickResult) const
 {
+  const auto handleRadius = currentHandleRadius();
   for (const auto& [position, info] : m_handles)
   {
     if (const auto plane = vm::from_points(std::begin(position), std::end(position)))
@@ -187,7 +192,7 @@ void FaceHandleManager::pickGridHandle(
 
         if (
           const auto pointDist = camera.pickPointHandle(
-            pickRay, pointHandle, FloatType(pref(Preferences::HandleRadius))))
+            pickRay, pointHandle, handleRadius))
         {
           const auto hitPoint = vm::point_at_distance(pickRay, *pointDist);
           pickResult.addHit(Model::Hit(
@@ -203,13 +208,12 @@ void FaceHandleManager::pickCenterHandle(
   const Renderer::Camera& camera,
   Model::PickResult& pickResult) const
 {
+  const auto handleRadius = currentHandleRadius();
   for (const auto& [position, info] : m_handles)
   {
     const auto pointHandle = position.center();
 
-    if (
-      const auto pointDist = camera.pickPointHandle(
-        pickRay, pointHandle, static_cast<FloatType>(pref(Preferences::HandleRadius))))
+    if (const auto pointDist = camera.pickPointHandle(pickRay, pointHandle, handleRadius))
     {
       const auto hitPoint = vm::point_at_distance(pickRay, *pointDist);
       pickResult.addHit(Model::Hit(HandleHitType, *pointDist, hitPoint, position));
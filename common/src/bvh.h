@@ -0,0 +1,454 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "vm/bbox.h"
+#include "vm/ray.h"
+#include "vm/scalar.h"
+#include "vm/vec.h"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace TrenchBroom
+{
+
+/**
+ * An immutable bounding volume hierarchy that allows for quick ray intersection queries.
+ *
+ * The tree is built once from a list of bounding boxes and their associated data using the
+ * surface area heuristic (SAH). The nodes are stored in a flat array in depth first order,
+ * and the data is stored in leaf order, so that the data of each leaf is contiguous in
+ * memory.
+ *
+ * @tparam T the floating point type
+ * @tparam U the data to store in the leafs
+ */
+template <typename T, typename U>
+class bvh
+{
+public:
+  using bbox_type = vm::bbox<T, 3>;
+  using vec_type = vm::vec<T, 3>;
+  using ray_type = vm::ray<T, 3>;
+
+  static constexpr size_t default_max_leaf_size = 4;
+
+private:
+  static constexpr size_t bin_count = 12;
+
+  // beyond this depth, nodes are split at the median, which bounds the total tree depth
+  static constexpr size_t max_sah_depth = 32;
+  static constexpr size_t max_depth = 2 * max_sah_depth;
+
+  /**
+   * If count is 0, this is an inner node whose left child immediately follows it in the
+   * node array, and whose right child is at index offset. Otherwise, this is a leaf node
+   * whose data is stored at [offset, offset + count) in the data array.
+   */
+  struct node
+  {
+    bbox_type bounds;
+    uint32_t offset;
+    uint32_t count;
+  };
+
+  struct build_item
+  {
+    bbox_type bounds;
+    vec_type center;
+    U data;
+  };
+
+  std::vector<node> m_nodes;
+  std::vector<U> m_data;
+
+public:
+  bvh() = default;
+
+  /**
+   * Builds a tree from the given bounding boxes and data.
+   *
+   * @param items pairs of bounding boxes and their associated data
+   * @param max_leaf_size the maximum number of data items stored in a leaf, unless the
+   * items cannot be split further
+   */
+  explicit bvh(
+    std::vector<std::pair<bbox_type, U>> items,
+    const size_t max_leaf_size = default_max_leaf_size)
+  {
+    if (items.empty())
+    {
+      return;
+    }
+
+    auto build_items = std::vector<build_item>{};
+    build_items.reserve(items.size());
+    for (auto& [bounds, data] : items)
+    {
+      build_items.push_back(build_item{bounds, bounds.center(), std::move(data)});
+    }
+
+    m_nodes.reserve(2 * items.size() / std::max(size_t(1), max_leaf_size) + 1);
+    m_data.reserve(items.size());
+    build(build_items.begin(), build_items.end(), std::max(size_t(1), max_leaf_size), 0);
+
+    m_nodes.shrink_to_fit();
+  }
+
+  /**
+   * Indicates whether this tree contains any data.
+   */
+  bool empty() const { return m_data.empty(); }
+
+  /**
+   * Returns the number of data items stored in this tree.
+   */
+  size_t size() const { return m_data.size(); }
+
+  /**
+   * Returns the number of nodes in this tree.
+   */
+  size_t node_count() const { return m_nodes.size(); }
+
+  /**
+   * Returns the bounds of all data items in this tree. The tree must not be empty.
+   */
+  const bbox_type& bounds() const
+  {
+    assert(!empty());
+    return m_nodes.front().bounds;
+  }
+
+  /**
+   * Returns the approximate number of bytes occupied by this tree.
+   */
+  size_t memory_usage() const
+  {
+    return sizeof(*this) + m_nodes.capacity() * sizeof(node)
+           + m_data.capacity() * sizeof(U);
+  }
+
+  /**
+   * Finds the closest intersection of the given ray with the data in this tree.
+   *
+   * The given intersector is called with the data items stored in every leaf that is hit
+   * by the given ray and must return the distance from the ray origin to the point of
+   * intersection of the ray and the given data item, or nullopt if the ray doesn't
+   * intersect the data item. The nodes are visited front to back, and nodes that are
+   * farther away than the closest intersection found so far are skipped.
+   *
+   * @return the distance to the closest intersection, or nullopt if no data item is hit
+   */
+  template <typename F>
+  std::optional<T> intersect(const ray_type& ray, const F& intersector) const
+  {
+    if (empty())
+    {
+      return std::nullopt;
+    }
+
+    const auto inv_direction = vec_type{
+      T(1) / ray.direction.x(), T(1) / ray.direction.y(), T(1) / ray.direction.z()};
+
+    auto closest = std::numeric_limits<T>::max();
+    auto found = false;
+
+    // the stack never holds more than one entry per level of the tree
+    auto stack = std::array<uint32_t, max_depth + 2>{};
+    auto stack_size = size_t(0);
+
+    if (intersect_bounds(ray, inv_direction, m_nodes.front().bounds, closest))
+    {
+      stack[stack_size++] = 0;
+    }
+
+    while (stack_size > 0)
+    {
+      const auto current_index = stack[--stack_size];
+      const auto& current = m_nodes[current_index];
+      if (current.count > 0)
+      {
+        for (uint32_t i = current.offset; i < current.offset + current.count; ++i)
+        {
+          if (const auto distance = intersector(m_data[i]);
+              distance && *distance < closest)
+          {
+            closest = *distance;
+            found = true;
+          }
+        }
+      }
+      else
+      {
+        const auto left_index = current_index + 1;
+        const auto right_index = current.offset;
+
+        const auto left_distance =
+          intersect_bounds(ray, inv_direction, m_nodes[left_index].bounds, closest);
+        const auto right_distance =
+          intersect_bounds(ray, inv_direction, m_nodes[right_index].bounds, closest);
+
+        // push the farther child first so that the closer child is visited first
+        if (left_distance && right_distance)
+        {
+          if (*left_distance < *right_distance)
+          {
+            stack[stack_size++] = right_index;
+            stack[stack_size++] = left_index;
+          }
+          else
+          {
+            stack[stack_size++] = left_index;
+            stack[stack_size++] = right_index;
+          }
+        }
+        else if (left_distance)
+        {
+          stack[stack_size++] = left_index;
+        }
+        else if (right_distance)
+        {
+          stack[stack_size++] = right_index;
+        }
+      }
+    }
+
+    return found ? std::optional<T>{closest} : std::nullopt;
+  }
+
+  /**
+   * Returns the data items of all leafs whose bounds are hit by the given ray.
+   */
+  std::vector<U> find_intersectors(const ray_type& ray) const
+  {
+    auto result = std::vector<U>{};
+    intersect(ray, [&](const U& data) {
+      result.push_back(data);
+      return std::optional<T>{};
+    });
+    return result;
+  }
+
+private:
+  /**
+   * Intersects the given ray with the given bounds using the slab method. Returns the
+   * distance at which the ray enters the bounds (0 if the ray origin is contained in the
+   * bounds), or nullopt if the ray misses the bounds or enters them at or beyond the given
+   * maximum distance.
+   */
+  static std::optional<T> intersect_bounds(
+    const ray_type& ray,
+    const vec_type& inv_direction,
+    const bbox_type& bounds,
+    const T max_distance)
+  {
+    auto t_min = T(0);
+    auto t_max = max_distance;
+
+    for (size_t i = 0; i < 3; ++i)
+    {
+      const auto t1 = (bounds.min[i] - ray.origin[i]) * inv_direction[i];
+      const auto t2 = (bounds.max[i] - ray.origin[i]) * inv_direction[i];
+
+      // comparisons with NaN are false, so NaN values (which occur if the ray lies in a
+      // slab plane) leave the interval unchanged
+      const auto t_near = t1 < t2 ? t1 : t2;
+      const auto t_far = t1 < t2 ? t2 : t1;
+      t_min = t_near > t_min ? t_near : t_min;
+      t_max = t_far < t_max ? t_far : t_max;
+    }
+
+    return t_min <= t_max ? std::optional<T>{t_min} : std::nullopt;
+  }
+
+  using item_iterator = typename std::vector<build_item>::iterator;
+
+  static T half_area(const bbox_type& bounds)
+  {
+    const auto size = bounds.size();
+    return size.x() * size.y() + size.y() * size.z() + size.z() * size.x();
+  }
+
+  uint32_t build(
+    const item_iterator first,
+    const item_iterator last,
+    const size_t max_leaf_size,
+    const size_t depth)
+  {
+    const auto count = size_t(std::distance(first, last));
+    assert(count > 0);
+
+    auto bounds_builder = typename bbox_type::builder{};
+    auto center_builder = typename bbox_type::builder{};
+    for (auto it = first; it != last; ++it)
+    {
+      bounds_builder.add(it->bounds);
+      center_builder.add(it->center);
+    }
+
+    const auto node_index = uint32_t(m_nodes.size());
+    m_nodes.push_back(node{bounds_builder.bounds(), 0, 0});
+
+    if (count <= max_leaf_size)
+    {
+      make_leaf(node_index, first, last);
+      return node_index;
+    }
+
+    const auto center_bounds = center_builder.bounds();
+    const auto split = depth < max_sah_depth
+                         ? find_split(first, last, bounds_builder.bounds(), center_bounds)
+                         : std::nullopt;
+
+    auto middle = first;
+    if (split)
+    {
+      const auto [axis, position] = *split;
+      middle = std::partition(
+        first, last, [&](const auto& item) { return item.center[axis] < position; });
+    }
+
+    if (middle == first || middle == last)
+    {
+      if (!split && depth < max_sah_depth && count <= max_leaf_size * 4)
+      {
+        // splitting isn't worth it, and the leaf is still reasonably small
+        make_leaf(node_index, first, last);
+        return node_index;
+      }
+
+      // fall back to a median split along the largest axis of the centers
+      const auto axis = vm::find_abs_max_component(center_bounds.size());
+      middle = first + std::ptrdiff_t(count / 2);
+      std::nth_element(first, middle, last, [&](const auto& lhs, const auto& rhs) {
+        return lhs.center[axis] < rhs.center[axis];
+      });
+    }
+
+    build(first, middle, max_leaf_size, depth + 1);
+    const auto right_index = build(middle, last, max_leaf_size, depth + 1);
+    m_nodes[node_index].offset = right_index;
+
+    return node_index;
+  }
+
+  void make_leaf(
+    const uint32_t node_index, const item_iterator first, const item_iterator last)
+  {
+    m_nodes[node_index].offset = uint32_t(m_data.size());
+    m_nodes[node_index].count = uint32_t(std::distance(first, last));
+    for (auto it = first; it != last; ++it)
+    {
+      m_data.push_back(std::move(it->data));
+    }
+  }
+
+  /**
+   * Finds the split plane with the lowest SAH cost by binning the item centers along
+   * each axis. Returns nullopt if no split is cheaper than creating a leaf.
+   */
+  static std::optional<std::pair<size_t, T>> find_split(
+    const item_iterator first,
+    const item_iterator last,
+    const bbox_type& bounds,
+    const bbox_type& center_bounds)
+  {
+    struct bin
+    {
+      typename bbox_type::builder bounds;
+      size_t count = 0;
+    };
+
+    const auto count = size_t(std::distance(first, last));
+    auto best_cost = T(count) * half_area(bounds);
+    auto best_split = std::optional<std::pair<size_t, T>>{};
+
+    for (size_t axis = 0; axis < 3; ++axis)
+    {
+      const auto min = center_bounds.min[axis];
+      const auto extent = center_bounds.max[axis] - min;
+      if (extent <= T(0))
+      {
+        continue;
+      }
+
+      auto bins = std::array<bin, bin_count>{};
+      const auto scale = T(bin_count) / extent;
+      for (auto it = first; it != last; ++it)
+      {
+        const auto b = std::min(bin_count - 1, size_t((it->center[axis] - min) * scale));
+        bins[b].bounds.add(it->bounds);
+        ++bins[b].count;
+      }
+
+      // sweep from the right to compute the costs of the right partitions
+      auto right_areas = std::array<T, bin_count>{};
+      auto right_counts = std::array<size_t, bin_count>{};
+      auto right_bounds = typename bbox_type::builder{};
+      auto right_count = size_t(0);
+      for (size_t i = bin_count - 1; i > 0; --i)
+      {
+        if (bins[i].count > 0)
+        {
+          right_bounds.add(bins[i].bounds.bounds());
+          right_count += bins[i].count;
+        }
+        right_areas[i] = right_count > 0 ? half_area(right_bounds.bounds()) : T(0);
+        right_counts[i] = right_count;
+      }
+
+      // sweep from the left and evaluate each split
+      auto left_bounds = typename bbox_type::builder{};
+      auto left_count = size_t(0);
+      for (size_t i = 0; i < bin_count - 1; ++i)
+      {
+        if (bins[i].count > 0)
+        {
+          left_bounds.add(bins[i].bounds.bounds());
+          left_count += bins[i].count;
+        }
+
+        if (left_count == 0 || right_counts[i + 1] == 0)
+        {
+          continue;
+        }
+
+        const auto cost = T(left_count) * half_area(left_bounds.bounds())
+                          + T(right_counts[i + 1]) * right_areas[i + 1];
+        if (cost < best_cost)
+        {
+          best_cost = cost;
+          best_split = {axis, min + T(i + 1) / scale};
+        }
+      }
+    }
+
+    return best_split;
+  }
+};
+
+} // namespace TrenchBroom
@@ -23,6 +23,7 @@
 #include "Exceptions.h"
 
 #include "kdl/overload.h"
+#include "kdl/parallel.h"
 #include "kdl/reflection_decl.h"
 #include "kdl/reflection_impl.h"
 #include "kdl/vector_utils.h"
@@ -39,6 +40,8 @@
 #include <optional>
 #include <ostream>
 #include <unordered_map>
+#include <unordered_set>
+#include <utility>
 #include <variant>
 #include <vector>
 
@@ -335,26 +338,31 @@ private:
             i.data.erase(i_data);
           }
 
-          if (!is_root(i.address))
-          {
-            const auto is_non_empty_child = [](const auto& c) {
-              return is_inner_node(c) || !get_data(c).empty();
-            };
-            const auto num_non_empty_children =
-              std::count_if(i.children.begin(), i.children.end(), is_non_empty_child);
-            if (num_non_empty_children == 0)
-            {
-              node = leaf_node{i.address, std::move(i.data)};
-            }
-            else if (num_non_empty_children == 1 && i.data.empty())
-            {
-              const auto i_non_empty_child =
-                std::find_if(i.children.begin(), i.children.end(), is_non_empty_child);
-              assert(i_non_empty_child != i.children.end());
+          collapse_inner_node(node, i);
+        },
+        [&](leaf_node& l) {
+          const auto i_data = std::find(l.data.begin(), l.data.end(), data);
+          assert(i_data != l.data.end());
+          l.data.erase(i_data);
+        }),
+      node);
+  }
 
-              auto child = std::move(*i_non_empty_child);
-              node = std::move(child);
-            }
+  static void erase_from_node(
+    node& node, const detail::node_address& address, const U& data)
+  {
+    std::visit(
+      kdl::overload(
+        [&](inner_node& i) {
+          if (const auto quadrant = get_quadrant(i.address, address))
+          {
+            erase_from_node(i.children[*quadrant], address, data);
+          }
+          else
+          {
+            const auto i_data = std::find(i.data.begin(), i.data.end(), data);
+            assert(i_data != i.data.end());
+            i.data.erase(i_data);
           }
         },
         [&](leaf_node& l) {
@@ -365,6 +373,58 @@ private:
       node);
   }
 
+  /**
+   * Collapses the inner nodes on the paths to the given addresses from the bottom up, as
+   * remove_from_node does for a single address.
+   */
+  static void compact_node(node& node, const std::vector<detail::node_address>& addresses)
+  {
+    std::visit(
+      kdl::overload(
+        [&](inner_node& i) {
+          for (auto& child : i.children)
+          {
+            const auto& child_address = get_address(child);
+            auto child_addresses = kdl::vec_filter(addresses, [&](const auto& address) {
+              return child_address.contains(address);
+            });
+            if (!child_addresses.empty())
+            {
+              compact_node(child, child_addresses);
+            }
+          }
+
+          collapse_inner_node(node, i);
+        },
+        [](leaf_node&) {}),
+      node);
+  }
+
+  static void collapse_inner_node(node& node, inner_node& i)
+  {
+    if (!is_root(i.address))
+    {
+      const auto is_non_empty_child = [](const auto& c) {
+        return is_inner_node(c) || !get_data(c).empty();
+      };
+      const auto num_non_empty_children =
+        std::count_if(i.children.begin(), i.children.end(), is_non_empty_child);
+      if (num_non_empty_children == 0)
+      {
+        node = leaf_node{i.address, std::move(i.data)};
+      }
+      else if (num_non_empty_children == 1 && i.data.empty())
+      {
+        const auto i_non_empty_child =
+          std::find_if(i.children.begin(), i.children.end(), is_non_empty_child);
+        assert(i_non_empty_child != i.children.end());
+
+        auto child = std::move(*i_non_empty_child);
+        node = std::move(child);
+      }
+    }
+  }
+
 private:
   std::optional<node> m_root;
   T m_min_size;
@@ -415,41 +475,7 @@ public:
   void insert(const vm::bbox<T, 3>& bounds, U data)
   {
     check(bounds);
-
-    if (contains(data))
-    {
-      throw NodeTreeException("Data already in tree");
-    }
-
-    const auto address = detail::get_container(bounds, m_min_size);
-    if (is_root(address))
-    {
-      if (!m_root)
-      {
-        m_root = leaf_node{address, {}};
-      }
-      else if (!get_address(*m_root).contains(address))
-      {
-        update_root_address(*m_root, address, m_node_address_for_data);
-      }
-
-      get_data(*m_root).push_back(std::move(data));
-      m_node_address_for_data.emplace(data, get_address(*m_root));
-    }
-    else
-    {
-      if (!m_root)
-      {
-        m_root = inner_node{get_root(address), {}};
-      }
-      else if (!get_address(*m_root).contains(address))
-      {
-        update_root_address(*m_root, get_root(address), m_node_address_for_data);
-      }
-
-      insert_into_node(*m_root, address, std::move(data));
-      m_node_address_for_data.emplace(data, address);
-    }
+    insert_at(detail::get_container(bounds, m_min_size), std::move(data));
   }
 
 
@@ -513,6 +539,121 @@ public:
    */
   bool empty() const { return m_root == std::nullopt; }
 
+  /**
+   * Returns the number of data items in this tree.
+   */
+  size_t size() const { return m_node_address_for_data.size(); }
+
+  /**
+   * Returns an estimate of the number of bytes used by this tree. The estimate does not
+   * account for allocator overhead.
+   */
+  size_t memory_usage() const
+  {
+    // every element of an std::unordered_map is stored in a separately allocated node
+    // along with a pointer to the next node and its hash
+    constexpr auto map_node_overhead = sizeof(void*) + sizeof(size_t);
+
+    auto visitor = kdl::overload(
+      [](auto&& self, const inner_node& node) -> size_t {
+        auto result = node.data.capacity() * sizeof(U)
+                      + node.children.capacity() * sizeof(octree::node);
+        for (const auto& child : node.children)
+        {
+          result += std::visit([&](const auto& c) { return self(self, c); }, child);
+        }
+        return result;
+      },
+      [](auto&&, const leaf_node& node) -> size_t {
+        return node.data.capacity() * sizeof(U);
+      });
+
+    using map_value_type = typename decltype(m_node_address_for_data)::value_type;
+
+    auto result = sizeof(octree) + m_node_address_for_data.bucket_count() * sizeof(void*)
+                  + m_node_address_for_data.size()
+                      * (map_node_overhead + sizeof(map_value_type));
+    if (m_root)
+    {
+      result +=
+        std::visit([&](const auto& node) { return visitor(visitor, node); }, *m_root);
+    }
+    return result;
+  }
+
+  /**
+   * Removes the given data items from this tree and inserts the given items in one go.
+   *
+   * If more than the given fraction of the items in this tree are changed, the tree is
+   * rebuilt from scratch, and the addresses of the inserted items are computed in
+   * parallel. Otherwise, the items are removed first, and the inner nodes that are left
+   * empty or with a single child are collapsed once afterwards instead of after every
+   * removal. Then the new items are inserted.
+   *
+   * @param to_remove the data items to remove
+   * @param to_insert the data items to insert along with their bounds
+   * @param rebuild_fraction the fraction of changed items above which the tree is rebuilt
+   *
+   * @throws NodeTreeException if any of the data items to remove cannot be found in this
+   * tree, or if any of the items to insert is already in this tree or has invalid bounds
+   */
+  void apply(
+    const std::vector<U>& to_remove,
+    std::vector<std::pair<vm::bbox<T, 3>, U>> to_insert,
+    const double rebuild_fraction)
+  {
+    for (const auto& data : to_remove)
+    {
+      if (!contains(data))
+      {
+        throw NodeTreeException("node not found");
+      }
+    }
+
+    const auto removed = std::unordered_set<U>{to_remove.begin(), to_remove.end()};
+    for (const auto& [bounds, data] : to_insert)
+    {
+      check(bounds);
+      if (contains(data) && removed.count(data) == 0)
+      {
+        throw NodeTreeException("Data already in tree");
+      }
+    }
+
+    const auto num_changes = double(to_remove.size() + to_insert.size());
+    if (num_changes > rebuild_fraction * double(size()))
+    {
+      rebuild(to_remove, std::move(to_insert));
+    }
+    else
+    {
+      auto removed_addresses = std::vector<detail::node_address>{};
+      removed_addresses.reserve(to_remove.size());
+
+      for (const auto& data : to_remove)
+      {
+        const auto i_address = m_node_address_for_data.find(data);
+        erase_from_node(*m_root, i_address->second, data);
+        removed_addresses.push_back(i_address->second);
+        m_node_address_for_data.erase(i_address);
+      }
+
+      if (m_node_address_for_data.empty())
+      {
+        m_root = std::nullopt;
+      }
+      else if (!removed_addresses.empty())
+      {
+        compact_node(*m_root, removed_addresses);
+      }
+
+      for (auto& [bounds, data] : to_insert)
+      {
+        insert(bounds, std::move(data));
+      }
+    }
+  }
+
   /**
    * Finds every data item in this tree whose bounding box intersects with the given ray
    * and returns a list of those items.
@@ -635,6 +776,70 @@ public:
   kdl_reflect_inline(octree, m_root, m_min_size, m_node_address_for_data);
 
 private:
+  void rebuild(
+    const std::vector<U>& to_remove, std::vector<std::pair<vm::bbox<T, 3>, U>> to_insert)
+  {
+    const auto min_size = m_min_size;
+    auto inserted_addresses =
+      kdl::vec_parallel_transform(std::move(to_insert), [&](auto&& bounds_and_data) {
+        auto& [bounds, data] = bounds_and_data;
+        return std::pair{detail::get_container(bounds, min_size), std::move(data)};
+      });
+
+    auto retained_addresses = std::move(m_node_address_for_data);
+    for (const auto& data : to_remove)
+    {
+      retained_addresses.erase(data);
+    }
+
+    clear();
+    for (auto& [data, address] : retained_addresses)
+    {
+      insert_at(address, data);
+    }
+    for (auto& [address, data] : inserted_addresses)
+    {
+      insert_at(address, std::move(data));
+    }
+  }
+
+  void insert_at(const detail::node_address& address, U data)
+  {
+    if (contains(data))
+    {
+      throw NodeTreeException("Data already in tree");
+    }
+
+    if (is_root(address))
+    {
+      if (!m_root)
+      {
+        m_root = leaf_node{address, {}};
+      }
+      else if (!get_address(*m_root).contains(address))
+      {
+        update_root_address(*m_root, address, m_node_address_for_data);
+      }
+
+      get_data(*m_root).push_back(std::move(data));
+      m_node_address_for_data.emplace(data, get_address(*m_root));
+    }
+    else
+    {
+      if (!m_root)
+      {
+        m_root = inner_node{get_root(address), {}};
+      }
+      else if (!get_address(*m_root).contains(address))
+      {
+        update_root_address(*m_root, get_root(address), m_node_address_for_data);
+      }
+
+      insert_into_node(*m_root, address, std::move(data));
+      m_node_address_for_data.emplace(data, address);
+    }
+  }
+
   void check(const vm::bbox<T, 3>& bounds) const
   {
     if (vm::is_nan(bounds.min) || vm::is_nan(bounds.max))
@@ -158,6 +158,34 @@ TEST_CASE("ResourceManager")
     CHECK(resourceManager.resources() == std::vector{resource1, resource2});
   }
 
+  SECTION("prioritize")
+  {
+    auto resource1 = std::make_shared<ResourceT>(mockResourceLoader);
+    auto resource2 = std::make_shared<ResourceT>(mockResourceLoader);
+    auto resource3 = std::make_shared<ResourceT>(mockResourceLoader);
+    resourceManager.addResource(resource1);
+    resourceManager.addResource(resource2);
+    resourceManager.addResource(resource3);
+
+    resourceManager.prioritize(resource3->id());
+    resourceManager.prioritize(resource2->id());
+    resourceManager.prioritize(resource3->id());
+    resourceManager.prioritize(ResourceId{});
+    CHECK(resourceManager.resources() == std::vector{resource1, resource2, resource3});
+
+    CHECK(
+      resourceManager.process(taskRunner, processContext)
+      == std::vector{resource2->id(), resource3->id(), resource1->id()});
+    CHECK(resourceManager.resources() == std::vector{resource2, resource3, resource1});
+
+    resourceManager.prioritize(resource1->id());
+    resourceManager.process(taskRunner, processContext);
+    CHECK(resourceManager.resources() == std::vector{resource1, resource2, resource3});
+
+    resourceManager.process(taskRunner, processContext);
+    CHECK(resourceManager.resources() == std::vector{resource1, resource2, resource3});
+  }
+
   SECTION("process")
   {
     SECTION("resource loading")
@@ -0,0 +1,105 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "EL/EvaluationCache.h"
+#include "EL/Expression.h"
+#include "EL/Value.h"
+#include "EL/VariableStore.h"
+#include "IO/ELParser.h"
+
+#include <string>
+
+#include "Catch2.h"
+
+namespace TrenchBroom::EL
+{
+
+TEST_CASE("EvaluationCache")
+{
+  const auto expression = IO::ELParser::parseStrict(R"({{
+      spawnflags == 1 -> "maps/b_shell0.bsp",
+                          "maps/b_shell1.bsp"
+  }})");
+
+  auto cache = EvaluationCache{};
+
+  SECTION("Caches results for string variables")
+  {
+    CHECK(
+      cache.evaluate(expression, VariableTable{{{"spawnflags", Value{"1"}}}})
+      == Value{"maps/b_shell0.bsp"});
+    CHECK(cache.size() == 1);
+
+    CHECK(
+      cache.evaluate(expression, VariableTable{{{"spawnflags", Value{"1"}}}})
+      == Value{"maps/b_shell0.bsp"});
+    CHECK(cache.size() == 1);
+
+    CHECK(
+      cache.evaluate(expression, VariableTable{{{"spawnflags", Value{"0"}}}})
+      == Value{"maps/b_shell1.bsp"});
+    CHECK(cache.size() == 2);
+
+    CHECK(
+      cache.evaluate(expression, VariableTable{{{"spawnflags", Value{"1"}}}})
+      == Value{"maps/b_shell0.bsp"});
+    CHECK(cache.size() == 2);
+  }
+
+  SECTION("Does not cache results for other variables")
+  {
+    CHECK(
+      cache.evaluate(expression, VariableTable{{{"spawnflags", Value{1}}}})
+      == Value{"maps/b_shell0.bsp"});
+    CHECK(
+      cache.evaluate(expression, VariableTable{}) == Value{"maps/b_shell1.bsp"});
+    CHECK(cache.size() == 0);
+  }
+
+  SECTION("Copies are empty")
+  {
+    cache.evaluate(expression, VariableTable{{{"spawnflags", Value{"1"}}}});
+    REQUIRE(cache.size() == 1);
+
+    const auto copy = cache;
+    CHECK(copy.size() == 0);
+  }
+
+  SECTION("Evicts the least recently used result when full")
+  {
+    for (size_t i = 0; i <= EvaluationCache::MaxEntries; ++i)
+    {
+      cache.evaluate(expression, VariableTable{{{"spawnflags", Value{"1"}}}});
+      cache.evaluate(
+        expression, VariableTable{{{"spawnflags", Value{std::to_string(i + 2)}}}});
+    }
+    CHECK(cache.size() == EvaluationCache::MaxEntries);
+  }
+
+  SECTION("clear")
+  {
+    cache.evaluate(expression, VariableTable{{{"spawnflags", Value{"1"}}}});
+    REQUIRE(cache.size() == 1);
+
+    cache.clear();
+    CHECK(cache.size() == 0);
+  }
+}
+
+} // namespace TrenchBroom::EL
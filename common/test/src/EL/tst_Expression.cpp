@@ -746,5 +746,25 @@ TEST_CASE("ExpressionTest.testOptimize")
 
   CHECK(IO::ELParser::parseStrict(expression).optimize() == expectedExpression);
 }
+
+TEST_CASE("ExpressionTest.variableNames")
+{
+  using T = std::tuple<std::string, std::vector<std::string>>;
+
+  // clang-format off
+  const auto
+  [expression,                             expectedVariableNames] = GENERATE(values<T>({
+  {"3 + 7",                                {}},
+  {"a",                                    {"a"}},
+  {"[b, a, -b]",                           {"a", "b"}},
+  {"{x: a, y: b[c]}",                      {"a", "b", "c"}},
+  {"{{ a == 1 -> b, !c -> 'd', e || f }}", {"a", "b", "c", "e", "f"}},
+  }));
+  // clang-format on
+
+  CAPTURE(expression);
+
+  CHECK(IO::ELParser::parseStrict(expression).variableNames() == expectedVariableNames);
+}
 } // namespace EL
 } // namespace TrenchBroom
@@ -31,6 +31,7 @@
 #include "Model/LockState.h"
 #include "Model/MapFormat.h"
 #include "Model/PatchNode.h"
+#include "Model/SerializedText.h"
 #include "Model/VisibilityState.h"
 #include "Model/WorldNode.h"
 #include "TestUtils.h"
@@ -47,6 +48,7 @@
 #include <fmt/format.h>
 
 #include <iostream>
+#include <memory>
 #include <sstream>
 #include <vector>
 
@@ -308,6 +310,55 @@ TEST_CASE("NodeWriterTest.writeWorldspawnWithBrushInDefaultLayer")
   CHECK(actual == expected);
 }
 
+TEST_CASE("NodeWriterTest.reuseSerializedText")
+{
+  const auto worldBounds = vm::bbox3{8192.0};
+
+  auto map = Model::WorldNode{{}, {}, Model::MapFormat::Standard};
+
+  auto builder = Model::BrushBuilder{map.mapFormat(), worldBounds};
+  auto* brushNode = new Model::BrushNode{builder.createCube(64.0, "none") | kdl::value()};
+  map.defaultLayer()->addChild(brushNode);
+
+  const auto writeMap = [&]() {
+    auto str = std::stringstream{};
+    auto writer = NodeWriter{map, str};
+    writer.writeMap();
+    return str.str();
+  };
+
+  CHECK(brushNode->serializedText() == nullptr);
+
+  const auto original = writeMap();
+  const auto serializedText = brushNode->serializedText();
+  REQUIRE(serializedText != nullptr);
+  CHECK(serializedText->format == Model::MapFormat::Standard);
+  CHECK(serializedText->lineCount == 6u);
+
+  CHECK(writeMap() == original);
+  CHECK(brushNode->serializedText() == serializedText);
+
+  SECTION("Clones share the serialized text")
+  {
+    auto clone = std::unique_ptr<Model::BrushNode>{static_cast<Model::BrushNode*>(
+      brushNode->clone(worldBounds, Model::SetLinkId::keep))};
+    CHECK(clone->serializedText() == serializedText);
+  }
+
+  SECTION("Changing the brush invalidates the serialized text")
+  {
+    auto brush = brushNode->brush();
+    const auto transform = vm::translation_matrix(vm::vec3{32, 0, 0});
+    REQUIRE(brush.transform(worldBounds, transform, false).is_success());
+    brushNode->setBrush(std::move(brush));
+    CHECK(brushNode->serializedText() == nullptr);
+
+    const auto changed = writeMap();
+    CHECK(changed != original);
+    CHECK(changed.find("( 64 32 32 )") != std::string::npos);
+  }
+}
+
 TEST_CASE("NodeWriterTest.writeWorldspawnWithBrushInCustomLayer")
 {
   const auto worldBounds = vm::bbox3{8192.0};
@@ -36,11 +36,16 @@
 #include "kdl/result.h"
 #include "kdl/result_io.h"
 
+#include "vm/mat.h"
+#include "vm/mat_ext.h"
+#include "vm/vec.h"
+
 #include <fmt/format.h>
 
 #include <memory>
 #include <optional>
 #include <sstream>
+#include <string>
 
 #include "Catch2.h"
 
@@ -48,6 +53,24 @@ namespace TrenchBroom
 {
 namespace IO
 {
+namespace
+{
+size_t countLines(const std::string& str, const std::string& prefix)
+{
+  auto count = size_t(0);
+  auto line = std::string{};
+  auto stream = std::istringstream{str};
+  while (std::getline(stream, line))
+  {
+    if (line.starts_with(prefix))
+    {
+      ++count;
+    }
+  }
+  return count;
+}
+} // namespace
+
 TEST_CASE("ObjSerializer.writeBrush")
 {
   const auto worldBounds = vm::bbox3{8192.0};
@@ -115,6 +138,50 @@ f  8/4/6  5/3/6  6/2/6  7/1/6
 )");
 }
 
+TEST_CASE("ObjSerializer.writeMultipleBrushes")
+{
+  const auto worldBounds = vm::bbox3{8192.0};
+
+  auto map = Model::WorldNode{{}, {}, Model::MapFormat::Quake3};
+
+  auto builder = Model::BrushBuilder{map.mapFormat(), worldBounds};
+  for (const auto x : {0.0, 64.0})
+  {
+    auto brush = builder.createCube(64.0, "some_material") | kdl::value();
+    REQUIRE(brush.transform(worldBounds, vm::translation_matrix(vm::vec3{x, 0, 0}), false)
+              .is_success());
+    map.defaultLayer()->addChild(new Model::BrushNode{std::move(brush)});
+  }
+
+  const auto writeMap = [&]() {
+    auto objStream = std::ostringstream{};
+    auto mtlStream = std::ostringstream{};
+    const auto objOptions =
+      ObjExportOptions{"/some/export/path.obj", ObjMtlPathMode::RelativeToGamePath};
+
+    auto writer = NodeWriter{
+      map,
+      std::make_unique<ObjSerializer>(
+        objStream, mtlStream, "some_file_name.mtl", objOptions)};
+    writer.writeMap();
+    return objStream.str();
+  };
+
+  const auto obj = writeMap();
+
+  // vertex positions are only shared within an object, normals are shared by all objects
+  CHECK(countLines(obj, "v ") == 16);
+  CHECK(countLines(obj, "vn ") == 6);
+  CHECK(
+    obj.find(R"(o entity0_brush1
+usemtl some_material
+f  9/)")
+    != std::string::npos);
+
+  // writing the same map again produces the same output
+  CHECK(writeMap() == obj);
+}
+
 TEST_CASE("ObjSerializer.writePatch")
 {
   const auto worldBounds = vm::bbox3{8192.0};
@@ -411,6 +411,55 @@ TEST_CASE("WorldReader.parseValveBrush")
   checkBrushUVCoordSystem(brush, true);
 }
 
+TEST_CASE("WorldReader.convertStandardToValve")
+{
+  const auto data = R"(
+{
+"classname" "worldspawn"
+{
+( -0 -0 -16 ) ( -0 -0  -0 ) ( 64 -0 -16 ) tex1 1 2 3 4 5
+( -0 -0 -16 ) ( -0 64 -16 ) ( -0 -0  -0 ) tex2 0 0 0 1 1
+( -0 -0 -16 ) ( 64 -0 -16 ) ( -0 64 -16 ) tex3 0 0 0 1 1
+( 64 64  -0 ) ( -0 64  -0 ) ( 64 64 -16 ) tex4 0 0 0 1 1
+( 64 64  -0 ) ( 64 64 -16 ) ( 64 -0  -0 ) tex5 0 0 0 1 1
+( 64 64  -0 ) ( 64 -0  -0 ) ( -0 64  -0 ) tex6 0 0 0 1 1
+}
+})";
+  const auto worldBounds = vm::bbox3{8192.0};
+
+  auto status = TestParserStatus{};
+
+  SECTION("Reader converts to the target format")
+  {
+    auto reader =
+      WorldReader{data, Model::MapFormat::Standard, Model::MapFormat::Valve, {}};
+    auto world = reader.read(worldBounds, status);
+
+    CHECK(world->mapFormat() == Model::MapFormat::Valve);
+    auto* defaultLayer = world->children().front();
+    REQUIRE(defaultLayer->childCount() == 1u);
+    auto* brush = static_cast<Model::BrushNode*>(defaultLayer->children().front());
+    checkBrushUVCoordSystem(brush, true);
+  }
+
+  SECTION("tryRead converts to the target format")
+  {
+    auto world = WorldReader::tryRead(
+      data,
+      {Model::MapFormat::Valve, Model::MapFormat::Standard},
+      Model::MapFormat::Valve,
+      worldBounds,
+      {},
+      status);
+
+    CHECK(world->mapFormat() == Model::MapFormat::Valve);
+    auto* defaultLayer = world->children().front();
+    REQUIRE(defaultLayer->childCount() == 1u);
+    auto* brush = static_cast<Model::BrushNode*>(defaultLayer->children().front());
+    checkBrushUVCoordSystem(brush, true);
+  }
+}
+
 TEST_CASE("WorldReader.parseQuake2Brush")
 {
   const auto data = R"(
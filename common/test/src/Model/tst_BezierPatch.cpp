@@ -60,6 +60,32 @@ TEST_CASE("BezierPatch.evaluate")
   CHECK(patch.evaluate(subdiv) == expectedGrid);
 }
 
+TEST_CASE("BezierPatch.evaluateWithSubdivisionsPerSurface")
+{
+  // clang-format off
+  const auto patch = BezierPatch{5, 3, { {0, 2,   0}, {1, 2,   0}, {2, 2,   0},
+                                         {0, 1.5, 0}, {1, 1.5, 0}, {2, 1.5, 0},
+                                         {0, 1,   0}, {1, 1,   0}, {2, 1,   0},
+                                         {0, 0.5, 0}, {1, 0.5, 0}, {2, 0.5, 0},
+                                         {0, 0,   0}, {1, 0,   0}, {2, 0,   0} }, ""};
+  // clang-format on
+
+  SECTION("Same subdivisions for every surface")
+  {
+    CHECK(patch.evaluate({1, 1}, {1}) == patch.evaluate(1));
+  }
+
+  SECTION("Different subdivisions per surface row")
+  {
+    // clang-format off
+    CHECK(patch.evaluate({1, 0}, {0}) == std::vector<BezierPatch::Point>{ {0, 2,   0}, {2, 2,   0},
+                                                                          {0, 1.5, 0}, {2, 1.5, 0},
+                                                                          {0, 1,   0}, {2, 1,   0},
+                                                                          {0, 0,   0}, {2, 0,   0} });
+    // clang-format on
+  }
+}
+
 TEST_CASE("BezierPatch.transform")
 {
   // clang-format off
@@ -40,14 +40,19 @@
 #include "kdl/vector_utils.h"
 
 #include "vm/approx.h"
+#include "vm/mat.h"
+#include "vm/mat_ext.h"
 #include "vm/polygon.h"
 #include "vm/ray.h"
+#include "vm/scalar.h"
 #include "vm/segment.h"
 #include "vm/vec.h"
 #include "vm/vec_ext.h"
 
+#include <algorithm>
 #include <fstream>
 #include <string>
+#include <tuple>
 #include <vector>
 
 #include "Catch2.h"
@@ -159,6 +164,130 @@ TEST_CASE("BrushTest.clip")
   CHECK_FALSE(brush.findFace(right.boundary()));
 }
 
+TEST_CASE("BrushTest.memoryUsage")
+{
+  const auto worldBounds = vm::bbox3{8192.0};
+  const auto builder = BrushBuilder{MapFormat::Standard, worldBounds};
+
+  const auto cube = builder.createCube(64.0, "material") | kdl::value();
+  const auto usage = cube.memoryUsage();
+  CHECK(usage > sizeof(Brush) + cube.faceCount() * sizeof(BrushFace));
+  CHECK(usage < 16u * 1024u);
+
+  const auto longMaterialName = std::string(64, 'x');
+  const auto cubeWithLongMaterialNames =
+    builder.createCube(64.0, longMaterialName) | kdl::value();
+  CHECK(
+    cubeWithLongMaterialNames.memoryUsage()
+    > usage + cube.faceCount() * longMaterialName.size());
+}
+
+TEST_CASE("BrushTest.packedFaces")
+{
+  const auto worldBounds = vm::bbox3{8192.0};
+  const auto builder = BrushBuilder{MapFormat::Standard, worldBounds};
+
+  auto brush = builder.createCube(64.0, "material") | kdl::value();
+
+  SECTION("Packed faces are rebuilt with the geometry")
+  {
+    const auto face =
+      createParaxial(vm::vec3{0, 0, 0}, vm::vec3{0, 1, 0}, vm::vec3{1, 0, 1});
+    REQUIRE(brush.clip(worldBounds, face).is_success());
+  }
+
+  SECTION("Packed faces are copied")
+  {
+    brush = Brush{brush};
+  }
+
+  const auto& packedFaces = brush.packedFaces();
+  REQUIRE(packedFaces.faceCount() == brush.faceCount());
+  REQUIRE(packedFaces.polygonOffsets().size() == brush.faceCount() + 1u);
+
+  for (size_t i = 0u; i < brush.faceCount(); ++i)
+  {
+    const auto& face = brush.face(i);
+    CHECK(packedFaces.normals()[i] == face.boundary().normal);
+    CHECK(packedFaces.distances()[i] == face.boundary().distance);
+
+    const auto begin = packedFaces.vertexPositions().begin()
+                       + static_cast<std::ptrdiff_t>(packedFaces.polygonOffsets()[i]);
+    const auto end = packedFaces.vertexPositions().begin()
+                     + static_cast<std::ptrdiff_t>(packedFaces.polygonOffsets()[i + 1u]);
+    CHECK(std::vector<vm::vec3>(begin, end) == face.vertexPositions());
+
+    const auto center = face.center();
+    const auto ray = vm::ray3{center + 8.0 * face.normal(), -face.normal()};
+    CHECK(packedFaces.intersectWithRay(i, ray) == face.intersectWithRay(ray));
+    CHECK(
+      packedFaces.intersectWithRay(i, vm::ray3{center, face.normal()})
+      == std::nullopt);
+  }
+
+  for (const auto& point : std::vector<vm::vec3>{
+         {0, 0, 0}, {16, 16, 16}, {31, -31, 31}, {32, 32, 32}, {-32, -32, -32}})
+  {
+    const auto expected = std::none_of(
+      brush.faces().begin(), brush.faces().end(), [&](const auto& face) {
+        return face.boundary().point_status(point) == vm::plane_status::above;
+      });
+    CHECK(packedFaces.containsPoint(point) == expected);
+  }
+}
+
+TEST_CASE("BrushTest.copy")
+{
+  const auto worldBounds = vm::bbox3{4096.0};
+  const auto builder = BrushBuilder{MapFormat::Standard, worldBounds};
+
+  const auto original =
+    builder.createCuboid(vm::vec3{64.0, 32.0, 16.0}, "material") | kdl::value();
+  const auto originalVertexPositions = original.vertexPositions();
+  const auto originalMemoryUsage = original.memoryUsage();
+
+  auto copy = original;
+  CHECK(copy == original);
+  CHECK(copy.vertexPositions() == originalVertexPositions);
+  CHECK(original.memoryUsage() < originalMemoryUsage);
+
+  SECTION("Translating a copy")
+  {
+    const auto delta = vm::vec3{16.0, 8.0, 4.0};
+    REQUIRE(
+      copy.transform(worldBounds, vm::translation_matrix(delta), false).is_success());
+    CHECK(copy.bounds() == original.bounds().translate(delta));
+    CHECK_THAT(
+      copy.vertexPositions(),
+      Catch::UnorderedEquals(kdl::vec_transform(
+        originalVertexPositions, [&](const auto& v) { return v + delta; })));
+    CHECK(copy.packedFaces().vertices() == copy.vertexPositions());
+    CHECK(copy.containsPoint(vm::vec3{40.0, 8.0, 4.0}));
+  }
+
+  SECTION("Rotating a copy")
+  {
+    REQUIRE(copy
+              .transform(
+                worldBounds,
+                vm::rotation_matrix(vm::vec3::pos_z(), vm::to_radians(90.0)),
+                false)
+              .is_success());
+    CHECK(copy.bounds() == vm::bbox3{{-16.0, -32.0, -8.0}, {16.0, 32.0, 8.0}});
+  }
+
+  SECTION("Translating a copy out of the world bounds")
+  {
+    CHECK(copy
+            .transform(
+              worldBounds, vm::translation_matrix(vm::vec3{4096.0, 0.0, 0.0}), false)
+            .is_error());
+  }
+
+  CHECK(original.vertexPositions() == originalVertexPositions);
+  CHECK(original.bounds() == vm::bbox3{{-32.0, -16.0, -8.0}, {32.0, 16.0, 8.0}});
+}
+
 TEST_CASE("BrushTest.moveBoundary")
 {
   const vm::bbox3 worldBounds(4096.0);
@@ -2383,6 +2512,112 @@ TEST_CASE("BrushTest.subtractCuboidFromCuboid")
     == minuendMaterial);
 }
 
+TEST_CASE("BrushTest.intersectsBrush")
+{
+  const auto worldBounds = vm::bbox3{4096.0};
+  const auto builder = BrushBuilder{MapFormat::Standard, worldBounds};
+
+  const auto cube =
+    builder.createCuboid(vm::bbox3{vm::vec3::fill(-8.0), vm::vec3::fill(8.0)}, "material")
+    | kdl::value();
+
+  SECTION("Rotated brush")
+  {
+    auto diamond = cube;
+    REQUIRE(diamond
+              .transform(
+                worldBounds,
+                vm::rotation_matrix(vm::vec3::pos_z(), vm::to_radians(45.0)),
+                false)
+              .is_success());
+
+    using T = std::tuple<vm::bbox3, bool>;
+
+    // clang-format off
+    const auto
+    [otherBounds,                                           expected] = GENERATE(values<T>({
+    {{vm::vec3{0, 0, 0}, vm::vec3{16, 16, 16}},             true},
+    {{vm::vec3{-4, -4, -4}, vm::vec3{4, 4, 4}},             true},
+    {{vm::vec3{5, 5, -8}, vm::vec3{21, 21, 8}},             true},
+    {{vm::vec3{6, 6, -8}, vm::vec3{22, 22, 8}},             false},
+    }));
+    // clang-format on
+
+    const auto other = builder.createCuboid(otherBounds, "material") | kdl::value();
+    REQUIRE(diamond.bounds().intersects(other.bounds()));
+    CHECK(diamond.intersects(other) == expected);
+    CHECK(other.intersects(diamond) == expected);
+    CHECK(cube.intersects(other));
+  }
+
+  SECTION("Brushes that overlap by no more than the point status epsilon")
+  {
+    constexpr auto epsilon = vm::constants<FloatType>::point_status_epsilon();
+
+    using T = std::tuple<FloatType, bool>;
+
+    // clang-format off
+    const auto
+    [overlap,          expected] = GENERATE(values<T>({
+    {-epsilon * 2.0,   false},
+    {-epsilon / 2.0,   false},
+    {0.0,              false},
+    {epsilon / 2.0,    false},
+    {0.01,             true},
+    }));
+    // clang-format on
+
+    CAPTURE(overlap);
+
+    // overlaps close to the epsilon are removed by vertex rounding when the brush is built,
+    // so the clearly overlapping case uses a larger overlap
+    const auto other =
+      builder.createCuboid(
+        vm::bbox3{vm::vec3{8.0 - overlap, -8.0, -8.0}, vm::vec3{24.0, 8.0, 8.0}},
+        "material")
+      | kdl::value();
+    CHECK(cube.intersects(other) == expected);
+    CHECK(other.intersects(cube) == expected);
+  }
+
+  SECTION("Wedges whose ridges cross and overlap by less than the point status epsilon")
+  {
+    constexpr auto epsilon = vm::constants<FloatType>::point_status_epsilon();
+
+    const auto overlap = GENERATE(epsilon / 2.0, 0.0005);
+    CAPTURE(overlap);
+
+    // the ridges are placed away from integer coordinates so that vertex rounding does
+    // not remove the overlap
+    const auto lower = builder.createBrush(
+                         {
+                           {-32.0, -32.0, -63.5},
+                           {32.0, -32.0, -63.5},
+                           {-32.0, 32.0, -63.5},
+                           {32.0, 32.0, -63.5},
+                           {-32.0, 0.0, 0.5},
+                           {32.0, 0.0, 0.5},
+                         },
+                         "material")
+                       | kdl::value();
+    const auto upper = builder.createBrush(
+                         {
+                           {-32.0, -32.0, 64.5 - overlap},
+                           {32.0, -32.0, 64.5 - overlap},
+                           {-32.0, 32.0, 64.5 - overlap},
+                           {32.0, 32.0, 64.5 - overlap},
+                           {0.0, -32.0, 0.5 - overlap},
+                           {0.0, 32.0, 0.5 - overlap},
+                         },
+                         "material")
+                       | kdl::value();
+
+    REQUIRE(lower.bounds().max.z() - upper.bounds().min.z() == vm::approx{overlap});
+    CHECK(lower.intersects(upper));
+    CHECK(upper.intersects(lower));
+  }
+}
+
 TEST_CASE("BrushTest.subtractDisjoint")
 {
   const vm::bbox3 worldBounds(4096.0);
@@ -26,6 +26,7 @@
 #include "Model/Entity.h"
 #include "Model/EntityNode.h"
 #include "Model/GroupNode.h"
+#include "Model/Layer.h"
 #include "Model/LayerNode.h"
 #include "Model/LockState.h"
 #include "Model/MapFormat.h"
@@ -1209,5 +1210,92 @@ TEST_CASE_METHOD(EditorContextTest, "EditorContextTest.testGroupedNodes")
     CHECK(context.selectable(entityNode) == selectable);
   }
 }
+
+TEST_CASE_METHOD(EditorContextTest, "EditorContextTest.cachedStatesAreUpdated")
+{
+  auto [entityNode, brushNode] = createTopLevelBrushEntity();
+
+  REQUIRE(context.visible(entityNode));
+  REQUIRE(context.visible(brushNode));
+  REQUIRE(context.selectable(brushNode));
+
+  SECTION("Changing the visibility of a node")
+  {
+    brushNode->setVisibilityState(V_Hidden);
+    CHECK_FALSE(context.visible(brushNode));
+    CHECK_FALSE(context.visible(entityNode));
+    CHECK_FALSE(context.selectable(brushNode));
+
+    brushNode->setVisibilityState(V_Shown);
+    CHECK(context.visible(brushNode));
+    CHECK(context.visible(entityNode));
+    CHECK(context.selectable(brushNode));
+  }
+
+  SECTION("Changing the lock state of a node")
+  {
+    brushNode->setLockState(L_Locked);
+    CHECK(context.visible(brushNode));
+    CHECK_FALSE(context.selectable(brushNode));
+  }
+
+  SECTION("Opening a group")
+  {
+    auto* groupNode = createTopLevelGroup();
+    REQUIRE(context.selectable(groupNode));
+
+    context.pushGroup(groupNode);
+    CHECK_FALSE(context.selectable(groupNode));
+
+    context.popGroup();
+    CHECK(context.selectable(groupNode));
+  }
+
+  SECTION("Hiding and locking an ancestor")
+  {
+    worldNode.defaultLayer()->setVisibilityState(V_Hidden);
+    CHECK_FALSE(context.visible(brushNode));
+    CHECK_FALSE(context.visible(entityNode));
+
+    worldNode.defaultLayer()->setVisibilityState(V_Inherited);
+    worldNode.defaultLayer()->setLockState(L_Locked);
+    CHECK(context.visible(brushNode));
+    CHECK_FALSE(context.editable(brushNode));
+    CHECK_FALSE(context.selectable(brushNode));
+  }
+
+  SECTION("Moving a node to another parent")
+  {
+    auto* layerNode = new LayerNode{Layer{"layer"}};
+    worldNode.addChild(layerNode);
+    layerNode->setVisibilityState(V_Hidden);
+
+    entityNode->removeChild(brushNode);
+    layerNode->addChild(brushNode);
+    CHECK_FALSE(context.visible(brushNode));
+  }
+
+  SECTION("Querying the same nodes with another context")
+  {
+    auto otherContext = EditorContext{};
+    brushNode->setLockState(L_Locked);
+    CHECK_FALSE(otherContext.selectable(brushNode));
+    CHECK_FALSE(context.selectable(brushNode));
+
+    brushNode->setLockState(L_Unlocked);
+    CHECK(context.selectable(brushNode));
+    CHECK(otherContext.selectable(brushNode));
+  }
+
+  SECTION("Changing a preference")
+  {
+    {
+      const auto setPref = TemporarilySetPref{Preferences::ShowBrushes, false};
+      CHECK_FALSE(context.visible(brushNode));
+    }
+
+    CHECK(context.visible(brushNode));
+  }
+}
 } // namespace Model
 } // namespace TrenchBroom
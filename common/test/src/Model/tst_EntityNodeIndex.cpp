@@ -23,6 +23,8 @@
 
 #include "kdl/vector_utils.h"
 
+#include <future>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -228,5 +230,81 @@ TEST_CASE("EntityNodeIndexTest.allValuesForKeys")
     index.allValuesForKeys(EntityNodeIndexQuery::exact("test")),
     Catch::UnorderedEquals(std::vector<std::string>{"somevalue", "somevalue2"}));
 }
+
+TEST_CASE("EntityNodeIndexTest.addManyEntityNodes")
+{
+  EntityNodeIndex index;
+
+  const auto emptyMemoryUsage = index.memoryUsage();
+
+  // enough properties to insert them into the index concurrently
+  auto entities = std::vector<std::unique_ptr<EntityNode>>{};
+  for (size_t i = 0; i < 2000; ++i)
+  {
+    entities.push_back(std::make_unique<EntityNode>(Entity{{
+      {"classname", "light"},
+      {"target" + std::to_string(i % 3), "light" + std::to_string(i)},
+    }}));
+    index.addEntityNode(entities.back().get());
+  }
+
+  CHECK_THAT(
+    index.allKeys(),
+    Catch::UnorderedEquals(
+      std::vector<std::string>{"classname", "target0", "target1", "target2"}));
+  CHECK(findExactExact(index, "classname", "light").size() == 2000u);
+  CHECK(
+    findNumberedExact(index, "target", "light1234")
+    == std::vector<EntityNodeBase*>{entities[1234].get()});
+  CHECK(index.allValuesForKeys(EntityNodeIndexQuery::exact("target1")).size() == 667u);
+  CHECK(index.memoryUsage() > emptyMemoryUsage);
+
+  index.removeEntityNode(entities[1234].get());
+  CHECK(findNumberedExact(index, "target", "light1234").empty());
+  CHECK(findExactExact(index, "classname", "light").size() == 1999u);
+
+  // removing a property that is still pending must not leave a stale entry
+  index.addProperty(entities[1234].get(), "target1", "light1234");
+  index.removeProperty(entities[1234].get(), "target1", "light1234");
+  CHECK(findNumberedExact(index, "target", "light1234").empty());
+}
+
+TEST_CASE("EntityNodeIndexTest.concurrentQueries")
+{
+  EntityNodeIndex index;
+
+  auto entities = std::vector<std::unique_ptr<EntityNode>>{};
+  for (size_t i = 0; i < 2000; ++i)
+  {
+    entities.push_back(std::make_unique<EntityNode>(Entity{{
+      {"classname", "light"},
+      {"targetname", "light" + std::to_string(i)},
+    }}));
+    index.addEntityNode(entities.back().get());
+  }
+
+  SECTION("Without flushing")
+  {
+  }
+
+  SECTION("After flushing")
+  {
+    index.flush();
+  }
+
+  // the first queries insert the pending properties
+  auto queries = std::vector<std::future<std::vector<EntityNodeBase*>>>{};
+  for (size_t i = 0; i < 8; ++i)
+  {
+    queries.push_back(std::async(std::launch::async, [&, i]() {
+      return findExactExact(index, "targetname", "light" + std::to_string(i));
+    }));
+  }
+
+  for (size_t i = 0; i < queries.size(); ++i)
+  {
+    CHECK(queries[i].get() == std::vector<EntityNodeBase*>{entities[i].get()});
+  }
+}
 } // namespace Model
 } // namespace TrenchBroom
@@ -41,6 +41,7 @@
 #include "vm/mat_io.h"
 
 #include <memory>
+#include <optional>
 #include <vector>
 
 #include "Catch2.h"
@@ -170,4 +171,52 @@ TEST_CASE("GroupNode.canRemoveChild")
   CHECK(groupNode.canRemoveChild(&patchNode));
 }
 
+TEST_CASE("GroupNode.addPendingChangedNodes")
+{
+  auto groupNode = GroupNode{Group{"group"}};
+  auto* entityNode1 = new EntityNode{Entity{}};
+  auto* entityNode2 = new EntityNode{Entity{}};
+  groupNode.addChildren({entityNode1, entityNode2});
+
+  REQUIRE_FALSE(groupNode.hasPendingChanges());
+  REQUIRE(groupNode.pendingChangedNodes() == std::nullopt);
+
+  SECTION("Adds changed nodes if there are no pending changes")
+  {
+    groupNode.addPendingChangedNodes({entityNode1});
+    CHECK(groupNode.hasPendingChanges());
+    CHECK(groupNode.pendingChangedNodes() == std::vector<Node*>{entityNode1});
+
+    groupNode.addPendingChangedNodes({entityNode2});
+    CHECK(groupNode.hasPendingChanges());
+    CHECK(
+      groupNode.pendingChangedNodes() == std::vector<Node*>{entityNode1, entityNode2});
+
+    // nodes that are changed again are not added twice
+    groupNode.addPendingChangedNodes({entityNode2, entityNode1});
+    CHECK(
+      groupNode.pendingChangedNodes() == std::vector<Node*>{entityNode1, entityNode2});
+
+    groupNode.setHasPendingChanges(false);
+    CHECK_FALSE(groupNode.hasPendingChanges());
+    CHECK(groupNode.pendingChangedNodes() == std::nullopt);
+  }
+
+  SECTION("Does not add changed nodes if there are other pending changes")
+  {
+    groupNode.setHasPendingChanges(true);
+    groupNode.addPendingChangedNodes({entityNode1});
+    CHECK(groupNode.hasPendingChanges());
+    CHECK(groupNode.pendingChangedNodes() == std::nullopt);
+  }
+
+  SECTION("Other pending changes discard changed nodes")
+  {
+    groupNode.addPendingChangedNodes({entityNode1});
+    groupNode.setHasPendingChanges(true);
+    CHECK(groupNode.hasPendingChanges());
+    CHECK(groupNode.pendingChangedNodes() == std::nullopt);
+  }
+}
+
 } // namespace TrenchBroom::Model
@@ -344,6 +344,135 @@ TEST_CASE("GroupNode.updateLinkedGroupsExceedsWorldBounds")
       });
 }
 
+TEST_CASE("GroupNode.updateLinkedNodes")
+{
+  const auto worldBounds = vm::bbox3{8192.0};
+
+  auto groupNode = GroupNode{Group{"name"}};
+  auto* entityNode = new EntityNode{Entity{}};
+  auto* otherEntityNode = new EntityNode{Entity{}};
+  groupNode.addChildren({entityNode, otherEntityNode});
+
+  transformNode(groupNode, vm::translation_matrix(vm::vec3{1, 0, 0}), worldBounds);
+
+  auto groupNodeClone = std::unique_ptr<GroupNode>{
+    static_cast<GroupNode*>(groupNode.cloneRecursively(worldBounds, SetLinkId::keep))};
+  transformNode(*groupNodeClone, vm::translation_matrix(vm::vec3{0, 2, 0}), worldBounds);
+
+  auto* entityNodeClone = static_cast<EntityNode*>(groupNodeClone->children().front());
+  REQUIRE(entityNodeClone->entity().origin() == vm::vec3{1, 2, 0});
+
+  SECTION("Target group list contains only source group")
+  {
+    updateLinkedNodes(groupNode, {&groupNode}, {entityNode}, worldBounds)
+      | kdl::transform([&](const UpdateLinkedNodesResult& r) { CHECK(r.empty()); })
+      | kdl::transform_error([](const auto&) { FAIL(); });
+  }
+
+  SECTION("Only changed nodes are updated")
+  {
+    transformNode(*entityNode, vm::translation_matrix(vm::vec3{0, 0, 3}), worldBounds);
+    REQUIRE(entityNode->entity().origin() == vm::vec3{1, 0, 3});
+
+    updateLinkedNodes(
+      groupNode, {groupNodeClone.get()}, {entityNode, entityNode}, worldBounds)
+      | kdl::transform([&](const UpdateLinkedNodesResult& r) {
+          REQUIRE(r.size() == 1u);
+
+          const auto& [nodeToUpdate, newContents] = r.front();
+          CHECK(nodeToUpdate == entityNodeClone);
+          CHECK(
+            std::get<Entity>(newContents.get()).origin() == vm::vec3{1, 2, 3});
+        })
+      | kdl::transform_error([](const auto&) { FAIL(); });
+  }
+
+  SECTION("Protected entity properties are preserved")
+  {
+    auto entity = entityNode->entity();
+    entity.addOrUpdateProperty("some_key", "some_value");
+    entity.setProtectedProperties({"some_key"});
+    entityNode->setEntity(std::move(entity));
+
+    updateLinkedNodes(groupNode, {groupNodeClone.get()}, {entityNode}, worldBounds)
+      | kdl::transform([&](const UpdateLinkedNodesResult& r) {
+          REQUIRE(r.size() == 1u);
+
+          const auto& newEntity = std::get<Entity>(r.front().second.get());
+          CHECK(newEntity.property("some_key") == nullptr);
+          CHECK(newEntity.protectedProperties().empty());
+        })
+      | kdl::transform_error([](const auto&) { FAIL(); });
+  }
+
+  SECTION("Changed node is not a descendant of the source group")
+  {
+    auto unrelatedEntityNode = EntityNode{Entity{}};
+
+    updateLinkedNodes(
+      groupNode, {groupNodeClone.get()}, {&unrelatedEntityNode}, worldBounds)
+      | kdl::transform([](auto) { FAIL(); }) | kdl::transform_error([](auto e) {
+          CHECK(e == Error{"Changed node is not a descendant of the linked group"});
+        });
+  }
+
+  SECTION("Target group has inconsistent structure")
+  {
+    groupNodeClone->removeChild(entityNodeClone);
+    delete entityNodeClone;
+
+    updateLinkedNodes(groupNode, {groupNodeClone.get()}, {otherEntityNode}, worldBounds)
+      | kdl::transform([](auto) { FAIL(); }) | kdl::transform_error([](auto e) {
+          CHECK(e == Error{"Inconsistent linked group structure"});
+        });
+  }
+
+  SECTION("Updated node exceeds world bounds")
+  {
+    transformNode(
+      *groupNodeClone, vm::translation_matrix(vm::vec3{8192 - 9, 0, 0}), worldBounds);
+    transformNode(*entityNode, vm::translation_matrix(vm::vec3{1, 0, 0}), worldBounds);
+
+    updateLinkedNodes(groupNode, {groupNodeClone.get()}, {entityNode}, worldBounds)
+      | kdl::transform([](auto) { FAIL(); }) | kdl::transform_error([](auto e) {
+          CHECK(e == Error{"Updating a linked node would exceed world bounds"});
+        });
+  }
+}
+
+TEST_CASE("GroupNode.updateLinkedNodesWithBrushEntity")
+{
+  const auto worldBounds = vm::bbox3{8192.0};
+  const auto brushBuilder = BrushBuilder{MapFormat::Quake3, worldBounds};
+
+  auto groupNode = GroupNode{Group{"name"}};
+
+  // the origin of a brush entity does not contribute to its bounds
+  auto* entityNode = new EntityNode{Entity{{{"origin", "8190 0 0"}}}};
+  auto* brushNode = new BrushNode{
+    brushBuilder.createCuboid(vm::bbox3{{0, 0, 0}, {16, 16, 16}}, "material")
+    | kdl::value()};
+  entityNode->addChild(brushNode);
+  groupNode.addChild(entityNode);
+
+  auto groupNodeClone = std::unique_ptr<GroupNode>{
+    static_cast<GroupNode*>(groupNode.cloneRecursively(worldBounds, SetLinkId::keep))};
+  transformNode(*groupNodeClone, vm::translation_matrix(vm::vec3{0, 2, 0}), worldBounds);
+
+  auto* entityNodeClone = static_cast<EntityNode*>(groupNodeClone->children().front());
+
+  auto entity = entityNode->entity();
+  entity.addOrUpdateProperty("some_key", "some_value");
+  entityNode->setEntity(std::move(entity));
+
+  updateLinkedNodes(groupNode, {groupNodeClone.get()}, {entityNode}, worldBounds)
+    | kdl::transform([&](const UpdateLinkedNodesResult& r) {
+        REQUIRE(r.size() == 1u);
+        CHECK(r.front().first == entityNodeClone);
+      })
+    | kdl::transform_error([](const auto&) { FAIL(); });
+}
+
 static void setGroupName(GroupNode& groupNode, const std::string& name)
 {
   auto group = groupNode.group();
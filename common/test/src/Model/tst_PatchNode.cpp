@@ -166,6 +166,84 @@ TEST_CASE("PatchNode.makePatchGrid")
     == kdl::vec_transform(expectedPoints, [](const auto& p) { return vm::approx{p}; }));
 }
 
+TEST_CASE("PatchNode.computePatchSubdivisions")
+{
+  using CP = BezierPatch::Point;
+  using T = std::tuple<size_t, size_t, std::vector<CP>, size_t, PatchSubdivisions>;
+
+  // clang-format off
+  const auto 
+  [r, c, controlPoints, maxSd, expectedSubdivisions] = GENERATE(values<T>({
+  {3, 3, // flat surface on XY plane
+    {CP{0.0, 2.0, 0.0}, CP{1.0, 2.0, 0.0}, CP{2.0, 2.0, 0.0},
+    CP{0.0, 1.0, 0.0}, CP{1.0, 1.0, 0.0}, CP{2.0, 1.0, 0.0},
+    CP{0.0, 0.0, 0.0}, CP{1.0, 0.0, 0.0}, CP{2.0, 0.0, 0.0}},
+    3, {{0}, {0}}},
+  {3, 3, // hill surface bulging towards +Z
+    {CP{0.0, 2.0, 0.0}, CP{1.0, 2.0, 0.0}, CP{2.0, 2.0, 0.0},
+    CP{0.0, 1.0, 0.0}, CP{1.0, 1.0, 4.0}, CP{2.0, 1.0, 0.0},
+    CP{0.0, 0.0, 0.0}, CP{1.0, 0.0, 0.0}, CP{2.0, 0.0, 0.0}},
+    3, {{1}, {1}}},
+  {3, 3, // steep hill surface bulging towards +Z
+    {CP{0.0, 2.0, 0.0}, CP{1.0, 2.0, 0.0}, CP{2.0, 2.0, 0.0},
+    CP{0.0, 1.0, 0.0}, CP{1.0, 1.0, 400.0}, CP{2.0, 1.0, 0.0},
+    CP{0.0, 0.0, 0.0}, CP{1.0, 0.0, 0.0}, CP{2.0, 0.0, 0.0}},
+    3, {{3}, {3}}},
+  {3, 3, // twisted surface with straight rows and columns
+    {CP{0.0, 0.0, 0.0}, CP{1.0, 0.0, 0.0}, CP{2.0, 0.0, 0.0},
+    CP{0.0, 1.0, 0.0}, CP{1.0, 1.0, 4.0}, CP{2.0, 1.0, 8.0},
+    CP{0.0, 2.0, 0.0}, CP{1.0, 2.0, 8.0}, CP{2.0, 2.0, 16.0}},
+    3, {{1}, {1}}},
+  {5, 3, // cylinder segment, only curved along its rows
+    {CP{-64.0,  0.0, 64.0}, CP{-64.0,  0.0, 0.0}, CP{-64.0,  0.0, -64.0},
+    CP{-64.0, 64.0, 64.0}, CP{-64.0, 64.0, 0.0}, CP{-64.0, 64.0, -64.0},
+    CP{  0.0, 64.0, 64.0}, CP{  0.0, 64.0, 0.0}, CP{  0.0, 64.0, -64.0},
+    CP{  0.0, 64.0, 64.0}, CP{  0.0, 64.0, 0.0}, CP{  0.0, 64.0, -64.0},
+    CP{  0.0, 64.0, 64.0}, CP{  0.0, 64.0, 0.0}, CP{  0.0, 64.0, -64.0}},
+    3, {{3, 0}, {0}}},
+  {3, 3, // flat surface with UV coordinates stretched non-linearly along its columns
+    {CP{0.0, 2.0, 0.0, 0.0, 0.0},  CP{1.0, 2.0, 0.0, 0.5, 0.0},  CP{2.0, 2.0, 0.0, 1.0, 0.0},
+    CP{0.0, 1.0, 0.0, 0.0, 0.25}, CP{1.0, 1.0, 0.0, 0.5, 0.25}, CP{2.0, 1.0, 0.0, 1.0, 0.25},
+    CP{0.0, 0.0, 0.0, 0.0, 1.0},  CP{1.0, 0.0, 0.0, 0.5, 1.0},  CP{2.0, 0.0, 0.0, 1.0, 1.0}},
+    3, {{3}, {0}}},
+  {3, 3, // flat surface with bilinear UV coordinates
+    {CP{0.0, 2.0, 0.0, 0.0, 0.0},  CP{1.0, 2.0, 0.0, 0.5, 0.0},   CP{2.0, 2.0, 0.0, 1.0, 0.0},
+    CP{0.0, 1.0, 0.0, 0.0, 0.5},  CP{1.0, 1.0, 0.0, 0.75, 0.75}, CP{2.0, 1.0, 0.0, 1.5, 1.0},
+    CP{0.0, 0.0, 0.0, 0.0, 1.0},  CP{1.0, 0.0, 0.0, 1.0, 1.5},   CP{2.0, 0.0, 0.0, 2.0, 2.0}},
+    3, {{3}, {3}}},
+  }));
+  // clang-format on
+
+  CAPTURE(r, c, controlPoints, maxSd);
+  CHECK(
+    computePatchSubdivisions(BezierPatch{r, c, controlPoints, "material"}, 1.0, maxSd)
+    == expectedSubdivisions);
+}
+
+TEST_CASE("PatchNode.makePatchGridWithSubdivisions")
+{
+  using P = BezierPatch::Point;
+
+  // clang-format off
+  const auto patch = BezierPatch{5, 3, {
+    P{0.0, 2.0, 0.0}, P{1.0, 2.0, 0.0}, P{2.0, 2.0, 0.0},
+    P{0.0, 1.5, 0.0}, P{1.0, 1.5, 0.0}, P{2.0, 1.5, 0.0},
+    P{0.0, 1.0, 0.0}, P{1.0, 1.0, 0.0}, P{2.0, 1.0, 0.0},
+    P{0.0, 0.5, 0.0}, P{1.0, 0.5, 0.0}, P{2.0, 0.5, 0.0},
+    P{0.0, 0.0, 0.0}, P{1.0, 0.0, 0.0}, P{2.0, 0.0, 0.0},
+  }, "material"};
+  // clang-format on
+
+  const auto grid = makePatchGrid(patch, PatchSubdivisions{{2, 0}, {1}});
+  CHECK(grid.pointRowCount == 6u);
+  CHECK(grid.pointColumnCount == 3u);
+  CHECK(grid.points.size() == 18u);
+  CHECK(grid.point(3, 1).position == vm::approx{vm::vec3{1.0, 1.25, 0.0}});
+  CHECK(grid.point(5, 2).position == vm::approx{vm::vec3{2.0, 0.0, 0.0}});
+
+  CHECK(makePatchGrid(patch, PatchSubdivisions{{1, 1}, {1}}) == makePatchGrid(patch, 1));
+}
+
 TEST_CASE("PatchNode.pickFlatPatch")
 {
   using P = BezierPatch::Point;
@@ -212,4 +290,49 @@ TEST_CASE("PatchNode.pickFlatPatch")
   }
 }
 
+TEST_CASE("PatchNode.pickCurvedPatch")
+{
+  using P = BezierPatch::Point;
+
+  // clang-format off
+  auto patchNode = PatchNode{BezierPatch{5, 5, {
+    P{0.0, 4.0, 0.0}, P{1.0, 4.0, 0.0}, P{2.0, 4.0, 0.0}, P{3.0, 4.0, 0.0}, P{4.0, 4.0, 0.0},
+    P{0.0, 3.0, 0.0}, P{1.0, 3.0, 8.0}, P{2.0, 3.0, 0.0}, P{3.0, 3.0, 0.0}, P{4.0, 3.0, 0.0},
+    P{0.0, 2.0, 0.0}, P{1.0, 2.0, 0.0}, P{2.0, 2.0, 0.0}, P{3.0, 2.0, 0.0}, P{4.0, 2.0, 0.0},
+    P{0.0, 1.0, 0.0}, P{1.0, 1.0, 0.0}, P{2.0, 1.0, 0.0}, P{3.0, 1.0, 0.0}, P{4.0, 1.0, 0.0},
+    P{0.0, 0.0, 0.0}, P{1.0, 0.0, 0.0}, P{2.0, 0.0, 0.0}, P{3.0, 0.0, 0.0}, P{4.0, 0.0, 0.0},
+  }, "material"}};
+  // clang-format on
+
+  using T = std::tuple<vm::ray3, std::optional<vm::vec3>>;
+
+  // clang-format off
+  const auto 
+  [pickRay,                                          expectedHitPoint  ] = GENERATE(values<T>({
+  {vm::ray3{vm::vec3{1, 3,  8}, vm::vec3::neg_z()}, vm::vec3{1, 3, 2}},
+  {vm::ray3{vm::vec3{1, 3, -1}, vm::vec3::pos_z()}, vm::vec3{1, 3, 2}},
+  {vm::ray3{vm::vec3{3, 1,  8}, vm::vec3::neg_z()}, vm::vec3{3, 1, 0}},
+  {vm::ray3{vm::vec3{5, 5,  8}, vm::vec3::neg_z()}, std::nullopt     },
+  }));
+  // clang-format on
+
+  CAPTURE(pickRay);
+
+  const auto editorContext = EditorContext{};
+  auto pickResult = PickResult{};
+  patchNode.pick(editorContext, pickRay, pickResult);
+
+  if (expectedHitPoint.has_value())
+  {
+    CHECK(pickResult.size() == 1u);
+
+    const auto hit = pickResult.all().front();
+    CHECK(hit.hitPoint() == vm::approx{*expectedHitPoint});
+  }
+  else
+  {
+    CHECK(pickResult.size() == 0u);
+  }
+}
+
 } // namespace TrenchBroom::Model
@@ -70,6 +70,40 @@ TEST_CASE("PointTrace")
 
   trace.retreat();
   CHECK(trace.currentPoint() == vm::vec3f{1, 1, 1});
+
+  trace.setCurrentPoint(2);
+  CHECK(trace.currentPoint() == vm::vec3f{1, 2, 2});
+}
+
+TEST_CASE("PointTrace.indexOfNearestPoint")
+{
+  auto points = std::vector<vm::vec3f>{};
+  for (size_t i = 0; i < 200; ++i)
+  {
+    points.emplace_back(float(i) * 64.0f, float(i % 2) * 64.0f, 0.0f);
+  }
+
+  const auto trace = PointTrace{points};
+
+  using T = std::tuple<vm::vec3f, size_t>;
+
+  // clang-format off
+  const auto
+  [position,                 expectedIndex] = GENERATE(values<T>({
+  {{0, 0, 0},                0},
+  {{-100, -100, 0},          0},
+  {{20, 0, 0},               0},
+  {{40, 40, 0},              1},
+  {{64 * 150, 0, 32},        150},
+  {{64 * 150 + 20, 0, 32},   150},
+  {{64 * 150 + 20, 64, 32},  151},
+  {{64 * 300, 0, 0},         199},
+  }));
+  // clang-format on
+
+  CAPTURE(position);
+
+  CHECK(trace.indexOfNearestPoint(position) == expectedIndex);
 }
 
 TEST_CASE("loadPointFile")
@@ -117,5 +151,24 @@ TEST_CASE("loadPointFile")
 
   auto stream = std::istringstream{file};
   CHECK(loadPointFile(stream) == expectedTrace);
+  CHECK(loadPointFile(std::string_view{file}) == expectedTrace);
+}
+
+TEST_CASE("loadPointFile.simplifiesCollinearPoints")
+{
+  auto file = std::string{};
+  for (size_t i = 0; i <= 1000; ++i)
+  {
+    file += "0 0 " + std::to_string(float(i) / 10.0f) + "\n";
+  }
+  file += "(0 25 100) (0 50 100)\n";
+
+  CHECK(
+    loadPointFile(std::string_view{file})
+    == PointTrace{{
+      {0, 0, 0},
+      {0, 0, 100},
+      {0, 50, 100},
+    }});
 }
 } // namespace TrenchBroom::Model
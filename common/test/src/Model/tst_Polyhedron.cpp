@@ -507,6 +507,32 @@ TEST_CASE("PolyhedronTest.swap")
   CHECK(rhs.bounds() == original.bounds());
 }
 
+TEST_CASE("PolyhedronTest.translate")
+{
+  const vm::vec3d p1(0.0, 0.0, 8.0);
+  const vm::vec3d p2(8.0, 0.0, 0.0);
+  const vm::vec3d p3(-8.0, 0.0, 0.0);
+  const vm::vec3d p4(0.0, 8.0, 0.0);
+  const vm::vec3d delta(16.0, -8.0, 4.0);
+
+  Polyhedron3d p({p1, p2, p3, p4});
+  p.translate(delta);
+
+  const Polyhedron3d expected({p1 + delta, p2 + delta, p3 + delta, p4 + delta});
+  CHECK(p == expected);
+  CHECK(p.bounds() == expected.bounds());
+
+  for (const auto* face : p.faces())
+  {
+    for (const auto* halfEdge : face->boundary())
+    {
+      CHECK(
+        face->plane().point_status(halfEdge->origin()->position())
+        == vm::plane_status::inside);
+    }
+  }
+}
+
 TEST_CASE("PolyhedronTest.clipCubeWithHorizontalPlane")
 {
   const vm::vec3d p1(-64.0, -64.0, -64.0);
@@ -25,6 +25,7 @@
 
 #include <filesystem>
 #include <memory>
+#include <string>
 
 #include "Catch2.h"
 
@@ -104,5 +105,59 @@ TEST_CASE("PortalFileTest.parsePRT2")
       .portals()
     == ExpectedPortals);
 }
+
+TEST_CASE("PortalFileTest.parseString")
+{
+  using T = std::tuple<std::string, std::vector<vm::polygon3f>>;
+
+  // clang-format off
+  const auto
+  [str, expectedPortals] = GENERATE(values<T>({
+  {"PRT1\n2\n2\n"
+   "4 0 1 (0 0 0 ) (0 1 0 ) (1 1 0 ) (1 0 0 )\n"
+   "3 1 0 (0 0 1 ) (1 0 1 ) (0 1 1 )\n",
+   {{{0, 0, 0}, {0, 1, 0}, {1, 1, 0}, {1, 0, 0}}, {{0, 0, 1}, {1, 0, 1}, {0, 1, 1}}}},
+  {"PRT1\r\n2\r\n2\r\n"
+   "4 0 1 (0 0 0 ) (0 1 0 ) (1 1 0 ) (1 0 0 )\r\n"
+   "3 1 0 (0 0 1 ) (1 0 1 ) (0 1 1 )",
+   {{{0, 0, 0}, {0, 1, 0}, {1, 1, 0}, {1, 0, 0}}, {{0, 0, 1}, {1, 0, 1}, {0, 1, 1}}}},
+  {"PRT1\n2\n1\n0\n"
+   "3 0 1 0 (0.5 -1.25 2 ) (1 0 2 ) (0 1 2 )\n",
+   {{{0.5f, -1.25f, 2}, {1, 0, 2}, {0, 1, 2}}}},
+  {"PRT2\n2\n2\n1\n"
+   "3 0 1 (0 0 0 ) (1 0 0 ) (0 1 0 )\n",
+   {{{0, 0, 0}, {1, 0, 0}, {0, 1, 0}}}},
+  {"PRT1-AM\n2\n1\n2\n"
+   "3 0 1 (0 0 0 ) (1 0 0 ) (0 1 0 )\n",
+   {{{0, 0, 0}, {1, 0, 0}, {0, 1, 0}}}},
+  }));
+  // clang-format on
+
+  CAPTURE(str);
+
+  const auto portalFile = loadPortalFile(std::string_view{str}) | kdl::value();
+  CHECK(portalFile.portals() == expectedPortals);
+  CHECK(portalFile.portalCount() == expectedPortals.size());
+  CHECK(portalFile.offsets().size() == expectedPortals.size() + 1);
+}
+
+TEST_CASE("PortalFileTest.parseInvalidString")
+{
+  // clang-format off
+  const auto str = GENERATE(values<std::string>({
+    "",
+    "PRT3\n2\n1\n3 0 1 (0 0 0 ) (1 0 0 ) (0 1 0 )\n",
+    "PRT1\n2\nx\n3 0 1 (0 0 0 ) (1 0 0 ) (0 1 0 )\n",
+    "PRT1\n2\n2\n3 0 1 (0 0 0 ) (1 0 0 ) (0 1 0 )\n",
+    "PRT1\n2\n1\n4 0 1 (0 0 0 ) (1 0 0 ) (0 1 0 )\n",
+    "PRT1\n2\n1\n3 0 1 (0 0 0 ) (1 x 0 ) (0 1 0 )\n",
+  }));
+  // clang-format on
+
+  CAPTURE(str);
+
+  CHECK(loadPortalFile(std::string_view{str}).is_error());
+}
+
 } // namespace Model
 } // namespace TrenchBroom
@@ -20,15 +20,19 @@
 #include "Error.h"
 #include "Exceptions.h"
 #include "Model/BrushBuilder.h"
+#include "Model/BrushFace.h"
 #include "Model/BrushNode.h"
 #include "Model/LayerNode.h"
 #include "Model/MapFormat.h"
 #include "Model/Tag.h"
 #include "Model/TagManager.h"
+#include "Model/TagMatcher.h"
 #include "Model/WorldNode.h"
 
 #include "kdl/result.h"
 
+#include <algorithm>
+
 #include "Catch2.h"
 
 namespace TrenchBroom
@@ -68,5 +72,80 @@ TEST_CASE("TaggingTest.testTagBrush")
   CHECK_FALSE(brushNode->hasTag(tag1));
   CHECK_FALSE(brushNode->hasTag(tag2));
 }
+
+TEST_CASE("TaggingTest.testFaceAttributeTags")
+{
+  const vm::bbox3 worldBounds{4096.0};
+  WorldNode world{{}, {}, MapFormat::Quake2};
+
+  auto tagManager = TagManager{};
+  tagManager.registerSmartTags({
+    SmartTag{"clip", {}, std::make_unique<MaterialNameTagMatcher>("clip*")},
+    SmartTag{"detail", {}, std::make_unique<SurfaceFlagsTagMatcher>(1 << 3)},
+  });
+
+  const auto& clipTag = tagManager.smartTag("clip");
+  const auto& detailTag = tagManager.smartTag("detail");
+
+  BrushBuilder builder{MapFormat::Quake2, worldBounds};
+  auto* brushNode1 = new BrushNode(
+    builder.createCube(64.0, "clip", "clip", "clip", "clip", "other", "other")
+    | kdl::value());
+  auto* brushNode2 = new BrushNode(
+    builder.createCube(64.0, "clip", "other", "other", "other", "other", "other")
+    | kdl::value());
+
+  world.defaultLayer()->addChild(brushNode1);
+  world.defaultLayer()->addChild(brushNode2);
+
+  brushNode1->initializeTags(tagManager);
+  brushNode2->initializeTags(tagManager);
+
+  // face attribute tags are not applied to brushes
+  CHECK_FALSE(brushNode1->hasTag(clipTag));
+
+  const auto countFacesWithTag = [](const BrushNode* brushNode, const Tag& tag) {
+    const auto& faces = brushNode->brush().faces();
+    return std::count_if(faces.begin(), faces.end(), [&](const auto& face) {
+      return face.hasTag(tag);
+    });
+  };
+
+  CHECK(countFacesWithTag(brushNode1, clipTag) == 4);
+  CHECK(countFacesWithTag(brushNode2, clipTag) == 1);
+  CHECK(countFacesWithTag(brushNode1, detailTag) == 0);
+  CHECK(countFacesWithTag(brushNode2, detailTag) == 0);
+
+  SECTION("Changing face attributes updates the tags")
+  {
+    auto brush = brushNode2->brush();
+    for (auto& face : brush.faces())
+    {
+      auto attributes = face.attributes();
+      attributes.setMaterialName("clip_other");
+      attributes.setSurfaceFlags(1 << 3);
+      face.setAttributes(attributes);
+    }
+    brushNode2->setBrush(std::move(brush));
+    brushNode2->updateTags(tagManager);
+
+    CHECK(countFacesWithTag(brushNode2, clipTag) == 6);
+    CHECK(countFacesWithTag(brushNode2, detailTag) == 6);
+
+    // other brushes with the same face attributes are not affected
+    CHECK(countFacesWithTag(brushNode1, clipTag) == 4);
+    CHECK(countFacesWithTag(brushNode1, detailTag) == 0);
+  }
+
+  SECTION("Re-registering smart tags clears the cached face tags")
+  {
+    tagManager.registerSmartTags({
+      SmartTag{"clip", {}, std::make_unique<MaterialNameTagMatcher>("other")},
+    });
+    brushNode1->initializeTags(tagManager);
+
+    CHECK(countFacesWithTag(brushNode1, tagManager.smartTag("clip")) == 2);
+  }
+}
 } // namespace Model
 } // namespace TrenchBroom
@@ -17,6 +17,8 @@
  along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include "IO/TestParserStatus.h"
+#include "IO/WorldReader.h"
 #include "Model/BezierPatch.h"
 #include "Model/BrushBuilder.h"
 #include "Model/BrushNode.h"
@@ -24,14 +26,17 @@
 #include "Model/EntityNode.h"
 #include "Model/Group.h"
 #include "Model/GroupNode.h"
+#include "Model/Issue.h"
 #include "Model/Layer.h"
 #include "Model/LayerNode.h"
+#include "Model/LinkTargetValidator.h"
 #include "Model/MapFormat.h"
 #include "Model/PatchNode.h"
 #include "Model/WorldNode.h"
 #include "TestUtils.h"
 #include "octree.h"
 
+#include "kdl/parallel.h"
 #include "kdl/result.h"
 #include "kdl/result_io.h"
 #include "kdl/string_utils.h"
@@ -40,6 +45,9 @@
 #include "vm/mat_ext.h"
 #include "vm/mat_io.h"
 
+#include <memory>
+#include <vector>
+
 #include "Catch2.h"
 
 namespace TrenchBroom::Model
@@ -119,15 +127,13 @@ TEST_CASE("WorldNodeTest.nodeTreeUpdates")
     {0, 2, 0}, {1, 2, 1}, {2, 2, 0} }, "material"}};
   // clang-format on
 
-  const auto& nodeTree = worldNode.nodeTree();
-
   SECTION("Adding a single node inserts into node tree")
   {
     auto* node = GENERATE_COPY(entityNode, brushNode, patchNode);
 
-    REQUIRE_FALSE(nodeTree.contains(node));
+    REQUIRE_FALSE(worldNode.nodeTree().contains(node));
     worldNode.defaultLayer()->addChild(node);
-    CHECK(nodeTree.contains(node));
+    CHECK(worldNode.nodeTree().contains(node));
   }
 
   SECTION("Adding a nested node inserts into node tree")
@@ -136,40 +142,40 @@ TEST_CASE("WorldNodeTest.nodeTreeUpdates")
 
     auto* node = GENERATE_COPY(entityNode, brushNode, patchNode);
 
-    REQUIRE_FALSE(nodeTree.contains(node));
+    REQUIRE_FALSE(worldNode.nodeTree().contains(node));
     groupNode->addChild(node);
-    CHECK(nodeTree.contains(node));
+    CHECK(worldNode.nodeTree().contains(node));
   }
 
   SECTION("Adding a layer does not insert it into node tree")
   {
-    REQUIRE_FALSE(nodeTree.contains(layerNode));
+    REQUIRE_FALSE(worldNode.nodeTree().contains(layerNode));
     worldNode.addChild(layerNode);
-    CHECK_FALSE(nodeTree.contains(layerNode));
+    CHECK_FALSE(worldNode.nodeTree().contains(layerNode));
   }
 
   SECTION("Adding a group node does not insert it into node tree")
   {
     groupNode->addChild(entityNode);
 
-    REQUIRE_FALSE(nodeTree.contains(groupNode));
+    REQUIRE_FALSE(worldNode.nodeTree().contains(groupNode));
     worldNode.defaultLayer()->addChild(groupNode);
-    CHECK_FALSE(nodeTree.contains(groupNode));
+    CHECK_FALSE(worldNode.nodeTree().contains(groupNode));
   }
 
   SECTION("Adding a subtree inserts all children into node tree")
   {
     groupNode->addChildren({entityNode, brushNode, patchNode});
 
-    REQUIRE_FALSE(nodeTree.contains(groupNode));
-    REQUIRE_FALSE(nodeTree.contains(entityNode));
-    REQUIRE_FALSE(nodeTree.contains(brushNode));
-    REQUIRE_FALSE(nodeTree.contains(patchNode));
+    REQUIRE_FALSE(worldNode.nodeTree().contains(groupNode));
+    REQUIRE_FALSE(worldNode.nodeTree().contains(entityNode));
+    REQUIRE_FALSE(worldNode.nodeTree().contains(brushNode));
+    REQUIRE_FALSE(worldNode.nodeTree().contains(patchNode));
     worldNode.defaultLayer()->addChild(groupNode);
-    CHECK_FALSE(nodeTree.contains(groupNode));
-    CHECK(nodeTree.contains(entityNode));
-    CHECK(nodeTree.contains(brushNode));
-    CHECK(nodeTree.contains(patchNode));
+    CHECK_FALSE(worldNode.nodeTree().contains(groupNode));
+    CHECK(worldNode.nodeTree().contains(entityNode));
+    CHECK(worldNode.nodeTree().contains(brushNode));
+    CHECK(worldNode.nodeTree().contains(patchNode));
   }
 
   SECTION("Removing a single node removes from node tree")
@@ -177,10 +183,10 @@ TEST_CASE("WorldNodeTest.nodeTreeUpdates")
     auto* node = GENERATE_COPY(entityNode, brushNode, patchNode);
 
     worldNode.defaultLayer()->addChild(node);
-    REQUIRE(nodeTree.contains(node));
+    REQUIRE(worldNode.nodeTree().contains(node));
 
     worldNode.defaultLayer()->removeChild(node);
-    CHECK_FALSE(nodeTree.contains(node));
+    CHECK_FALSE(worldNode.nodeTree().contains(node));
   }
 
   SECTION("Removing a nested node removes from node tree")
@@ -189,10 +195,10 @@ TEST_CASE("WorldNodeTest.nodeTreeUpdates")
     worldNode.defaultLayer()->addChild(groupNode);
 
     auto* node = GENERATE_COPY(entityNode, brushNode, patchNode);
-    REQUIRE(nodeTree.contains(node));
+    REQUIRE(worldNode.nodeTree().contains(node));
 
     groupNode->removeChild(node);
-    CHECK_FALSE(nodeTree.contains(node));
+    CHECK_FALSE(worldNode.nodeTree().contains(node));
   }
 
   SECTION("Removing a subtree removes all children from node tree")
@@ -200,14 +206,14 @@ TEST_CASE("WorldNodeTest.nodeTreeUpdates")
     groupNode->addChildren({entityNode, brushNode, patchNode});
 
     worldNode.defaultLayer()->addChild(groupNode);
-    REQUIRE(nodeTree.contains(entityNode));
-    REQUIRE(nodeTree.contains(brushNode));
-    REQUIRE(nodeTree.contains(patchNode));
+    REQUIRE(worldNode.nodeTree().contains(entityNode));
+    REQUIRE(worldNode.nodeTree().contains(brushNode));
+    REQUIRE(worldNode.nodeTree().contains(patchNode));
 
     worldNode.defaultLayer()->removeChild(groupNode);
-    CHECK_FALSE(nodeTree.contains(entityNode));
-    CHECK_FALSE(nodeTree.contains(brushNode));
-    CHECK_FALSE(nodeTree.contains(patchNode));
+    CHECK_FALSE(worldNode.nodeTree().contains(entityNode));
+    CHECK_FALSE(worldNode.nodeTree().contains(brushNode));
+    CHECK_FALSE(worldNode.nodeTree().contains(patchNode));
   }
 
   SECTION("Updating a descendant updates it in node tree")
@@ -215,14 +221,14 @@ TEST_CASE("WorldNodeTest.nodeTreeUpdates")
     groupNode->addChildren({entityNode, brushNode, patchNode});
     worldNode.defaultLayer()->addChild(groupNode);
 
-    REQUIRE(nodeTree.contains(entityNode));
-    REQUIRE(nodeTree.contains(brushNode));
-    REQUIRE(nodeTree.contains(patchNode));
+    REQUIRE(worldNode.nodeTree().contains(entityNode));
+    REQUIRE(worldNode.nodeTree().contains(brushNode));
+    REQUIRE(worldNode.nodeTree().contains(patchNode));
     REQUIRE_THAT(
-      nodeTree.find_containers(vm::vec3d::zero()),
+      worldNode.nodeTree().find_containers(vm::vec3d::zero()),
       Catch::UnorderedEquals(std::vector<Node*>{entityNode, brushNode, patchNode}));
     REQUIRE_THAT(
-      nodeTree.find_containers(vm::vec3d{384, 384, 384}),
+      worldNode.nodeTree().find_containers(vm::vec3d{384, 384, 384}),
       Catch::UnorderedEquals(std::vector<Node*>{}));
 
     transformNode(
@@ -232,16 +238,84 @@ TEST_CASE("WorldNodeTest.nodeTreeUpdates")
     transformNode(
       *patchNode, vm::translation_matrix(vm::vec3d(384, 384, 384)), worldBounds);
 
-    CHECK(nodeTree.contains(entityNode));
-    CHECK(nodeTree.contains(brushNode));
-    CHECK(nodeTree.contains(patchNode));
+    CHECK(worldNode.nodeTree().contains(entityNode));
+    CHECK(worldNode.nodeTree().contains(brushNode));
+    CHECK(worldNode.nodeTree().contains(patchNode));
     CHECK_THAT(
-      nodeTree.find_containers(vm::vec3d::zero()),
+      worldNode.nodeTree().find_containers(vm::vec3d::zero()),
       Catch::UnorderedEquals(std::vector<Node*>{}));
     CHECK_THAT(
-      nodeTree.find_containers(vm::vec3d{384, 384, 384}),
+      worldNode.nodeTree().find_containers(vm::vec3d{384, 384, 384}),
       Catch::UnorderedEquals(std::vector<Node*>{entityNode, brushNode, patchNode}));
   }
+
+  SECTION("Updates are applied when the node tree is queried")
+  {
+    entityNode->addChild(brushNode);
+    worldNode.defaultLayer()->addChild(entityNode);
+
+    transformNode(
+      *brushNode, vm::translation_matrix(vm::vec3d(384, 384, 384)), worldBounds);
+
+    CHECK_THAT(
+      worldNode.nodeTree().find_containers(vm::vec3d::zero()),
+      Catch::UnorderedEquals(std::vector<Node*>{}));
+    CHECK_THAT(
+      worldNode.nodeTree().find_containers(vm::vec3d{384, 384, 384}),
+      Catch::UnorderedEquals(std::vector<Node*>{entityNode, brushNode}));
+  }
+
+  SECTION("Adding and removing a node before the node tree is queried")
+  {
+    auto* node = GENERATE_COPY(entityNode, brushNode, patchNode);
+
+    worldNode.defaultLayer()->addChild(node);
+    worldNode.defaultLayer()->removeChild(node);
+    CHECK_FALSE(worldNode.nodeTree().contains(node));
+    CHECK(worldNode.nodeTree().empty());
+  }
+
+  SECTION("Pending changes are applied in a batch or by rebuilding the node tree")
+  {
+    const auto rebuildThreshold = GENERATE(0.0, 0.5, 10.0);
+    worldNode.setNodeTreeRebuildThreshold(rebuildThreshold);
+
+    groupNode->addChildren({entityNode, brushNode});
+    worldNode.defaultLayer()->addChild(groupNode);
+    worldNode.defaultLayer()->addChild(patchNode);
+    REQUIRE(worldNode.nodeTree().size() == 3u);
+
+    transformNode(
+      *brushNode, vm::translation_matrix(vm::vec3d(384, 384, 384)), worldBounds);
+    worldNode.defaultLayer()->removeChild(patchNode);
+    worldNode.defaultLayer()->addChild(patchNode);
+    transformNode(
+      *patchNode, vm::translation_matrix(vm::vec3d(384, 384, 384)), worldBounds);
+    groupNode->removeChild(entityNode);
+
+    CHECK(worldNode.nodeTree().size() == 2u);
+    CHECK_FALSE(worldNode.nodeTree().contains(entityNode));
+    CHECK_THAT(
+      worldNode.nodeTree().find_containers(vm::vec3d::zero()),
+      Catch::UnorderedEquals(std::vector<Node*>{}));
+    CHECK_THAT(
+      worldNode.nodeTree().find_containers(vm::vec3d{384, 384, 384}),
+      Catch::UnorderedEquals(std::vector<Node*>{brushNode, patchNode}));
+  }
+
+  SECTION("Removing a node discards its pending update")
+  {
+    worldNode.defaultLayer()->addChild(brushNode);
+
+    transformNode(
+      *brushNode, vm::translation_matrix(vm::vec3d(384, 384, 384)), worldBounds);
+    worldNode.defaultLayer()->removeChild(brushNode);
+
+    CHECK_FALSE(worldNode.nodeTree().contains(brushNode));
+    CHECK_THAT(
+      worldNode.nodeTree().find_containers(vm::vec3d{384, 384, 384}),
+      Catch::UnorderedEquals(std::vector<Node*>{}));
+  }
 }
 
 TEST_CASE("WorldNodeTest.rebuildNodeTree")
@@ -319,7 +393,90 @@ TEST_CASE("WorldNodeTest.disableNodeTreeUpdates")
 
   worldNode.enableNodeTreeUpdates();
   groupNode->addChild(patchNode);
-  CHECK(nodeTree.contains(patchNode));
+  CHECK(worldNode.nodeTree().contains(patchNode));
+}
+
+TEST_CASE("WorldNodeTest.cloneRecursively")
+{
+  constexpr auto worldBounds = vm::bbox3d{8192.0};
+
+  auto worldNode = WorldNode{{}, {}, MapFormat::Quake3};
+
+  auto* defaultLayerNode = worldNode.defaultLayer();
+  auto defaultLayer = defaultLayerNode->layer();
+  defaultLayer.setColor(Color{1.0f, 0.0f, 0.0f});
+  defaultLayerNode->setLayer(std::move(defaultLayer));
+  defaultLayerNode->setLockState(LockState::Locked);
+  defaultLayerNode->setVisibilityState(VisibilityState::Hidden);
+
+  auto* entityNode = new EntityNode{Entity{}};
+  defaultLayerNode->addChild(entityNode);
+  auto* layerNode = new LayerNode{Layer{"layer"}};
+  worldNode.addChild(layerNode);
+
+  const auto worldClone = std::unique_ptr<WorldNode>{static_cast<WorldNode*>(
+    worldNode.cloneRecursively(worldBounds, SetLinkId::keep))};
+
+  const auto* defaultLayerClone = worldClone->defaultLayer();
+  CHECK(defaultLayerClone->layer() == defaultLayerNode->layer());
+  CHECK(defaultLayerClone->lockState() == LockState::Locked);
+  CHECK(defaultLayerClone->visibilityState() == VisibilityState::Hidden);
+  CHECK(defaultLayerClone->childCount() == 1u);
+  CHECK(worldClone->customLayers().size() == 1u);
+}
+
+TEST_CASE("WorldNodeTest.validateLinksConcurrently")
+{
+  const auto data = R"(
+{
+"classname" "worldspawn"
+}
+{
+"classname" "light"
+"target" "spot1"
+}
+{
+"classname" "info_null"
+"targetname" "spot1"
+}
+{
+"classname" "light"
+"target" "spot2"
+}
+{
+"classname" "info_null"
+"targetname" "spot2"
+}
+{
+"classname" "light"
+"target" "missing"
+}
+)";
+
+  auto status = IO::TestParserStatus{};
+  auto worldNode = IO::WorldReader::tryRead(
+    data, {MapFormat::Standard}, vm::bbox3{8192.0}, {}, status);
+  REQUIRE(worldNode != nullptr);
+
+  SECTION("Without flushing the entity node index")
+  {
+    // the first concurrent queries insert the properties of the freshly loaded entities
+  }
+
+  SECTION("After flushing the entity node index")
+  {
+    worldNode->flushEntityNodeIndex();
+  }
+
+  const auto validator = LinkTargetValidator{};
+  const auto issueCounts = kdl::vec_parallel_transform(
+    worldNode->defaultLayer()->children(), [&](Node* node) {
+      auto issues = std::vector<std::unique_ptr<Issue>>{};
+      validator.validate(*node, issues);
+      return issues.size();
+    });
+
+  CHECK(issueCounts == std::vector<size_t>{0, 0, 0, 0, 1});
 }
 
 TEST_CASE("WorldNodeTest.persistentIdOfDefaultLayer")
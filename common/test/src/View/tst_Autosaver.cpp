@@ -97,6 +97,7 @@ TEST_CASE_METHOD(MapDocumentTest, "MapDocumentTest.autosaverNoSaveUntilSaveInter
   document->addNodes({{document->currentLayer(), {createBrushNode("some_material")}}});
 
   autosaver.triggerAutosave(logger);
+  autosaver.finishPendingAutosave(logger);
 
   CHECK_FALSE(env.fileExists("autosave/test.1.map"));
   CHECK_FALSE(env.directoryExists("autosave"));
@@ -114,6 +115,7 @@ TEST_CASE_METHOD(MapDocumentTest, "MapDocumentTest.autosaverNoSaveOfUnchangedMap
 
   auto autosaver = Autosaver{document, 0s};
   autosaver.triggerAutosave(logger);
+  autosaver.finishPendingAutosave(logger);
 
   CHECK_FALSE(env.fileExists("autosave/test.1.map"));
   CHECK_FALSE(env.directoryExists("autosave"));
@@ -137,6 +139,7 @@ TEST_CASE_METHOD(MapDocumentTest, "MapDocumentTest.autosaverSavesAfterSaveInterv
   std::this_thread::sleep_for(100ms);
 
   autosaver.triggerAutosave(logger);
+  autosaver.finishPendingAutosave(logger);
 
   CHECK(env.fileExists("autosave/test.1.map"));
   CHECK(env.directoryExists("autosave"));
@@ -160,6 +163,7 @@ TEST_CASE_METHOD(MapDocumentTest, "MapDocumentTest.autosaverSavesAgainAfterSaveI
   std::this_thread::sleep_for(100ms);
 
   autosaver.triggerAutosave(logger);
+  autosaver.finishPendingAutosave(logger);
 
   CHECK(env.fileExists("autosave/test.1.map"));
   CHECK(env.directoryExists("autosave"));
@@ -169,12 +173,14 @@ TEST_CASE_METHOD(MapDocumentTest, "MapDocumentTest.autosaverSavesAgainAfterSaveI
   std::this_thread::sleep_for(100ms);
 
   autosaver.triggerAutosave(logger);
+  autosaver.finishPendingAutosave(logger);
   CHECK_FALSE(env.fileExists("autosave/test.2.map"));
 
   // modify the map
   document->addNodes({{document->currentLayer(), {createBrushNode("some_material")}}});
 
   autosaver.triggerAutosave(logger);
+  autosaver.finishPendingAutosave(logger);
   CHECK(env.fileExists("autosave/test.2.map"));
 }
 
@@ -220,6 +226,7 @@ TEST_CASE_METHOD(MapDocumentTest, "MapDocumentTest.autosaverCleanup")
 
     std::this_thread::sleep_for(100ms);
     autosaver.triggerAutosave(logger);
+    autosaver.finishPendingAutosave(logger);
 
     const auto allPaths = kdl::vec_push_back(initialPaths, "autosave/test.3.map");
 
@@ -244,6 +251,7 @@ TEST_CASE_METHOD(MapDocumentTest, "MapDocumentTest.autosaverCleanup")
 
     std::this_thread::sleep_for(100ms);
     autosaver.triggerAutosave(logger);
+    autosaver.finishPendingAutosave(logger);
 
     CHECK(env.directoryContents("autosave") == allPaths);
     CHECK(
@@ -305,6 +313,7 @@ TEST_CASE_METHOD(MapDocumentTest, "MapDocumentTest.autosaverCleanup")
 
     std::this_thread::sleep_for(100ms);
     autosaver.triggerAutosave(logger);
+    autosaver.finishPendingAutosave(logger);
 
     const auto allPaths = std::vector<std::filesystem::path>{
       "autosave/test.1.map",
@@ -330,6 +339,39 @@ TEST_CASE_METHOD(MapDocumentTest, "MapDocumentTest.autosaverCleanup")
   }
 }
 
+TEST_CASE_METHOD(MapDocumentTest, "MapDocumentTest.autosaverWritesSnapshot")
+{
+  using namespace std::chrono_literals;
+
+  auto env = IO::TestEnvironment{};
+  auto logger = NullLogger{};
+
+  document->saveDocumentAs(env.dir() / "test.map");
+  assert(env.fileExists("test.map"));
+
+  auto autosaver = Autosaver{document, 0s};
+
+  // modify the map
+  document->addNodes({{document->currentLayer(), {new Model::EntityNode{{}}}}});
+  autosaver.triggerAutosave(logger);
+
+  // modify the map again while the autosave is pending
+  document->addNodes({{document->currentLayer(), {new Model::EntityNode{{}}}}});
+  autosaver.finishPendingAutosave(logger);
+
+  CHECK(
+    env.directoryContents("autosave")
+    == std::vector<std::filesystem::path>{"autosave/test.1.map"});
+  CHECK(env.loadFile("autosave/test.1.map") == R"(// entity 0
+{
+"classname" "worldspawn"
+}
+// entity 1
+{
+}
+)");
+}
+
 TEST_CASE_METHOD(MapDocumentTest, "MapDocumentTest.autosaverSavesWhenCrashFilesPresent")
 {
   // https://github.com/TrenchBroom/TrenchBroom/issues/2544
@@ -352,6 +394,7 @@ TEST_CASE_METHOD(MapDocumentTest, "MapDocumentTest.autosaverSavesWhenCrashFilesP
   document->addNodes({{document->currentLayer(), {createBrushNode("some_material")}}});
 
   autosaver.triggerAutosave(logger);
+  autosaver.finishPendingAutosave(logger);
 
   CHECK(env.fileExists("autosave/test.2.map"));
 }
@@ -18,9 +18,12 @@
  */
 
 #include "Assets/EntityDefinition.h"
+#include "Assets/EntityModel.h"
 #include "Assets/PropertyDefinition.h"
+#include "Assets/Resource.h"
 #include "Error.h"
 #include "Exceptions.h"
+#include "IO/ELParser.h"
 #include "IO/WorldReader.h"
 #include "MapDocumentTest.h"
 #include "Model/BrushBuilder.h"
@@ -40,6 +43,7 @@
 #include "kdl/result.h"
 #include "kdl/vector_utils.h"
 
+#include <algorithm>
 #include <filesystem>
 
 #include "Catch2.h"
@@ -121,6 +125,66 @@ TEST_CASE_METHOD(MapDocumentTest, "MapDocumentTest.throwExceptionDuringCommand")
   CHECK_THROWS_AS(document->throwExceptionDuringCommand(), CommandProcessorException);
 }
 
+TEST_CASE("MapDocumentTest.memoryUsage")
+{
+  auto [document, game, gameConfig] = View::loadMapDocument(
+    "fixture/test/View/MapDocumentTest/memoryUsage.map",
+    "Quake",
+    Model::MapFormat::Standard);
+
+  const auto memoryUsage = [&, &document = document](const std::string& name) {
+    const auto entries = document->memoryUsage();
+    const auto it = std::find_if(entries.begin(), entries.end(), [&](const auto& entry) {
+      return entry.name == name;
+    });
+    REQUIRE(it != entries.end());
+    return it->bytes;
+  };
+
+  document->selectAllNodes();
+  REQUIRE(document->selectedNodes().brushes().size() == 14u);
+  REQUIRE(document->selectedNodes().entities().size() == 8u);
+
+  SECTION("Estimates stay within fixed budgets")
+  {
+    // upper budgets for this map, about one and a half times the estimates when they were
+    // written; exceeding one means that a subsystem has grown and the budget must be
+    // revisited deliberately
+    CHECK(memoryUsage("Brushes") <= 140u * 1024u);
+    CHECK(memoryUsage("Patches") == 0u);
+    CHECK(memoryUsage("Entities") <= 15u * 1024u);
+    CHECK(memoryUsage("Worlds, layers and groups") <= 3u * 1024u);
+    CHECK(memoryUsage("Node tree") <= 5u * 1024u);
+    CHECK(memoryUsage("Entity property index") <= 14u * 1024u);
+    CHECK(memoryUsage("Undo history") <= 1024u);
+  }
+
+  SECTION("Brush usage follows the number of brushes")
+  {
+    const auto brushesUsage = memoryUsage("Brushes");
+    document->duplicateObjects();
+
+    // the copies share their geometry with the originals
+    CHECK(memoryUsage("Brushes") > brushesUsage);
+    CHECK(memoryUsage("Brushes") < 2u * brushesUsage);
+
+    // the undo history retains the copies, so the originals still share their geometry
+    document->undoCommand();
+    CHECK(memoryUsage("Brushes") < brushesUsage);
+  }
+
+  SECTION("Undo history grows with edits")
+  {
+    const auto brushesUsage = memoryUsage("Brushes");
+    const auto undoUsage = memoryUsage("Undo history");
+    REQUIRE(document->translateObjects({16, 0, 0}));
+
+    // the undo history retains the previous contents of the translated nodes
+    CHECK(memoryUsage("Undo history") > undoUsage + brushesUsage / 2u);
+    CHECK(memoryUsage("Brushes") == brushesUsage);
+  }
+}
+
 TEST_CASE("MapDocumentTest.detectValveFormatMap")
 {
   auto [document, game, gameConfig] = View::loadMapDocument(
@@ -194,6 +258,38 @@ TEST_CASE("MapDocument.reloadMaterialCollections")
     kdl::none_of(faces, [](const auto* face) { return face->material() == nullptr; }));
 }
 
+TEST_CASE("MapDocumentTest.updateEntityBoundsWhenModelIsLoaded")
+{
+  auto [document, game, gameConfig] =
+    View::newMapDocument("Quake", Model::MapFormat::Standard);
+
+  auto definitionOwner = std::make_unique<Assets::PointEntityDefinition>(
+    "some_name",
+    Color{},
+    vm::bbox3{8.0},
+    "",
+    std::vector<std::shared_ptr<Assets::PropertyDefinition>>{},
+    Assets::ModelDefinition{IO::ELParser::parseStrict(R"("cube.bsp")")},
+    Assets::DecalDefinition{});
+  document->setEntityDefinitions(kdl::vec_from<std::unique_ptr<Assets::EntityDefinition>>(
+    std::move(definitionOwner)));
+
+  auto* entityNode = new Model::EntityNode{Model::Entity{{
+    {"classname", "some_name"},
+  }}};
+  document->addNodes({{document->parentForNodes(), {entityNode}}});
+
+  // the entity uses the bounds of its definition while its model is loading
+  REQUIRE(entityNode->entity().model() != nullptr);
+  REQUIRE(entityNode->entity().model()->data() == nullptr);
+  CHECK(entityNode->physicalBounds() == vm::bbox3{8.0});
+
+  document->processResourcesSync(Assets::ProcessContext{false});
+
+  REQUIRE(entityNode->entity().model()->data() != nullptr);
+  CHECK(entityNode->physicalBounds() == vm::bbox3{32.0});
+}
+
 TEST_CASE_METHOD(MapDocumentTest, "Brush Node Selection")
 {
   auto* brushNodeInDefaultLayer = createBrushNode("brushNodeInDefaultLayer");
@@ -695,6 +695,34 @@ TEST_CASE_METHOD(TagManagementTest, "TagManagementTest.tagRemoveBrushFaceTags")
   }
 }
 
+TEST_CASE_METHOD(
+  TagManagementTest, "TagManagementTest.updateBrushFaceTagsAfterReloadingMaterials")
+{
+  auto* brushNode = createBrushNode("some_material");
+  document->addNodes({{document->parentForNodes(), {brushNode}}});
+
+  const auto& materialTag = document->smartTag("material");
+  const auto& surfaceParmTag = document->smartTag("surfaceparm_multi");
+
+  for (const auto& face : brushNode->brush().faces())
+  {
+    REQUIRE(face.material() == m_materialA);
+    REQUIRE(face.hasTag(materialTag));
+    REQUIRE(face.hasTag(surfaceParmTag));
+  }
+
+  // the test game does not load a material named some_material, so the faces lose the
+  // tags that depend on the material's surface parameters
+  document->reloadMaterialCollections();
+
+  for (const auto& face : brushNode->brush().faces())
+  {
+    CHECK(face.material() == nullptr);
+    CHECK(face.hasTag(materialTag));
+    CHECK_FALSE(face.hasTag(surfaceParmTag));
+  }
+}
+
 TEST_CASE_METHOD(TagManagementTest, "TagManagementTest.tagUpdateBrushFaceTags")
 {
   auto* brushNode = createBrushNode("asdf");
@@ -229,6 +229,62 @@ TEST_CASE_METHOD(UpdateLinkedGroupsHelperTest, "applyLinkedGroupUpdates")
     == originalBrushBounds.translate(vm::vec3(32.0, 0.0, 0.0)));
 }
 
+TEST_CASE_METHOD(UpdateLinkedGroupsHelperTest, "applyLinkedGroupUpdatesForChangedNodes")
+{
+  auto* groupNode = new Model::GroupNode{Model::Group{"test"}};
+  setLinkId(*groupNode, "asdf");
+
+  auto* brushNode = createBrushNode();
+  groupNode->addChild(brushNode);
+
+  auto* linkedGroupNode = static_cast<Model::GroupNode*>(
+    groupNode->cloneRecursively(document->worldBounds(), Model::SetLinkId::keep));
+
+  REQUIRE(linkedGroupNode->children().size() == 1u);
+  auto* linkedBrushNode =
+    dynamic_cast<Model::BrushNode*>(linkedGroupNode->children().front());
+  REQUIRE(linkedBrushNode != nullptr);
+
+  transformNode(
+    *linkedGroupNode,
+    vm::translation_matrix(vm::vec3(32.0, 0.0, 0.0)),
+    document->worldBounds());
+
+  document->addNodes({{document->parentForNodes(), {groupNode, linkedGroupNode}}});
+
+  const auto originalBrushBounds = brushNode->physicalBounds();
+
+  transformNode(
+    *brushNode,
+    vm::translation_matrix(vm::vec3(0.0, 16.0, 0.0)),
+    document->worldBounds());
+
+  // propagate changes
+  auto helper = UpdateLinkedGroupsHelper{{groupNode}, {{groupNode, {brushNode}}}};
+  REQUIRE(
+    helper
+      .applyLinkedGroupUpdates(*static_cast<MapDocumentCommandFacade*>(document.get()))
+      .is_success());
+
+  // the linked brush node was updated in place
+  CHECK_THAT(
+    linkedGroupNode->children(),
+    Catch::Equals(std::vector<Model::Node*>{linkedBrushNode}));
+  CHECK(
+    linkedBrushNode->physicalBounds()
+    == originalBrushBounds.translate(vm::vec3(32.0, 16.0, 0.0)));
+
+  // undo change propagation
+  helper.undoLinkedGroupUpdates(*static_cast<MapDocumentCommandFacade*>(document.get()));
+
+  CHECK_THAT(
+    linkedGroupNode->children(),
+    Catch::Equals(std::vector<Model::Node*>{linkedBrushNode}));
+  CHECK(
+    linkedBrushNode->physicalBounds()
+    == originalBrushBounds.translate(vm::vec3(32.0, 0.0, 0.0)));
+}
+
 static void setGroupName(Model::GroupNode& groupNode, const std::string& name)
 {
   auto group = groupNode.group();
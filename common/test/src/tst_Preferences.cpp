@@ -27,6 +27,7 @@
 #include "PreferenceManager.h"
 #include "Preferences.h"
 #include "QtPrettyPrinters.h"
+#include "TestPreferenceManager.h"
 #include "View/Actions.h"
 
 #include "kdl/vector_utils.h"
@@ -286,6 +287,51 @@ TEST_CASE("PreferencesTest.serializeKeyboardShortcut")
     QKeySequence::fromString("Meta+W")); // "Meta" in Qt = Control in macOS
 }
 
+TEST_CASE("PreferencesTest.snapshot")
+{
+  auto& prefs = PreferenceManager::instance();
+
+  const auto originalSnapshot = prefs.snapshot();
+  REQUIRE(originalSnapshot->version == prefs.snapshotVersion());
+  REQUIRE(originalSnapshot->alignmentLock == pref(Preferences::AlignmentLock));
+
+  {
+    const auto setPref =
+      TemporarilySetPref{Preferences::AlignmentLock, !originalSnapshot->alignmentLock};
+
+    const auto snapshot = prefs.snapshot();
+    CHECK(snapshot->version > originalSnapshot->version);
+    CHECK(snapshot->version == prefs.snapshotVersion());
+    CHECK(snapshot->alignmentLock == !originalSnapshot->alignmentLock);
+
+    // published snapshots are never modified
+    CHECK(originalSnapshot->alignmentLock != pref(Preferences::AlignmentLock));
+  }
+
+  CHECK(prefs.snapshot()->alignmentLock == originalSnapshot->alignmentLock);
+
+  SECTION("Changing a preference that is not in the snapshot")
+  {
+    const auto version = prefs.snapshotVersion();
+    const auto setPref =
+      TemporarilySetPref{Preferences::UVLock, !pref(Preferences::UVLock)};
+
+    CHECK(prefs.snapshotVersion() == version);
+  }
+}
+
+TEST_CASE("PreferencesTest.defaultSnapshot")
+{
+  const auto prefs = TestPreferenceManager{};
+
+  const auto snapshot = prefs.snapshot();
+  CHECK(snapshot->version == 0);
+  CHECK(snapshot->showPointEntities == Preferences::ShowPointEntities.defaultValue());
+  CHECK(snapshot->showBrushes == Preferences::ShowBrushes.defaultValue());
+  CHECK(snapshot->alignmentLock == Preferences::AlignmentLock.defaultValue());
+  CHECK(snapshot->handleRadius == Preferences::HandleRadius.defaultValue());
+}
+
 TEST_CASE("PreferencesTest.testWxViewShortcutsAndMenuShortcutsRecognized")
 {
   // All map view shortcuts, and all binadable menu items before the Qt port
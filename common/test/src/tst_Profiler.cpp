@@ -0,0 +1,215 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Profiler.h"
+
+#include <atomic>
+#include <chrono>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Catch2.h"
+
+namespace TrenchBroom
+{
+using namespace std::chrono_literals;
+
+namespace
+{
+auto makeTime(const ProfilerEvent::Clock::duration offset)
+{
+  return ProfilerEvent::Clock::time_point{} + offset;
+}
+
+auto eventNames(const std::vector<ProfilerEvent>& events)
+{
+  auto result = std::vector<std::string>{};
+  for (const auto& event : events)
+  {
+    result.emplace_back(event.name);
+  }
+  return result;
+}
+} // namespace
+
+TEST_CASE("Profiler.events")
+{
+  Profiler::clear();
+
+  Profiler::recordZone("Test", "b", makeTime(20ms), makeTime(30ms));
+  Profiler::recordZone("Test", "a", makeTime(10ms), makeTime(40ms));
+  Profiler::recordZone("Test", "c", makeTime(30ms), makeTime(35ms));
+
+  SECTION("Returns all events sorted by start time")
+  {
+    const auto events = Profiler::events();
+    CHECK(eventNames(events) == std::vector<std::string>{"a", "b", "c"});
+    CHECK(events[0].type == ProfilerEventType::Zone);
+    CHECK(events[0].duration == 30ms);
+  }
+
+  SECTION("Returns events that started in the given interval")
+  {
+    CHECK(
+      eventNames(Profiler::events(makeTime(20ms), makeTime(30ms)))
+      == std::vector<std::string>{"b"});
+    CHECK(
+      eventNames(Profiler::events(makeTime(15ms), makeTime(31ms)))
+      == std::vector<std::string>{"b", "c"});
+  }
+
+  SECTION("Clear discards all events")
+  {
+    Profiler::clear();
+    CHECK(Profiler::events().empty());
+  }
+
+  Profiler::clear();
+}
+
+TEST_CASE("Profiler.eventsFromOtherThreads")
+{
+  Profiler::clear();
+
+  Profiler::recordZone("Test", "main", makeTime(10ms), makeTime(20ms));
+  auto thread = std::thread{
+    [] { Profiler::recordZone("Test", "worker", makeTime(15ms), makeTime(20ms)); }};
+  thread.join();
+
+  const auto events = Profiler::events();
+  REQUIRE(eventNames(events) == std::vector<std::string>{"main", "worker"});
+  CHECK(events[0].threadIndex != events[1].threadIndex);
+
+  Profiler::clear();
+}
+
+TEST_CASE("Profiler.eventsWhileRecording")
+{
+  Profiler::clear();
+
+  auto done = std::atomic<bool>{false};
+  auto thread = std::thread{[&] {
+    for (std::size_t i = 0; i < 8 * Profiler::EventsPerThread; ++i)
+    {
+      const auto start = makeTime(std::chrono::milliseconds{i});
+      Profiler::recordZone("Test", "worker", start, start + start.time_since_epoch());
+    }
+    done = true;
+  }};
+
+  // every event must be read as it was recorded, even if the worker overwrites it
+  auto consistent = true;
+  while (!done)
+  {
+    for (const auto& event : Profiler::events())
+    {
+      consistent =
+        consistent && event.duration == event.start.time_since_epoch()
+        && std::string{event.name} == "worker";
+    }
+  }
+  thread.join();
+
+  CHECK(consistent);
+  CHECK(Profiler::events().size() == Profiler::EventsPerThread);
+
+  Profiler::clear();
+}
+
+TEST_CASE("Profiler.retainsMostRecentEvents")
+{
+  Profiler::clear();
+
+  for (std::size_t i = 0; i < Profiler::EventsPerThread + 2; ++i)
+  {
+    const auto start = makeTime(std::chrono::milliseconds{i});
+    Profiler::recordZone("Test", i < 2 ? "old" : "new", start, start);
+  }
+
+  const auto events = Profiler::events();
+  CHECK(events.size() == Profiler::EventsPerThread);
+  CHECK(events.front().start == makeTime(2ms));
+  CHECK(events.back().start == makeTime(std::chrono::milliseconds{events.size() + 1}));
+
+  Profiler::clear();
+}
+
+TEST_CASE("Profiler.zoneStatistics")
+{
+  const auto events = std::vector<ProfilerEvent>{
+    {ProfilerEventType::Zone, "Test", "a", makeTime(0ms), 10ms, 0, 0},
+    {ProfilerEventType::Zone, "Test", "b", makeTime(0ms), 30ms, 0, 0},
+    {ProfilerEventType::Counter, "Test", "a", makeTime(0ms), 0ms, 100, 0},
+    {ProfilerEventType::Zone, "Test", "a", makeTime(20ms), 5ms, 0, 1},
+  };
+
+  const auto statistics = Profiler::zoneStatistics(events);
+  REQUIRE(statistics.size() == 2);
+  CHECK(std::string{statistics[0].name} == "b");
+  CHECK(statistics[0].count == 1);
+  CHECK(statistics[0].totalDuration == 30ms);
+  CHECK(std::string{statistics[1].name} == "a");
+  CHECK(statistics[1].count == 2);
+  CHECK(statistics[1].totalDuration == 15ms);
+}
+
+TEST_CASE("Profiler.writeChromeTrace")
+{
+  const auto events = std::vector<ProfilerEvent>{
+    {ProfilerEventType::Zone, "View", "Frame", makeTime(10ms), 2ms, 0, 0},
+    {ProfilerEventType::Counter,
+     "Model",
+     "Brushes \"total\"",
+     makeTime(11ms),
+     0ms,
+     42,
+     1},
+  };
+
+  auto str = std::stringstream{};
+  Profiler::writeChromeTrace(str, events);
+
+  CHECK(
+    str.str()
+    == R"({"traceEvents":[
+{"name":"Frame","cat":"View","pid":1,"tid":0,"ts":0.000,"ph":"X","dur":2000.000},
+{"name":"Brushes \"total\"","cat":"Model","pid":1,"tid":1,"ts":1000.000,"ph":"C","args":{"value":42}}
+]}
+)");
+}
+
+TEST_CASE("Profiler.profileZone")
+{
+  Profiler::clear();
+
+  {
+    profileZone("Test", "zone");
+    profileCounter("Test", "counter", 7);
+  }
+
+  const auto events = Profiler::events();
+  REQUIRE(eventNames(events) == std::vector<std::string>{"zone", "counter"});
+  CHECK(events[1].value == 7);
+
+  Profiler::clear();
+}
+
+} // namespace TrenchBroom
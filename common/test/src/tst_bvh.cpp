@@ -0,0 +1,126 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "bvh.h"
+
+#include "vm/bbox.h"
+#include "vm/intersection.h"
+#include "vm/ray.h"
+#include "vm/vec.h"
+
+#include <optional>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "Catch2.h"
+
+namespace TrenchBroom
+{
+
+using tree = bvh<float, size_t>;
+
+TEST_CASE("bvh.empty")
+{
+  const auto t = tree{};
+  CHECK(t.empty());
+  CHECK(t.size() == 0u);
+  CHECK(t.find_intersectors(vm::ray3f{vm::vec3f{0, 0, 0}, vm::vec3f{1, 0, 0}}).empty());
+  CHECK(
+    t.intersect(
+      vm::ray3f{vm::vec3f{0, 0, 0}, vm::vec3f{1, 0, 0}},
+      [](const auto) { return std::optional<float>{1.0f}; })
+    == std::nullopt);
+}
+
+TEST_CASE("bvh.find_intersectors")
+{
+  const auto t = tree{{
+    {vm::bbox3f{{0, 0, 0}, {1, 1, 1}}, 1u},
+    {vm::bbox3f{{4, 0, 0}, {5, 1, 1}}, 2u},
+    {vm::bbox3f{{0, 4, 0}, {1, 5, 1}}, 3u},
+  }, 1u};
+
+  CHECK(t.size() == 3u);
+  CHECK(t.bounds() == vm::bbox3f{{0, 0, 0}, {5, 5, 1}});
+
+  using Catch::Matchers::UnorderedEquals;
+  CHECK_THAT(
+    t.find_intersectors(vm::ray3f{vm::vec3f{-1, 0.5f, 0.5f}, vm::vec3f{1, 0, 0}}),
+    UnorderedEquals(std::vector<size_t>{1u, 2u}));
+  CHECK_THAT(
+    t.find_intersectors(vm::ray3f{vm::vec3f{0.5f, 0.5f, 0.5f}, vm::vec3f{0, 1, 0}}),
+    UnorderedEquals(std::vector<size_t>{1u, 3u}));
+  CHECK(t.find_intersectors(vm::ray3f{vm::vec3f{0.5f, 0.5f, 2}, vm::vec3f{0, 0, 1}})
+          .empty());
+}
+
+TEST_CASE("bvh.intersect")
+{
+  // a random triangle soup, compared against a brute force intersection test
+  auto rng = std::mt19937{42};
+  auto dist = std::uniform_real_distribution<float>{-64.0f, 64.0f};
+  auto offset = std::uniform_real_distribution<float>{-4.0f, 4.0f};
+
+  auto triangles = std::vector<vm::vec3f>{};
+  auto items = std::vector<std::pair<vm::bbox3f, size_t>>{};
+  for (size_t i = 0; i < 1000; ++i)
+  {
+    const auto center = vm::vec3f{dist(rng), dist(rng), dist(rng)};
+    const auto p1 = center + vm::vec3f{offset(rng), offset(rng), offset(rng)};
+    const auto p2 = center + vm::vec3f{offset(rng), offset(rng), offset(rng)};
+    const auto p3 = center + vm::vec3f{offset(rng), offset(rng), offset(rng)};
+    triangles.push_back(p1);
+    triangles.push_back(p2);
+    triangles.push_back(p3);
+
+    auto bounds = vm::bbox3f::builder{};
+    bounds.add(p1);
+    bounds.add(p2);
+    bounds.add(p3);
+    items.emplace_back(bounds.bounds(), i);
+  }
+
+  const auto t = tree{items};
+  REQUIRE(t.size() == items.size());
+
+  const auto intersectTriangle = [&](const auto& ray, const size_t i) {
+    return vm::intersect_ray_triangle(
+      ray, triangles[i * 3 + 0], triangles[i * 3 + 1], triangles[i * 3 + 2]);
+  };
+
+  for (size_t i = 0; i < 200; ++i)
+  {
+    const auto origin = vm::vec3f{dist(rng), dist(rng), dist(rng)} * 2.0f;
+    const auto target = vm::vec3f{dist(rng), dist(rng), dist(rng)} / 2.0f;
+    const auto ray = vm::ray3f{origin, vm::normalize(target - origin)};
+
+    auto expected = std::optional<float>{};
+    for (size_t j = 0; j < items.size(); ++j)
+    {
+      expected = vm::safe_min(expected, intersectTriangle(ray, j));
+    }
+
+    CHECK(
+      t.intersect(ray, [&](const size_t j) { return intersectTriangle(ray, j); })
+      == expected);
+  }
+}
+
+} // namespace TrenchBroom
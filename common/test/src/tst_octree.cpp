@@ -546,6 +546,90 @@ TEST_CASE("octree.remove")
   }
 }
 
+TEST_CASE("octree.apply")
+{
+  auto tree = octree<double, int>{
+    32.0,
+    inner_node{
+      {-2, -2, -2, 2},
+      {},
+      kdl::vec_from(
+        node{leaf_node{{-2, -2, -2, 1}, {}}},
+        node{leaf_node{{0, -2, -2, 1}, {}}},
+        node{leaf_node{{-2, 0, -2, 1}, {}}},
+        node{leaf_node{{0, 0, -2, 1}, {}}},
+        node{leaf_node{{-2, -2, 0, 1}, {}}},
+        node{leaf_node{{0, -2, 0, 1}, {}}},
+        node{leaf_node{{-2, 0, 0, 1}, {}}},
+        node{inner_node{
+          {0, 0, 0, 1},
+          {3},
+          kdl::vec_from(
+            node{leaf_node{{0, 0, 0, 0}, {1, 2}}},
+            node{leaf_node{{1, 0, 0, 0}, {}}},
+            node{leaf_node{{0, 1, 0, 0}, {}}},
+            node{leaf_node{{1, 1, 0, 0}, {}}},
+            node{leaf_node{{0, 0, 1, 0}, {}}},
+            node{leaf_node{{1, 0, 1, 0}, {}}},
+            node{leaf_node{{0, 1, 1, 0}, {}}},
+            node{leaf_node{{1, 1, 1, 0}, {}}})}})}};
+
+  SECTION("removing several items collapses the tree once")
+  {
+    tree.apply({1, 2}, {}, 1.0);
+    CHECK(
+      tree
+      == octree<double, int>{
+        32.0,
+        inner_node{
+          {-2, -2, -2, 2},
+          {},
+          kdl::vec_from(
+            node{leaf_node{{-2, -2, -2, 1}, {}}},
+            node{leaf_node{{0, -2, -2, 1}, {}}},
+            node{leaf_node{{-2, 0, -2, 1}, {}}},
+            node{leaf_node{{0, 0, -2, 1}, {}}},
+            node{leaf_node{{-2, -2, 0, 1}, {}}},
+            node{leaf_node{{0, -2, 0, 1}, {}}},
+            node{leaf_node{{-2, 0, 0, 1}, {}}},
+            node{leaf_node{{0, 0, 0, 1}, {3}}})}});
+
+    tree.apply({3}, {}, 1.0);
+    CHECK(tree == octree<double, int>{32.0});
+  }
+
+  SECTION("removing and inserting items")
+  {
+    const auto rebuild_fraction = GENERATE(0.0, 10.0);
+
+    tree.apply(
+      {1, 3},
+      {{vm::bbox3d{{-16, -16, -16}, {-8, -8, -8}}, 4},
+       {vm::bbox3d{{48, 48, 48}, {64, 64, 64}}, 1}},
+      rebuild_fraction);
+
+    CHECK(tree.size() == 3u);
+    CHECK_FALSE(tree.contains(3));
+    CHECK_THAT(
+      tree.find_containers(vm::vec3d{-12, -12, -12}),
+      Catch::UnorderedEquals(std::vector<int>{4}));
+    CHECK_THAT(
+      tree.find_containers(vm::vec3d{56, 56, 56}),
+      Catch::UnorderedEquals(std::vector<int>{1}));
+    CHECK_THAT(
+      tree.find_containers(vm::vec3d{1, 1, 1}),
+      Catch::UnorderedEquals(std::vector<int>{2}));
+  }
+
+  SECTION("invalid changes")
+  {
+    CHECK_THROWS_AS(tree.apply({4}, {}, 1.0), NodeTreeException);
+    CHECK_THROWS_AS(
+      tree.apply({}, {{vm::bbox3d{{0, 0, 0}, {1, 1, 1}}, 1}}, 1.0), NodeTreeException);
+    CHECK(tree.size() == 3u);
+  }
+}
+
 TEST_CASE("octree.insert_duplicate")
 {
   auto tree = octree<double, int>{32.0};
@@ -724,4 +808,21 @@ TEST_CASE("octree.find_containers")
     CHECK(tree.find_containers({64, 64, 64}) == std::vector<int>{1});
   }
 }
+
+TEST_CASE("octree.memory_usage")
+{
+  auto tree = octree<double, int>{32.0};
+  const auto emptyUsage = tree.memory_usage();
+  CHECK(emptyUsage >= sizeof(tree));
+
+  tree.insert({{0, 0, 0}, {2, 2, 2}}, 1);
+  const auto singleUsage = tree.memory_usage();
+  CHECK(singleUsage > emptyUsage);
+
+  tree.insert({{32, 32, 32}, {64, 64, 64}}, 2);
+  CHECK(tree.memory_usage() > singleUsage);
+
+  tree.clear();
+  CHECK(tree.memory_usage() < singleUsage);
+}
 } // namespace TrenchBroom
@@ -653,6 +653,32 @@ private:
       }
     }
 
+    /**
+     * Returns an estimate of the number of bytes used by this node and its subtree. The
+     * estimate includes the node itself, its key, its value map and its children, but
+     * does not account for allocator overhead.
+     */
+    std::size_t memory_usage() const
+    {
+      // every element of an std::set or std::unordered_map is stored in a separately
+      // allocated node along with some bookkeeping pointers
+      constexpr auto set_node_overhead = 3u * sizeof(void*) + sizeof(int);
+      constexpr auto map_node_overhead = sizeof(void*) + sizeof(std::size_t);
+
+      auto result = sizeof(node) + m_key.capacity()
+                    + m_values.bucket_count() * sizeof(void*)
+                    + m_values.size()
+                        * (sizeof(typename value_container::value_type)
+                           + map_node_overhead);
+
+      for (const auto& child : m_children)
+      {
+        result += set_node_overhead + child.memory_usage();
+      }
+
+      return result;
+    }
+
   private:
     void insert_value(const V& value) const { m_values[value]++; }
 
@@ -857,5 +883,14 @@ public:
   {
     m_root.get_keys("", out);
   }
+
+  /**
+   * Returns an estimate of the number of bytes used by this trie. The estimate does not
+   * account for allocator overhead.
+   */
+  std::size_t memory_usage() const
+  {
+    return sizeof(compact_trie) - sizeof(node) + m_root.memory_usage();
+  }
 };
 } // namespace kdl
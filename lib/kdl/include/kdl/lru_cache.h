@@ -0,0 +1,180 @@
+/*
+ Copyright 2010-2019 Kristian Duske
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ software and associated documentation files (the "Software"), to deal in the Software
+ without restriction, including without limitation the rights to use, copy, modify, merge,
+ publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or
+ substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ DEALINGS IN THE SOFTWARE.
+*/
+#pragma once
+
+#include <cassert>
+#include <functional>
+#include <list>
+#include <map>
+#include <utility>
+
+namespace kdl
+{
+/**
+ * A map with a fixed capacity. If an entry is inserted into a full cache, the least
+ * recently used entry is evicted.
+ *
+ * Pointers to values returned by find and references returned by insert remain valid
+ * until the entry is evicted or the cache is cleared.
+ *
+ * @tparam K the key type
+ * @tparam V the value type
+ * @tparam C the key comparator
+ */
+template <typename K, typename V, typename C = std::less<K>>
+class lru_cache
+{
+private:
+  using entry = std::pair<const K, V>;
+  using entry_list = std::list<entry>;
+  using entry_iterator = typename entry_list::iterator;
+
+  struct key_ref_cmp
+  {
+    C cmp;
+
+    bool operator()(
+      const std::reference_wrapper<const K>& lhs,
+      const std::reference_wrapper<const K>& rhs) const
+    {
+      return cmp(lhs.get(), rhs.get());
+    }
+  };
+
+  std::size_t m_capacity;
+  // the most recently used entry comes first
+  entry_list m_entries;
+  std::map<std::reference_wrapper<const K>, entry_iterator, key_ref_cmp> m_index;
+
+public:
+  /**
+   * Creates an empty cache with the given capacity.
+   *
+   * @param capacity the maximum number of entries, must not be 0
+   */
+  explicit lru_cache(const std::size_t capacity)
+    : m_capacity{capacity}
+  {
+    assert(m_capacity > 0);
+  }
+
+  lru_cache(const lru_cache& other)
+    : m_capacity{other.m_capacity}
+    , m_entries{other.m_entries}
+  {
+    rebuild_index();
+  }
+
+  lru_cache(lru_cache&& other) noexcept = default;
+
+  lru_cache& operator=(const lru_cache& other)
+  {
+    *this = lru_cache{other};
+    return *this;
+  }
+
+  lru_cache& operator=(lru_cache&& other) noexcept = default;
+
+  /**
+   * Returns the maximum number of entries.
+   */
+  std::size_t capacity() const { return m_capacity; }
+
+  /**
+   * Returns the number of entries.
+   */
+  std::size_t size() const { return m_entries.size(); }
+
+  /**
+   * Indicates whether this cache is empty.
+   */
+  bool empty() const { return m_entries.empty(); }
+
+  /**
+   * Indicates whether this cache contains an entry with the given key. Does not mark the
+   * entry as used.
+   */
+  bool contains(const K& key) const
+  {
+    return m_index.find(std::cref(key)) != m_index.end();
+  }
+
+  /**
+   * Returns a pointer to the value with the given key and marks the entry as the most
+   * recently used one, or returns nullptr if there is no such entry.
+   */
+  V* find(const K& key)
+  {
+    const auto it = m_index.find(std::cref(key));
+    if (it == m_index.end())
+    {
+      return nullptr;
+    }
+
+    m_entries.splice(m_entries.begin(), m_entries, it->second);
+    return &it->second->second;
+  }
+
+  /**
+   * Inserts the given value with the given key and marks the entry as the most recently
+   * used one. If the cache already contains an entry with the given key, its value is
+   * replaced. Otherwise, if the cache is full, the least recently used entry is evicted.
+   *
+   * @return a reference to the inserted value
+   */
+  V& insert(K key, V value)
+  {
+    if (auto* existingValue = find(key))
+    {
+      *existingValue = std::move(value);
+      return *existingValue;
+    }
+
+    if (m_entries.size() >= m_capacity)
+    {
+      m_index.erase(std::cref(m_entries.back().first));
+      m_entries.pop_back();
+    }
+
+    m_entries.emplace_front(std::move(key), std::move(value));
+    m_index.emplace(std::cref(m_entries.front().first), m_entries.begin());
+    return m_entries.front().second;
+  }
+
+  /**
+   * Removes all entries.
+   */
+  void clear()
+  {
+    m_index.clear();
+    m_entries.clear();
+  }
+
+private:
+  void rebuild_index()
+  {
+    m_index.clear();
+    for (auto it = m_entries.begin(); it != m_entries.end(); ++it)
+    {
+      m_index.emplace(std::cref(it->first), it);
+    }
+  }
+};
+} // namespace kdl
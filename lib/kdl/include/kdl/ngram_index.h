@@ -0,0 +1,205 @@
+/*
+ Copyright 2024 Kristian Duske
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ software and associated documentation files (the "Software"), to deal in the Software
+ without restriction, including without limitation the rights to use, copy, modify, merge,
+ publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or
+ substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+#include "kdl/string_format.h"
+#include "kdl/string_utils.h"
+#include "kdl/vector_utils.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace kdl
+{
+
+/**
+ * Finds the values whose string keys contain a given set of patterns, ignoring case.
+ *
+ * Every key is split into its n-grams, i.e., its substrings of length N, and the index
+ * maps each n-gram to the entries whose keys contain it. A query first narrows down the
+ * candidates to the entries that contain all n-grams of the given patterns, starting with
+ * the rarest n-gram, and then only compares the patterns with the keys of the remaining
+ * candidates. Patterns that are shorter than N are compared with every candidate.
+ */
+template <typename T, std::size_t N = 3>
+class ngram_index
+{
+private:
+  struct entry
+  {
+    std::string key;
+    T value;
+  };
+
+  std::vector<entry> m_entries;
+  std::unordered_map<std::string, std::vector<std::size_t>> m_postings;
+
+public:
+  /**
+   * Adds the given value under the given key. Values are returned by queries in the
+   * order in which they were inserted.
+   */
+  void insert(const std::string_view key, T value)
+  {
+    const auto index = m_entries.size();
+    auto lower_key = str_to_lower(key);
+
+    for (std::size_t i = 0; i + N <= lower_key.size(); ++i)
+    {
+      auto& posting = m_postings[lower_key.substr(i, N)];
+      if (posting.empty() || posting.back() != index)
+      {
+        posting.push_back(index);
+      }
+    }
+
+    m_entries.push_back(entry{std::move(lower_key), std::move(value)});
+  }
+
+  std::size_t size() const { return m_entries.size(); }
+
+  bool empty() const { return m_entries.empty(); }
+
+  void clear()
+  {
+    m_entries.clear();
+    m_postings.clear();
+  }
+
+  /**
+   * Returns an estimate of the number of bytes used by this index. The estimate does not
+   * account for allocator overhead.
+   */
+  std::size_t memory_usage() const
+  {
+    // every element of an std::unordered_map is stored in a separately allocated node
+    // along with a pointer to the next node and its hash
+    constexpr auto map_node_overhead = sizeof(void*) + sizeof(std::size_t);
+
+    auto result = sizeof(ngram_index) + m_entries.capacity() * sizeof(entry)
+                  + m_postings.bucket_count() * sizeof(void*);
+    for (const auto& e : m_entries)
+    {
+      result += str_allocated_size(e.key);
+    }
+    for (const auto& [ngram, posting] : m_postings)
+    {
+      result += map_node_overhead
+                + sizeof(typename decltype(m_postings)::value_type)
+                + str_allocated_size(ngram) + posting.capacity() * sizeof(std::size_t);
+    }
+    return result;
+  }
+
+  /**
+   * Returns the values of all entries whose key contains every one of the given
+   * patterns, ignoring case. Empty patterns match every entry.
+   */
+  std::vector<T> find_all(const std::vector<std::string>& patterns) const
+  {
+    const auto lower_patterns =
+      vec_transform(patterns, [](const auto& pattern) { return str_to_lower(pattern); });
+
+    auto result = std::vector<T>{};
+    if (const auto candidates = find_candidates(lower_patterns))
+    {
+      for (const auto index : *candidates)
+      {
+        add_if_matches(m_entries[index], lower_patterns, result);
+      }
+    }
+    else
+    {
+      for (const auto& e : m_entries)
+      {
+        add_if_matches(e, lower_patterns, result);
+      }
+    }
+    return result;
+  }
+
+private:
+  static void add_if_matches(
+    const entry& e, const std::vector<std::string>& lower_patterns, std::vector<T>& out)
+  {
+    const auto matches = [&](const auto& pattern) {
+      return e.key.find(pattern) != std::string::npos;
+    };
+    if (std::all_of(lower_patterns.begin(), lower_patterns.end(), matches))
+    {
+      out.push_back(e.value);
+    }
+  }
+
+  /**
+   * Returns the sorted indices of the entries that contain every n-gram of the given
+   * patterns, or nothing if none of the patterns is long enough to contain an n-gram.
+   */
+  std::optional<std::vector<std::size_t>> find_candidates(
+    const std::vector<std::string>& lower_patterns) const
+  {
+    auto postings = std::vector<const std::vector<std::size_t>*>{};
+    for (const auto& pattern : lower_patterns)
+    {
+      for (std::size_t i = 0; i + N <= pattern.size(); ++i)
+      {
+        const auto it = m_postings.find(pattern.substr(i, N));
+        if (it == m_postings.end())
+        {
+          return std::vector<std::size_t>{};
+        }
+        postings.push_back(&it->second);
+      }
+    }
+
+    if (postings.empty())
+    {
+      return std::nullopt;
+    }
+
+    std::sort(postings.begin(), postings.end(), [](const auto* lhs, const auto* rhs) {
+      return lhs->size() < rhs->size();
+    });
+
+    auto result = *postings.front();
+    for (auto it = std::next(postings.begin()); it != postings.end() && !result.empty();
+         ++it)
+    {
+      auto intersection = std::vector<std::size_t>{};
+      std::set_intersection(
+        result.begin(),
+        result.end(),
+        (*it)->begin(),
+        (*it)->end(),
+        std::back_inserter(intersection));
+      result = std::move(intersection);
+    }
+    return result;
+  }
+};
+
+} // namespace kdl
@@ -25,6 +25,8 @@
 #include <algorithm> // for std::search
 #include <cassert>
 #include <charconv>
+#include <cstddef>
+#include <functional>
 #include <iterator>
 #include <optional>
 #include <sstream>
@@ -268,6 +270,24 @@ inline std::string str_replace_every(
   return result.str();
 }
 
+/**
+ * Returns the number of bytes the given string has allocated to store its characters.
+ * Returns 0 if the string stores its characters inside the string object itself, which
+ * is the case for short strings.
+ *
+ * @param str the string
+ * @return the number of allocated bytes, including the terminating null character
+ */
+inline std::size_t str_allocated_size(const std::string& str)
+{
+  const auto* data = str.data();
+  const auto* object = reinterpret_cast<const char*>(&str);
+
+  const auto less = std::less<const char*>{};
+  const auto isInline = !less(data, object) && less(data, object + sizeof(std::string));
+  return isInline ? 0u : str.capacity() + 1u;
+}
+
 /**
  * Returns a concatenation of the string representations of the given objects by means of
  * the stream insertion operator.
@@ -208,4 +208,28 @@ TEST_CASE("compact_trie_test.get_keys")
     Catch::UnorderedEquals(
       std::vector<std::string>{"key", "key2", "key22", "key22bs", "k1"}));
 }
+
+TEST_CASE("compact_trie_test.memory_usage")
+{
+  test_index index;
+  const auto empty_usage = index.memory_usage();
+  CHECK(empty_usage >= sizeof(test_index));
+
+  index.insert("key", "value");
+  const auto one_key_usage = index.memory_usage();
+  CHECK(one_key_usage > empty_usage);
+
+  index.insert("key2", "value");
+  index.insert("key22", "value2");
+  index.insert("k1", "value3");
+  const auto four_keys_usage = index.memory_usage();
+  CHECK(four_keys_usage > one_key_usage);
+
+  index.remove("key22", "value2");
+  index.remove("k1", "value3");
+  CHECK(index.memory_usage() < four_keys_usage);
+
+  index.clear();
+  CHECK(index.memory_usage() == empty_usage);
+}
 } // namespace kdl
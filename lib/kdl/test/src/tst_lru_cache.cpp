@@ -0,0 +1,120 @@
+/*
+ Copyright 2010-2019 Kristian Duske
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ software and associated documentation files (the "Software"), to deal in the Software
+ without restriction, including without limitation the rights to use, copy, modify, merge,
+ publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or
+ substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ DEALINGS IN THE SOFTWARE.
+*/
+
+#include "kdl/lru_cache.h"
+
+#include <string>
+
+#include "catch2.h"
+
+namespace kdl
+{
+TEST_CASE("lru_cache_test.insert")
+{
+  auto cache = lru_cache<std::string, int>{2};
+  CHECK(cache.capacity() == 2u);
+  CHECK(cache.empty());
+
+  CHECK(cache.insert("a", 1) == 1);
+  CHECK(cache.size() == 1u);
+
+  CHECK(cache.insert("b", 2) == 2);
+  CHECK(cache.size() == 2u);
+
+  // replaces the existing value
+  CHECK(cache.insert("a", 3) == 3);
+  CHECK(cache.size() == 2u);
+  CHECK(*cache.find("a") == 3);
+}
+
+TEST_CASE("lru_cache_test.find")
+{
+  auto cache = lru_cache<std::string, int>{2};
+  cache.insert("a", 1);
+
+  CHECK(cache.find("b") == nullptr);
+  REQUIRE(cache.find("a") != nullptr);
+  CHECK(*cache.find("a") == 1);
+}
+
+TEST_CASE("lru_cache_test.evict")
+{
+  auto cache = lru_cache<std::string, int>{2};
+  cache.insert("a", 1);
+  cache.insert("b", 2);
+
+  SECTION("Evicts the least recently inserted entry")
+  {
+    cache.insert("c", 3);
+    CHECK(cache.size() == 2u);
+    CHECK(!cache.contains("a"));
+    CHECK(cache.contains("b"));
+    CHECK(cache.contains("c"));
+  }
+
+  SECTION("Evicts the least recently found entry")
+  {
+    cache.find("a");
+    cache.insert("c", 3);
+    CHECK(cache.size() == 2u);
+    CHECK(cache.contains("a"));
+    CHECK(!cache.contains("b"));
+    CHECK(cache.contains("c"));
+  }
+
+  SECTION("Evicts the least recently replaced entry")
+  {
+    cache.insert("a", 4);
+    cache.insert("c", 3);
+    CHECK(cache.contains("a"));
+    CHECK(!cache.contains("b"));
+    CHECK(cache.contains("c"));
+  }
+}
+
+TEST_CASE("lru_cache_test.copy")
+{
+  auto cache = lru_cache<std::string, int>{2};
+  cache.insert("a", 1);
+  cache.insert("b", 2);
+
+  auto copy = cache;
+  cache.clear();
+  CHECK(cache.empty());
+
+  REQUIRE(copy.size() == 2u);
+  CHECK(*copy.find("a") == 1);
+
+  copy.insert("c", 3);
+  CHECK(copy.contains("a"));
+  CHECK(!copy.contains("b"));
+  CHECK(copy.contains("c"));
+}
+
+TEST_CASE("lru_cache_test.clear")
+{
+  auto cache = lru_cache<std::string, int>{2};
+  cache.insert("a", 1);
+  cache.clear();
+
+  CHECK(cache.empty());
+  CHECK(cache.find("a") == nullptr);
+}
+} // namespace kdl
@@ -0,0 +1,88 @@
+/*
+ Copyright 2024 Kristian Duske
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ software and associated documentation files (the "Software"), to deal in the Software
+ without restriction, including without limitation the rights to use, copy, modify, merge,
+ publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or
+ substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ DEALINGS IN THE SOFTWARE.
+*/
+
+#include "kdl/ngram_index.h"
+
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "catch2.h" // IWYU pragma: keep
+
+namespace kdl
+{
+
+TEST_CASE("ngram_index")
+{
+  auto index = ngram_index<int>{};
+  index.insert("textures/base_wall/concrete", 1);
+  index.insert("textures/base_floor/Concrete_Dark", 2);
+  index.insert("textures/sfx/flame", 3);
+  index.insert("ab", 4);
+
+  CHECK(index.size() == 4u);
+  CHECK_FALSE(index.empty());
+
+  SECTION("find_all")
+  {
+    using T = std::tuple<std::vector<std::string>, std::vector<int>>;
+    const auto& [patterns, expected] = GENERATE(values<T>({
+      {{}, {1, 2, 3, 4}},
+      {{""}, {1, 2, 3, 4}},
+      {{"a"}, {1, 2, 3, 4}},
+      {{"wall"}, {1}},
+      {{"CONCRETE"}, {1, 2}},
+      {{"concrete", "floor"}, {2}},
+      {{"concrete", "flame"}, {}},
+      {{"crete", "da"}, {2}},
+      {{"textures/"}, {1, 2, 3}},
+      {{"xyz"}, {}},
+      {{"abc"}, {}},
+    }));
+
+    CAPTURE(patterns);
+
+    CHECK(index.find_all(patterns) == expected);
+  }
+
+  SECTION("clear")
+  {
+    index.clear();
+    CHECK(index.size() == 0u);
+    CHECK(index.empty());
+    CHECK(index.find_all({"concrete"}).empty());
+  }
+}
+
+TEST_CASE("ngram_index.memory_usage")
+{
+  auto index = ngram_index<int>{};
+  const auto empty_usage = index.memory_usage();
+  CHECK(empty_usage >= sizeof(ngram_index<int>));
+
+  index.insert("textures/concrete_wall_with_a_long_name", 1);
+  const auto one_key_usage = index.memory_usage();
+  CHECK(one_key_usage > empty_usage);
+
+  index.insert("textures/concrete_floor_with_a_long_name", 2);
+  CHECK(index.memory_usage() > one_key_usage);
+}
+
+} // namespace kdl
@@ -102,6 +102,14 @@ TEST_CASE("string_utils_test.str_replace_every")
   CHECK(str_replace_every("the brick brown fox", "bro", "cro") == "the brick crown fox");
 }
 
+TEST_CASE("string_utils_test.str_allocated_size")
+{
+  CHECK(str_allocated_size(std::string{}) == 0u);
+
+  const auto longString = std::string(1000, 'x');
+  CHECK(str_allocated_size(longString) == longString.capacity() + 1u);
+}
+
 struct to_string
 {
   std::string x;
@@ -0,0 +1,629 @@
+/*
+ Copyright (C) 2024 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Exceptions.h"
+#include "IO/DiskIO.h"
+#include "IO/ExportOptions.h"
+#include "IO/File.h"
+#include "IO/NodeWriter.h"
+#include "IO/ObjSerializer.h"
+#include "IO/SimpleParserStatus.h"
+#include "IO/WorldReader.h"
+#include "Logger.h"
+#include "Model/BrushNode.h"
+#include "Model/EmptyGroupValidator.h"
+#include "Model/EmptyPropertyKeyValidator.h"
+#include "Model/EmptyPropertyValueValidator.h"
+#include "Model/EntityNode.h"
+#include "Model/EntityProperties.h"
+#include "Model/GroupNode.h"
+#include "Model/InvalidUVScaleValidator.h"
+#include "Model/Issue.h"
+#include "Model/LayerNode.h"
+#include "Model/LinkSourceValidator.h"
+#include "Model/LinkTargetValidator.h"
+#include "Model/LongPropertyKeyValidator.h"
+#include "Model/LongPropertyValueValidator.h"
+#include "Model/MapFormat.h"
+#include "Model/MissingClassnameValidator.h"
+#include "Model/MixedBrushContentsValidator.h"
+#include "Model/NonIntegerVerticesValidator.h"
+#include "Model/PatchNode.h"
+#include "Model/PropertyKeyWithDoubleQuotationMarksValidator.h"
+#include "Model/PropertyValueWithDoubleQuotationMarksValidator.h"
+#include "Model/WorldBoundsValidator.h"
+#include "Model/WorldNode.h"
+
+#include "kdl/overload.h"
+#include "kdl/parallel.h"
+#include "kdl/path_utils.h"
+#include "kdl/result.h"
+#include "kdl/string_compare.h"
+#include "kdl/string_utils.h"
+#include "kdl/vector_utils.h"
+
+#include "vm/bbox.h"
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace TrenchBroom
+{
+namespace
+{
+
+/**
+ * The exit codes are ordered by severity. When several maps are processed, the most
+ * severe exit code is returned.
+ */
+enum class ExitCode
+{
+  Success = 0,
+  IssuesFound = 1,
+  InvalidArguments = 2,
+  ProcessingFailed = 3,
+};
+
+const auto AllMapFormats = std::vector<Model::MapFormat>{
+  Model::MapFormat::Standard,
+  Model::MapFormat::Quake2,
+  Model::MapFormat::Quake2_Valve,
+  Model::MapFormat::Valve,
+  Model::MapFormat::Hexen2,
+  Model::MapFormat::Daikatana,
+  Model::MapFormat::Quake3_Legacy,
+  Model::MapFormat::Quake3_Valve,
+  Model::MapFormat::Quake3,
+};
+
+struct Options
+{
+  std::vector<std::filesystem::path> inputPaths;
+  std::vector<Model::MapFormat> sourceFormats = AllMapFormats;
+  std::optional<Model::MapFormat> targetFormat;
+  std::optional<std::filesystem::path> outputDir;
+  bool writeMap = false;
+  bool exportObj = false;
+  std::vector<std::string> validatorNames;
+  size_t maxPropertyLength = 1023;
+  vm::bbox3 worldBounds = vm::bbox3{-32768.0, 32768.0};
+};
+
+struct ValidatorFactory
+{
+  std::string_view name;
+  std::function<std::unique_ptr<Model::Validator>(const Options&)> create;
+};
+
+template <typename V>
+auto makeValidator()
+{
+  return [](const Options&) { return std::make_unique<V>(); };
+}
+
+/**
+ * The validators that don't depend on a game configuration or on entity definitions.
+ */
+const std::vector<ValidatorFactory>& validatorFactories()
+{
+  static const auto factories = std::vector<ValidatorFactory>{
+    {"empty-group", makeValidator<Model::EmptyGroupValidator>()},
+    {"empty-property-key", makeValidator<Model::EmptyPropertyKeyValidator>()},
+    {"empty-property-value", makeValidator<Model::EmptyPropertyValueValidator>()},
+    {"invalid-uv-scale", makeValidator<Model::InvalidUVScaleValidator>()},
+    {"link-source", makeValidator<Model::LinkSourceValidator>()},
+    {"link-target", makeValidator<Model::LinkTargetValidator>()},
+    {"long-property-key",
+     [](const Options& options) {
+       return std::make_unique<Model::LongPropertyKeyValidator>(
+         options.maxPropertyLength);
+     }},
+    {"long-property-value",
+     [](const Options& options) {
+       return std::make_unique<Model::LongPropertyValueValidator>(
+         options.maxPropertyLength);
+     }},
+    {"missing-classname", makeValidator<Model::MissingClassnameValidator>()},
+    {"mixed-brush-contents", makeValidator<Model::MixedBrushContentsValidator>()},
+    {"non-integer-vertices", makeValidator<Model::NonIntegerVerticesValidator>()},
+    {"property-key-quotes",
+     makeValidator<Model::PropertyKeyWithDoubleQuotationMarksValidator>()},
+    {"property-value-quotes",
+     makeValidator<Model::PropertyValueWithDoubleQuotationMarksValidator>()},
+    {"world-bounds",
+     [](const Options& options) {
+       return std::make_unique<Model::WorldBoundsValidator>(options.worldBounds);
+     }},
+  };
+  return factories;
+}
+
+/**
+ * Logs to stderr. The map reader logs from several threads.
+ */
+class StderrLogger : public Logger
+{
+private:
+  std::mutex m_mutex;
+
+  void doLog(const LogLevel level, const std::string_view message) override
+  {
+    if (level != LogLevel::Debug)
+    {
+      const auto lock = std::lock_guard{m_mutex};
+      std::cerr << message << "\n";
+    }
+  }
+};
+
+class Stopwatch
+{
+private:
+  using Clock = std::chrono::steady_clock;
+  Clock::time_point m_start = Clock::now();
+
+public:
+  std::chrono::milliseconds lap()
+  {
+    const auto now = Clock::now();
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+      now - std::exchange(m_start, now));
+  }
+};
+
+void printUsage(std::ostream& str)
+{
+  str << R"usage(Usage: map-batch [options] <map file>...
+
+Loads the given map files and optionally validates, converts and exports them.
+
+Options:
+  --format <name>             parse the maps as the given format, otherwise all
+                              formats are tried in turn
+  --convert <name>            convert the maps to the given format, implies
+                              --write-map
+  --write-map                 write the maps to the output directory
+  --export-obj                export the maps as OBJ and MTL files to the output
+                              directory
+  --output-dir <path>         the directory to write files to, required by
+                              --write-map and --export-obj
+  --validate <names>          run the given comma separated validators, or all
+                              validators if the name is "all"
+  --list-validators           print the names of the available validators
+  --max-property-length <n>   the maximum length of property keys and values
+                              (default: 1023)
+  --world-bounds <size>       the world bounds extend from -size to +size on each
+                              axis (default: 32768)
+  --help                      print this message
+
+Format names are Standard, Quake2, "Quake2 (Valve)", Valve, Hexen2, Daikatana,
+"Quake3 (legacy)", "Quake3 (Valve)" and Quake3.
+
+Exit codes:
+  0  all maps were processed and no issues were found
+  1  the validators found issues
+  2  the arguments are invalid
+  3  a map could not be loaded or written
+)usage";
+}
+
+std::optional<Model::MapFormat> parseMapFormat(const std::string& name)
+{
+  const auto format = Model::formatFromName(name);
+  if (format == Model::MapFormat::Unknown)
+  {
+    std::cerr << "Unknown map format: " << name << "\n";
+    return std::nullopt;
+  }
+  return format;
+}
+
+bool parseValidatorNames(const std::string& str, std::vector<std::string>& names)
+{
+  for (const auto& name : kdl::str_split(str, ","))
+  {
+    if (name == "all")
+    {
+      for (const auto& factory : validatorFactories())
+      {
+        names.emplace_back(factory.name);
+      }
+    }
+    else if (std::none_of(
+               validatorFactories().begin(),
+               validatorFactories().end(),
+               [&](const auto& factory) { return factory.name == name; }))
+    {
+      std::cerr << "Unknown validator: " << name << "\n";
+      return false;
+    }
+    else
+    {
+      names.push_back(name);
+    }
+  }
+
+  names = kdl::vec_sort_and_remove_duplicates(std::move(names));
+  return true;
+}
+
+/**
+ * Parses the command line arguments. Returns an exit code if the program should exit
+ * without processing any maps.
+ */
+std::optional<ExitCode> parseOptions(
+  const std::vector<std::string>& args, Options& options)
+{
+  for (size_t i = 0; i < args.size(); ++i)
+  {
+    const auto& arg = args[i];
+    const auto nextArg = [&]() -> std::optional<std::string> {
+      if (i + 1 < args.size())
+      {
+        return args[++i];
+      }
+      std::cerr << "Missing value for " << arg << "\n";
+      return std::nullopt;
+    };
+
+    if (arg == "--help")
+    {
+      printUsage(std::cout);
+      return ExitCode::Success;
+    }
+    else if (arg == "--list-validators")
+    {
+      for (const auto& factory : validatorFactories())
+      {
+        std::cout << factory.name << "\n";
+      }
+      return ExitCode::Success;
+    }
+    else if (arg == "--format" || arg == "--convert")
+    {
+      const auto value = nextArg();
+      const auto format = value ? parseMapFormat(*value) : std::nullopt;
+      if (!format)
+      {
+        return ExitCode::InvalidArguments;
+      }
+
+      if (arg == "--format")
+      {
+        options.sourceFormats = {*format};
+      }
+      else
+      {
+        options.targetFormat = *format;
+        options.writeMap = true;
+      }
+    }
+    else if (arg == "--write-map")
+    {
+      options.writeMap = true;
+    }
+    else if (arg == "--export-obj")
+    {
+      options.exportObj = true;
+    }
+    else if (arg == "--output-dir")
+    {
+      const auto value = nextArg();
+      if (!value)
+      {
+        return ExitCode::InvalidArguments;
+      }
+      options.outputDir = std::filesystem::absolute(*value);
+    }
+    else if (arg == "--validate")
+    {
+      const auto value = nextArg();
+      if (!value || !parseValidatorNames(*value, options.validatorNames))
+      {
+        return ExitCode::InvalidArguments;
+      }
+    }
+    else if (arg == "--max-property-length")
+    {
+      const auto value = nextArg();
+      const auto maxLength = value ? kdl::str_to_size(*value) : std::nullopt;
+      if (!maxLength)
+      {
+        std::cerr << "Invalid maximum property length\n";
+        return ExitCode::InvalidArguments;
+      }
+      options.maxPropertyLength = *maxLength;
+    }
+    else if (arg == "--world-bounds")
+    {
+      const auto value = nextArg();
+      const auto size = value ? kdl::str_to_double(*value) : std::nullopt;
+      if (!size || *size <= 0.0)
+      {
+        std::cerr << "Invalid world bounds\n";
+        return ExitCode::InvalidArguments;
+      }
+      options.worldBounds = vm::bbox3{-*size, *size};
+    }
+    else if (kdl::cs::str_is_prefix(arg, "--"))
+    {
+      std::cerr << "Unknown option: " << arg << "\n";
+      return ExitCode::InvalidArguments;
+    }
+    else
+    {
+      options.inputPaths.push_back(std::filesystem::absolute(arg));
+    }
+  }
+
+  if (options.inputPaths.empty())
+  {
+    printUsage(std::cerr);
+    return ExitCode::InvalidArguments;
+  }
+
+  if ((options.writeMap || options.exportObj) && !options.outputDir)
+  {
+    std::cerr << "--write-map, --convert and --export-obj require --output-dir\n";
+    return ExitCode::InvalidArguments;
+  }
+
+  return std::nullopt;
+}
+
+std::vector<Model::Node*> collectNodes(Model::WorldNode& worldNode)
+{
+  auto result = std::vector<Model::Node*>{};
+  worldNode.accept(kdl::overload(
+    [&](auto&& thisLambda, Model::WorldNode* node) {
+      result.push_back(node);
+      node->visitChildren(thisLambda);
+    },
+    [&](auto&& thisLambda, Model::LayerNode* node) {
+      result.push_back(node);
+      node->visitChildren(thisLambda);
+    },
+    [&](auto&& thisLambda, Model::GroupNode* node) {
+      result.push_back(node);
+      node->visitChildren(thisLambda);
+    },
+    [&](auto&& thisLambda, Model::EntityNode* node) {
+      result.push_back(node);
+      node->visitChildren(thisLambda);
+    },
+    [&](Model::BrushNode* node) { result.push_back(node); },
+    [&](Model::PatchNode* node) { result.push_back(node); }));
+  return result;
+}
+
+/**
+ * Runs the given validators on every node of the given world in parallel. The issues
+ * are returned in the order of their line numbers.
+ */
+std::vector<std::unique_ptr<Model::Issue>> validate(
+  Model::WorldNode& worldNode,
+  const std::vector<std::unique_ptr<Model::Validator>>& validators)
+{
+  // the link validators query the entity node index, which still holds the properties
+  // of the freshly loaded entities
+  worldNode.flushEntityNodeIndex();
+
+  auto issuesPerNode =
+    kdl::vec_parallel_transform(collectNodes(worldNode), [&](Model::Node* node) {
+      auto issues = std::vector<std::unique_ptr<Model::Issue>>{};
+      for (const auto& validator : validators)
+      {
+        validator->validate(*node, issues);
+      }
+      return issues;
+    });
+
+  auto result = kdl::vec_flatten(std::move(issuesPerNode));
+  std::stable_sort(result.begin(), result.end(), [](const auto& lhs, const auto& rhs) {
+    return lhs->lineNumber() < rhs->lineNumber();
+  });
+  return result;
+}
+
+Result<std::unique_ptr<Model::WorldNode>> loadMap(
+  const std::filesystem::path& path, const Options& options, Logger& logger)
+{
+  auto parserStatus = IO::SimpleParserStatus{logger, path.string()};
+  return IO::Disk::openFile(path) | kdl::transform([&](auto file) {
+           auto fileReader = file->reader().buffer();
+           return IO::WorldReader::tryRead(
+             fileReader.stringView(),
+             options.sourceFormats,
+             options.targetFormat,
+             options.worldBounds,
+             Model::EntityPropertyConfig{},
+             parserStatus);
+         });
+}
+
+Result<void> writeMap(Model::WorldNode& worldNode, const std::filesystem::path& path)
+{
+  return IO::Disk::withOutputStream(path, [&](auto& stream) {
+    stream << "// Format: " << Model::formatName(worldNode.mapFormat()) << "\n";
+
+    auto writer = IO::NodeWriter{worldNode, stream};
+    writer.writeMap();
+  });
+}
+
+Result<void> exportObj(Model::WorldNode& worldNode, const std::filesystem::path& path)
+{
+  const auto options = IO::ObjExportOptions{path, IO::ObjMtlPathMode::RelativeToGamePath};
+  return IO::Disk::withOutputStream(path, [&](auto& objStream) {
+    const auto mtlPath = kdl::path_replace_extension(path, ".mtl");
+    return IO::Disk::withOutputStream(mtlPath, [&](auto& mtlStream) {
+      auto writer = IO::NodeWriter{
+        worldNode,
+        std::make_unique<IO::ObjSerializer>(
+          objStream, mtlStream, mtlPath.filename().string(), options)};
+      writer.setExporting(true);
+      writer.writeMap();
+    });
+  });
+}
+
+ExitCode processMap(
+  const std::filesystem::path& inputPath,
+  const Options& options,
+  const std::vector<std::unique_ptr<Model::Validator>>& validators,
+  Logger& logger)
+{
+  auto stopwatch = Stopwatch{};
+  auto timings = std::vector<std::pair<std::string_view, std::chrono::milliseconds>>{};
+
+  auto exitCode = ExitCode::Success;
+  const auto fail = [&](const auto& stage, const auto& message) {
+    std::cerr << inputPath.string() << ": " << stage << " failed: " << message << "\n";
+    exitCode = ExitCode::ProcessingFailed;
+  };
+
+  auto worldNode = std::unique_ptr<Model::WorldNode>{};
+  try
+  {
+    worldNode = loadMap(inputPath, options, logger)
+                | kdl::if_error([&](const auto& e) { fail("Loading", e.msg); })
+                | kdl::value_or(std::unique_ptr<Model::WorldNode>{});
+  }
+  catch (const Exception& e)
+  {
+    fail("Loading", e.what());
+  }
+  timings.emplace_back("load", stopwatch.lap());
+
+  if (worldNode)
+  {
+    if (!validators.empty())
+    {
+      const auto issues = validate(*worldNode, validators);
+      for (const auto& issue : issues)
+      {
+        std::cout << inputPath.string() << ":" << issue->lineNumber() << ": "
+                  << issue->description() << "\n";
+      }
+      if (!issues.empty())
+      {
+        exitCode = ExitCode::IssuesFound;
+      }
+      timings.emplace_back("validate", stopwatch.lap());
+    }
+
+    if (options.writeMap)
+    {
+      const auto outputPath = *options.outputDir / inputPath.filename();
+      if (outputPath.lexically_normal() == inputPath.lexically_normal())
+      {
+        fail("Writing", "refusing to overwrite the input file");
+      }
+      else
+      {
+        writeMap(*worldNode, outputPath)
+          | kdl::if_error([&](const auto& e) { fail("Writing", e.msg); })
+          | kdl::is_success();
+      }
+      timings.emplace_back("write", stopwatch.lap());
+    }
+
+    if (options.exportObj)
+    {
+      const auto outputPath =
+        *options.outputDir / kdl::path_replace_extension(inputPath.filename(), ".obj");
+      exportObj(*worldNode, outputPath)
+        | kdl::if_error([&](const auto& e) { fail("Exporting", e.msg); })
+        | kdl::is_success();
+      timings.emplace_back("export", stopwatch.lap());
+    }
+  }
+
+  std::cerr << inputPath.string() << ":";
+  for (const auto& [stage, duration] : timings)
+  {
+    std::cerr << " " << stage << " " << duration.count() << " ms";
+  }
+  std::cerr << "\n";
+
+  return exitCode;
+}
+
+ExitCode run(const std::vector<std::string>& args)
+{
+  auto options = Options{};
+  if (const auto exitCode = parseOptions(args, options))
+  {
+    return *exitCode;
+  }
+
+  if (options.outputDir)
+  {
+    const auto created =
+      IO::Disk::createDirectory(*options.outputDir) | kdl::if_error([](const auto& e) {
+        std::cerr << "Could not create output directory: " << e.msg << "\n";
+      })
+      | kdl::is_success();
+    if (!created)
+    {
+      return ExitCode::ProcessingFailed;
+    }
+  }
+
+  const auto validators = kdl::vec_transform(
+    options.validatorNames, [&](const auto& name) {
+      const auto it = std::find_if(
+        validatorFactories().begin(),
+        validatorFactories().end(),
+        [&](const auto& factory) { return factory.name == name; });
+      return it->create(options);
+    });
+
+  auto logger = StderrLogger{};
+  auto stopwatch = Stopwatch{};
+
+  auto exitCode = ExitCode::Success;
+  for (const auto& inputPath : options.inputPaths)
+  {
+    exitCode = std::max(exitCode, processMap(inputPath, options, validators, logger));
+  }
+
+  std::cerr << "Processed " << options.inputPaths.size() << " map(s) in "
+            << stopwatch.lap().count() << " ms\n";
+  return exitCode;
+}
+
+} // namespace
+} // namespace TrenchBroom
+
+int main(int argc, char* argv[])
+{
+  const auto args = std::vector<std::string>(argv + 1, argv + argc);
+  return static_cast<int>(TrenchBroom::run(args));
+}